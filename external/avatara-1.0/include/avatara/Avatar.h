@@ -52,9 +52,12 @@
 #ifndef _DR_AVATAR_H
   #define _DR_AVATAR_H
 
+#include <vector>
+
 #include "avatara/Model.h"
 #include "avatara/Texture.h"
 #include "avatara/Animation.h"
+#include "avatara/PoseCache.h"
 #include "avatara/AvataraTimer.h"
 #include "avatara/AvataraDllExports.h"
 
@@ -106,6 +109,7 @@ namespace Avatara
     void Draw(DrawType drawType);
     void DrawSkeleton(bool drawAxis);
     Algebra::Vector SkinVertex(const Vertex &vertex) const;
+    void SkinVertices(float* pPositions, float* pNormals, int stride);
     void SetPose(const Pose& pose);
     void SetRestPose();
     void LookTarget(const Algebra::Vector& target);
@@ -125,6 +129,7 @@ namespace Avatara
     void StopAnimation();
     void SmoothAnimation(bool enable);
     void SetSpeed(float s);
+    void SetPoseCache(PoseCache* pPoseCache);
 
     const static float maxHeadPitch;      ///< Max. angle for head pitch (up-down).
     const static float maxHeadYaw;        ///< Max. angle for head yaw (left-right).
@@ -141,7 +146,8 @@ namespace Avatara
     Avatar(const Avatar&);                // forbid use of copy constructor
     Avatar& operator=(const Avatar&);     // forbid use of assignment operator
     void CalculatePose();
-    void UpdateAnimationPose();
+    bool UpdateAnimationPose();
+    void UseCachedPose(int time);
     void UpdateMatrixStack();
     Algebra::Matrix ComputeBoneMatrix(int boneID) const;
     Algebra::Matrix BonePose(int boneID) const;
@@ -155,6 +161,7 @@ namespace Avatara
     AnimationSet* pAnimationSet;          ///< Pointer to animation set.
     Utilities::Timer timer;               ///< Animation timer.
     const Animation* pCurrentAnimation;   ///< Pointer to current animation.
+    PoseCache* pPoseCache;                ///< Pointer to shared pose cache (optional).
 
     bool recalculatePose;                 ///< Flag: Recalculate current pose.
     bool animationRunning;                ///< Flag: Animation is running.
@@ -172,6 +179,7 @@ namespace Avatara
     Pose restPose;                        ///< Rest pose of model.
     Pose currentPose;                     ///< Current pose of avatar.
     Algebra::Matrix* pBoneMatrices;       ///< Matrix stack of current pose.
+    std::vector<float> skinMatrices;      ///< Posed bone-to-world * world-to-bone matrix of each bone (column by column).
   };
 
 } // namespace Avatara
@@ -51,6 +51,8 @@
 #ifndef _DR_MODEL_H
   #define _DR_MODEL_H
 
+#include <vector>
+
 #include "avatara/Vertex.h"
 #include "avatara/Skeleton.h"
 
@@ -99,6 +101,22 @@ namespace Avatara
   };
 
 
+  //-------------------------------------------------------
+  /// Vertex data of a model prepared for batched skinning.
+  /// The data is stored as structure of arrays so that the
+  /// skinning kernel can stream through it. The bone weights
+  /// are already normalized.
+  //-------------------------------------------------------
+  struct SkinningData
+  {
+    std::vector<float> positions;     ///< Rest positions (x, y, z, 1) of all vertices.
+    std::vector<float> normals;       ///< Rest normals (x, y, z, 0) of all vertices.
+    std::vector<int> influenceStart;  ///< Index of first influence of each vertex (one entry more than vertices).
+    std::vector<int> boneIndices;     ///< Bone index of each influence.
+    std::vector<float> weights;       ///< Normalized weight of each influence.
+  };
+
+
   //-------------------------------------------------------
   /// Contains model (vertices and faces) with skeleton.
   /// The skeleton is optional.
@@ -116,6 +134,7 @@ namespace Avatara
     int GetNoOfFaces() const;
     const Face& GetFace(int index) const;
     const Skeleton& GetSkeleton() const;
+    const SkinningData& GetSkinningData() const;
     int GetVersion() const;
 
   private:
@@ -123,6 +142,7 @@ namespace Avatara
     Model& operator=(const Model&); // forbid use of assignment operator
 
     bool LoadBones(FILE* file, int noOfBones);
+    void BuildSkinningData();
     void UnLoad();
 
     int version;          ///< Version of model file format.
@@ -131,6 +151,7 @@ namespace Avatara
     int noOfFaces;        ///< Number of faces.
     Face* pFaces;         ///< Array of faces.
     Skeleton skeleton;    ///< Skeleton object.
+    SkinningData skinningData; ///< Vertex data for Avatar::SkinVertices().
   };
 
 } // namespace Avatara
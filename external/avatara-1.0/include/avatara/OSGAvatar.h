@@ -55,6 +55,9 @@
 
 #include <OpenSG/OSGGeometry.h>
 #include <OpenSG/OSGImage.h>
+#if OSG_MAJOR_VERSION >= 2
+#include <OpenSG/OSGTypedGeoVectorProperty.h>
+#endif
 
 
 namespace Avatara
@@ -66,6 +69,14 @@ namespace Avatara
   /// MakeAvatarGeo() produces a geometry object.
   /// UpdateAvatarGeo() updates the geometry to represent the
   /// actual pose (in an animation).
+  ///
+  /// The update can also be split into three steps:
+  /// BeginAvatarGeoUpdate() (calculates the pose) and
+  /// EndAvatarGeoUpdate() have to be called from the thread
+  /// owning the OpenSG geometry, SkinAvatarGeo() only writes
+  /// into the geometry properties and may be called from any
+  /// thread in between, so that several avatars can be
+  /// skinned in parallel.
   //-------------------------------------------------------
   class AVATARA_API OSGAvatar : public Avatar
   {
@@ -79,6 +90,10 @@ namespace Avatara
 	OSG::GeometryPtr MakeAvatarGeo(OSG::ImagePtr image);
 #endif
     void UpdateAvatarGeo();
+    void BeginAvatarGeoUpdate();
+    void SkinAvatarGeo();
+    void EndAvatarGeoUpdate();
+    void SetSkinNormals(bool skin);
 
   private:
     OSGAvatar(const OSGAvatar&);                // forbid use of copy constructor
@@ -86,9 +101,19 @@ namespace Avatara
 
 #if OSG_MAJOR_VERSION >= 2
     OSG::GeometryRecPtr geo;    ///<Pointer to Avatar OpenSG geometry.
+    OSG::GeoPnt3fProperty* pPositions;  ///<Positions of the geometry.
+    OSG::GeoVec3fProperty* pNormals;    ///<Normals of the geometry.
 #else //OpenSG1:
     OSG::GeometryPtr geo;    ///<Pointer to Avatar OpenSG geometry.
+    OSG::GeoPositions3fPtr pPositions;  ///<Positions of the geometry.
+    OSG::GeoNormals3fPtr pNormals;      ///<Normals of the geometry.
 #endif
+    float* pPositionData;               ///<Position storage, valid between Begin- and EndAvatarGeoUpdate().
+    float* pNormalData;                 ///<Normal storage, valid between Begin- and EndAvatarGeoUpdate().
+    bool skinNormals;                   ///<Update the normals together with the positions.
+    std::vector<int> cornerVertices;    ///<Vertex of each face corner, -1 for flat shaded faces.
+    std::vector<float> faceNormalSigns; ///<Orientation of each face normal relative to its winding.
+    std::vector<float> vertexNormals;   ///<Skinned normal of each vertex.
   };
 
 }
@@ -0,0 +1,128 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                           Project: Avatara                                *
+ *                                                                           *
+ * The Avatara library was developed during a practical at the Johannes      *
+ * Kepler University, Linz in 2005 by Helmut Garstenauer                     *
+ * (helmut@digitalrune.com) and Martin Garstenauer (martin@digitalrune.com)  *
+ *                                                                           *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                Changes                                    *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+\*---------------------------------------------------------------------------*/
+
+//_______________________________________________________
+//
+/// \file PoseCache.h
+/// Cache for animation poses shared by several avatars.
+//_______________________________________________________
+
+#ifndef _DR_POSECACHE_H
+  #define _DR_POSECACHE_H
+
+#include "avatara/Pose.h"
+#include "avatara/Matrix.h"
+#include "avatara/AvataraDllExports.h"
+#include <map>
+#include <vector>
+
+namespace Avatara
+{
+  class Animation;
+  class Skeleton;
+
+  //-------------------------------------------------------
+  /// Evaluated animation pose of a skeleton.
+  /// Contains the interpolated pose and the resulting
+  /// PosedBone-To-World matrix stack.
+  //-------------------------------------------------------
+  struct AVATARA_API CachedPose
+  {
+    Pose pose;                                ///< Interpolated pose.
+    std::vector<Algebra::Matrix> boneMatrices;  ///< Matrix stack of the pose.
+  };
+
+
+  //-------------------------------------------------------
+  /// Cache for animation poses.
+  /// Avatars playing the same animation on the same skeleton
+  /// at the same (quantized) animation time share one
+  /// evaluated pose, so the interpolation and the matrix
+  /// stack are only computed once per animation phase and
+  /// not once per avatar.
+  ///
+  /// The cache is not thread safe, all avatars using it have
+  /// to calculate their poses in the same thread.
+  //-------------------------------------------------------
+  class AVATARA_API PoseCache
+  {
+  public:
+    PoseCache(int timeQuantum = 10);
+    ~PoseCache();
+
+    int GetTimeQuantum() const;
+    int QuantizeTime(int time) const;
+    CachedPose* GetPose(const Animation* pAnimation, const Skeleton* pSkeleton,
+                        bool smooth, int quantizedTime, bool& created);
+    void Remove(const Animation* pAnimation);
+    void Remove(const Skeleton* pSkeleton);
+    void Clear();
+    int GetNoOfPoses() const;
+    int GetNoOfHits() const;
+    int GetNoOfMisses() const;
+
+  private:
+    PoseCache(const PoseCache&);              // forbid use of copy constructor
+    PoseCache& operator=(const PoseCache&);   // forbid use of assignment operator
+
+    /// Identifies one evaluated pose.
+    struct Key
+    {
+      const Animation* pAnimation;
+      const Skeleton* pSkeleton;
+      bool smooth;
+      int time;
+      bool operator<(const Key& other) const;
+    };
+
+    typedef std::map<Key, CachedPose*> PoseMap;
+
+    int timeQuantum;          ///< Resolution of the animation time [ms].
+    PoseMap poses;            ///< All evaluated poses.
+    int noOfHits;             ///< Number of lookups answered from the cache.
+    int noOfMisses;           ///< Number of lookups which created a new pose.
+  };
+}
+
+#endif // _DR_POSECACHE_H
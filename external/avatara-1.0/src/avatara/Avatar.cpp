@@ -52,6 +52,11 @@
 #endif
 #include <cmath>
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+  #define AVATARA_USE_SSE
+  #include <xmmintrin.h>
+#endif
+
 using namespace Algebra;
 using namespace Utilities;
 using namespace std;
@@ -83,6 +88,7 @@ namespace Avatara
     pTexture = 0;
     pAnimationSet = 0;
     pCurrentAnimation = 0;
+    pPoseCache = 0;
     recalculatePose = false;
     animationRunning = false;
     smoothAnimation = false;
@@ -436,6 +442,127 @@ namespace Avatara
   }
 
 
+  //-------------------------------------------------------
+  /// Skins all vertices of the model.
+  /// Same result as calling SkinVertex() for every vertex,
+  /// but the skinning matrix of every bone is computed only
+  /// once and the weighted matrices are blended with SSE (if
+  /// available) before the vertex is transformed. The bone
+  /// matrices are affine, so no homogeneous division is done.
+  /// The pose has to be calculated before.
+  ///
+  /// \param pPositions OUT: Skinned positions (x, y, z) of all vertices.
+  /// \param pNormals OUT: Skinned and normalized normals (x, y, z) of
+  ///                  all vertices, may be NULL.
+  /// \param stride Number of floats between two positions/normals.
+  //-------------------------------------------------------
+  void Avatar::SkinVertices(float* pPositions, float* pNormals, int stride)
+  {
+    ASSERT(pModel != NULL)
+
+    const SkinningData& data = pModel->GetSkinningData();
+    int noOfVertices = pModel->GetNoOfVertices();
+    int noOfBones = pModel->GetSkeleton().GetNoOfBones();
+    bool skin = (pBoneMatrices != 0 && noOfBones > 0);
+
+    if (skin)
+    {
+      skinMatrices.resize(16*noOfBones);
+      for (int bone=0; bone<noOfBones; bone++)
+      {
+        Matrix m = pBoneMatrices[bone] * pModel->GetSkeleton().GetBone(bone).worldToBoneMatrix;
+        for (int column=0; column<4; column++)
+          for (int row=0; row<4; row++)
+            skinMatrices[16*bone + 4*column + row] = m.M(row, column);
+      }
+    }
+
+    for (int i=0; i<noOfVertices; i++)
+    {
+      const float* pPos = &data.positions[4*i];
+      const float* pNormal = &data.normals[4*i];
+      float* pPosOut = pPositions + i*stride;
+      float* pNormalOut = pNormals ? pNormals + i*stride : 0;
+      int start = data.influenceStart[i];
+      int end = data.influenceStart[i+1];
+
+      if (!skin || start == end)
+      {
+        for (int j=0; j<3; j++)
+        {
+          pPosOut[j] = pPos[j];
+          if (pNormalOut)
+            pNormalOut[j] = pNormal[j];
+        }
+        continue;
+      }
+
+#ifdef AVATARA_USE_SSE
+      // blend the columns of the bone matrices
+      __m128 c0 = _mm_setzero_ps();
+      __m128 c1 = _mm_setzero_ps();
+      __m128 c2 = _mm_setzero_ps();
+      __m128 c3 = _mm_setzero_ps();
+      for (int k=start; k<end; k++)
+      {
+        const float* m = &skinMatrices[16*data.boneIndices[k]];
+        __m128 w = _mm_set1_ps(data.weights[k]);
+        c0 = _mm_add_ps(c0, _mm_mul_ps(w, _mm_loadu_ps(m)));
+        c1 = _mm_add_ps(c1, _mm_mul_ps(w, _mm_loadu_ps(m+4)));
+        c2 = _mm_add_ps(c2, _mm_mul_ps(w, _mm_loadu_ps(m+8)));
+        c3 = _mm_add_ps(c3, _mm_mul_ps(w, _mm_loadu_ps(m+12)));
+      }
+
+      float result[4];
+      __m128 p = _mm_add_ps(
+          _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(pPos[0])), _mm_mul_ps(c1, _mm_set1_ps(pPos[1]))),
+          _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(pPos[2])), c3));
+      _mm_storeu_ps(result, p);
+      pPosOut[0] = result[0];
+      pPosOut[1] = result[1];
+      pPosOut[2] = result[2];
+
+      if (pNormalOut)
+      {
+        __m128 n = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(pNormal[0])), _mm_mul_ps(c1, _mm_set1_ps(pNormal[1]))),
+            _mm_mul_ps(c2, _mm_set1_ps(pNormal[2])));
+        _mm_storeu_ps(result, n);
+        float length = sqrtf(result[0]*result[0] + result[1]*result[1] + result[2]*result[2]);
+        float scale = (length > 0.0f) ? 1.0f / length : 0.0f;
+        pNormalOut[0] = result[0] * scale;
+        pNormalOut[1] = result[1] * scale;
+        pNormalOut[2] = result[2] * scale;
+      }
+#else
+      // blend the columns of the bone matrices
+      float c[16] = {0};
+      for (int k=start; k<end; k++)
+      {
+        const float* m = &skinMatrices[16*data.boneIndices[k]];
+        float w = data.weights[k];
+        for (int j=0; j<16; j++)
+          c[j] += w * m[j];
+      }
+
+      for (int j=0; j<3; j++)
+        pPosOut[j] = c[j]*pPos[0] + c[4+j]*pPos[1] + c[8+j]*pPos[2] + c[12+j];
+
+      if (pNormalOut)
+      {
+        float n[3];
+        for (int j=0; j<3; j++)
+          n[j] = c[j]*pNormal[0] + c[4+j]*pNormal[1] + c[8+j]*pNormal[2];
+        float length = sqrtf(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+        float scale = (length > 0.0f) ? 1.0f / length : 0.0f;
+        for (int j=0; j<3; j++)
+          pNormalOut[j] = n[j] * scale;
+      }
+#endif
+    }
+  }
+
+
   //-------------------------------------------------------
   /// Sets current pose.
   ///
@@ -539,8 +666,8 @@ namespace Avatara
     {
       if (animationRunning)
       {
-        UpdateAnimationPose();
-        UpdateMatrixStack();
+        if (!UpdateAnimationPose())
+          UpdateMatrixStack();
       }
 
       if (bowAngle < -EPSILON || EPSILON < bowAngle)
@@ -563,8 +690,11 @@ namespace Avatara
 
   //-------------------------------------------------------
   /// Calculates new animation pose.
+  ///
+  /// \return true if the matrix stack was taken from the pose
+  ///         cache and does not have to be updated.
   //-------------------------------------------------------
-  void Avatar::UpdateAnimationPose()
+  bool Avatar::UpdateAnimationPose()
   {
     ASSERT(pCurrentAnimation != 0);
 
@@ -585,6 +715,14 @@ namespace Avatara
       }
       timer.SetTimeInMilliseconds(time);
 
+      // Share the pose with other avatars in the same animation phase.
+      // (Not during a transition, which depends on the previous pose.)
+      if (pPoseCache != 0 && animationLength != 0 && time >= 0 && currentPose.time >= 0)
+      {
+        UseCachedPose(time);
+        return true;
+      }
+
       if (smoothAnimation == false)
       {
         // Jerky animation
@@ -608,6 +746,51 @@ namespace Avatara
         currentPose.Interpolate(nextPose, time);
       }
     }
+    return false;
+  }
+
+
+  //-------------------------------------------------------
+  /// Sets current pose and matrix stack from the pose cache.
+  ///
+  /// The cached pose of the quantized animation time is
+  /// interpolated between the surrounding key frames (or is
+  /// the preceding key frame for jerky animations) and is
+  /// evaluated only by the first avatar reaching this time.
+  ///
+  /// \param time Animation time in ms.
+  //-------------------------------------------------------
+  void Avatar::UseCachedPose(int time)
+  {
+    ASSERT(pPoseCache != 0);
+
+    int noOfBones = pModel->GetSkeleton().GetNoOfBones();
+    int quantizedTime = pPoseCache->QuantizeTime(time);
+    bool created;
+    CachedPose* pCachedPose = pPoseCache->GetPose(pCurrentAnimation, &pModel->GetSkeleton(),
+                                                  smoothAnimation, quantizedTime, created);
+
+    if (created)
+    {
+      const Pose& precPose = pCurrentAnimation->GetPrecPose(quantizedTime);
+      currentPose = precPose;
+      if (smoothAnimation && precPose.time < quantizedTime)
+      {
+        currentPose.Interpolate(pCurrentAnimation->GetSuccPose(quantizedTime), quantizedTime);
+      }
+      UpdateMatrixStack();
+
+      pCachedPose->pose = currentPose;
+      pCachedPose->boneMatrices.assign(pBoneMatrices, pBoneMatrices + noOfBones);
+    }
+    else
+    {
+      currentPose = pCachedPose->pose;
+      for (int i=0; i<noOfBones; i++)
+        pBoneMatrices[i] = pCachedPose->boneMatrices[i];
+    }
+
+    currentPose.time = time;
   }
 
 
@@ -1362,6 +1545,19 @@ namespace Avatara
   }
 
 
+  //-------------------------------------------------------
+  /// Sets a pose cache shared with other avatars.
+  /// Avatars using the same animation then share the
+  /// evaluated poses (see PoseCache).
+  ///
+  /// \param pPoseCache Pointer to pose cache, 0 disables caching.
+  //-------------------------------------------------------
+  void Avatar::SetPoseCache(PoseCache* pPoseCache)
+  {
+    this->pPoseCache = pPoseCache;
+  }
+
+
   //-------------------------------------------------------
   /// Sets angle of hand rotation.
   /// \param angle Angle of rotation [rad]
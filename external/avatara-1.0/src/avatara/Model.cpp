@@ -276,6 +276,9 @@ namespace Avatara
     // close file
     fclose(file);
 
+    if (bSuccessful)
+      BuildSkinningData();
+
     PRINT("Model::Load() finished")
 
     return bSuccessful;
@@ -409,6 +412,12 @@ namespace Avatara
     }
 
     skeleton.UnLoad();
+
+    skinningData.positions.clear();
+    skinningData.normals.clear();
+    skinningData.influenceStart.clear();
+    skinningData.boneIndices.clear();
+    skinningData.weights.clear();
   }
 
 
@@ -460,6 +469,58 @@ namespace Avatara
   }
 
 
+  //-------------------------------------------------------
+  /// Return vertex data for batched skinning.
+  //-------------------------------------------------------
+  const SkinningData& Model::GetSkinningData() const
+  {
+    return skinningData;
+  }
+
+
+  //-------------------------------------------------------
+  /// Copies the vertices into the skinning data arrays.
+  /// Influences of vertices whose bone weights sum up to
+  /// zero are dropped, these vertices keep their rest
+  /// position like in Avatar::SkinVertex().
+  //-------------------------------------------------------
+  void Model::BuildSkinningData()
+  {
+    skinningData.positions.resize(4*noOfVertices);
+    skinningData.normals.resize(4*noOfVertices);
+    skinningData.influenceStart.resize(noOfVertices+1);
+    skinningData.boneIndices.clear();
+    skinningData.weights.clear();
+
+    for (int i=0; i<noOfVertices; i++)
+    {
+      const Vertex& vertex = pVertices[i];
+      Vector normal = vertex.Normal();
+      normal.Normalize();
+      for (int j=0; j<3; j++)
+      {
+        skinningData.positions[4*i+j] = vertex.Position()[j];
+        skinningData.normals[4*i+j] = normal[j];
+      }
+      skinningData.positions[4*i+3] = 1.0f;
+      skinningData.normals[4*i+3] = 0.0f;
+
+      skinningData.influenceStart[i] = (int)skinningData.weights.size();
+      float totalWeight = 0.0f;
+      for (int j=0; j<vertex.NoOfBones(); j++)
+        totalWeight += vertex.GetBoneWeight(j);
+      if (totalWeight == 0.0f)
+        continue;
+      for (int j=0; j<vertex.NoOfBones(); j++)
+      {
+        skinningData.boneIndices.push_back(vertex.GetBoneIndex(j));
+        skinningData.weights.push_back(vertex.GetBoneWeight(j) / totalWeight);
+      }
+    }
+    skinningData.influenceStart[noOfVertices] = (int)skinningData.weights.size();
+  }
+
+
   //-------------------------------------------------------
   /// Return skeleton.
   //-------------------------------------------------------
@@ -62,7 +62,12 @@ namespace Avatara
 	//-------------------------------------------------------
 	/// Initializes empty avatar object.
 	//-------------------------------------------------------
-	OSGAvatar::OSGAvatar()
+	OSGAvatar::OSGAvatar() :
+		pPositions(NULL),
+		pNormals(NULL),
+		pPositionData(NULL),
+		pNormalData(NULL),
+		skinNormals(true)
 	{
 	}
 
@@ -190,6 +195,32 @@ namespace Avatara
 			endEditCP  (colors, GeoPositions3f::GeoPropDataFieldMask);
 #endif
 
+			//
+			// ----- skinning of the normals
+			//
+			// Smooth shaded corners take the normal of their skinned vertex,
+			// flat shaded faces are recalculated from the skinned positions.
+			// The sign keeps the face normal on the side given by the model.
+			cornerVertices.resize(3*pModel->GetNoOfFaces());
+			faceNormalSigns.resize(pModel->GetNoOfFaces());
+			vertexNormals.resize(3*pModel->GetNoOfVertices());
+			{
+				for (int i=0; i<pModel->GetNoOfFaces(); i++)
+				{
+					Face face = pModel->GetFace(i);
+					Algebra::Vector p0 = pModel->GetVertex(face.pVertexIndices[0]).Position();
+					Algebra::Vector p1 = pModel->GetVertex(face.pVertexIndices[1]).Position();
+					Algebra::Vector p2 = pModel->GetVertex(face.pVertexIndices[2]).Position();
+					Vec3f edge1(p1.X()-p0.X(), p1.Y()-p0.Y(), p1.Z()-p0.Z());
+					Vec3f edge2(p2.X()-p0.X(), p2.Y()-p0.Y(), p2.Z()-p0.Z());
+					Vec3f cross = edge1.cross(edge2);
+					faceNormalSigns[i] = (cross.dot(Vec3f(face.normal.X(), face.normal.Y(),
+							face.normal.Z())) < 0) ? -1.0f : 1.0f;
+					for (int j=0; j<3; j++)
+						cornerVertices[3*i+j] = (face.shading == Smooth) ? face.pVertexIndices[j] : -1;
+				}
+			}
+
 			//
 			// ----- index list
 			//
@@ -309,47 +340,134 @@ namespace Avatara
 	//-------------------------------------------------------
 	void OSGAvatar::UpdateAvatarGeo()
 	{
-		// get position vector from the geometry
-#if OSG_MAJOR_VERSION >= 2
-		GeoVectorProperty* pos = geo->getPositions();
-#else //OpenSG1:
-		GeoPositionsPtr pos = geo->getPositions();
-#endif
+		BeginAvatarGeoUpdate();
+		SkinAvatarGeo();
+		EndAvatarGeoUpdate();
+	}
 
-#if OPENSG_GEOPROPERTY_HAVE_SIZE_FUNCTION
-		ASSERT(pModel->GetNoOfVertices() == pos->size());
-#else
-		ASSERT(pModel->GetNoOfVertices() == pos->getSize());
-#endif
+
+	//-------------------------------------------------------
+	/// Calculates the new pose and opens the geometry
+	/// properties for SkinAvatarGeo().
+	/// Has to be called from the thread owning the geometry
+	/// (the pose cache is not thread safe).
+	//-------------------------------------------------------
+	void OSGAvatar::BeginAvatarGeoUpdate()
+	{
+		ASSERT(pModel != NULL);
 
 		// Calculate the new pose of the animation
 		CalculatePose();
 
-		// discard the old positions and add the new skinned positions
 #if OSG_MAJOR_VERSION >= 2
+		pPositions = dynamic_cast<GeoPnt3fProperty*>(geo->getPositions());
+		pNormals = dynamic_cast<GeoVec3fProperty*>(geo->getNormals());
+		ASSERT(pPositions != NULL && pNormals != NULL);
+		pPositionData = pPositions->editField()[0].getValues();
+		if (skinNormals)
+			pNormalData = pNormals->editField()[0].getValues();
 #else //OpenSG1:
-		beginEditCP(pos);
-#endif
-#if OPENSG_GEOPROPERTY_HAVE_SIZE_FUNCTION
-		for(UInt32 i = 0; i < pos->size(); i++)
-#else
-		for(UInt32 i = 0; i < pos->getSize(); i++)
+		pPositions = GeoPositions3fPtr::dcast(geo->getPositions());
+		pNormals = GeoNormals3fPtr::dcast(geo->getNormals());
+		ASSERT(pPositions != NullFC);
+		beginEditCP(pPositions, GeoPositions3f::GeoPropDataFieldMask);
+		pPositionData = pPositions->getField()[0].getValues();
+		if (skinNormals)
+		{
+			beginEditCP(pNormals, GeoNormals3f::GeoPropDataFieldMask);
+			pNormalData = pNormals->getField()[0].getValues();
+		}
 #endif
+	}
+
+
+	//-------------------------------------------------------
+	/// Writes the skinned positions (and normals) into the
+	/// geometry.
+	/// Only valid between BeginAvatarGeoUpdate() and
+	/// EndAvatarGeoUpdate(), may be called from any thread.
+	//-------------------------------------------------------
+	void OSGAvatar::SkinAvatarGeo()
+	{
+		ASSERT(pPositionData != NULL);
+
+		if (!skinNormals)
 		{
-			Algebra::Vector pnt = SkinVertex(pModel->GetVertex(i));
-			Pnt3f p(pnt.X(), pnt.Y(), pnt.Z());
-			pos->setValue(p, i);
+			SkinVertices(pPositionData, NULL, 3);
+			return;
+		}
+
+		SkinVertices(pPositionData, &vertexNormals[0], 3);
+
+		for (int i=0; i<pModel->GetNoOfFaces(); i++)
+		{
+			float* pCorner = pNormalData + 9*i;
+			if (cornerVertices[3*i] >= 0)
+			{
+				for (int j=0; j<3; j++)
+				{
+					const float* pNormal = &vertexNormals[3*cornerVertices[3*i+j]];
+					pCorner[3*j] = pNormal[0];
+					pCorner[3*j+1] = pNormal[1];
+					pCorner[3*j+2] = pNormal[2];
+				}
+				continue;
+			}
+
+			Face face = pModel->GetFace(i);
+			const float* p0 = pPositionData + 3*face.pVertexIndices[0];
+			const float* p1 = pPositionData + 3*face.pVertexIndices[1];
+			const float* p2 = pPositionData + 3*face.pVertexIndices[2];
+			Vec3f edge1(p1[0]-p0[0], p1[1]-p0[1], p1[2]-p0[2]);
+			Vec3f edge2(p2[0]-p0[0], p2[1]-p0[1], p2[2]-p0[2]);
+			Vec3f normal = edge1.cross(edge2);
+			normal.normalize();
+			normal *= faceNormalSigns[i];
+			for (int j=0; j<3; j++)
+			{
+				pCorner[3*j] = normal[0];
+				pCorner[3*j+1] = normal[1];
+				pCorner[3*j+2] = normal[2];
+			}
 		}
+	}
+
+
+	//-------------------------------------------------------
+	/// Commits the changes done by SkinAvatarGeo().
+	/// Has to be called from the thread owning the geometry.
+	//-------------------------------------------------------
+	void OSGAvatar::EndAvatarGeoUpdate()
+	{
+		pPositionData = NULL;
+		pNormalData = NULL;
+
 #if OSG_MAJOR_VERSION >= 2
 		OSG::commitChanges();
 #else //OpenSG1:
-		endEditCP  (pos);
+		endEditCP  (pPositions, GeoPositions3f::GeoPropDataFieldMask);
+		if (skinNormals)
+			endEditCP  (pNormals, GeoNormals3f::GeoPropDataFieldMask);
 
 		// right now the geometry doesn't notice changes to the properties, it has
 		// to be notified explicitly
-		beginEditCP(geo, Geometry::PositionsFieldMask);
-		endEditCP  (geo, Geometry::PositionsFieldMask);
+		BitVector mask = Geometry::PositionsFieldMask;
+		if (skinNormals)
+			mask |= Geometry::NormalsFieldMask;
+		beginEditCP(geo, mask);
+		endEditCP  (geo, mask);
 #endif
 	}
-}
 
+
+	//-------------------------------------------------------
+	/// Defines if the normals are skinned together with the
+	/// positions (default) or keep the normals of the model.
+	///
+	/// \param skin IN: true to skin the normals.
+	//-------------------------------------------------------
+	void OSGAvatar::SetSkinNormals(bool skin)
+	{
+		skinNormals = skin;
+	}
+}
@@ -157,6 +157,8 @@ namespace Avatara
   //-------------------------------------------------------
   Pose::Pose(const Pose& pose)
   {
+    noOfBones = 0;
+    pBoneKeys = 0;
     Set(pose);
   }
 
@@ -222,10 +224,10 @@ namespace Avatara
   void Pose::Set(const Pose& pose)
   {
     time = pose.time;
-    noOfBones = pose.noOfBones;
 
-    if (noOfBones == 0)
+    if (pose.noOfBones == 0)
     {
+      noOfBones = 0;
       if (pBoneKeys != NULL)
       {
         delete[] pBoneKeys;
@@ -234,7 +236,9 @@ namespace Avatara
       return;
     }
 
-    AllocateBoneKeys(noOfBones);
+    // keep the bone keys if the size does not change
+    if (pBoneKeys == NULL || noOfBones != pose.noOfBones)
+      AllocateBoneKeys(pose.noOfBones);
 
     // Copy bone-keys
     int i;
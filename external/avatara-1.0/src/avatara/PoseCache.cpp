@@ -0,0 +1,236 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                           Project: Avatara                                *
+ *                                                                           *
+ * The Avatara library was developed during a practical at the Johannes      *
+ * Kepler University, Linz in 2005 by Helmut Garstenauer                     *
+ * (helmut@digitalrune.com) and Martin Garstenauer (martin@digitalrune.com)  *
+ *                                                                           *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                Changes                                    *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+\*---------------------------------------------------------------------------*/
+
+//_______________________________________________________
+//
+/// \file PoseCache.cpp
+/// Cache for animation poses shared by several avatars.
+//_______________________________________________________
+
+#include "avatara/PoseCache.h"
+
+namespace Avatara
+{
+
+  //-------------------------------------------------------
+  /// Initializes an empty cache.
+  ///
+  /// \param timeQuantum Resolution of the animation time in ms.
+  ///                    Avatars whose animation times differ by
+  ///                    less than this share the same pose.
+  //-------------------------------------------------------
+  PoseCache::PoseCache(int timeQuantum)
+  {
+    this->timeQuantum = (timeQuantum > 0) ? timeQuantum : 1;
+    noOfHits = 0;
+    noOfMisses = 0;
+  }
+
+
+  //-------------------------------------------------------
+  /// Frees all cached poses.
+  //-------------------------------------------------------
+  PoseCache::~PoseCache()
+  {
+    Clear();
+  }
+
+
+  //-------------------------------------------------------
+  /// Returns the resolution of the animation time.
+  ///
+  /// \return Time quantum in ms.
+  //-------------------------------------------------------
+  int PoseCache::GetTimeQuantum() const
+  {
+    return timeQuantum;
+  }
+
+
+  //-------------------------------------------------------
+  /// Rounds an animation time down to the time quantum.
+  ///
+  /// \param time Animation time in ms (>= 0).
+  /// \return Quantized animation time in ms.
+  //-------------------------------------------------------
+  int PoseCache::QuantizeTime(int time) const
+  {
+    return time - time % timeQuantum;
+  }
+
+
+  //-------------------------------------------------------
+  /// Returns the pose of an animation at a quantized time.
+  /// If the pose is not cached yet an empty entry is
+  /// created which has to be filled by the caller.
+  ///
+  /// \param pAnimation Animation.
+  /// \param pSkeleton Skeleton the matrix stack is computed for.
+  /// \param smooth Smooth (interpolated) or jerky animation.
+  /// \param quantizedTime Animation time, see QuantizeTime().
+  /// \param created OUT: true if the entry was created.
+  /// \return Cached pose.
+  //-------------------------------------------------------
+  CachedPose* PoseCache::GetPose(const Animation* pAnimation, const Skeleton* pSkeleton,
+                                 bool smooth, int quantizedTime, bool& created)
+  {
+    Key key;
+    key.pAnimation = pAnimation;
+    key.pSkeleton = pSkeleton;
+    key.smooth = smooth;
+    key.time = quantizedTime;
+
+    PoseMap::iterator it = poses.lower_bound(key);
+    if (it != poses.end() && !(key < it->first))
+    {
+      created = false;
+      noOfHits++;
+      return it->second;
+    }
+
+    CachedPose* pCachedPose = new CachedPose;
+    poses.insert(it, PoseMap::value_type(key, pCachedPose));
+    created = true;
+    noOfMisses++;
+    return pCachedPose;
+  }
+
+
+  //-------------------------------------------------------
+  /// Removes all poses of an animation.
+  /// Has to be called before the animation is deleted.
+  ///
+  /// \param pAnimation Animation.
+  //-------------------------------------------------------
+  void PoseCache::Remove(const Animation* pAnimation)
+  {
+    PoseMap::iterator it = poses.begin();
+    while (it != poses.end())
+    {
+      if (it->first.pAnimation == pAnimation)
+      {
+        delete it->second;
+        poses.erase(it++);
+      }
+      else
+        ++it;
+    }
+  }
+
+
+  //-------------------------------------------------------
+  /// Removes all poses of a skeleton.
+  /// Has to be called before the model of the skeleton is
+  /// unloaded.
+  ///
+  /// \param pSkeleton Skeleton.
+  //-------------------------------------------------------
+  void PoseCache::Remove(const Skeleton* pSkeleton)
+  {
+    PoseMap::iterator it = poses.begin();
+    while (it != poses.end())
+    {
+      if (it->first.pSkeleton == pSkeleton)
+      {
+        delete it->second;
+        poses.erase(it++);
+      }
+      else
+        ++it;
+    }
+  }
+
+
+  //-------------------------------------------------------
+  /// Removes all poses.
+  //-------------------------------------------------------
+  void PoseCache::Clear()
+  {
+    for (PoseMap::iterator it = poses.begin(); it != poses.end(); ++it)
+      delete it->second;
+    poses.clear();
+  }
+
+
+  //-------------------------------------------------------
+  /// Returns the number of cached poses.
+  //-------------------------------------------------------
+  int PoseCache::GetNoOfPoses() const
+  {
+    return (int)poses.size();
+  }
+
+
+  //-------------------------------------------------------
+  /// Returns the number of lookups answered from the cache.
+  //-------------------------------------------------------
+  int PoseCache::GetNoOfHits() const
+  {
+    return noOfHits;
+  }
+
+
+  //-------------------------------------------------------
+  /// Returns the number of lookups which created a pose.
+  //-------------------------------------------------------
+  int PoseCache::GetNoOfMisses() const
+  {
+    return noOfMisses;
+  }
+
+
+  //-------------------------------------------------------
+  /// Orders keys by animation, skeleton, mode and time.
+  //-------------------------------------------------------
+  bool PoseCache::Key::operator<(const Key& other) const
+  {
+    if (pAnimation != other.pAnimation)
+      return pAnimation < other.pAnimation;
+    if (pSkeleton != other.pSkeleton)
+      return pSkeleton < other.pSkeleton;
+    if (smooth != other.smooth)
+      return smooth < other.smooth;
+    return time < other.time;
+  }
+}
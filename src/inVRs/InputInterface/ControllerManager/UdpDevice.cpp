@@ -36,10 +36,21 @@
 #include "../../SystemCore/DebugOutput.h"
 #include "../../SystemCore/SystemCore.h"
 #include "../../SystemCore/MessageFunctions.h"
+#include "../../SystemCore/Timer.h"
+
+namespace {
+
+// states received after a long pause are not spread over the whole pause
+const double MAX_SAMPLE_SPREAD = 0.1;
+
+} // namespace
 
 UdpDevice::UdpDevice(unsigned networkChannel) :
 	networkChannel(networkChannel),
-	netInt(NULL) {
+	netInt(NULL),
+	predictionTime(0),
+	maxExtrapolationTime(UDPDEVICE_MAX_EXTRAPOLATION),
+	lastUpdateTime(0) {
 
 	nButtons = UDPDEVICE_MAX_BUTTONS;
 	nAxes = UDPDEVICE_MAX_AXIS;
@@ -52,9 +63,12 @@ UdpDevice::UdpDevice(unsigned networkChannel) :
 	memset(buttonState, 0, sizeof(int) * nButtons);
 	memset(axisState, 0, sizeof(float) * nAxes);
 	memset(sensorState, 0, sizeof(SensorData) * nSensors);
+	memset(sensorFilters, 0, sizeof(sensorFilters));
 } // UdpDevice
 
 UdpDevice::~UdpDevice() {
+	for (int i = 0; i < UDPDEVICE_MAX_SENSORS; i++)
+		delete sensorFilters[i];
 	delete[] buttonState;
 	delete[] axisState;
 	delete[] sensorState;
@@ -63,10 +77,9 @@ UdpDevice::~UdpDevice() {
 void UdpDevice::update() {
 	std::vector<NetMessage*> deviceStatesList;
 	DEVICESTATE deviceState;
-	NetMessage* message;
-	int i;
-
-	memset(&deviceState, 0, sizeof(deviceState));
+	double now = inVRsUtilities::Timer::getMonotonicTime();
+	double sampleTime, spread;
+	int i, j, numMessages;
 
 	if (!netInt)
 		netInt = (NetworkInterface*)SystemCore::getModuleByName("Network");
@@ -77,36 +90,80 @@ void UdpDevice::update() {
 	}
 
 	netInt->popAll(networkChannel, &deviceStatesList);
-	if (deviceStatesList.size() == 0)
-		return;
+	numMessages = deviceStatesList.size();
 
-	message = deviceStatesList[deviceStatesList.size() - 1];
-	decodeStateFromBinaryMessage(&deviceState, message);
+	// the protocol has no timestamps, so the states received since the last
+	// update are spread evenly over the time in between
+	spread = now - lastUpdateTime;
+	if (spread > MAX_SAMPLE_SPREAD)
+		spread = MAX_SAMPLE_SPREAD;
+	lastUpdateTime = now;
 
-	for (i = 0; i < nButtons; i++) {
-		if (buttonState[i] != deviceState.buttonValues[i]) {
-			buttonState[i] = deviceState.buttonValues[i];
-			sendButtonChangeNotification(i, buttonState[i]);
-		} // if
+	for (j = 0; j < numMessages; j++) {
+		memset(&deviceState, 0, sizeof(deviceState));
+		decodeStateFromBinaryMessage(&deviceState, deviceStatesList[j]);
+
+		// report button changes of every state, not only of the last one
+		for (i = 0; i < nButtons; i++) {
+			if (buttonState[i] != deviceState.buttonValues[i]) {
+				buttonState[i] = deviceState.buttonValues[i];
+				sendButtonChangeNotification(i, buttonState[i]);
+			} // if
+		} // for
+
+		sampleTime = now - spread * (numMessages - 1 - j) / numMessages;
+		for (i = 0; i < (int)deviceState.numSensors && i < UDPDEVICE_MAX_SENSORS; i++) {
+			if (sensorFilters[i])
+				sensorFilters[i]->addSample(deviceState.sensorValues[i], sampleTime);
+		} // for
 	} // for
 
-	for (i = 0; i < nAxes; i++)
-		axisState[i] = deviceState.axisValues[i];
+	if (numMessages > 0) {
+		for (i = 0; i < nAxes; i++)
+			axisState[i] = deviceState.axisValues[i];
+
+		for (i = 0; i < nSensors; i++)
+			sensorState[i] = deviceState.sensorValues[i];
+	} // if
 
-	for (i = 0; i < nSensors; i++)
-		sensorState[i] = deviceState.sensorValues[i];
+	// filtered sensors are predicted in every frame, also without new states
+	updateFilteredSensors(now);
 
-	for (i = 0; i < (int)deviceStatesList.size(); i++)
+	for (i = 0; i < numMessages; i++)
 		delete deviceStatesList[i];
 } // update
 
+void UdpDevice::setSensorFilter(unsigned sensorIndex, SensorFilter* filter) {
+	if (sensorIndex >= UDPDEVICE_MAX_SENSORS) {
+		printd(ERROR, "UdpDevice::setSensorFilter(): invalid sensor index %u!\n", sensorIndex);
+		delete filter;
+		return;
+	} // if
+	delete sensorFilters[sensorIndex];
+	sensorFilters[sensorIndex] = filter;
+} // setSensorFilter
+
+void UdpDevice::setPredictionTime(float predictionTime, float maxExtrapolationTime) {
+	this->predictionTime = predictionTime;
+	this->maxExtrapolationTime = maxExtrapolationTime;
+} // setPredictionTime
+
+void UdpDevice::updateFilteredSensors(double time) {
+	for (int i = 0; i < nSensors; i++) {
+		if (sensorFilters[i] && sensorFilters[i]->hasSample())
+			sensorFilters[i]->predict(time + predictionTime, maxExtrapolationTime, sensorState[i]);
+	} // for
+} // updateFilteredSensors
+
 void UdpDevice::decodeStateFromBinaryMessage(DEVICESTATE* deviceState, NetMessage* msg) {
 	int i;
 	uint8_t numButtons, numAxes, numSensors;
 	uint8_t numBytes;
 	uint8_t *buttonData;
+	float skippedAxis;
 
 	msg->getUInt8(numButtons);
+	deviceState->numButtons = numButtons;
 	if (numButtons > 0)
 		numBytes = ((numButtons - 1) / 8) + 1;
 	else
@@ -121,12 +178,24 @@ void UdpDevice::decodeStateFromBinaryMessage(DEVICESTATE* deviceState, NetMessag
 		delete buttonData;
 	} // if
 
+	// the counts are read from the network, values which do not fit into
+	// the DEVICESTATE are skipped
 	msg->getUInt8(numAxes);
-	for (int i = 0; i < numAxes; i++) {
-		msg->getReal32(deviceState->axisValues[i]);
+	deviceState->numAxes = numAxes < UDPDEVICE_MAX_AXIS ? numAxes : UDPDEVICE_MAX_AXIS;
+	for (i = 0; i < numAxes; i++) {
+		if (i < UDPDEVICE_MAX_AXIS)
+			msg->getReal32(deviceState->axisValues[i]);
+		else
+			msg->getReal32(skippedAxis);
 	} // for
 
 	msg->getUInt8(numSensors);
+	if (numSensors > UDPDEVICE_MAX_SENSORS) {
+		printd(WARNING, "UdpDevice::decodeStateFromBinaryMessage(): received %u sensors, only %u are supported!\n",
+				(unsigned)numSensors, (unsigned)UDPDEVICE_MAX_SENSORS);
+		numSensors = UDPDEVICE_MAX_SENSORS;
+	} // if
+	deviceState->numSensors = numSensors;
 	for (i = 0; i < numSensors; i++) {
 		msgFunctions::decode(deviceState->sensorValues[i], msg);
 	} // for
@@ -152,9 +221,63 @@ InputDevice* UdpDeviceFactory::create(std::string className, ArgumentVector* arg
 		return NULL;
 
 	unsigned networkChannel = UDPDEVICE_NETWORKCHANNEL;
+	float predictionTime = 0;
+	float maxExtrapolationTime = UDPDEVICE_MAX_EXTRAPOLATION;
 
 	if (args && args->keyExists("networkChannel")) {
 		args->get("networkChannel", networkChannel);
 	} // if
-	return new UdpDevice(networkChannel);
+	UdpDevice* device = new UdpDevice(networkChannel);
+
+	SensorFilter* filter = NULL;
+	if (args && args->keyExists("sensorFilter"))
+		filter = createSensorFilter(args);
+	if (filter) {
+		device->setSensorFilter(0, filter);
+		for (unsigned i = 1; i < UDPDEVICE_MAX_SENSORS; i++)
+			device->setSensorFilter(i, createSensorFilter(args));
+		if (args->keyExists("predictionTime"))
+			args->get("predictionTime", predictionTime);
+		if (args->keyExists("maxExtrapolationTime"))
+			args->get("maxExtrapolationTime", maxExtrapolationTime);
+		device->setPredictionTime(predictionTime, maxExtrapolationTime);
+	} // if
+	return device;
 } // create
+
+SensorFilter* UdpDeviceFactory::createSensorFilter(ArgumentVector* args) {
+	std::string type;
+	args->get("sensorFilter", type);
+
+	if (type == "OneEuro") {
+		float minCutoff = 1.0f;
+		float beta = 20.0f;
+		float derivativeCutoff = 5.0f;
+		if (args->keyExists("minCutoff"))
+			args->get("minCutoff", minCutoff);
+		if (args->keyExists("beta"))
+			args->get("beta", beta);
+		if (args->keyExists("derivativeCutoff"))
+			args->get("derivativeCutoff", derivativeCutoff);
+		return new OneEuroSensorFilter(minCutoff, beta, derivativeCutoff);
+	} else if (type == "Kalman") {
+		float positionProcessNoise = 3.f;
+		float positionMeasurementNoise = 1e-4f;
+		float orientationProcessNoise = 3.f;
+		float orientationMeasurementNoise = 1e-4f;
+		if (args->keyExists("positionProcessNoise"))
+			args->get("positionProcessNoise", positionProcessNoise);
+		if (args->keyExists("positionMeasurementNoise"))
+			args->get("positionMeasurementNoise", positionMeasurementNoise);
+		if (args->keyExists("orientationProcessNoise"))
+			args->get("orientationProcessNoise", orientationProcessNoise);
+		if (args->keyExists("orientationMeasurementNoise"))
+			args->get("orientationMeasurementNoise", orientationMeasurementNoise);
+		return new KalmanSensorFilter(positionProcessNoise, positionMeasurementNoise,
+				orientationProcessNoise, orientationMeasurementNoise);
+	} // else if
+
+	printd(WARNING, "UdpDeviceFactory::createSensorFilter(): unknown sensorFilter %s, sensors are not filtered!\n",
+			type.c_str());
+	return NULL;
+} // createSensorFilter
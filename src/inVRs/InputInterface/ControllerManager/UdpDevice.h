@@ -39,6 +39,7 @@
 #include <vector>
 
 #include "InputDeviceBase.h"
+#include "../SensorFilter.h"
 #include "../../SystemCore/NetMessage.h"
 #include "../../SystemCore/ComponentInterfaces/NetworkInterface.h"
 
@@ -46,6 +47,7 @@
 #define UDPDEVICE_MAX_AXIS 			64
 #define UDPDEVICE_MAX_BUTTONS		256
 #define UDPDEVICE_NETWORKCHANNEL	255
+#define UDPDEVICE_MAX_EXTRAPOLATION	0.25f
 
 /**
  * message protocol:
@@ -69,6 +71,9 @@ struct DEVICESTATE {
  * InputDevice for receiving input data via UDP messages over the network.
  * This class receives network messages with the message protocol defined by
  * the DEVICESTATE struct and decodes it into button, axis and sensor values.
+ * Optionally the sensor values can be passed through a SensorFilter, which
+ * gets every received state (not only the last one of a frame) and predicts
+ * the sensor pose for the configured time in the future.
  */
 class CONTROLLERMANAGER_API UdpDevice : public InputDeviceBase {
 public:
@@ -89,8 +94,27 @@ public:
 	 */
 	virtual void update();
 
+	/**
+	 * Sets the filter for the sensor with the passed index. The device takes
+	 * ownership of the filter, NULL disables the filtering of the sensor.
+	 */
+	void setSensorFilter(unsigned sensorIndex, SensorFilter* filter);
+
+	/**
+	 * Sets the time in seconds the filtered sensors are predicted into the
+	 * future, normally the latency between the update of the device and the
+	 * display of the frame. The prediction stops maxExtrapolationTime
+	 * seconds after the last received state.
+	 */
+	void setPredictionTime(float predictionTime, float maxExtrapolationTime = UDPDEVICE_MAX_EXTRAPOLATION);
+
 protected:
 
+	/**
+	 * Writes the predicted poses of all filtered sensors into the sensor state
+	 */
+	void updateFilteredSensors(double time);
+
 	/**
 	 * Decodes the device state from the passed NetMessage
 	 */
@@ -103,6 +127,10 @@ protected:
 
 	unsigned networkChannel;	// network channel on which the UDP-packets arrive (must match with sender)
 	NetworkInterface* netInt;	// pointer to the network module
+	SensorFilter* sensorFilters[UDPDEVICE_MAX_SENSORS];	// NULL for unfiltered sensors
+	float predictionTime;
+	float maxExtrapolationTime;
+	double lastUpdateTime;
 }; // UdpDevice
 
 /******************************************************************************
@@ -114,6 +142,15 @@ protected:
  *                   conflict with other network channels (like used by modules
  *                   = MODULE-ID or by main application = 0). The default value
  *                   for the networkChannel is 255
+ * sensorFilter ..... filter for all sensors, either "OneEuro" or "Kalman". By
+ *                   default the sensors are not filtered
+ * minCutoff, beta, derivativeCutoff .. parameters of the OneEuro filter
+ * positionProcessNoise, positionMeasurementNoise, orientationProcessNoise,
+ * orientationMeasurementNoise .. parameters of the Kalman filter
+ * predictionTime ... time in seconds the filtered sensors are predicted into
+ *                   the future (default 0)
+ * maxExtrapolationTime .. maximum time in seconds a sensor is extrapolated
+ *                   after its last sample (default 0.25)
  */
 class UdpDeviceFactory : public InputDeviceFactory {
 public:
@@ -126,6 +163,12 @@ public:
 	 * Creates a new UdpDevice if the className matches
 	 */
 	virtual InputDevice* create(std::string className, ArgumentVector* args = NULL);
+
+protected:
+	/**
+	 * Creates the sensor filter configured in the arguments
+	 */
+	SensorFilter* createSensorFilter(ArgumentVector* args);
 }; // UdpDeviceFactory
 
 
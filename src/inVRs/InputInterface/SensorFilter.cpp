@@ -0,0 +1,228 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+ \*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+
+#include "SensorFilter.h"
+
+#include <math.h>
+
+#include <gmtl/AxisAngle.h>
+#include <gmtl/Generate.h>
+#include <gmtl/QuatOps.h>
+#include <gmtl/VecOps.h>
+
+namespace {
+
+// initial variance of the velocity of the Kalman filter, the velocity is
+// unknown until the second sample arrives
+const float INITIAL_VELOCITY_VARIANCE = 1e4f;
+
+/**
+ * Returns the smoothing factor of an exponential filter with the passed
+ * cutoff frequency for a sample interval of dt.
+ */
+float getSmoothingFactor(float dt, float cutoff) {
+	float tau = 1.f / (2.f * (float)M_PI * cutoff);
+	return 1.f / (1.f + tau / dt);
+} // getSmoothingFactor
+
+} // namespace
+
+SensorFilter::SensorFilter() {
+	reset();
+} // SensorFilter
+
+SensorFilter::~SensorFilter() {
+
+} // ~SensorFilter
+
+void SensorFilter::reset() {
+	estimate = identitySensorData();
+	sampleTime = 0;
+	validSample = false;
+	velocity = gmtl::Vec3f(0, 0, 0);
+	angularVelocity = gmtl::Vec3f(0, 0, 0);
+} // reset
+
+bool SensorFilter::hasSample() const {
+	return validSample;
+} // hasSample
+
+double SensorFilter::getSampleTime() const {
+	return sampleTime;
+} // getSampleTime
+
+void SensorFilter::predict(double time, double maxExtrapolationTime, SensorData& dst) const {
+	if (!validSample)
+		return;
+
+	double dt = time - sampleTime;
+	if (dt > maxExtrapolationTime)
+		dt = maxExtrapolationTime;
+	if (dt < 0)
+		dt = 0;
+
+	dst.position = estimate.position + velocity * (float)dt;
+	dst.orientation = rotate(estimate.orientation, angularVelocity * (float)dt);
+} // predict
+
+gmtl::Vec3f SensorFilter::getRotationVector(const gmtl::Quatf& from, const gmtl::Quatf& to) {
+	gmtl::Quatf inverseFrom = from;
+	gmtl::Quatf delta = to * gmtl::invert(inverseFrom);
+	gmtl::Vec3f axis(delta[0], delta[1], delta[2]);
+	float w = delta[3];
+	float sinHalfAngle;
+
+	// use the shorter rotation
+	if (w < 0) {
+		axis = -axis;
+		w = -w;
+	} // if
+	if (w > 1)
+		w = 1;
+	sinHalfAngle = sqrtf(1 - w * w);
+	if (sinHalfAngle < 1e-6f)
+		return gmtl::Vec3f(0, 0, 0);
+	return axis * (2 * acosf(w) / sinHalfAngle);
+} // getRotationVector
+
+gmtl::Quatf SensorFilter::rotate(const gmtl::Quatf& orientation, const gmtl::Vec3f& rotation) {
+	gmtl::Quatf delta;
+	gmtl::Quatf result;
+	float angle = gmtl::length(rotation);
+
+	if (angle < 1e-6f)
+		return orientation;
+	gmtl::set(delta, gmtl::AxisAnglef(angle, rotation / angle));
+	result = delta * orientation;
+	gmtl::normalize(result);
+	return result;
+} // rotate
+
+OneEuroSensorFilter::OneEuroSensorFilter(float minCutoff, float beta, float derivativeCutoff) :
+	minCutoff(minCutoff),
+	beta(beta),
+	derivativeCutoff(derivativeCutoff) {
+
+} // OneEuroSensorFilter
+
+void OneEuroSensorFilter::addSample(const SensorData& sample, double time) {
+	if (!validSample) {
+		estimate = sample;
+		sampleTime = time;
+		validSample = true;
+		return;
+	} // if
+
+	float dt = (float)(time - sampleTime);
+	if (dt <= 0)
+		return;
+
+	// the velocity is smoothed with a fixed cutoff, its magnitude then raises
+	// the cutoff of the value
+	gmtl::Vec3f delta = sample.position - estimate.position;
+	velocity += (delta / dt - velocity) * getSmoothingFactor(dt, derivativeCutoff);
+	float cutoff = minCutoff + beta * gmtl::length(velocity);
+	estimate.position += delta * getSmoothingFactor(dt, cutoff);
+
+	// same for the orientation, the difference is the rotation from the
+	// estimate to the sample
+	gmtl::Vec3f rotation = getRotationVector(estimate.orientation, sample.orientation);
+	angularVelocity += (rotation / dt - angularVelocity) * getSmoothingFactor(dt, derivativeCutoff);
+	cutoff = minCutoff + beta * gmtl::length(angularVelocity);
+	estimate.orientation = rotate(estimate.orientation, rotation * getSmoothingFactor(dt, cutoff));
+
+	sampleTime = time;
+} // addSample
+
+void KalmanSensorFilter::Covariance::init(float measurementNoise) {
+	value = measurementNoise;
+	valueVelocity = 0;
+	velocity = INITIAL_VELOCITY_VARIANCE;
+} // init
+
+void KalmanSensorFilter::Covariance::predict(float dt, float processNoise) {
+	value += dt * (2 * valueVelocity + dt * velocity) + processNoise * dt * dt * dt / 3;
+	valueVelocity += dt * velocity + processNoise * dt * dt / 2;
+	velocity += processNoise * dt;
+} // predict
+
+void KalmanSensorFilter::Covariance::update(float measurementNoise, float& valueGain,
+		float& velocityGain) {
+	float innovationVariance = value + measurementNoise;
+	valueGain = value / innovationVariance;
+	velocityGain = valueVelocity / innovationVariance;
+	velocity -= velocityGain * valueVelocity;
+	value *= 1 - valueGain;
+	valueVelocity *= 1 - valueGain;
+} // update
+
+KalmanSensorFilter::KalmanSensorFilter(float positionProcessNoise, float positionMeasurementNoise,
+		float orientationProcessNoise, float orientationMeasurementNoise) :
+	positionProcessNoise(positionProcessNoise),
+	positionMeasurementNoise(positionMeasurementNoise),
+	orientationProcessNoise(orientationProcessNoise),
+	orientationMeasurementNoise(orientationMeasurementNoise) {
+	positionCovariance.init(positionMeasurementNoise);
+	orientationCovariance.init(orientationMeasurementNoise);
+} // KalmanSensorFilter
+
+void KalmanSensorFilter::addSample(const SensorData& sample, double time) {
+	float valueGain, velocityGain;
+
+	if (!validSample) {
+		estimate = sample;
+		sampleTime = time;
+		validSample = true;
+		positionCovariance.init(positionMeasurementNoise);
+		orientationCovariance.init(orientationMeasurementNoise);
+		return;
+	} // if
+
+	float dt = (float)(time - sampleTime);
+	if (dt <= 0)
+		return;
+
+	// predict the state at the time of the sample
+	estimate.position += velocity * dt;
+	estimate.orientation = rotate(estimate.orientation, angularVelocity * dt);
+	positionCovariance.predict(dt, positionProcessNoise);
+	orientationCovariance.predict(dt, orientationProcessNoise);
+
+	// correct it with the difference to the measurement
+	gmtl::Vec3f residual = sample.position - estimate.position;
+	positionCovariance.update(positionMeasurementNoise, valueGain, velocityGain);
+	estimate.position += residual * valueGain;
+	velocity += residual * velocityGain;
+
+	residual = getRotationVector(estimate.orientation, sample.orientation);
+	orientationCovariance.update(orientationMeasurementNoise, valueGain, velocityGain);
+	estimate.orientation = rotate(estimate.orientation, residual * valueGain);
+	angularVelocity += residual * velocityGain;
+
+	sampleTime = time;
+} // addSample
@@ -0,0 +1,176 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+ \*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                Changes                                    *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+\*---------------------------------------------------------------------------*/
+
+
+#ifndef _SENSORFILTER_H
+#define _SENSORFILTER_H
+
+#include "InputInterfaceSharedLibraryExports.h"
+#include "../SystemCore/DataTypes.h"
+
+/******************************************************************************
+ * Filters the samples of a tracking sensor and predicts its pose. Input
+ * devices pass every received sample with its time, the filter smoothes the
+ * jitter and estimates the velocities, which are used to extrapolate the pose
+ * to the time when it will be displayed. This hides part of the tracking
+ * latency without raising the tracker rate.
+ */
+class INVRS_INPUTINTERFACE_API SensorFilter {
+public:
+	SensorFilter();
+	virtual ~SensorFilter();
+
+	/**
+	 * Removes all samples.
+	 */
+	virtual void reset();
+
+	/**
+	 * Adds a sample measured at the passed time (timebase of
+	 * Timer::getMonotonicTime()). Samples which are not newer than the
+	 * previous one are ignored.
+	 */
+	virtual void addSample(const SensorData& sample, double time) = 0;
+
+	/**
+	 * Returns true if at least one sample was added.
+	 */
+	bool hasSample() const;
+
+	/**
+	 * Returns the time of the last sample.
+	 */
+	double getSampleTime() const;
+
+	/**
+	 * Writes the filtered pose extrapolated to the passed time into dst. The
+	 * extrapolation stops maxExtrapolationTime seconds after the last sample,
+	 * so a lost tracker does not send the sensor to infinity.
+	 */
+	void predict(double time, double maxExtrapolationTime, SensorData& dst) const;
+
+protected:
+	/**
+	 * Returns the rotation from -> to as axis scaled by the angle (in radians).
+	 */
+	static gmtl::Vec3f getRotationVector(const gmtl::Quatf& from, const gmtl::Quatf& to);
+
+	/**
+	 * Returns the orientation rotated by the passed rotation vector.
+	 */
+	static gmtl::Quatf rotate(const gmtl::Quatf& orientation, const gmtl::Vec3f& rotation);
+
+	SensorData estimate;
+	double sampleTime;
+	bool validSample;
+	gmtl::Vec3f velocity;
+	gmtl::Vec3f angularVelocity; // rotation axis scaled by radians per second
+}; // SensorFilter
+
+/******************************************************************************
+ * One Euro filter (Casiez et al., CHI 2012). An exponential smoothing filter
+ * whose cutoff frequency rises with the speed of the sensor: slow movements
+ * are smoothed strongly to remove jitter, fast movements only a little to
+ * keep the lag small. Position and orientation are filtered separately. The
+ * default parameters suit a tracker measuring in meters.
+ */
+class INVRS_INPUTINTERFACE_API OneEuroSensorFilter : public SensorFilter {
+public:
+	/**
+	 * @param minCutoff cutoff frequency (Hz) at rest, lower values remove more jitter
+	 * @param beta increase of the cutoff frequency per unit (or radian) per
+	 * second, higher values reduce the lag of fast movements
+	 * @param derivativeCutoff cutoff frequency (Hz) of the velocity estimation
+	 */
+	OneEuroSensorFilter(float minCutoff = 1.0f, float beta = 20.0f, float derivativeCutoff = 5.0f);
+
+	virtual void addSample(const SensorData& sample, double time);
+
+protected:
+	float minCutoff;
+	float beta;
+	float derivativeCutoff;
+}; // OneEuroSensorFilter
+
+/******************************************************************************
+ * Kalman filter with a constant velocity model. Position and orientation each
+ * have a state of value and velocity per axis, the motion between two samples
+ * is modelled as random acceleration. Unlike the One Euro filter the velocity
+ * is part of the state, so constant movements are followed without lag.
+ */
+class INVRS_INPUTINTERFACE_API KalmanSensorFilter : public SensorFilter {
+public:
+	/**
+	 * @param positionProcessNoise spectral density of the random acceleration
+	 * (units^2/s^3), higher values follow changes of the velocity faster
+	 * @param positionMeasurementNoise variance of the measured position (units^2)
+	 * @param orientationProcessNoise same as positionProcessNoise for the
+	 * orientation (radians^2/s^3)
+	 * @param orientationMeasurementNoise variance of the measured orientation
+	 * (radians^2)
+	 */
+	KalmanSensorFilter(float positionProcessNoise = 3.f, float positionMeasurementNoise = 1e-4f,
+			float orientationProcessNoise = 3.f, float orientationMeasurementNoise = 1e-4f);
+
+	virtual void addSample(const SensorData& sample, double time);
+
+protected:
+	/**
+	 * Covariance of the state (value, velocity) of one axis. All axes share
+	 * the same covariance since they are updated with the same noise.
+	 */
+	struct Covariance {
+		float value;
+		float valueVelocity;
+		float velocity;
+
+		void init(float measurementNoise);
+		void predict(float dt, float processNoise);
+		/**
+		 * Updates the covariance with a measurement and returns the gains for
+		 * the value and the velocity.
+		 */
+		void update(float measurementNoise, float& valueGain, float& velocityGain);
+	};
+
+	float positionProcessNoise;
+	float positionMeasurementNoise;
+	float orientationProcessNoise;
+	float orientationMeasurementNoise;
+	Covariance positionCovariance;
+	Covariance orientationCovariance;
+}; // KalmanSensorFilter
+
+#endif // _SENSORFILTER_H
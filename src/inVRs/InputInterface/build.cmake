@@ -2,7 +2,8 @@ set (INPUTINTERFACE_SOURCE_DIR ${INVRS_SOURCE_DIR}/src/inVRs/InputInterface)
 
 set (INPUTINTERFACE_SRCS
 	${INVRS_SOURCE_DIR}/src/inVRs/InputInterface/ControllerInterface.cpp
-	${INVRS_SOURCE_DIR}/src/inVRs/InputInterface/InputInterface.cpp)
+	${INVRS_SOURCE_DIR}/src/inVRs/InputInterface/InputInterface.cpp
+	${INVRS_SOURCE_DIR}/src/inVRs/InputInterface/SensorFilter.cpp)
 
 set (INPUTINTERFACE_TARGET_INCLUDE_DIR ${INVRS_TARGET_INCLUDE_DIR}/inVRs/InputInterface)
 
@@ -15,4 +16,5 @@ install (FILES
 		${INPUTINTERFACE_SOURCE_DIR}/ControllerManagerInterface.h
 		${INPUTINTERFACE_SOURCE_DIR}/InputInterface.h
 		${INPUTINTERFACE_SOURCE_DIR}/InputInterfaceSharedLibraryExports.h
+		${INPUTINTERFACE_SOURCE_DIR}/SensorFilter.h
 	DESTINATION ${INPUTINTERFACE_TARGET_INCLUDE_DIR})
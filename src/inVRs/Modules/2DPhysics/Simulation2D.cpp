@@ -119,11 +119,13 @@ void Simulation2D::cleanup()
 			delete objects[i];
 	} // for
 	objects.clear();
+	broadphase.invalidate();
 } // cleanup ~Simulation2D
 
 void Simulation2D::addObject(RigidBody* obj)
 {
 	objects.push_back(obj);
+	broadphase.invalidate();
 //	Vec2f p = Vec2f(obj->x[0], obj->x[2]);
 } // addCollCircle
 
@@ -137,6 +139,7 @@ void Simulation2D::removeObject(RigidBody* obj)
 			objects.erase(objects.begin()+i);
 		}
 	}
+	broadphase.invalidate();
 }
 
 RigidBody* Simulation2D::getObject(unsigned id)
@@ -153,7 +156,8 @@ void Simulation2D::setCollisionMap(CollisionMap* collMap)
 
 bool Simulation2D::checkCollision()
 {
-	int i,j, k;
+	int i, k;
+	unsigned p;
 	RigidBody *obj1, *obj2;
 	std::vector<CollisionData*> collisionList;
 	Contact *ct;
@@ -165,14 +169,19 @@ bool Simulation2D::checkCollision()
 
 // TODO: write RigidBody-Transformation to shape!!!
 
+	// only pairs with overlapping bounds are tested, the pairs are sorted so
+	// that the contacts are found in the order of the objects
+	broadphase.findPairs(objects, pairs);
+	p = 0;
+
 	for (i=0; i < (int)objects.size(); i++)
 	{
 		obj1 = objects[i];
 		assert(obj1);
 		isFixed1 = obj1->isFixed();
-		for (j=i+1; j < (int)objects.size(); j++)
+		for (; p < pairs.size() && pairs[p].first == (unsigned)i; p++)
 		{
-			obj2 = objects[j];
+			obj2 = objects[pairs[p].second];
 			assert(obj2);
 			isFixed2 = obj2->isFixed();
 			if (isFixed1 && isFixed2)
@@ -46,6 +46,7 @@
 #include "2DPhysicsSharedLibraryExports.h"
 #include <inVRs/SystemCore/ComponentInterfaces/ModuleInterface.h>
 #include "CollisionMap/CollisionMap.h"
+#include "SweepAndPrune2D.h"
 
 struct CollisionData;
 class TransformationPipe;
@@ -73,6 +74,8 @@ private:
 	std::map<RigidBody*, TransformationPipe*> transformationPipes;
 	gmtl::Vec3f up;
 	gmtl::Vec3f gravity;
+	SweepAndPrune2D broadphase;
+	std::vector<SweepAndPrune2D::Pair> pairs;
 
 	void collisionResponse(Contact* ct);
 	CollisionMap* collMap;
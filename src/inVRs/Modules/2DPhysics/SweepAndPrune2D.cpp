@@ -0,0 +1,134 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+#include "SweepAndPrune2D.h"
+
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+#include "RigidBody.h"
+
+namespace {
+
+// the bounds are enlarged slightly, so that rounding never prunes a pair which
+// Simulation2D::couldCollide() would accept
+const float BOUNDS_TOLERANCE = 1e-5f;
+
+struct EntryMinXCompare
+{
+	template<typename T> bool operator()(const T& a, const T& b) const
+	{
+		return a.minX < b.minX;
+	}
+}; // EntryMinXCompare
+
+} // namespace
+
+SweepAndPrune2D::SweepAndPrune2D()
+{
+	valid = false;
+	numberOfSwaps = 0;
+} // SweepAndPrune2D
+
+void SweepAndPrune2D::invalidate()
+{
+	valid = false;
+} // invalidate
+
+void SweepAndPrune2D::findPairs(std::vector<RigidBody*>& objects, std::vector<Pair>& pairs)
+{
+	unsigned i, j;
+	Entry entry;
+
+	pairs.clear();
+	numberOfSwaps = 0;
+
+	if (!valid || entries.size() != objects.size())
+	{
+		entries.resize(objects.size());
+		for (i = 0; i < entries.size(); i++)
+		{
+			entries[i].index = i;
+			updateBounds(entries[i], objects[i]);
+		} // for
+		std::sort(entries.begin(), entries.end(), EntryMinXCompare());
+		valid = true;
+	} // if
+	else
+	{
+		// insertion sort, the objects move only a little between two steps
+		for (i = 0; i < entries.size(); i++)
+		{
+			updateBounds(entries[i], objects[entries[i].index]);
+			entry = entries[i];
+			for (j = i; j > 0 && entries[j-1].minX > entry.minX; j--)
+				entries[j] = entries[j-1];
+			entries[j] = entry;
+			numberOfSwaps += i - j;
+		} // for
+	} // else
+
+	for (i = 0; i < entries.size(); i++)
+	{
+		const Entry& entry1 = entries[i];
+		for (j = i+1; j < entries.size() && entries[j].minX <= entry1.maxX; j++)
+		{
+			const Entry& entry2 = entries[j];
+			if (entry2.minZ > entry1.maxZ || entry1.minZ > entry2.maxZ)
+				continue;
+			if (entry1.index < entry2.index)
+				pairs.push_back(Pair(entry1.index, entry2.index));
+			else
+				pairs.push_back(Pair(entry2.index, entry1.index));
+		} // for
+	} // for
+	std::sort(pairs.begin(), pairs.end());
+} // findPairs
+
+unsigned SweepAndPrune2D::getNumberOfSwaps()
+{
+	return numberOfSwaps;
+} // getNumberOfSwaps
+
+void SweepAndPrune2D::updateBounds(Entry& entry, RigidBody* object)
+{
+	float radius = object->getBoundingCircleRadius();
+	gmtl::Vec2f position = object->get2DPos();
+
+	if (radius < 0)
+	{
+		entry.minX = entry.minZ = -FLT_MAX;
+		entry.maxX = entry.maxZ = FLT_MAX;
+		return;
+	} // if
+
+	radius += BOUNDS_TOLERANCE * (radius + fabsf(position[0]) + fabsf(position[1]));
+	entry.minX = position[0] - radius;
+	entry.maxX = position[0] + radius;
+	entry.minZ = position[1] - radius;
+	entry.maxZ = position[1] + radius;
+} // updateBounds
@@ -0,0 +1,91 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                Changes                                    *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+\*---------------------------------------------------------------------------*/
+
+#ifndef _SWEEPANDPRUNE2D_H_
+#define _SWEEPANDPRUNE2D_H_
+
+#include <utility>
+#include <vector>
+#include "2DPhysicsSharedLibraryExports.h"
+
+class RigidBody;
+
+/******************************************************************************
+ * Broadphase of the Simulation2D. The bounding circles of the objects are
+ * projected on the x-axis of the world and kept sorted between two steps, so
+ * that the sort only has to move the objects which passed each other since
+ * the last step. Only objects whose bounding boxes overlap in x and z are
+ * reported as pair. Objects without bounding circle (radius < 0) are reported
+ * together with all other objects.
+ */
+class INVRS_2DPHYSICS_API SweepAndPrune2D
+{
+public:
+	typedef std::pair<unsigned, unsigned> Pair;
+
+	SweepAndPrune2D();
+
+	/** Rebuilds the sorted list in the next call of findPairs, has to be
+	 * called when objects are added to or removed from the object list.
+	 */
+	void invalidate();
+
+	/** Updates the bounds of all objects and returns the index pairs of the
+	 * objects with overlapping bounds. The first index of a pair is smaller
+	 * than the second one and the pairs are sorted.
+	 * @param objects objects of the simulation
+	 * @param pairs list which is cleared and filled with the pairs
+	 */
+	void findPairs(std::vector<RigidBody*>& objects, std::vector<Pair>& pairs);
+
+	/** Returns the number of swaps of the sort in the last call of findPairs.
+	 */
+	unsigned getNumberOfSwaps();
+
+private:
+	struct Entry
+	{
+		float minX, maxX, minZ, maxZ;
+		unsigned index;
+	}; // Entry
+
+	void updateBounds(Entry& entry, RigidBody* object);
+
+	std::vector<Entry> entries;
+	bool valid;
+	unsigned numberOfSwaps;
+}; // SweepAndPrune2D
+
+#endif // _SWEEPANDPRUNE2D_H_
@@ -0,0 +1,117 @@
+#include <inVRs/Modules/2DPhysics/RigidBody.h>
+#include <inVRs/Modules/2DPhysics/SweepAndPrune2D.h>
+
+#include <inVRs/SystemCore/Timer.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static const unsigned MEASURED_STEPS = 50;
+static const float RADIUS = 0.5f;
+// area per body in square units, roughly a dense crowd
+static const float AREA_PER_BODY = 4.f;
+static const float MAX_SPEED = 0.05f;
+
+// same test as Simulation2D::couldCollide()
+static bool couldCollide(RigidBody* obj1, RigidBody* obj2) {
+	float radius1 = obj1->getBoundingCircleRadius();
+	float radius2 = obj2->getBoundingCircleRadius();
+	if (radius1 < 0 || radius2 < 0)
+		return true;
+	gmtl::Vec2f distance = obj1->get2DPos() - obj2->get2DPos();
+	return gmtl::length(distance) <= radius1 + radius2;
+}
+
+static float random(float min, float max) {
+	return min + (max - min) * (rand() / (float)RAND_MAX);
+}
+
+/** Headless benchmark for the broadphase of the Simulation2D. A crowd of
+ * bodies walks randomly in a square, every step the pairs which could collide
+ * are searched with the nested loop over all pairs (as done before) and with
+ * the SweepAndPrune2D. Reports the pair tests per step and the time of both
+ * methods and checks that both find the same pairs.
+ */
+int main() {
+	static const unsigned bodyCounts[] = {100, 500, 1000, 2000, 5000};
+	bool identical = true;
+
+	printf("%6s %16s %16s %14s %14s %8s %10s\n", "bodies", "loop tests/step",
+			"SAP tests/step", "loop [ms]", "SAP [ms]", "swaps", "identical");
+
+	for (unsigned c = 0; c < sizeof(bodyCounts) / sizeof(bodyCounts[0]); c++) {
+		unsigned numBodies = bodyCounts[c];
+		float size = sqrtf(numBodies * AREA_PER_BODY);
+		std::vector<RigidBody*> objects;
+		std::vector<gmtl::Vec3f> velocities;
+		std::vector<SweepAndPrune2D::Pair> pairs, loopPairs, sapPairs;
+		SweepAndPrune2D broadphase;
+		double loopTime = 0, sapTime = 0, start;
+		unsigned long loopTests = 0, sapTests = 0, swaps = 0;
+		unsigned i, j, step;
+
+		srand(1);
+		for (i = 0; i < numBodies; i++) {
+			RigidBody* body = new RigidBody;
+			body->setPos(gmtl::Vec3f(random(0, size), 0, random(0, size)));
+			body->setBoundingCircleRadius(RADIUS);
+			objects.push_back(body);
+			velocities.push_back(gmtl::Vec3f(random(-MAX_SPEED, MAX_SPEED), 0,
+					random(-MAX_SPEED, MAX_SPEED)));
+		} // for
+		// first call builds the sorted list
+		broadphase.findPairs(objects, pairs);
+
+		for (step = 0; step < MEASURED_STEPS; step++) {
+			for (i = 0; i < numBodies; i++) {
+				gmtl::Vec3f pos = objects[i]->getPos() + velocities[i];
+				if (pos[0] < 0 || pos[0] > size)
+					velocities[i][0] = -velocities[i][0];
+				if (pos[2] < 0 || pos[2] > size)
+					velocities[i][2] = -velocities[i][2];
+				objects[i]->setPos(pos);
+			} // for
+
+			loopPairs.clear();
+			start = inVRsUtilities::Timer::getMonotonicTime();
+			for (i = 0; i < numBodies; i++) {
+				for (j = i + 1; j < numBodies; j++) {
+					if (couldCollide(objects[i], objects[j]))
+						loopPairs.push_back(SweepAndPrune2D::Pair(i, j));
+				} // for
+			} // for
+			loopTime += inVRsUtilities::Timer::getMonotonicTime() - start;
+			loopTests += numBodies * (numBodies - 1) / 2;
+
+			sapPairs.clear();
+			start = inVRsUtilities::Timer::getMonotonicTime();
+			broadphase.findPairs(objects, pairs);
+			for (i = 0; i < pairs.size(); i++) {
+				if (couldCollide(objects[pairs[i].first], objects[pairs[i].second]))
+					sapPairs.push_back(pairs[i]);
+			} // for
+			sapTime += inVRsUtilities::Timer::getMonotonicTime() - start;
+			sapTests += pairs.size();
+			swaps += broadphase.getNumberOfSwaps();
+
+			if (sapPairs != loopPairs)
+				identical = false;
+		} // for
+
+		printf("%6u %16.0f %16.1f %14.3f %14.3f %8.1f %10s\n", numBodies,
+				(double)loopTests / MEASURED_STEPS, (double)sapTests / MEASURED_STEPS,
+				loopTime * 1e3 / MEASURED_STEPS, sapTime * 1e3 / MEASURED_STEPS,
+				(double)swaps / MEASURED_STEPS, identical ? "yes" : "NO");
+
+		for (i = 0; i < numBodies; i++)
+			delete objects[i];
+	} // for
+
+	if (!identical) {
+		printf("ERROR: broadphase missed pairs of the nested loop!\n");
+		return 1;
+	} // if
+	return 0;
+}
@@ -42,6 +42,8 @@ SynchronisationModel* AccelerationSynchronisationModelFactory::create(std::strin
 	float angularThreshold = 0;
 	float convergenceTime = -1;
 	int convergenceAlgorithm = -1;
+	int keyframeInterval = 0;
+	AccelerationSynchronisationModel* result;
 	
 	ArgumentVector* arguments = (ArgumentVector*)args;
 	
@@ -61,9 +63,21 @@ SynchronisationModel* AccelerationSynchronisationModelFactory::create(std::strin
 	if (arguments->keyExists("convergenceTime"))
 		arguments->get("convergenceTime", convergenceTime);
 	
+	if (arguments->keyExists("keyframeInterval"))
+		arguments->get("keyframeInterval", keyframeInterval);
+
 	if (convergenceAlgorithm < 0)
-		return new AccelerationSynchronisationModel(linearThreshold, angularThreshold);
-	if (convergenceTime < 0)
-		return new AccelerationSynchronisationModel(linearThreshold, angularThreshold, convergenceAlgorithm);
-	return new AccelerationSynchronisationModel(linearThreshold, angularThreshold, convergenceAlgorithm, convergenceTime);
+		result = new AccelerationSynchronisationModel(linearThreshold, angularThreshold);
+	else if (convergenceTime < 0)
+		result = new AccelerationSynchronisationModel(linearThreshold, angularThreshold, convergenceAlgorithm);
+	else
+		result = new AccelerationSynchronisationModel(linearThreshold, angularThreshold, convergenceAlgorithm, convergenceTime);
+
+	if (keyframeInterval < 0) {
+		printd(ERROR, "AccelerationSynchronisationModelFactory::create(): invalid keyframeInterval %i found (must not be negative)!\n", keyframeInterval);
+		keyframeInterval = 0;
+	} // if
+	result->setKeyframeInterval(keyframeInterval);
+
+	return result;
 } // create
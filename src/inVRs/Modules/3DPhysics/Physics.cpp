@@ -56,11 +56,13 @@
 
 #include <inVRs/SystemCore/Configuration.h>
 #include <inVRs/SystemCore/XMLTools.h>
+#include <inVRs/SystemCore/WorkerPool.h>
 #include <inVRs/SystemCore/UserDatabase/UserDatabase.h>
 #include <inVRs/SystemCore/WorldDatabase/WorldDatabase.h>
 #include <inVRs/SystemCore/TransformationManager/TransformationManager.h>
 #include <inVRs/SystemCore/SystemCore.h>
 #include <inVRs/SystemCore/Timer.h>
+#include <inVRs/SystemCore/Profiler.h>
 #include <inVRs/SystemCore/UtilityFunctions.h>
 #include <inVRs/SystemCore/ComponentInterfaces/module_core_api.h>
 
@@ -130,10 +132,12 @@ Physics::Physics()
 	simulationStepLock = ThreadManager::the()->getLock("Physics::simulationStepLock",false);
 	simulationStepListenerLock = ThreadManager::the()->getLock("Physics::simulationStepListenerLock",false);
 	systemThreadListenerLock = ThreadManager::the()->getLock("Physics::systemThreadListenerLock",false);
+	connectedUserLock = ThreadManager::the()->getLock("Physics::connectedUserLock",false);
 #else
 	simulationStepLock = dynamic_cast<Lock*>(ThreadManager::the()->getLock("Physics::simulationStepLock"));
 	simulationStepListenerLock = dynamic_cast<Lock*>(ThreadManager::the()->getLock("Physics::simulationStepListenerLock"));
 	systemThreadListenerLock = dynamic_cast<Lock*>(ThreadManager::the()->getLock("Physics::systemThreadListenerLock"));
+	connectedUserLock = dynamic_cast<Lock*>(ThreadManager::the()->getLock("Physics::connectedUserLock"));
 #endif
 
 	if (!singleton)
@@ -208,6 +212,12 @@ bool Physics::loadConfig(std::string configFile)
 
 	bool success = true;
 
+	// cooked triangle meshes are stored in this directory and mapped on later runs
+	if (Configuration::containsPath("PhysicsMeshCache")) {
+		xmlLoader->getTriangleMeshCache()->setDiskCacheDirectory(
+				Configuration::getPath("PhysicsMeshCache"));
+	} // if
+
 	const XmlElement* simulationElement = document->getElement("physics.simulation");
 	const XmlElement* objectManagerElement = document->getElement("physics.objectManager");
 	const XmlElement* synchronisationModelElement = document->getElement("physics.synchronisationModel");
@@ -263,6 +273,59 @@ bool Physics::loadConfig(std::string configFile)
 		} // else
 	} // if
 
+	const XmlElement* spaceElement = simulationElement->getSubElement("space");
+	if (spaceElement) {
+		std::string spaceType = spaceElement->getAttributeValue("type");
+		if (spaceType == "QUADTREE") {
+			gmtl::Vec3f center(0, 0, 0);
+			gmtl::Vec3f extents(1000, 1000, 1000);
+			int depth = 6;
+			const XmlElement* centerElement = spaceElement->getSubElement("center");
+			const XmlElement* extentsElement = spaceElement->getSubElement("extents");
+			if (centerElement) {
+				center[0] = centerElement->getAttributeValueAsFloat("x");
+				center[1] = centerElement->getAttributeValueAsFloat("y");
+				center[2] = centerElement->getAttributeValueAsFloat("z");
+			} // if
+			if (extentsElement) {
+				extents[0] = extentsElement->getAttributeValueAsFloat("x");
+				extents[1] = extentsElement->getAttributeValueAsFloat("y");
+				extents[2] = extentsElement->getAttributeValueAsFloat("z");
+			} // if
+			if (spaceElement->hasAttribute("depth"))
+				depth = spaceElement->getAttributeValueAsInt("depth");
+			if (simulation->setSpaceType(Simulation::SPACETYPE_QUADTREE, center, extents, depth))
+				printd(INFO, "Physics::loadConfig(): using QUADTREE space with depth %i!\n", depth);
+		} // if
+		else if (spaceType != "HASH") {
+			printd(WARNING, "Physics::loadConfig(): unknown space type %s found! Using HASH space!\n", spaceType.c_str());
+		} // else if
+	} // if
+
+	const XmlElement* islandThreadsElement = simulationElement->getSubElement("islandThreads");
+	if (islandThreadsElement) {
+		unsigned numberOfThreads = WorkerPool::getDefaultNumberOfThreads();
+		if (islandThreadsElement->hasAttribute("number"))
+			numberOfThreads = islandThreadsElement->getAttributeValueAsInt("number");
+		simulation->setNumberOfThreads(numberOfThreads);
+		printd(INFO, "Physics::loadConfig(): stepping the islands with %u additional threads!\n", numberOfThreads);
+		if (numberOfThreads > 0 && (stepFunction == "QUICKSTEP" || stepFunction == "STEPFAST1"))
+			printd(WARNING, "Physics::loadConfig(): islands are only stepped in parallel by stepFunction STEP!\n");
+	} // if
+
+	// cooking options of the triangle meshes, e.g.
+	// <triangleMesh weldTolerance="0.001" recomputeNormals="true"/>
+	const XmlElement* triangleMeshElement = simulationElement->getSubElement("triangleMesh");
+	if (triangleMeshElement) {
+		TriangleMeshCache* meshCache = xmlLoader->getTriangleMeshCache();
+		if (triangleMeshElement->hasAttribute("weldTolerance"))
+			meshCache->setWeldTolerance(triangleMeshElement->getAttributeValueAsFloat("weldTolerance"));
+		if (triangleMeshElement->hasAttribute("recomputeNormals"))
+			meshCache->setRecomputeNormals(triangleMeshElement->getAttributeValueAsBool("recomputeNormals"));
+		printd(INFO, "Physics::loadConfig(): cooking triangle meshes with weld tolerance %f!\n",
+				meshCache->getWeldTolerance());
+	} // if
+
 	// handle <objectManager> element
 	std::string className = objectManagerElement->getAttributeValue("type");
 	ArgumentVector* arguments;
@@ -718,13 +781,22 @@ bool Physics::removeSimulationStepListener(SimulationStepListenerInterface* list
 void Physics::update(float dt)
 {
 	int i;
+	User* user;
 
-// 	connectedUserLock->aquire();
-// 		connectedUsers.clear();
-// 		connectedUsers.push_back(UserDatabase::getLocalUserId());
-// 		for (i=0; i < (int)UserDatabase::getNumberOfRemoteUsers(); i++)
-// 			connectedUsers.push_back(UserDatabase::getRemoteUserByIndex(i)->getId());
-// 	connectedUserLock->release();
+	// the UserDatabase is changed by the main thread without lock, the
+	// physics thread only gets the copy of the user IDs
+#if OSG_MAJOR_VERSION >= 2
+	connectedUserLock->acquire();
+#else
+	connectedUserLock->aquire();
+#endif
+		connectedUsers.clear();
+		for (i=0; i < (int)UserDatabase::getNumberOfRemoteUsers(); i++) {
+			user = UserDatabase::getRemoteUserByIndex(i);
+			if (user)
+				connectedUsers.push_back(user->getId());
+		} // for
+	connectedUserLock->release();
 
 #if OSG_MAJOR_VERSION >= 2
 	systemThreadListenerLock->acquire();
@@ -739,6 +811,17 @@ void Physics::update(float dt)
 	systemThreadListenerLock->release();
 } // update
 
+void Physics::getConnectedUsers(std::vector<unsigned>& dst)
+{
+#if OSG_MAJOR_VERSION >= 2
+	connectedUserLock->acquire();
+#else
+	connectedUserLock->aquire();
+#endif
+		dst = connectedUsers;
+	connectedUserLock->release();
+} // getConnectedUsers
+
 Simulation* Physics::getSimulation()
 {
 	return simulation;
@@ -946,6 +1029,8 @@ void Physics::run(void* args)
 	bool slept = false;
 	float sleepCount = 0;
 
+	inVRsUtilities::Profiler::setThreadName("physics");
+
 	if (waitForEvent) {
 		while (startTime == 0) {
 			usleep(500000);
@@ -1015,6 +1100,7 @@ void Physics::run(void* args)
 		stepsPerFrame = 0;
 		while (timeToNextStep <= 0)
 		{
+			inVRsUtilities::Profiler::markFrame();
 			singleton->step();
 			timeToNextStep += singleton->stepSize;
 			fpsCounter++;
@@ -1028,20 +1114,32 @@ void Physics::run(void* args)
 
 void Physics::step()
 {
+	INVRS_PROFILE_ZONE("Physics::step");
 #if OSG_MAJOR_VERSION >= 2
 	simulationStepLock->acquire();
 #else
 	simulationStepLock->aquire();
 #endif
 		handleEvents();
-		synchronisationModel->handleMessages();
-		objectManager->step(stepSize);
+		{
+			INVRS_PROFILE_ZONE("SynchronisationModel::handleMessages");
+			synchronisationModel->handleMessages();
+		}
+		{
+			INVRS_PROFILE_ZONE("PhysicsObjectManager::step");
+			objectManager->step(stepSize);
+		}
 		handleSimulationStepListener(stepSize);
 		synchronisationModel->synchroniseBeforeStep();
-		if (objectManager->isServer() || synchronisationModel->needPhysicsCalculation())
+		if (objectManager->isServer() || synchronisationModel->needPhysicsCalculation()) {
+			INVRS_PROFILE_ZONE("Simulation::step");
 			simulation->step(stepSize);
+		} // if
 		simulationTime++;
-		synchronisationModel->synchroniseAfterStep();
+		{
+			INVRS_PROFILE_ZONE("SynchronisationModel::synchroniseAfterStep");
+			synchronisationModel->synchroniseAfterStep();
+		}
 	simulationStepLock->release();
 } // step
 
@@ -370,6 +370,13 @@ protected:
 	 */
 	void setSynchronisationModel(std::string modelName, ArgumentVector* args);
 
+	/** Copies the IDs of all connected remote Users into the passed vector.
+	 * The IDs are updated by the update method in the main thread, so the
+	 * physics thread can use them without accessing the UserDatabase.
+	 * @param dst vector where the userIds are stored in
+	 */
+	void getConnectedUsers(std::vector<unsigned>& dst);
+
 //*********************//
 // PROTECTED MEMBERS: *//
 //*********************//
@@ -395,6 +402,8 @@ protected:
 	OSG::LockRefPtr systemThreadListenerLock;
 	/// Lock for simulationStepListener-list
 	OSG::LockRefPtr simulationStepListenerLock;
+	/// Lock for updating the connected Users
+	OSG::LockRefPtr connectedUserLock;
 #else
 	/// Lock for simulation step so that no PhysicsObject can be removed
 	OSG::Lock* simulationStepLock;
@@ -402,6 +411,8 @@ protected:
 	OSG::Lock* systemThreadListenerLock;
 	/// Lock for simulationStepListener-list
 	OSG::Lock* simulationStepListenerLock;
+	/// Lock for updating the connected Users
+	OSG::Lock* connectedUserLock;
 #endif
 	/// Simulation instance running the underlying simulation
 	oops::Simulation* simulation;
@@ -449,10 +460,8 @@ protected:
 	/// Model which handles synchronisation between servers and clients
 	SynchronisationModel* synchronisationModel;
 
-//	/// Lock for updating the connected Users
-// 	OSG::Lock* connectedUserLock;
-	/// list with the IDs of all directly (network link) connected Users
-//	std::vector<unsigned> connectedUsers;
+	/// list with the IDs of all remote Users, guarded by connectedUserLock
+	std::vector<unsigned> connectedUsers;
 	/// map with the relevant data for each user
 //	std::map<unsigned, UserData*> userDataMap;
 
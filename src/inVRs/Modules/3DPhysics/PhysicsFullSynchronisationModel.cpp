@@ -27,9 +27,11 @@
 
 #include "PhysicsFullSynchronisationModel.h"
 
+#include <gmtl/AxisAngle.h>
 #include <gmtl/Generate.h>
 
 #include "MessageSizeCounter.h"
+#include "PhysicsSnapshotCodec.h"
 
 #include "Physics.h"
 #include "PhysicsObjectManager.h"
@@ -37,8 +39,13 @@
 #include "PhysicsMessageFunctions.h"
 
 //#include <inVRs/SystemCore/SystemCore.h>
+#include <inVRs/SystemCore/UserDatabase/UserDatabase.h>
+#include <inVRs/SystemCore/NetworkTime.h>
+#include <inVRs/SystemCore/Timer.h>
 
 const unsigned PhysicsFullSynchronisationModel::PHYSICSFULLSYNCHRONISATION_MESSAGEID = 5;
+const unsigned PhysicsFullSynchronisationModel::PHYSICSFULLSYNCHRONISATION_DELTA_MESSAGEID = 7;
+const float PhysicsFullSynchronisationModel::MAX_LATENCY_COMPENSATION = 0.5f;
 
 using namespace oops;
 
@@ -54,6 +61,10 @@ PhysicsFullSynchronisationModel::PhysicsFullSynchronisationModel(unsigned update
 	this->convergenceTime = convergenceTime;
 	simulationStepSize = 0;
 	stepsUntilUpdate = updateInterval;
+	linearThreshold = -1;
+	angularThreshold = -1;
+	keyframeInterval = 0;
+	snapshotCodec = NULL;
 	counter = new MessageSizeCounter(physics);
 	counter->setLogFileName("PhysicsFullSyncModel.log");
 } // PhysicsFullSynchronisationModel
@@ -61,8 +72,28 @@ PhysicsFullSynchronisationModel::PhysicsFullSynchronisationModel(unsigned update
 PhysicsFullSynchronisationModel::~PhysicsFullSynchronisationModel() {
 	counter->dumpResults();
 	delete counter;
+	if (snapshotCodec)
+		delete snapshotCodec;
 } // ~PhysicsFullSynchronisationModel
 
+void PhysicsFullSynchronisationModel::setSendThresholds(float linearThreshold,
+		float angularThreshold) {
+	this->linearThreshold = linearThreshold;
+	this->angularThreshold = angularThreshold;
+} // setSendThresholds
+
+void PhysicsFullSynchronisationModel::setKeyframeInterval(unsigned keyframeInterval) {
+	this->keyframeInterval = keyframeInterval;
+} // setKeyframeInterval
+
+void PhysicsFullSynchronisationModel::enableDeltaCompression(float positionPrecision,
+		float velocityPrecision, unsigned maxBaselineAge) {
+	if (snapshotCodec)
+		delete snapshotCodec;
+	snapshotCodec = new PhysicsSnapshotCodec(positionPrecision, velocityPrecision, maxBaselineAge);
+	deltaUsers.clear();
+} // enableDeltaCompression
+
 
 //*******************************************************//
 // PUBLIC METHODS INHERITED FROM: SynchronisationModel: *//
@@ -80,13 +111,18 @@ void PhysicsFullSynchronisationModel::synchroniseAfterStep() {
 
 void PhysicsFullSynchronisationModel::handleServerSynchronisation() {
 	int i, size;
+	unsigned simulationTime;
+	unsigned numberOfStates = 0;
 	NetMessage* msg;
 //	std::vector<PhysicsObjectInterface*> objects;
 	std::vector<RigidBody*> rigidBodies;
 	std::vector<Joint*> joints;
+	RigidBody* rigidBody;
 	TransformationData rigidBodyTrans;
 	gmtl::Vec3f linearVel;
 	gmtl::Vec3f angularVel;
+	SentRigidBodyState* sent;
+	bool useThresholds = linearThreshold >= 0 && angularThreshold >= 0;
 
 	stepsUntilUpdate--;
 	
@@ -95,41 +131,215 @@ void PhysicsFullSynchronisationModel::handleServerSynchronisation() {
 		return;
 	} // if
 
+	stepsUntilUpdate = updateInterval;
+
 	getLocalSimulatedRigidBodies(objectManager, rigidBodies);
 	getLocalSimulatedJoints(objectManager, joints);
 //	objectManager->getLocalSimulatedObjects(objects);
 	
 	size = rigidBodies.size();
-	if (size <= 0)
+	if (size <= 0) {
+		sentState.clear();
+		counter->stepFinished();
 		return;
+	} // if
+
+	simulationTime = physics->getSimulationTime();
+
+	if (snapshotCodec) {
+		handleServerDeltaSynchronisation(rigidBodies, simulationTime);
+		counter->stepFinished();
+		return;
+	} // if
 
 	msg = new NetMessage;
 	msgFunctions::encode((unsigned)MSGTYPE_SYNC, msg);
 	msgFunctions::encode(PHYSICSFULLSYNCHRONISATION_MESSAGEID, msg);
-	msgFunctions::encode((unsigned)physics->getSimulationTime(), msg);
+	msgFunctions::encode(simulationTime, msg);
+	encodeSendTime(msg);
 
 	for (i=0; i < size; i++) {
-		msgFunctions::encode(rigidBodies[i]->getID(), msg);
+		rigidBody = rigidBodies[i];
+		if (useThresholds && !needsUpdate(rigidBody, simulationTime))
+			continue;
+
+		rigidBodyTrans = rigidBody->getTransformation();
+		rigidBody->getLinearVelocity(linearVel);
+		rigidBody->getAngularVelocity(angularVel);
+
+		if (useThresholds) {
+			sent = &sentState[rigidBody->getID()];
+			sent->active = !rigidBody->isFixed() && rigidBody->isActive();
+			if (!sent->active) {
+				// resting rigid bodies are sent without velocity so that they
+				// stay where they are on the clients until the next change
+				linearVel = gmtl::Vec3f(0, 0, 0);
+				angularVel = gmtl::Vec3f(0, 0, 0);
+			} // if
+			sent->state.simulationTime = simulationTime;
+			sent->state.position = rigidBodyTrans.position;
+			sent->state.orientation = rigidBodyTrans.orientation;
+			sent->state.linearVel = linearVel;
+			sent->state.angularVel = angularVel;
+		} // if
 
-		rigidBodyTrans = rigidBodies[i]->getTransformation();
-		rigidBodies[i]->getLinearVelocity(linearVel);
-		rigidBodies[i]->getAngularVelocity(angularVel);
+		msgFunctions::encode(rigidBody->getID(), msg);
 		msgFunctions::encode(rigidBodyTrans.position, msg);
 		msgFunctions::encode(rigidBodyTrans.orientation, msg);
 		msgFunctions::encode(linearVel, msg);
 		msgFunctions::encode(angularVel, msg);
+		numberOfStates++;
 	} // for
 
-	network->sendMessageUDP(msg, PHYSICS_MODULE_ID);
+	if (useThresholds)
+		removeStaleSentStates(rigidBodies);
+
+	// nothing changed, the clients simulate the same scene on their own
+	if (numberOfStates > 0) {
+		network->sendMessageUDP(msg, PHYSICS_MODULE_ID);
+		counter->countBytes(msg);
+	} // if
 
-	counter->countBytes(msg);
 	counter->stepFinished();
 	
-	stepsUntilUpdate = updateInterval;
-	
 	delete msg;
 } // synchroniseAfterStep
 
+void PhysicsFullSynchronisationModel::removeStaleSentStates(
+		std::vector<RigidBody*>& rigidBodies) {
+	std::set<uint64_t> ids;
+	std::map<uint64_t, SentRigidBodyState>::iterator it;
+	unsigned i;
+
+	// every local rigid body has an entry after an update, so additional
+	// entries belong to destroyed or no longer locally simulated rigid bodies
+	if (sentState.size() <= rigidBodies.size())
+		return;
+
+	for (i = 0; i < rigidBodies.size(); i++)
+		ids.insert(rigidBodies[i]->getID());
+
+	it = sentState.begin();
+	while (it != sentState.end()) {
+		if (ids.find(it->first) == ids.end())
+			sentState.erase(it++);
+		else
+			++it;
+	} // while
+} // removeStaleSentStates
+
+bool PhysicsFullSynchronisationModel::needsUpdate(RigidBody* rigidBody,
+		unsigned simulationTime) {
+
+	std::map<uint64_t, SentRigidBodyState>::iterator it;
+	SentRigidBodyState* sent;
+	TransformationData trans = identityTransformation();
+	TransformationData predicted;
+	gmtl::Vec3f deltaPosition;
+	gmtl::Quatf deltaOrientation;
+	gmtl::AxisAnglef deltaRotation;
+	bool active;
+	float dt;
+
+	if (linearThreshold < 0 || angularThreshold < 0)
+		return true;
+
+	it = sentState.find(rigidBody->getID());
+	if (it == sentState.end())
+		return true;
+	sent = &it->second;
+
+	active = !rigidBody->isFixed() && rigidBody->isActive();
+	if (active != sent->active)
+		return true;
+
+	if (keyframeInterval > 0 && simulationTime - sent->state.simulationTime >= keyframeInterval)
+		return true;
+
+	// the final state of a resting rigid body was sent when it fell asleep
+	if (!active)
+		return false;
+
+	if (simulationStepSize == 0)
+		simulationStepSize = physics->getStepSize();
+
+	// the clients simulate the rigid body on their own, the extrapolated last
+	// sent state is used as estimation of the state on the clients
+	dt = (simulationTime - sent->state.simulationTime) * simulationStepSize;
+	trans.position = sent->state.position;
+	trans.orientation = sent->state.orientation;
+	calculateFutureTransformation(predicted, trans, sent->state.linearVel,
+			sent->state.angularVel, dt);
+
+	rigidBody->getTransformation(trans);
+	deltaPosition = trans.position - predicted.position;
+	gmtl::invert(predicted.orientation);
+	deltaOrientation = trans.orientation * predicted.orientation;
+	gmtl::set(deltaRotation, deltaOrientation);
+
+	return gmtl::length(deltaPosition) > linearThreshold ||
+			deltaRotation.getAngle() > angularThreshold;
+} // needsUpdate
+
+void PhysicsFullSynchronisationModel::handleServerDeltaSynchronisation(
+		std::vector<RigidBody*>& rigidBodies, unsigned simulationTime) {
+
+	int i;
+	unsigned userId;
+	unsigned localUserId = UserDatabase::getLocalUserId();
+	NetMessage* msg;
+	RigidBody* rigidBody;
+	TransformationData trans;
+	gmtl::Vec3f linearVel, angularVel;
+	PhysicsSnapshotCodec::Snapshot snapshot;
+	std::vector<unsigned> connectedUsers;
+	std::set<unsigned> users;
+	std::set<unsigned>::iterator it;
+
+	for (i=0; i < (int)rigidBodies.size(); i++) {
+		rigidBody = rigidBodies[i];
+		rigidBody->getTransformation(trans);
+		if (!rigidBody->isFixed() && rigidBody->isActive()) {
+			rigidBody->getLinearVelocity(linearVel);
+			rigidBody->getAngularVelocity(angularVel);
+		} // if
+		else {
+			linearVel = gmtl::Vec3f(0, 0, 0);
+			angularVel = gmtl::Vec3f(0, 0, 0);
+		} // else
+		snapshotCodec->quantize(trans, linearVel, angularVel, snapshot[rigidBody->getID()]);
+	} // for
+	snapshotCodec->addSnapshot(simulationTime, snapshot);
+
+	// every client gets the snapshot relative to its own baseline, the users
+	// are copied by the main thread since the UserDatabase is not locked
+	getConnectedUsers(connectedUsers);
+	for (i=0; i < (int)connectedUsers.size(); i++) {
+		userId = connectedUsers[i];
+		users.insert(userId);
+
+		msg = new NetMessage;
+		msgFunctions::encode((unsigned)MSGTYPE_SYNC, msg);
+		msgFunctions::encode(PHYSICSFULLSYNCHRONISATION_DELTA_MESSAGEID, msg);
+		msgFunctions::encode(simulationTime, msg);
+		encodeSendTime(msg);
+		msgFunctions::encode(localUserId, msg);
+		snapshotCodec->encode(simulationTime, userId, msg);
+
+		network->sendMessageUDPTo(msg, PHYSICS_MODULE_ID, userId);
+		counter->countBytes(msg);
+		delete msg;
+	} // for
+
+	// forget the baselines of users who left, a rejoining user with the same
+	// ID must not be encoded against the snapshots of its last session
+	for (it = deltaUsers.begin(); it != deltaUsers.end(); ++it) {
+		if (users.find(*it) == users.end())
+			snapshotCodec->removeUser(*it);
+	} // for
+	deltaUsers.swap(users);
+} // handleServerDeltaSynchronisation
+
 void PhysicsFullSynchronisationModel::handleClientSynchronisation() {
 	int i, size;
 	TransformationData prediction = identityTransformation();
@@ -274,26 +484,29 @@ void PhysicsFullSynchronisationModel::calculateFutureTransformation(Transformati
 void PhysicsFullSynchronisationModel::handleSyncMessage(NetMessage* msg) {
 
 	TransformationData trans = identityTransformation();
-	TransformationData currentTrans;
 	unsigned simulationTime;
 //	PhysicsObjectID destinationObjectID;
 //	PhysicsObjectInterface* object = NULL;
 //	std::vector<RigidBody*> rigidBodies;
 	RigidBody* rigidBody;
-	RigidBodyState* state;
 	uint64_t rigidBodyID;
 	gmtl::Vec3f linearVel, angularVel;
-	gmtl::Vec3f currentLinearVel, currentAngularVel;
 	unsigned syncTypeID;
 	unsigned localSimulationTime = physics->getSimulationTime();
+	float latency;
 
 	msgFunctions::decode(syncTypeID, msg);
+	if (syncTypeID == PHYSICSFULLSYNCHRONISATION_DELTA_MESSAGEID) {
+		handleDeltaSyncMessage(msg);
+		return;
+	} // if
 	if (syncTypeID != PHYSICSFULLSYNCHRONISATION_MESSAGEID) {
 		printd(ERROR, "PhysicsFullSynchronisationModel::handleSyncMessage(): got sync-message for invalid SynchronisationModel (ID=%u)!\n");
 		return;
 	} // if
 
 	msgFunctions::decode(simulationTime, msg);
+	latency = decodeLatency(msg);
 	
 	while (!msg->finished())
 	{
@@ -315,40 +528,139 @@ void PhysicsFullSynchronisationModel::handleSyncMessage(NetMessage* msg) {
 		msgFunctions::decode(linearVel, msg);
 		msgFunctions::decode(angularVel, msg);
 		
-		if (convergenceAlgorithm == SNAPPING) {
-			rigidBody->setTransformation(trans, true);
-			rigidBody->setLinearVelocity(linearVel);
-			rigidBody->setAngularVelocity(angularVel);
-		} // if
-		else if (convergenceAlgorithm == LINEAR || convergenceAlgorithm == QUADRIC) {
-			state = convergenceState[rigidBodyID];
-			if (!state) {
-				state = new RigidBodyState;
-				convergenceState[rigidBodyID] = state;
-			} // if
-
-			rigidBody->getTransformation(currentTrans);
-			rigidBody->getLinearVelocity(currentLinearVel);
-			rigidBody->getAngularVelocity(currentAngularVel);
-			
-			rigidBody->setTransformation(trans, false);
-			rigidBody->setLinearVelocity(linearVel);
-			rigidBody->setAngularVelocity(angularVel);
-			
-			state->position = currentTrans.position;
-			state->orientation = currentTrans.orientation;
-			state->linearVel = currentLinearVel;
-			state->angularVel = currentAngularVel;
-			state->simulationTime = localSimulationTime;
-		} // else if
-		else
-			printd(ERROR, "PhysicsFullSynchronisationModel::handleSyncMessage(): unknown convergenceAlgorithm %i set!\n", convergenceAlgorithm);
+		if (latency > 0)
+			calculateFutureTransformation(trans, trans, linearVel, angularVel, latency);
+		applyRemoteState(rigidBody, trans, linearVel, angularVel, localSimulationTime);
 	} // while
 
 } // handleSynchronisationModel
 
+void PhysicsFullSynchronisationModel::handleDeltaSyncMessage(NetMessage* msg) {
+
+	TransformationData trans = identityTransformation();
+	unsigned simulationTime;
+	unsigned serverUserId;
+	unsigned localSimulationTime = physics->getSimulationTime();
+	RigidBody* rigidBody;
+	gmtl::Vec3f linearVel, angularVel;
+	PhysicsSnapshotCodec::Snapshot snapshot;
+	PhysicsSnapshotCodec::Snapshot::iterator it;
+	NetMessage* ack;
+	float latency;
+
+	msgFunctions::decode(simulationTime, msg);
+	latency = decodeLatency(msg);
+	msgFunctions::decode(serverUserId, msg);
+
+	if (!snapshotCodec) {
+		printd(ERROR, "PhysicsFullSynchronisationModel::handleDeltaSyncMessage(): got delta compressed message but delta compression is not enabled!\n");
+		return;
+	} // if
+
+	if (!snapshotCodec->decode(simulationTime, msg, snapshot))
+		return;
+
+	ack = new NetMessage;
+	msgFunctions::encode((unsigned)MSGTYPE_CLIENTINPUT, ack);
+	msgFunctions::encode(PHYSICSFULLSYNCHRONISATION_DELTA_MESSAGEID, ack);
+	msgFunctions::encode(UserDatabase::getLocalUserId(), ack);
+	msgFunctions::encode(simulationTime, ack);
+	network->sendMessageUDPTo(ack, PHYSICS_MODULE_ID, serverUserId);
+	delete ack;
+
+	for (it = snapshot.begin(); it != snapshot.end(); ++it) {
+		rigidBody = getRigidBodyById(objectManager, it->first);
+		if (!rigidBody) {
+			printd(ERROR, "PhysicsFullSynchronisationModel::handleDeltaSyncMessage(): sync-message for unknown RigidBody found!\n");
+			continue;
+		} // if
+
+		snapshotCodec->dequantize(it->second, trans, linearVel, angularVel);
+		if (latency > 0)
+			calculateFutureTransformation(trans, trans, linearVel, angularVel, latency);
+		applyRemoteState(rigidBody, trans, linearVel, angularVel, localSimulationTime);
+	} // for
+} // handleDeltaSyncMessage
+
+void PhysicsFullSynchronisationModel::encodeSendTime(NetMessage* msg) {
+	double sendTime = -1;
+
+	if (NetworkTime::isSynchronised())
+		sendTime = NetworkTime::getTime();
+	msgFunctions::encode(sendTime, msg);
+} // encodeSendTime
+
+float PhysicsFullSynchronisationModel::decodeLatency(NetMessage* msg) {
+	double sendTime;
+	double latency;
+
+	msgFunctions::decode(sendTime, msg);
+	if (sendTime < 0 || !NetworkTime::isSynchronised())
+		return 0;
+
+	// the received state is extrapolated by the time it was underway
+	latency = inVRsUtilities::Timer::getMonotonicTime() - NetworkTime::toLocalTime(sendTime);
+	if (latency < 0)
+		return 0;
+	if (latency > MAX_LATENCY_COMPENSATION)
+		return MAX_LATENCY_COMPENSATION;
+	return (float)latency;
+} // decodeLatency
+
+void PhysicsFullSynchronisationModel::applyRemoteState(RigidBody* rigidBody,
+		TransformationData& trans, gmtl::Vec3f& linearVel, gmtl::Vec3f& angularVel,
+		unsigned localSimulationTime) {
+
+	TransformationData currentTrans;
+	RigidBodyState* state;
+	gmtl::Vec3f currentLinearVel, currentAngularVel;
+	uint64_t rigidBodyID = rigidBody->getID();
+
+	if (convergenceAlgorithm == SNAPPING) {
+		rigidBody->setTransformation(trans, true);
+		rigidBody->setLinearVelocity(linearVel);
+		rigidBody->setAngularVelocity(angularVel);
+	} // if
+	else if (convergenceAlgorithm == LINEAR || convergenceAlgorithm == QUADRIC) {
+		state = convergenceState[rigidBodyID];
+		if (!state) {
+			state = new RigidBodyState;
+			convergenceState[rigidBodyID] = state;
+		} // if
+
+		rigidBody->getTransformation(currentTrans);
+		rigidBody->getLinearVelocity(currentLinearVel);
+		rigidBody->getAngularVelocity(currentAngularVel);
+		
+		rigidBody->setTransformation(trans, false);
+		rigidBody->setLinearVelocity(linearVel);
+		rigidBody->setAngularVelocity(angularVel);
+		
+		state->position = currentTrans.position;
+		state->orientation = currentTrans.orientation;
+		state->linearVel = currentLinearVel;
+		state->angularVel = currentAngularVel;
+		state->simulationTime = localSimulationTime;
+	} // else if
+	else
+		printd(ERROR, "PhysicsFullSynchronisationModel::applyRemoteState(): unknown convergenceAlgorithm %i set!\n", convergenceAlgorithm);
+} // applyRemoteState
+
 void PhysicsFullSynchronisationModel::handleClientInputMessage(NetMessage* msg) {
-	
+	unsigned syncTypeID;
+	unsigned userId;
+	unsigned simulationTime;
+
+	msgFunctions::decode(syncTypeID, msg);
+	if (syncTypeID != PHYSICSFULLSYNCHRONISATION_DELTA_MESSAGEID) {
+		printd(ERROR, "PhysicsFullSynchronisationModel::handleClientInputMessage(): got message for invalid SynchronisationModel (ID=%u)!\n", syncTypeID);
+		return;
+	} // if
+
+	msgFunctions::decode(userId, msg);
+	msgFunctions::decode(simulationTime, msg);
+	if (snapshotCodec)
+		snapshotCodec->acknowledge(userId, simulationTime);
 } // handleClientInputMessage
 
 bool PhysicsFullSynchronisationModel::needPhysicsCalculation() {
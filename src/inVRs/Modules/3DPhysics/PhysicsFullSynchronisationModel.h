@@ -36,11 +36,19 @@
 #ifndef _PHYSICSFULLSYNCHRONISATIONMODEL_H_
 #define _PHYSICSFULLSYNCHRONISATIONMODEL_H_
 
+#include <set>
+
 #include "SynchronisationModel.h"
 
 class MessageSizeCounter;
+class PhysicsSnapshotCodec;
 
 /** SynchronisationModel which does client-side physics calculations.
+ * Every updateInterval steps the server sends the state of its rigid bodies.
+ * If send thresholds are set only the rigid bodies are sent whose state changed
+ * significantly since they were sent last, see setSendThresholds(). With
+ * delta compression the states are sent quantized and relative to the last
+ * state acknowledged by each client, see enableDeltaCompression().
  */
 class PhysicsFullSynchronisationModel : public SynchronisationModel {
 	
@@ -59,6 +67,33 @@ public:
 	 */
 	virtual ~PhysicsFullSynchronisationModel();
 
+	/** Restricts the update messages to rigid bodies whose state differs from
+	 * the last sent state. A rigid body is sent when it falls asleep or wakes
+	 * up, or when its position (in units) or its orientation (in radians)
+	 * deviates from the state extrapolated from the last sent state by more
+	 * than the passed thresholds. Negative thresholds (the default) send all
+	 * rigid bodies with every update.
+	 */
+	void setSendThresholds(float linearThreshold, float angularThreshold);
+
+	/** Sets the number of simulation steps after which a rigid body is sent
+	 * again even if its state did not change, so that clients recover from
+	 * lost messages. 0 (the default) disables the keyframes.
+	 */
+	void setKeyframeInterval(unsigned keyframeInterval);
+
+	/** Sends the states of all rigid bodies to every client as difference to
+	 * the last state acknowledged by the client, using a PhysicsSnapshotCodec.
+	 * The clients reconstruct the same quantized states which are sent without
+	 * delta compression. Replaces the filtering of setSendThresholds().
+	 * @param positionPrecision quantization step of the position
+	 * @param velocityPrecision quantization step of the velocities
+	 * @param maxBaselineAge number of simulation steps after which a client
+	 * without newer acknowledgement gets the full states again
+	 */
+	void enableDeltaCompression(float positionPrecision, float velocityPrecision,
+			unsigned maxBaselineAge);
+
 //*******************************************************//
 // PUBLIC METHODS INHERITED FROM: SynchronisationModel: *//
 //*******************************************************//
@@ -70,6 +105,11 @@ protected:
 	
 	static const unsigned PHYSICSFULLSYNCHRONISATION_MESSAGEID;
 
+	static const unsigned PHYSICSFULLSYNCHRONISATION_DELTA_MESSAGEID;
+
+	/// maximum transmission latency (in seconds) compensated on the clients
+	static const float MAX_LATENCY_COMPENSATION;
+
 	struct RigidBodyState {
 		unsigned simulationTime;
 		gmtl::Vec3f position;
@@ -78,6 +118,11 @@ protected:
 		gmtl::Vec3f angularVel;
 	};
 	
+	struct SentRigidBodyState {
+		RigidBodyState state;
+		bool active;
+	};
+
 	enum CONVERGENCE_ALGORITHM {
 		SNAPPING = 0,
 		LINEAR = 1,
@@ -91,6 +136,43 @@ protected:
 	virtual void handleServerSynchronisation();
 	virtual void handleClientSynchronisation();
 
+	/** Returns if the state of the passed rigid body has to be sent, depending
+	 * on the send thresholds and the keyframe interval.
+	 */
+	virtual bool needsUpdate(oops::RigidBody* rigidBody, unsigned simulationTime);
+
+	/** Removes the sent states of rigid bodies which are not in the passed
+	 * list of local rigid bodies any more, e.g. because they were destroyed.
+	 */
+	virtual void removeStaleSentStates(std::vector<oops::RigidBody*>& rigidBodies);
+
+	/** Sends the delta compressed states of the passed rigid bodies to every
+	 * connected user.
+	 */
+	virtual void handleServerDeltaSynchronisation(std::vector<oops::RigidBody*>& rigidBodies,
+			unsigned simulationTime);
+
+	/** Decodes a delta compressed message, applies the states and
+	 * acknowledges the snapshot to the server.
+	 */
+	virtual void handleDeltaSyncMessage(NetMessage* msg);
+
+	/** Writes the current network time into the sync message, or a negative
+	 * value if the network clock is not synchronised yet.
+	 */
+	virtual void encodeSendTime(NetMessage* msg);
+
+	/** Reads the send time written by encodeSendTime() and returns the
+	 * transmission latency of the message in seconds (0 if unknown).
+	 */
+	virtual float decodeLatency(NetMessage* msg);
+
+	/** Applies the received state to the rigid body using the convergence
+	 * algorithm.
+	 */
+	virtual void applyRemoteState(oops::RigidBody* rigidBody, TransformationData& trans,
+			gmtl::Vec3f& linearVel, gmtl::Vec3f& angularVel, unsigned localSimulationTime);
+
 	/**
 	 */
 	virtual bool calculateLinearConvergence(gmtl::Vec3f& newPos, gmtl::Quatf& newOri, 
@@ -133,6 +215,22 @@ protected:
 	float convergenceTime;
 	
 	std::map<uint64_t, RigidBodyState*> convergenceState;
+
+	/// State of each local rigid body when it was sent last
+	std::map<uint64_t, SentRigidBodyState> sentState;
+
+	float linearThreshold;
+
+	float angularThreshold;
+
+	/// Number of simulation steps after which unchanged rigid bodies are sent again
+	unsigned keyframeInterval;
+
+	/// Codec for the delta compression, NULL if the states are sent uncompressed
+	PhysicsSnapshotCodec* snapshotCodec;
+
+	/// Users which got the last delta compressed snapshot
+	std::set<unsigned> deltaUsers;
 }; // PhysicsFullSynchronisationModel
 
 #endif /*_PHYSICSFULLSYNCHRONISATIONMODEL_H_*/
@@ -43,6 +43,14 @@ SynchronisationModel* PhysicsFullSynchronisationModelFactory::create(std::string
 	int updateInterval = -1;
 	int convergenceAlgorithm = -1;
 	float convergenceTime = -1;
+	float linearThreshold = -1;
+	float angularThreshold = -1;
+	int keyframeInterval = 0;
+	bool deltaCompression = false;
+	float positionPrecision = 0.0001f;
+	float velocityPrecision = 0.0001f;
+	int maxBaselineAge = 100;
+	PhysicsFullSynchronisationModel* result;
 
 	ArgumentVector* argVec = (ArgumentVector*)args;
 	
@@ -60,15 +68,60 @@ SynchronisationModel* PhysicsFullSynchronisationModelFactory::create(std::string
 	if (argVec->keyExists("convergenceTime"))
 		argVec->get("convergenceTime", convergenceTime);
 
+	if (argVec->keyExists("linearThreshold"))
+		argVec->get("linearThreshold", linearThreshold);
+
+	if (argVec->keyExists("angularThreshold"))
+		argVec->get("angularThreshold", angularThreshold);
+
+	if (argVec->keyExists("keyframeInterval"))
+		argVec->get("keyframeInterval", keyframeInterval);
+
+	if (argVec->keyExists("deltaCompression"))
+		argVec->get("deltaCompression", deltaCompression);
+
+	if (argVec->keyExists("positionPrecision"))
+		argVec->get("positionPrecision", positionPrecision);
+
+	if (argVec->keyExists("velocityPrecision"))
+		argVec->get("velocityPrecision", velocityPrecision);
+
+	if (argVec->keyExists("maxBaselineAge"))
+		argVec->get("maxBaselineAge", maxBaselineAge);
+
 	if (updateInterval <= 0) {
 		printd(ERROR, "PhysicsFullSynchronisationModelFactory::create(): invalid update inverval %i found (must be positive)!\n", updateInterval);
 		return new PhysicsFullSynchronisationModel;
 	} // if
 
 	if (convergenceAlgorithm < 0)
-		return new PhysicsFullSynchronisationModel(updateInterval);
-	if (convergenceTime < 0)
-		return new PhysicsFullSynchronisationModel(updateInterval, convergenceAlgorithm);
+		result = new PhysicsFullSynchronisationModel(updateInterval);
+	else if (convergenceTime < 0)
+		result = new PhysicsFullSynchronisationModel(updateInterval, convergenceAlgorithm);
+	else
+		result = new PhysicsFullSynchronisationModel(updateInterval, convergenceAlgorithm, convergenceTime);
+
+	if ((linearThreshold < 0) != (angularThreshold < 0))
+		printd(WARNING, "PhysicsFullSynchronisationModelFactory::create(): linearThreshold and angularThreshold have to be set both, sending all rigid bodies!\n");
+	result->setSendThresholds(linearThreshold, angularThreshold);
+
+	if (keyframeInterval < 0) {
+		printd(ERROR, "PhysicsFullSynchronisationModelFactory::create(): invalid keyframeInterval %i found (must not be negative)!\n", keyframeInterval);
+		keyframeInterval = 0;
+	} // if
+	result->setKeyframeInterval(keyframeInterval);
+
+	if (deltaCompression) {
+		if (linearThreshold >= 0 || angularThreshold >= 0)
+			printd(WARNING, "PhysicsFullSynchronisationModelFactory::create(): thresholds are ignored with deltaCompression!\n");
+		if (positionPrecision <= 0 || velocityPrecision <= 0 || maxBaselineAge < 0) {
+			printd(ERROR, "PhysicsFullSynchronisationModelFactory::create(): invalid precision or maxBaselineAge found (must be positive), using defaults!\n");
+			positionPrecision = 0.0001f;
+			velocityPrecision = 0.0001f;
+			maxBaselineAge = 100;
+		} // if
+		result->enableDeltaCompression(positionPrecision, velocityPrecision, maxBaselineAge);
+	} // if
 
-	return new PhysicsFullSynchronisationModel(updateInterval, convergenceAlgorithm, convergenceTime);
+	return result;
 } // create
@@ -0,0 +1,265 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+#include "PhysicsSnapshotCodec.h"
+
+#include <assert.h>
+#include <math.h>
+#include <vector>
+
+#include <inVRs/SystemCore/DebugOutput.h>
+
+// quantization steps per unit of the quaternion components
+static const float ORIENTATION_SCALE = 32767.f;
+
+static int32_t quantizeValue(float value, float scale) {
+	return (int32_t)floorf(value * scale + 0.5f);
+} // quantizeValue
+
+//*****************//
+// PUBLIC METHODS: //
+//*****************//
+
+bool PhysicsSnapshotCodec::QuantizedState::operator==(const QuantizedState& other) const {
+	for (int i=0; i < NUMBER_OF_VALUES; i++) {
+		if (values[i] != other.values[i])
+			return false;
+	} // for
+	return true;
+} // operator==
+
+bool PhysicsSnapshotCodec::QuantizedState::operator!=(const QuantizedState& other) const {
+	return !(*this == other);
+} // operator!=
+
+PhysicsSnapshotCodec::PhysicsSnapshotCodec(float positionPrecision, float velocityPrecision,
+		unsigned maxBaselineAge) {
+	assert(positionPrecision > 0 && velocityPrecision > 0);
+	this->positionPrecision = positionPrecision;
+	this->velocityPrecision = velocityPrecision;
+	this->maxBaselineAge = maxBaselineAge;
+} // PhysicsSnapshotCodec
+
+PhysicsSnapshotCodec::~PhysicsSnapshotCodec() {
+
+} // ~PhysicsSnapshotCodec
+
+void PhysicsSnapshotCodec::quantize(const TransformationData& trans,
+		const gmtl::Vec3f& linearVel, const gmtl::Vec3f& angularVel, QuantizedState& dst) const {
+
+	int i;
+	// q and -q are the same rotation, the positive w keeps the differences small
+	float sign = trans.orientation[3] < 0 ? -1.f : 1.f;
+
+	for (i=0; i < 3; i++) {
+		dst.values[i] = quantizeValue(trans.position[i], 1.f / positionPrecision);
+		dst.values[7+i] = quantizeValue(linearVel[i], 1.f / velocityPrecision);
+		dst.values[10+i] = quantizeValue(angularVel[i], 1.f / velocityPrecision);
+	} // for
+	for (i=0; i < 4; i++)
+		dst.values[3+i] = quantizeValue(sign * trans.orientation[i], ORIENTATION_SCALE);
+} // quantize
+
+void PhysicsSnapshotCodec::dequantize(const QuantizedState& src, TransformationData& trans,
+		gmtl::Vec3f& linearVel, gmtl::Vec3f& angularVel) const {
+
+	int i;
+
+	for (i=0; i < 3; i++) {
+		trans.position[i] = src.values[i] * positionPrecision;
+		linearVel[i] = src.values[7+i] * velocityPrecision;
+		angularVel[i] = src.values[10+i] * velocityPrecision;
+	} // for
+	for (i=0; i < 4; i++)
+		trans.orientation[i] = src.values[3+i] / ORIENTATION_SCALE;
+	gmtl::normalize(trans.orientation);
+} // dequantize
+
+void PhysicsSnapshotCodec::addSnapshot(unsigned simulationTime, const Snapshot& snapshot) {
+	sentSnapshots[simulationTime] = snapshot;
+	if (simulationTime > maxBaselineAge)
+		removeOlderSnapshots(sentSnapshots, simulationTime - maxBaselineAge);
+} // addSnapshot
+
+void PhysicsSnapshotCodec::acknowledge(unsigned userId, unsigned simulationTime) {
+	std::map<unsigned, unsigned>::iterator it = acknowledgedSnapshots.find(userId);
+
+	// acknowledgements may arrive out of order, only newer ones are of interest
+	if (it == acknowledgedSnapshots.end() || it->second < simulationTime)
+		acknowledgedSnapshots[userId] = simulationTime;
+} // acknowledge
+
+void PhysicsSnapshotCodec::removeUser(unsigned userId) {
+	acknowledgedSnapshots.erase(userId);
+} // removeUser
+
+bool PhysicsSnapshotCodec::encode(unsigned simulationTime, unsigned userId, NetMessage* msg) {
+	std::map<unsigned, unsigned>::iterator ackIt;
+	std::map<unsigned, Snapshot>::iterator baselineIt = sentSnapshots.end();
+	Snapshot::const_iterator it, baseIt;
+	const Snapshot* baseline = NULL;
+	std::vector<const Snapshot::value_type*> changed;
+	std::vector<uint64_t> removed;
+	unsigned i;
+	int j;
+
+	if (sentSnapshots.find(simulationTime) == sentSnapshots.end()) {
+		printd(ERROR, "PhysicsSnapshotCodec::encode(): no snapshot for simulation time %u found!\n", simulationTime);
+		msg->putUInt8(0);
+		msg->putUInt32(0);
+		msg->putUInt32(0);
+		return false;
+	} // if
+	const Snapshot& snapshot = sentSnapshots[simulationTime];
+
+	ackIt = acknowledgedSnapshots.find(userId);
+	if (ackIt != acknowledgedSnapshots.end() && ackIt->second < simulationTime &&
+			simulationTime - ackIt->second <= maxBaselineAge)
+		baselineIt = sentSnapshots.find(ackIt->second);
+
+	if (baselineIt != sentSnapshots.end()) {
+		baseline = &baselineIt->second;
+		msg->putUInt8(1);
+		msg->putUInt32(baselineIt->first);
+	} // if
+	else
+		msg->putUInt8(0);
+
+	for (it = snapshot.begin(); it != snapshot.end(); ++it) {
+		if (baseline) {
+			baseIt = baseline->find(it->first);
+			if (baseIt != baseline->end() && baseIt->second == it->second)
+				continue;
+		} // if
+		changed.push_back(&*it);
+	} // for
+	if (baseline) {
+		for (baseIt = baseline->begin(); baseIt != baseline->end(); ++baseIt) {
+			if (snapshot.find(baseIt->first) == snapshot.end())
+				removed.push_back(baseIt->first);
+		} // for
+	} // if
+
+	msg->putUInt32(changed.size());
+	for (i=0; i < changed.size(); i++) {
+		msg->putUInt64(changed[i]->first);
+		const QuantizedState* base = NULL;
+		if (baseline) {
+			baseIt = baseline->find(changed[i]->first);
+			if (baseIt != baseline->end())
+				base = &baseIt->second;
+		} // if
+		for (j=0; j < NUMBER_OF_VALUES; j++)
+			encodeValue(changed[i]->second.values[j] - (base ? base->values[j] : 0), msg);
+	} // for
+
+	msg->putUInt32(removed.size());
+	for (i=0; i < removed.size(); i++)
+		msg->putUInt64(removed[i]);
+
+	return baseline != NULL;
+} // encode
+
+bool PhysicsSnapshotCodec::decode(unsigned simulationTime, NetMessage* msg, Snapshot& dst) {
+	std::map<unsigned, Snapshot>::iterator baselineIt;
+	Snapshot::iterator it;
+	unsigned baselineTime = 0;
+	unsigned i, size;
+	uint64_t rigidBodyID;
+	QuantizedState state;
+	bool hasBaseline;
+	int j;
+
+	hasBaseline = msg->getUInt8() != 0;
+	if (hasBaseline) {
+		baselineTime = msg->getUInt32();
+		baselineIt = receivedSnapshots.find(baselineTime);
+		if (baselineIt == receivedSnapshots.end()) {
+			printd(WARNING, "PhysicsSnapshotCodec::decode(): baseline %u of snapshot %u not found, snapshot is ignored!\n",
+					baselineTime, simulationTime);
+			return false;
+		} // if
+		dst = baselineIt->second;
+	} // if
+	else
+		dst.clear();
+
+	size = msg->getUInt32();
+	for (i=0; i < size; i++) {
+		rigidBodyID = msg->getUInt64();
+		it = dst.find(rigidBodyID);
+		for (j=0; j < NUMBER_OF_VALUES; j++)
+			state.values[j] = decodeValue(msg) + (it != dst.end() ? it->second.values[j] : 0);
+		dst[rigidBodyID] = state;
+	} // for
+
+	size = msg->getUInt32();
+	for (i=0; i < size; i++)
+		dst.erase(msg->getUInt64());
+
+	receivedSnapshots[simulationTime] = dst;
+	// the sender never uses an older baseline for this receiver again
+	if (hasBaseline)
+		removeOlderSnapshots(receivedSnapshots, baselineTime);
+	if (simulationTime > maxBaselineAge)
+		removeOlderSnapshots(receivedSnapshots, simulationTime - maxBaselineAge);
+
+	return true;
+} // decode
+
+//********************//
+// PROTECTED METHODS: //
+//********************//
+
+void PhysicsSnapshotCodec::encodeValue(int32_t value, NetMessage* msg) {
+	uint32_t zigzag = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+
+	while (zigzag >= 0x80) {
+		msg->putUInt8((uint8_t)(zigzag | 0x80));
+		zigzag >>= 7;
+	} // while
+	msg->putUInt8((uint8_t)zigzag);
+} // encodeValue
+
+int32_t PhysicsSnapshotCodec::decodeValue(NetMessage* msg) {
+	uint32_t zigzag = 0;
+	uint8_t byte;
+	int shift = 0;
+
+	do {
+		byte = msg->getUInt8();
+		zigzag |= (uint32_t)(byte & 0x7F) << shift;
+		shift += 7;
+	} while ((byte & 0x80) && shift < 35);
+
+	return (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+} // decodeValue
+
+void PhysicsSnapshotCodec::removeOlderSnapshots(std::map<unsigned, Snapshot>& snapshots,
+		unsigned simulationTime) {
+	snapshots.erase(snapshots.begin(), snapshots.lower_bound(simulationTime));
+} // removeOlderSnapshots
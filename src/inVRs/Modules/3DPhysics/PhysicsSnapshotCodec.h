@@ -0,0 +1,171 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                Changes                                    *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+\*---------------------------------------------------------------------------*/
+
+
+#ifndef _PHYSICSSNAPSHOTCODEC_H_
+#define _PHYSICSSNAPSHOTCODEC_H_
+
+#include <map>
+
+#include "3DPhysicsSharedLibraryExports.h"
+#include <inVRs/SystemCore/DataTypes.h>
+#include <inVRs/SystemCore/NetMessage.h>
+
+/** Encodes snapshots of the rigid body states relative to acknowledged ones.
+ * The state of each rigid body is quantized to integers. The sender keeps the
+ * snapshots it sent and the last snapshot acknowledged by every receiver, and
+ * encodes new snapshots as differences to this baseline. Rigid bodies which
+ * did not change are left out, changed values are written as variable length
+ * integers. If a receiver did not acknowledge a snapshot within the maximum
+ * baseline age the full snapshot is encoded instead. The receiver keeps the
+ * decoded snapshots to reconstruct the following ones exactly.
+ */
+class INVRS_3DPHYSICS_API PhysicsSnapshotCodec {
+public:
+
+	enum {
+		/// position (3), orientation (4), linear velocity (3) and angular velocity (3)
+		NUMBER_OF_VALUES = 13
+	};
+
+	/** Quantized state of a single rigid body.
+	 */
+	struct QuantizedState {
+		int32_t values[NUMBER_OF_VALUES];
+
+		bool operator==(const QuantizedState& other) const;
+		bool operator!=(const QuantizedState& other) const;
+	};
+
+	/// Quantized states of all rigid bodies, indexed by the rigid body ID
+	typedef std::map<uint64_t, QuantizedState> Snapshot;
+
+//*****************//
+// PUBLIC METHODS: //
+//*****************//
+
+	/** Constructor
+	 * @param positionPrecision quantization step of the position
+	 * @param velocityPrecision quantization step of the linear and angular velocity
+	 * @param maxBaselineAge maximum number of simulation steps between a
+	 * snapshot and the baseline it is encoded against
+	 */
+	PhysicsSnapshotCodec(float positionPrecision = 0.0001f, float velocityPrecision = 0.0001f,
+			unsigned maxBaselineAge = 100);
+
+	/** Empty destructor
+	 */
+	virtual ~PhysicsSnapshotCodec();
+
+	/** Quantizes the passed rigid body state.
+	 */
+	void quantize(const TransformationData& trans, const gmtl::Vec3f& linearVel,
+			const gmtl::Vec3f& angularVel, QuantizedState& dst) const;
+
+	/** Converts the quantized state back into a rigid body state.
+	 */
+	void dequantize(const QuantizedState& src, TransformationData& trans,
+			gmtl::Vec3f& linearVel, gmtl::Vec3f& angularVel) const;
+
+	/** Stores the snapshot of the passed simulation step for encoding.
+	 * Snapshots older than the maximum baseline age are dropped.
+	 */
+	void addSnapshot(unsigned simulationTime, const Snapshot& snapshot);
+
+	/** Marks the snapshot of the passed simulation step as received by the
+	 * passed user.
+	 */
+	void acknowledge(unsigned userId, unsigned simulationTime);
+
+	/** Forgets the acknowledged snapshot of the passed user, e.g. when the
+	 * user left. A user rejoining with the same ID gets a full snapshot.
+	 */
+	void removeUser(unsigned userId);
+
+	/** Encodes the snapshot of the passed simulation step for the passed user.
+	 * The snapshot has to be added with addSnapshot() before.
+	 * @return true if the snapshot was encoded relative to a baseline, false if
+	 * the full snapshot was encoded
+	 */
+	bool encode(unsigned simulationTime, unsigned userId, NetMessage* msg);
+
+	/** Decodes a snapshot encoded with encode() and stores it as baseline for
+	 * the following snapshots.
+	 * @return false if the baseline of the snapshot is not available any more
+	 */
+	bool decode(unsigned simulationTime, NetMessage* msg, Snapshot& dst);
+
+protected:
+
+//********************//
+// PROTECTED METHODS: //
+//********************//
+
+	/** Writes the value as zigzag encoded variable length integer, small
+	 * absolute values need less bytes.
+	 */
+	static void encodeValue(int32_t value, NetMessage* msg);
+
+	/** Reads a value written by encodeValue().
+	 */
+	static int32_t decodeValue(NetMessage* msg);
+
+	/** Removes all snapshots which are older than the passed simulation time.
+	 */
+	static void removeOlderSnapshots(std::map<unsigned, Snapshot>& snapshots,
+			unsigned simulationTime);
+
+//********************//
+// PROTECTED MEMBERS: //
+//********************//
+
+	float positionPrecision;
+
+	float velocityPrecision;
+
+	unsigned maxBaselineAge;
+
+	/// Snapshots which can still be used as baseline by the sender
+	std::map<unsigned, Snapshot> sentSnapshots;
+
+	/// Last acknowledged snapshot of each user
+	std::map<unsigned, unsigned> acknowledgedSnapshots;
+
+	/// Snapshots which can still be used as baseline by the receiver
+	std::map<unsigned, Snapshot> receivedSnapshots;
+
+}; // PhysicsSnapshotCodec
+
+#endif /*_PHYSICSSNAPSHOTCODEC_H_*/
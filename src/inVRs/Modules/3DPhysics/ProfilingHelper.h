@@ -40,35 +40,76 @@
  *      Author: landi
  */
 
-#ifndef PROFILINGHELPER_H_
-#define PROFILINGHELPER_H_
+#ifndef PHYSICS_PROFILINGHELPER_H_
+#define PHYSICS_PROFILINGHELPER_H_
 
 #include <string>
 #include <vector>
-#include <map>
+
+#include <inVRs/SystemCore/Profiler.h>
 #include <inVRs/SystemCore/Timer.h>
 
 using namespace inVRsUtilities;
 
+/**
+ * DEPRECATED: use INVRS_PROFILE_ZONE and the Profiler instead.
+ * Thin wrapper which records the data values as zones of the Profiler, so
+ * the data appears in the Profiler output and nothing is recorded while the
+ * Profiler is disabled. The passed Timers are not used any more. Unlike the
+ * old implementation the value <code>index</code> covers the time from the
+ * call of dt() to the next call of dt() or stop(), and the log file gets
+ * the statistics of the Profiler when the helper is destroyed.
+ */
 class ProfilingHelper {
 public:
 	ProfilingHelper(std::string logFile, int numValues,
-			char** dataNames);
-	virtual ~ProfilingHelper();
+			char** dataNames) :
+		zoneOpen(false) {
+		initialize(logFile, numValues, dataNames);
+	} // ProfilingHelper
+
+	virtual ~ProfilingHelper() {
+		closeZone();
+		if (logFile.size() > 0)
+			Profiler::writeStatistics(logFile);
+	} // ~ProfilingHelper
+
+	virtual void start(Timer&) {
+		closeZone();
+		Profiler::markFrame();
+	} // start
 
-	virtual void start(Timer& timer);
-	virtual void dt(unsigned index, Timer& timer);
-	virtual void stop(Timer& timer);
+	virtual void dt(unsigned index, Timer&) {
+		closeZone();
+		if (index < names.size() && Profiler::isEnabled()) {
+			Profiler::beginZone(names[index]);
+			zoneOpen = true;
+		} // if
+	} // dt
+
+	virtual void stop(Timer&) {
+		closeZone();
+	} // stop
 
 protected:
-	FILE* logFile;
-	double lastTime;
-	int numValues;
-	double* data;
-	double sumValues;
+	std::string logFile;
+	std::vector<const char*> names;
+	bool zoneOpen;
 
 	virtual void initialize(std::string logFile, int numValues,
-			char** dataNames);
+			char** dataNames) {
+		int i;
+
+		this->logFile = logFile;
+		for (i = 0; i < numValues; i++)
+			names.push_back(Profiler::internName(dataNames[i]));
+	} // initialize
+
+	void closeZone() {
+		if (zoneOpen)
+			Profiler::endZone();
+		zoneOpen = false;
+	} // closeZone
 };
 
-#endif /* PROFILINGHELPER_H_ */
+#endif /* PHYSICS_PROFILINGHELPER_H_ */
@@ -172,3 +172,10 @@ void SynchronisationModel::setSimulationTime(unsigned simulationTime) {
 	else
 		printd(WARNING, "SynchronisationModel::setSimulationTime(): Physics module not set! Ignoring new simulationTime!\n");
 } // setSimulationTime
+
+void SynchronisationModel::getConnectedUsers(std::vector<unsigned>& dst) {
+	if (physics)
+		physics->getConnectedUsers(dst);
+	else
+		dst.clear();
+} // getConnectedUsers
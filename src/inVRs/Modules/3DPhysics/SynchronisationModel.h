@@ -151,13 +151,14 @@ protected:
 //	 */
 //	void getRigidBodiesForSync(PhysicsObjectInterface* obj, std::vector<RigidBody*>& rigidBodyList);
 	
-//	/** Stores all connected users in the passes vector.
-//	 * The method copies the vector of connected users from the Physics module
-//	 * to the passed vector.
-//	 * @param dst vector where the connected userIds should be stored in
-//	 */
-//	void getConnectedUsers(std::vector<unsigned>& dst);
-//
+	/** Stores all connected remote users in the passed vector.
+	 * The method copies the vector of connected users from the Physics module
+	 * to the passed vector. Unlike the UserDatabase it can be used from the
+	 * physics thread.
+	 * @param dst vector where the connected userIds should be stored in
+	 */
+	void getConnectedUsers(std::vector<unsigned>& dst);
+
 //	/** Returns the UserData of the user with the passed Id.
 //	 * @param userId Id of the user
 //	 * @return UserData of the user with the passed Id
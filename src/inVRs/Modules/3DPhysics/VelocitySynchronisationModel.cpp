@@ -56,6 +56,7 @@ VelocitySynchronisationModel::VelocitySynchronisationModel(float linearThreshold
 	this->convergenceTime = convergenceTime;
 	counter = new MessageSizeCounter(physics);
 	simulationStepSize = 0;
+	keyframeInterval = 0;
 	counter->setLogFileName("VelocitySyncModel.log");
 	usedSyncModel = VELOCITYSYNCHRONISATION_MESSAGEID;
 } // VelocitySynchronisationModel
@@ -81,6 +82,13 @@ VelocitySynchronisationModel::~VelocitySynchronisationModel()
 	linearConvMap.clear();
 } // ~VelocitySynchronisationModel
 
+void VelocitySynchronisationModel::setKeyframeInterval(unsigned keyframeInterval)
+{
+	this->keyframeInterval = keyframeInterval;
+	if (keyframeInterval == 0)
+		lastSendTime.clear();
+} // setKeyframeInterval
+
 //*******************************************************//
 // PUBLIC METHODS INHERITED FROM: SynchronisationModel: *//
 //*******************************************************//
@@ -132,14 +140,19 @@ void VelocitySynchronisationModel::synchroniseAfterStep()
 //	std::vector<PhysicsObjectInterface*> objects;
 	std::vector<RigidBody*> rigidBodies;
 	RigidBody* rigidBody;
+	uint64_t rigidBodyID;
 	unsigned simulationTime;
+	unsigned numberOfStates = 0;
+	bool inactive;
 
 	getLocalSimulatedRigidBodies(objectManager, rigidBodies);
 //	objectManager->getLocalSimulatedObjects(objects);
 
 	size = rigidBodies.size();
-	if (size <= 0)
+	if (size <= 0) {
+		lastSendTime.clear();
 		return;
+	} // if
 
 	simulationTime = physics->getSimulationTime();
 
@@ -150,22 +163,40 @@ void VelocitySynchronisationModel::synchroniseAfterStep()
 
 	for (i=0; i < size; i++) {
 		rigidBody = rigidBodies[i];
-		if (rigidBody->isFixed() || !rigidBody->isActive()) {
-			handleDeactivatedRigidBody(rigidBody, simulationTime, msg);
-			continue;
-		} // if
-		else
-			inactiveRepeatSend[rigidBody->getID()] = 3;
+		rigidBodyID = rigidBody->getID();
+		inactive = rigidBody->isFixed() || !rigidBody->isActive();
+		if (!inactive)
+			inactiveRepeatSend[rigidBodyID] = 3;
 
-		if (!isPredictionStillValid(rigidBody, simulationTime)) {
-			updatePredictionState(rigidBody, simulationTime);
+		if (isKeyframeDue(rigidBodyID, simulationTime)) {
+			updatePredictionState(rigidBody, simulationTime, inactive);
 			encodePredictionState(rigidBody, msg);
 		} // if
+		else if (inactive) {
+			if (!handleDeactivatedRigidBody(rigidBody, simulationTime, msg))
+				continue;
+		} // else if
+		else if (!isPredictionStillValid(rigidBody, simulationTime)) {
+			updatePredictionState(rigidBody, simulationTime);
+			encodePredictionState(rigidBody, msg);
+		} // else if
+		else
+			continue;
+
+		if (keyframeInterval > 0)
+			lastSendTime[rigidBodyID] = simulationTime;
+		numberOfStates++;
 	} // for
 
-	network->sendMessageUDP(msg, PHYSICS_MODULE_ID);
+	if (keyframeInterval > 0)
+		removeStaleSendTimes(rigidBodies);
+
+	// with keyframes the clients do not depend on a message every step
+	if (numberOfStates > 0 || keyframeInterval == 0) {
+		network->sendMessageUDP(msg, PHYSICS_MODULE_ID);
+		counter->countBytes(msg);
+	} // if
 
-	counter->countBytes(msg);
 	counter->stepFinished();
 
 	delete msg;
@@ -175,7 +206,7 @@ void VelocitySynchronisationModel::synchroniseAfterStep()
 // PROTECTED METHODS: //
 //********************//
 
-void VelocitySynchronisationModel::handleDeactivatedRigidBody(RigidBody* rigidBody,
+bool VelocitySynchronisationModel::handleDeactivatedRigidBody(RigidBody* rigidBody,
 		unsigned simulationTime, NetMessage* msg) {
 
 	std::map<uint64_t, int>::iterator it;
@@ -189,12 +220,51 @@ void VelocitySynchronisationModel::handleDeactivatedRigidBody(RigidBody* rigidBo
 	else if (it->second > 0)
 		inactiveRepeatSend[rigidBodyID] = it->second - 1;
 	else
-		return;
+		return false;
 
 	updatePredictionState(rigidBody, simulationTime, true);
 	encodePredictionState(rigidBody, msg);
+	return true;
 } // handleDeactivatedRigidBody
 
+void VelocitySynchronisationModel::removeStaleSendTimes(
+		std::vector<RigidBody*>& rigidBodies) {
+	std::set<uint64_t> ids;
+	std::map<uint64_t, unsigned>::iterator it;
+	unsigned i;
+
+	// every sent local rigid body has an entry, so additional entries belong
+	// to destroyed or no longer locally simulated rigid bodies
+	if (lastSendTime.size() <= rigidBodies.size())
+		return;
+
+	for (i = 0; i < rigidBodies.size(); i++)
+		ids.insert(rigidBodies[i]->getID());
+
+	it = lastSendTime.begin();
+	while (it != lastSendTime.end()) {
+		if (ids.find(it->first) == ids.end())
+			lastSendTime.erase(it++);
+		else
+			++it;
+	} // while
+} // removeStaleSendTimes
+
+bool VelocitySynchronisationModel::isKeyframeDue(uint64_t rigidBodyID,
+		unsigned simulationTime) {
+
+	std::map<uint64_t, unsigned>::iterator it;
+
+	if (keyframeInterval == 0)
+		return false;
+
+	it = lastSendTime.find(rigidBodyID);
+	if (it == lastSendTime.end())
+		return false;
+
+	return simulationTime - it->second >= keyframeInterval;
+} // isKeyframeDue
+
 bool VelocitySynchronisationModel::isPredictionStillValid(RigidBody* rigidBody,
 		unsigned simulationTime) {
 
@@ -68,6 +68,14 @@ public:
 	 */
 	virtual ~VelocitySynchronisationModel();
 
+	/** Sets the number of simulation steps after which a rigid body is sent
+	 * again even if its prediction is still valid or if it is resting, so that
+	 * clients recover from lost messages. If a keyframe interval is set steps
+	 * without changed rigid bodies are not sent at all. 0 (the default)
+	 * disables the keyframes.
+	 */
+	void setKeyframeInterval(unsigned keyframeInterval);
+
 //*******************************************************//
 // PUBLIC METHODS INHERITED FROM: SynchronisationModel: *//
 //*******************************************************//
@@ -117,8 +125,9 @@ protected:
 
 	/** Sends last rigid body states of deactivated objects multiple times to 
 	 * ensure the clients receive the correct values.
+	 * @return true if the state was added to the message
 	 */
-	void handleDeactivatedRigidBody(oops::RigidBody* rigidBody, 
+	bool handleDeactivatedRigidBody(oops::RigidBody* rigidBody, 
 			unsigned simulationTime, NetMessage* msg);
 	
 	/** Calculates the predicted transformation for the passed rigid body
@@ -128,6 +137,16 @@ protected:
 	virtual bool isPredictionStillValid(oops::RigidBody* rigidBody, 
 			unsigned simulationTime);
 
+	/** Returns if the last sent state of the rigid body is older than the
+	 * keyframe interval.
+	 */
+	bool isKeyframeDue(uint64_t rigidBodyID, unsigned simulationTime);
+
+	/** Removes the send times of rigid bodies which are not in the passed
+	 * list of local rigid bodies any more, e.g. because they were destroyed.
+	 */
+	void removeStaleSendTimes(std::vector<oops::RigidBody*>& rigidBodies);
+
 	/**
 	 */
 	virtual bool calculatePrediction(gmtl::Vec3f& newPos, gmtl::Quatf& newOri, 
@@ -179,6 +198,13 @@ protected:
 	unsigned lastUpdateTime;
 	
 	std::map<uint64_t, int> inactiveRepeatSend;
+
+	/// Simulation time when the state of each local rigid body was sent last,
+	/// only recorded if keyframes are enabled
+	std::map<uint64_t, unsigned> lastSendTime;
+
+	/// Number of simulation steps after which unchanged rigid bodies are sent again
+	unsigned keyframeInterval;
 	
 	std::map<uint64_t, RigidBodyState*> lastStateMap;
 
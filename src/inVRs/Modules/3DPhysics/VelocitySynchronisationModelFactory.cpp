@@ -42,6 +42,8 @@ SynchronisationModel* VelocitySynchronisationModelFactory::create(std::string cl
 	float angularThreshold = 0;
 	float convergenceTime = -1;
 	int convergenceAlgorithm = -1;
+	int keyframeInterval = 0;
+	VelocitySynchronisationModel* result;
 	
 	ArgumentVector* arguments = (ArgumentVector*)args;
 	
@@ -61,9 +63,21 @@ SynchronisationModel* VelocitySynchronisationModelFactory::create(std::string cl
 	if (arguments->keyExists("convergenceTime"))
 		arguments->get("convergenceTime", convergenceTime);
 	
+	if (arguments->keyExists("keyframeInterval"))
+		arguments->get("keyframeInterval", keyframeInterval);
+
 	if (convergenceAlgorithm < 0)
-		return new VelocitySynchronisationModel(linearThreshold, angularThreshold);
-	if (convergenceTime < 0)
-		return new VelocitySynchronisationModel(linearThreshold, angularThreshold, convergenceAlgorithm);
-	return new VelocitySynchronisationModel(linearThreshold, angularThreshold, convergenceAlgorithm, convergenceTime);
+		result = new VelocitySynchronisationModel(linearThreshold, angularThreshold);
+	else if (convergenceTime < 0)
+		result = new VelocitySynchronisationModel(linearThreshold, angularThreshold, convergenceAlgorithm);
+	else
+		result = new VelocitySynchronisationModel(linearThreshold, angularThreshold, convergenceAlgorithm, convergenceTime);
+
+	if (keyframeInterval < 0) {
+		printd(ERROR, "VelocitySynchronisationModelFactory::create(): invalid keyframeInterval %i found (must not be negative)!\n", keyframeInterval);
+		keyframeInterval = 0;
+	} // if
+	result->setKeyframeInterval(keyframeInterval);
+
+	return result;
 } // create
@@ -0,0 +1,141 @@
+#include <inVRs/Modules/3DPhysics/PhysicsSnapshotCodec.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static const unsigned NUM_BODIES = 500;
+static const unsigned NUM_CLIENTS = 4;
+static const unsigned MEASURED_UPDATES = 1000;
+static const float STEP_SIZE = 0.01f;
+// size of an uncompressed PhysicsFullSynchronisationModel message
+static const unsigned ABSOLUTE_HEADER_SIZE = 3 * 4;
+static const unsigned ABSOLUTE_BODY_SIZE = 8 + 13 * 4;
+// messageType, syncModel, simulationTime and userId of a delta message
+static const unsigned DELTA_HEADER_SIZE = 4 * 4;
+
+struct Client {
+	PhysicsSnapshotCodec codec;
+	unsigned received;
+};
+
+static float random(float min, float max) {
+	return min + (max - min) * (rand() / (float)RAND_MAX);
+}
+
+/** Stores the state of all bodies at the passed step in the snapshot. Every
+ * movingEvery-th body moves on a circle and rotates, the others rest. The
+ * last body is removed and added again every 100 steps.
+ */
+static void createSnapshot(PhysicsSnapshotCodec& codec, unsigned step, unsigned movingEvery,
+		PhysicsSnapshotCodec::Snapshot& snapshot) {
+	TransformationData trans = identityTransformation();
+	gmtl::Vec3f linearVel, angularVel;
+	float time = step * STEP_SIZE;
+
+	snapshot.clear();
+	for (unsigned i = 0; i < NUM_BODIES; i++) {
+		if (i == NUM_BODIES - 1 && (step / 100) % 2)
+			continue;
+		trans.position = gmtl::Vec3f((float)(i % 25), 0.5f, (float)(i / 25));
+		trans.orientation = gmtl::Quatf(0, 0, 0, 1);
+		linearVel = gmtl::Vec3f(0, 0, 0);
+		angularVel = gmtl::Vec3f(0, 0, 0);
+		if (i % movingEvery == 0) {
+			float angle = time + i;
+			trans.position += gmtl::Vec3f(cosf(angle), 0, sinf(angle));
+			trans.orientation = gmtl::Quatf(0, sinf(angle / 2), 0, cosf(angle / 2));
+			linearVel = gmtl::Vec3f(-sinf(angle), 0, cosf(angle));
+			angularVel = gmtl::Vec3f(0, 1, 0);
+		} // if
+		codec.quantize(trans, linearVel, angularVel, snapshot[i + 1]);
+	} // for
+}
+
+/** Runs the server and the clients in a loopback with the passed loss rate
+ * for the snapshots and the acknowledgements.
+ * @return false if a client reconstructed a snapshot which differs from the
+ * one of the server
+ */
+static bool run(unsigned movingEvery, float loss, double& absoluteBytes, double& deltaBytes,
+		double& fullRatio, double& receivedRatio) {
+	PhysicsSnapshotCodec server;
+	std::vector<Client*> clients;
+	PhysicsSnapshotCodec::Snapshot snapshot, decoded;
+	unsigned long bytes = 0, fullSnapshots = 0, sent = 0, received = 0;
+	bool identical = true;
+	unsigned step, c;
+
+	srand(1);
+	for (c = 0; c < NUM_CLIENTS; c++)
+		clients.push_back(new Client);
+
+	for (step = 1; step <= MEASURED_UPDATES; step++) {
+		createSnapshot(server, step, movingEvery, snapshot);
+		server.addSnapshot(step, snapshot);
+
+		for (c = 0; c < NUM_CLIENTS; c++) {
+			NetMessage msg;
+			if (!server.encode(step, c, &msg))
+				fullSnapshots++;
+			bytes += DELTA_HEADER_SIZE + msg.getBufferSize();
+			sent++;
+
+			if (random(0, 1) < loss)
+				continue;
+			if (!clients[c]->codec.decode(step, &msg, decoded))
+				continue;
+			received++;
+			if (decoded != snapshot)
+				identical = false;
+
+			if (random(0, 1) >= loss)
+				server.acknowledge(c, step);
+		} // for
+	} // for
+
+	absoluteBytes = (double)(ABSOLUTE_HEADER_SIZE + NUM_BODIES * ABSOLUTE_BODY_SIZE);
+	deltaBytes = (double)bytes / sent;
+	fullRatio = (double)fullSnapshots / sent;
+	receivedRatio = (double)received / sent;
+
+	for (c = 0; c < NUM_CLIENTS; c++)
+		delete clients[c];
+	return identical;
+}
+
+/** Headless loopback harness for the delta compression of the
+ * PhysicsFullSynchronisationModel. A server sends the snapshots of resting and
+ * moving rigid bodies to several clients while snapshots and acknowledgements
+ * get lost. Reports the bytes per client and update compared to the
+ * uncompressed messages and checks that every decoded snapshot matches the
+ * snapshot of the server exactly.
+ */
+int main() {
+	static const unsigned movingEvery[] = {1, 10, 100};
+	static const float lossRates[] = {0, 0.1f, 0.3f};
+	double absoluteBytes, deltaBytes, fullRatio, receivedRatio;
+	bool identical = true;
+
+	printf("%u bodies, %u clients, %u updates\n", NUM_BODIES, NUM_CLIENTS, MEASURED_UPDATES);
+	printf("%8s %6s %16s %16s %10s %10s %10s %10s\n", "moving", "loss", "absolute [B]",
+			"delta [B]", "ratio", "full", "decoded", "identical");
+	for (unsigned m = 0; m < sizeof(movingEvery) / sizeof(movingEvery[0]); m++) {
+		for (unsigned l = 0; l < sizeof(lossRates) / sizeof(lossRates[0]); l++) {
+			bool same = run(movingEvery[m], lossRates[l], absoluteBytes, deltaBytes,
+					fullRatio, receivedRatio);
+			identical = identical && same;
+			printf("%7.0f%% %5.0f%% %16.0f %16.1f %10.1f %9.1f%% %9.1f%% %10s\n",
+					100.0 / movingEvery[m], lossRates[l] * 100, absoluteBytes, deltaBytes,
+					absoluteBytes / deltaBytes, fullRatio * 100, receivedRatio * 100,
+					same ? "yes" : "NO");
+		} // for
+	} // for
+
+	if (!identical) {
+		printf("ERROR: a client reconstructed a different snapshot!\n");
+		return 1;
+	} // if
+	return 0;
+}
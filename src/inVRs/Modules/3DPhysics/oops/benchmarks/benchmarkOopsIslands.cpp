@@ -0,0 +1,125 @@
+#include <OpenSG/OSGConfig.h>
+#if OSG_MAJOR_VERSION >= 2
+#include <OpenSG/OSGBaseInitFunctions.h>
+#else
+#include <OpenSG/OSGBaseFunctions.h>
+#endif
+#include <oops/Simulation.h>
+#include <oops/RigidBody.h>
+#include <oops/Geometries.h>
+
+#include <inVRs/SystemCore/Timer.h>
+#include <inVRs/SystemCore/WorkerPool.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+OSG_USING_NAMESPACE
+
+static const unsigned NUM_STACKS = 64;
+static const unsigned STACK_HEIGHT = 8;
+static const float BOX_SIZE = 1.f;
+static const unsigned SETTLE_STEPS = 50;
+static const unsigned MEASURED_STEPS = 200;
+static const float STEP_SIZE = 0.01f;
+
+/** Runs the scene with the passed number of island threads and stores the
+ * final position and orientation of all boxes in result.
+ * @return time per step in seconds
+ */
+static double run(unsigned numberOfThreads, std::vector<float>& result, unsigned& islands) {
+	oops::Simulation simulation;
+	std::vector<oops::RigidBody*> bodies;
+	TransformationData trans = identityTransformation();
+	unsigned i, j, k;
+	uint64_t id = 1;
+
+	simulation.setGravity(gmtl::Vec3f(0, -9.81f, 0));
+	simulation.setStepFunction(oops::Simulation::STEPFUNCTION_STEP);
+	simulation.setStepSize(STEP_SIZE);
+	// stacks must not fall asleep, otherwise there is nothing left to measure
+	simulation.setGlobalAutoDisable(false);
+	simulation.setNumberOfThreads(numberOfThreads);
+
+	oops::RigidBody* ground = new oops::RigidBody(new oops::Plane(gmtl::Vec3f(0, 1, 0), 0));
+	ground->setID(id++);
+	simulation.addRigidBody(ground);
+	bodies.push_back(ground);
+
+	// the stacks only touch the ground, so every stack is an island of its own
+	for (i = 0; i < NUM_STACKS; i++) {
+		for (j = 0; j < STACK_HEIGHT; j++) {
+			oops::RigidBody* body = new oops::RigidBody(new oops::Box(gmtl::Vec3f(BOX_SIZE,
+					BOX_SIZE, BOX_SIZE)));
+			trans.position = gmtl::Vec3f((i % 8) * 3 * BOX_SIZE + 0.05f * j,
+					(j + 0.5f) * BOX_SIZE * 1.001f, (i / 8) * 3 * BOX_SIZE);
+			body->setTransformation(trans);
+			body->setMass(1);
+			body->setID(id++);
+			simulation.addRigidBody(body);
+			bodies.push_back(body);
+		} // for
+	} // for
+
+	for (i = 0; i < SETTLE_STEPS; i++)
+		simulation.step(STEP_SIZE);
+
+	double start = inVRsUtilities::Timer::getMonotonicTime();
+	for (i = 0; i < MEASURED_STEPS; i++)
+		simulation.step(STEP_SIZE);
+	double time = inVRsUtilities::Timer::getMonotonicTime() - start;
+	islands = simulation.getNumberOfIslands();
+
+	result.clear();
+	for (i = 1; i < bodies.size(); i++) {
+		trans = bodies[i]->getTransformation();
+		for (k = 0; k < 3; k++)
+			result.push_back(trans.position[k]);
+		for (k = 0; k < 4; k++)
+			result.push_back(trans.orientation[k]);
+	} // for
+
+	for (i = 0; i < bodies.size(); i++) {
+		simulation.removeRigidBody(bodies[i]);
+		delete bodies[i];
+	} // for
+	return time / MEASURED_STEPS;
+}
+
+/** Headless benchmark for the parallel stepping of the islands of
+ * oops::Simulation. Independent stacks of boxes are simulated with an
+ * increasing number of island threads (0 uses dWorldStep of ODE). Reports the
+ * time per step and the speedup and checks that every run ends in exactly the
+ * same state as the serial simulation.
+ */
+int main(int argc, char **argv) {
+	std::vector<float> reference, result;
+	unsigned threads, islands;
+	unsigned maxThreads = WorkerPool::getDefaultNumberOfThreads();
+	bool identical = true;
+
+	osgInit(argc, argv);
+
+	printf("%u boxes in %u stacks, %u steps\n", NUM_STACKS * STACK_HEIGHT, NUM_STACKS,
+			MEASURED_STEPS);
+	printf("%8s %8s %20s %10s %10s\n", "threads", "islands", "time per step [ms]", "speedup",
+			"identical");
+	double serialTime = run(0, reference, islands);
+	printf("%8s %8s %20.3f %10.2f %10s\n", "serial", "-", serialTime * 1e3, 1.0, "yes");
+
+	for (threads = 1; threads <= maxThreads; threads++) {
+		double time = run(threads, result, islands);
+		bool same = result.size() == reference.size() && memcmp(&result[0], &reference[0],
+				result.size() * sizeof(float)) == 0;
+		identical = identical && same;
+		printf("%8u %8u %20.3f %10.2f %10s\n", threads, islands, time * 1e3, serialTime / time,
+				same ? "yes" : "NO");
+	} // for
+
+	if (!identical) {
+		printf("ERROR: parallel stepping changed the result of the simulation!\n");
+		return 1;
+	} // if
+	return 0;
+}
@@ -0,0 +1,125 @@
+#include <oops/Simulation.h>
+#include <oops/RigidBody.h>
+#include <oops/Geometries.h>
+
+#include <inVRs/SystemCore/Timer.h>
+
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static const unsigned NUM_TOWERS = 10;
+static const unsigned TOWER_HEIGHT = 10;
+static const float BOX_SIZE = 1.f;
+static const unsigned SETTLE_STEPS = 100;
+static const unsigned MEASURED_STEPS = 1000;
+static const float STEP_SIZE = 0.01f;
+
+// counts the C++ heap allocations while counting is true (allocations of
+// ODE itself use malloc and are not counted)
+static bool counting = false;
+static unsigned long allocations = 0;
+
+// dynamic exception specifications are deprecated since C++11, operator new
+// gets none and operator delete the matching non-throwing one
+#if __cplusplus >= 201103L
+#define BENCHMARK_NOTHROW noexcept
+#else
+#define BENCHMARK_NOTHROW throw ()
+#endif
+
+void* operator new(size_t size) {
+	if (counting)
+		allocations++;
+	void* result = malloc(size ? size : 1);
+	if (!result)
+		throw std::bad_alloc();
+	return result;
+} // operator new
+
+void* operator new[](size_t size) {
+	return operator new(size);
+} // operator new[]
+
+void operator delete(void* ptr) BENCHMARK_NOTHROW {
+	free(ptr);
+} // operator delete
+
+void operator delete[](void* ptr) BENCHMARK_NOTHROW {
+	free(ptr);
+} // operator delete[]
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void* ptr, size_t) noexcept {
+	free(ptr);
+} // operator delete
+
+void operator delete[](void* ptr, size_t) noexcept {
+	free(ptr);
+} // operator delete[]
+#endif
+
+/** Headless benchmark for the contact generation of oops::Simulation.
+ * Towers of boxes stand on a ground plane, so that every step generates the
+ * contacts of a resting stack. Reports the steps and contacts per second and
+ * the number of heap allocations per step.
+ */
+int main() {
+	oops::Simulation simulation;
+	std::vector<oops::RigidBody*> bodies;
+	TransformationData trans = identityTransformation();
+	unsigned i, j, contacts = 0, pairs = 0;
+	uint64_t id = 1;
+
+	simulation.setGravity(gmtl::Vec3f(0, -9.81f, 0));
+	simulation.setStepFunction(oops::Simulation::STEPFUNCTION_QUICKSTEP);
+	simulation.setStepSize(STEP_SIZE);
+
+	oops::RigidBody* ground = new oops::RigidBody(new oops::Plane(gmtl::Vec3f(0, 1, 0), 0));
+	ground->setID(id++);
+	simulation.addRigidBody(ground);
+	bodies.push_back(ground);
+
+	for (i = 0; i < NUM_TOWERS; i++) {
+		for (j = 0; j < TOWER_HEIGHT; j++) {
+			oops::Geometry* box = new oops::Box(gmtl::Vec3f(BOX_SIZE, BOX_SIZE, BOX_SIZE));
+			box->setMaterial(j % 2 ? oops::materials::WOOD : oops::materials::STEEL);
+			oops::RigidBody* body = new oops::RigidBody(box);
+			trans.position = gmtl::Vec3f(i * 3 * BOX_SIZE, (j + 0.5f) * BOX_SIZE * 1.001f, 0);
+			body->setTransformation(trans);
+			body->setMass(1);
+			body->setID(id++);
+			simulation.addRigidBody(body);
+			bodies.push_back(body);
+		} // for
+	} // for
+
+	for (i = 0; i < SETTLE_STEPS; i++)
+		simulation.step(STEP_SIZE);
+
+	allocations = 0;
+	counting = true;
+	double start = inVRsUtilities::Timer::getMonotonicTime();
+	for (i = 0; i < MEASURED_STEPS; i++) {
+		simulation.step(STEP_SIZE);
+		contacts += simulation.getNumberOfContacts();
+		pairs += simulation.getNumberOfCollidingPairs();
+	} // for
+	double time = inVRsUtilities::Timer::getMonotonicTime() - start;
+	counting = false;
+
+	printf("%u boxes in %u towers, %u steps\n", NUM_TOWERS * TOWER_HEIGHT, NUM_TOWERS,
+			MEASURED_STEPS);
+	printf("%28s %12.3f\n", "time per step [ms]", time * 1e3 / MEASURED_STEPS);
+	printf("%28s %12.1f\n", "contacts per step", (double)contacts / MEASURED_STEPS);
+	printf("%28s %12.1f\n", "colliding pairs per step", (double)pairs / MEASURED_STEPS);
+	printf("%28s %12.0f\n", "contacts per second", contacts / time);
+	printf("%28s %12.2f\n", "allocations per step", (double)allocations / MEASURED_STEPS);
+
+	for (i = 0; i < bodies.size(); i++) {
+		simulation.removeRigidBody(bodies[i]);
+		delete bodies[i];
+	} // for
+	return 0;
+}
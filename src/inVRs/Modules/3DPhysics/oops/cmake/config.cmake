@@ -14,6 +14,15 @@ endif()
 # -> add compiled header file
 configure_file( "${CMAKE_CURRENT_LIST_DIR}/oops-include-ode-joint.h.in" "${CMAKE_CURRENT_BINARY_DIR}/include/oops/odeJoints/oops-include-ode-joint.h" @ONLY)
 
+# ODE-internal island stepper, used by Simulation to step the islands in parallel
+set ( ODESOURCEPATH_UTIL_H "${ODE_SOURCE_DIR}/ode/src/util.h" )
+set ( ODESOURCEPATH_STEP_H "${ODE_SOURCE_DIR}/ode/src/step.h" )
+set ( ODESOURCEPATH_COLLISION_KERNEL_H "${ODE_SOURCE_DIR}/ode/src/collision_kernel.h" )
+if ( NOT EXISTS "${ODESOURCEPATH_UTIL_H}" OR NOT EXISTS "${ODESOURCEPATH_STEP_H}" OR NOT EXISTS "${ODESOURCEPATH_COLLISION_KERNEL_H}" )
+	message( FATAL_ERROR "Could not find util.h, step.h and collision_kernel.h in the ODE source directory!" )
+endif()
+configure_file( "${CMAKE_CURRENT_LIST_DIR}/oops-include-ode-step.h.in" "${CMAKE_CURRENT_BINARY_DIR}/include/oops/oops-include-ode-step.h" @ONLY)
+
 set (OOPS_CONFIG_CMAKE_LOADED ON)
 endif (NOT OOPS_CONFIG_CMAKE_LOADED)
 
@@ -101,6 +101,25 @@ MATERIAL getMaterial(std::string name);
 
 float getFriction(materials::MATERIAL mat1, materials::MATERIAL mat2);
 
+/**
+ * Result of getFriction() for all pairs of materials, indexed by the material
+ * ids. Used by the Simulation for every contact, where the search in the
+ * triangular FRICTION matrix is too expensive.
+ */
+class FrictionTable
+{
+public:
+	FrictionTable();
+
+	float getFriction(materials::MATERIAL mat1, materials::MATERIAL mat2) const
+	{
+		return table[mat1][mat2];
+	} // getFriction
+
+private:
+	float table[N_MATERIALS + 1][N_MATERIALS + 1];
+}; // FrictionTable
+
 } // oops
 
 #endif // _FRICTIONVALUES_H
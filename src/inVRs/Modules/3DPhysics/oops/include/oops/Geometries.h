@@ -52,6 +52,8 @@ namespace oops {
 class RigidBody;
 class HeightFieldLoader;
 class TriangleMeshLoader;
+class TriangleMeshCache;
+struct CookedTriangleMesh;
 
 //*****************************************************************************
 
@@ -264,9 +266,17 @@ protected:
 
 	TriangleMeshData* data;
 	dTriMeshDataID meshData;
+	CookedTriangleMesh* cookedMesh;
 
 public:
 	TriangleMesh(TriangleMeshLoader* loader, std::string fileName);
+	/**
+	 * Uses the cooked mesh data from the passed cache if available, otherwise
+	 * the mesh is loaded via the loader and added to the cache. The vertices
+	 * of the mesh are transformed by the passed transformation.
+	 */
+	TriangleMesh(TriangleMeshCache* cache, TriangleMeshLoader* loader,
+			std::string fileName, const TransformationData& trans);
 	virtual ~TriangleMesh();
 	virtual Geometry* clone();
 
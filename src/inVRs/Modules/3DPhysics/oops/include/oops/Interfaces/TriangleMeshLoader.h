@@ -49,6 +49,11 @@ class TriangleMeshLoader
 public:
 	virtual ~TriangleMeshLoader() {};
 	virtual void loadMesh(std::string fileName, TriangleMesh* object) = 0;
+	/**
+	 * Returns the path under which the loader finds the passed file, used to
+	 * check the modification time of the file for the disk cache.
+	 */
+	virtual std::string findFile(std::string fileName) { return fileName; };
 }; // TriangleMeshLoader
 
 } // oops
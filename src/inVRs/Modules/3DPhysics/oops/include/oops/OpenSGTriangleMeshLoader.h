@@ -52,6 +52,7 @@ protected:
 public:
 	virtual ~OpenSGTriangleMeshLoader();
 	virtual void loadMesh(std::string fileName, TriangleMesh* object);
+	virtual std::string findFile(std::string fileName);
 }; // OpenSGTriangleMeshLoader
 
 } // oops
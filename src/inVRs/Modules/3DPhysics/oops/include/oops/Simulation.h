@@ -43,6 +43,7 @@
 #include <string>
 #include <gmtl/Math.h>
 #include <gmtl/Vec.h>
+#include "FrictionValues.h"
 
 #ifndef WIN32
   #include <stdint.h>
@@ -51,6 +52,7 @@
 #endif
 
 class NetMessage;
+class WorkerPool;
 
 // Object Oriented Physics Simulation
 namespace oops
@@ -97,6 +99,13 @@ public:
 		STEPFUNCTION_STEPFAST1
 	}; // STEPFUNCTION
 
+	// Enumeration used to distinguish between the broadphase collision spaces
+	enum SPACETYPE
+	{
+		SPACETYPE_HASH,
+		SPACETYPE_QUADTREE
+	}; // SPACETYPE
+
 public:
 	Simulation();
 	~Simulation();
@@ -114,6 +123,18 @@ public:
 	void setAutoDisableAngularThreshold(float threshold);
 	void setAutoDisableTime(float time);
 
+	// the space can only be changed as long as no objects are added; the
+	// center, extents and depth are only used by the quadtree space (ODE
+	// subdivides the quadtree along the x- and y-axis)
+	bool setSpaceType(SPACETYPE type, gmtl::Vec3f center = gmtl::Vec3f(0, 0, 0),
+		gmtl::Vec3f extents = gmtl::Vec3f(1000, 1000, 1000), int depth = 6);
+
+	// the islands of the world (bodies connected by joints or contacts) are
+	// stepped in parallel by the passed number of additional threads; only
+	// used by STEPFUNCTION_STEP, the result is the same as with dWorldStep
+	// for every number of threads
+	void setNumberOfThreads(unsigned numberOfThreads);
+
 	// method to activate or deactivate rendering of objects
 	void setObjectsVisible(bool visible);
 
@@ -125,6 +146,12 @@ public:
 	gmtl::Vec3f getGravity();
 	float getStepSize();
 
+	// statistics of the collision detection of the last step
+	unsigned getNumberOfContacts();
+	unsigned getNumberOfCollidingPairs();
+	// only counted if the islands are stepped in parallel
+	unsigned getNumberOfIslands();
+
 	// methods to add or remove SimulationObjects from the Simulation
 	bool addRigidBody(RigidBody* obj);
 	bool addJoint(Joint* joint);
@@ -185,6 +212,37 @@ private:
 	std::map<uint64_t, ArticulatedBody*>		articulatedBodyMap;
 	std::vector<CollisionListenerInterface*>	collisionListenerList;
 
+	// maximum number of contacts generated for a pair of geometries
+	static const int							MAX_CONTACTS = 10;
+
+	// scratch buffers of checkCollision, reused for all geometry pairs so
+	// that the collision detection does not allocate memory
+	dContact									contactBuffer[MAX_CONTACTS];
+	std::vector<ContactData>					contactList;
+	FrictionTable								frictionTable;
+	unsigned									numberOfContacts;
+	unsigned									numberOfCollidingPairs;
+
+	// islands of the last step, the bodies and joints of an island are
+	// stored consecutively in islandBodies and islandJoints
+	struct Island
+	{
+		unsigned firstBody, numberOfBodies;
+		unsigned firstJoint, numberOfJoints;
+	}; // Island
+	WorkerPool*									workerPool;
+	std::vector<Island>							islands;
+	// pairs of island size and index, the largest islands are started first
+	std::vector<std::pair<unsigned, unsigned> >	islandOrder;
+	std::vector<dBodyID>						islandBodies;
+	std::vector<dGeomID>						islandGeoms;
+	std::vector<dJointID>						islandJoints;
+	std::vector<dBodyID>						islandStack;
+	float										islandStepSize;
+
+	void stepIslands(float dt);
+	static void stepIslandTask(unsigned taskIndex, void* userData);
+
 	// internal methods used by simulation loop
 	void applyObjectForces();
 	void updatePosAndRot();
@@ -0,0 +1,153 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                Changes                                    *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+\*---------------------------------------------------------------------------*/
+
+
+#ifndef _TRIANGLEMESHCACHE_H
+#define _TRIANGLEMESHCACHE_H
+
+#include <map>
+#include <string>
+#include "Geometries.h"
+
+// Object Oriented Physics Simulation
+namespace oops
+{
+
+class TriangleMeshCache;
+
+/**
+ * Collision data of a triangle mesh which is ready to be used by ODE.
+ * The vertices are already transformed (and welded if enabled) and the ODE
+ * TriMeshData is built. A CookedTriangleMesh is reference counted and shared between all
+ * TriangleMesh geometries which were loaded from the same file with the same
+ * transformation.
+ */
+struct CookedTriangleMesh {
+	std::string key;
+	TriangleMeshData* data;
+	dTriMeshDataID meshData;
+	int refCount;
+	TriangleMeshCache* cache;
+	// memory mapped cache file (NULL if data was cooked in memory)
+	void* mappedFile;
+	size_t mappedSize;
+}; // CookedTriangleMesh
+
+/**
+ * Cache for cooked triangle meshes.
+ * Meshes are looked up by file name and transformation. If a mesh is not in
+ * memory the cache tries to map a previously written cache file from the
+ * disk cache directory (if set). Only if this fails the mesh has to be
+ * loaded via a TriangleMeshLoader and cooked. Newly cooked meshes are written
+ * to the disk cache directory so that they can be mapped on later runs.
+ */
+class TriangleMeshCache
+{
+public:
+	TriangleMeshCache();
+	virtual ~TriangleMeshCache();
+
+	/**
+	 * Returns the cooked mesh for the passed file and transformation if it is
+	 * either in memory or in the disk cache. The reference count of the
+	 * returned mesh is increased.
+	 * @return cooked mesh or NULL if the mesh has to be loaded
+	 */
+	CookedTriangleMesh* lookup(std::string fileName, const TransformationData& trans);
+
+	/**
+	 * Cooks the passed raw mesh data, adds it to the cache and writes it to
+	 * the disk cache directory (if set). The cache takes ownership of the raw
+	 * data. The reference count of the returned mesh is increased.
+	 */
+	CookedTriangleMesh* insert(std::string fileName, const TransformationData& trans,
+			TriangleMeshData* rawData);
+
+	/**
+	 * Sets the directory where cache files are written to and read from. An
+	 * empty string disables the disk cache (default).
+	 */
+	void setDiskCacheDirectory(std::string directory);
+	std::string getDiskCacheDirectory();
+
+	/**
+	 * Sets the distance below which vertices are merged when cooking a mesh.
+	 * A tolerance of 0 disables welding (default).
+	 */
+	void setWeldTolerance(float tolerance);
+	float getWeldTolerance();
+
+	/**
+	 * If enabled the triangle normals are calculated from the cooked
+	 * vertices instead of using the normals of the loader (default false).
+	 */
+	void setRecomputeNormals(bool recompute);
+	bool getRecomputeNormals();
+
+	int getNumberOfCachedMeshes();
+
+	/**
+	 * Transforms the passed raw mesh data and builds the ODE TriMeshData.
+	 * Vertices are only welded if weldTolerance is greater than 0, normals are
+	 * only recalculated if recomputeNormals is set. The raw data is deleted.
+	 * The returned mesh does not belong to any cache and has a reference count
+	 * of 1.
+	 */
+	static CookedTriangleMesh* cook(TriangleMeshData* rawData,
+			const TransformationData& trans, float weldTolerance, bool recomputeNormals);
+
+	static CookedTriangleMesh* addReference(CookedTriangleMesh* mesh);
+	static void release(CookedTriangleMesh* mesh);
+
+	static void deleteTriangleMeshData(TriangleMeshData* data);
+
+protected:
+	std::string createKey(std::string fileName, const TransformationData& trans);
+	std::string getCacheFileName(std::string key);
+
+	CookedTriangleMesh* readCacheFile(std::string fileName, std::string key);
+	bool writeCacheFile(std::string fileName, CookedTriangleMesh* mesh);
+
+	static void buildODEData(CookedTriangleMesh* mesh);
+
+	std::map<std::string, CookedTriangleMesh*> meshMap;
+	std::string diskCacheDirectory;
+	float weldTolerance;
+	bool recomputeNormals;
+}; // TriangleMeshCache
+
+} // oops
+
+#endif // _TRIANGLEMESHCACHE_H
@@ -44,6 +44,7 @@
 #include "Interfaces/RendererFactory.h"
 #include "Interfaces/TriangleMeshLoader.h"
 #include "Interfaces/HeightFieldLoader.h"
+#include "TriangleMeshCache.h"
 #include "RigidBody.h"
 #include "ArticulatedBody.h"
 
@@ -95,6 +96,9 @@ public:
 	TriangleMeshLoader* getTriangleMeshLoader();
 	HeightFieldLoader* getHeightFieldLoader();
 
+	// cache for triangle meshes, shared by all TriangleMeshes loaded via this loader
+	TriangleMeshCache* getTriangleMeshCache();
+
 protected:
 
 //	RigidBody* loadRigidBody(std::string className, IrrXMLReader* xml);
@@ -120,6 +124,7 @@ protected:
 	RendererFactory* rendererFactory;
 	TriangleMeshLoader* triMeshLoader;
 	HeightFieldLoader* heightFieldLoader;
+	TriangleMeshCache* triMeshCache;
 
 }; // XMLLoader
 
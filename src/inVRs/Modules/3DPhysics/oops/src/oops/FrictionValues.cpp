@@ -117,4 +117,15 @@ float getFriction(materials::MATERIAL mat1, materials::MATERIAL mat2)
 	return result;
 } // getFriction
 
+FrictionTable::FrictionTable()
+{
+	int i, j;
+
+	for (i = 0; i <= N_MATERIALS; i++)
+	{
+		for (j = 0; j <= N_MATERIALS; j++)
+			table[i][j] = oops::getFriction((materials::MATERIAL)i, (materials::MATERIAL)j);
+	} // for
+} // FrictionTable
+
 } // oops
@@ -29,6 +29,7 @@
 #include "oops/Simulation.h"
 #include "oops/RigidBody.h"
 #include "oops/Interfaces/TriangleMeshLoader.h"
+#include "oops/TriangleMeshCache.h"
 #include "oops/OopsMath.h"
 #include "oops/Interfaces/HeightFieldLoader.h"
 #include <gmtl/Generate.h>
@@ -360,11 +361,15 @@ CompositeGeometry::CompositeGeometry(const std::vector<CompositeGeometryComponen
 	for (i=0; i < (int)geoms.size(); i++)
 		geometryList.push_back(geoms[i]);
 
+	geometryTransforms = NULL;
 	geometryOffsetsCorrected = false;
 } // CompositeGeometry
 
 CompositeGeometry::~CompositeGeometry()
 {
+	// the transforms reference the ODE geometries of the sub geometries
+	if (geometryTransforms)
+		destroy();
 	for (int i=0; i < (int)geometryList.size(); i++) {
 		delete geometryList[i]->geometry;
 		delete geometryList[i];
@@ -484,11 +489,13 @@ void CompositeGeometry::correctGeometryOffsets()
 	} // if
 
 	// STEP 6: delete temporary geometries and free reserved memory
+	// the transform destroys the ODE geometry of the sub geometry, which may
+	// still reference data of the sub geometry (e.g. the TriMeshData)
 	for (int i=0; i < (int)tempGeometryList.size(); i++) {
-		delete tempGeometryList[i]->geometry;
-		delete tempGeometryList[i];
 		dGeomDestroy(tempGeometryTransforms[i]);
 		tempGeometryTransforms[i] = 0;
+		delete tempGeometryList[i]->geometry;
+		delete tempGeometryList[i];
 	} // for
 	tempGeometryList.clear();
 	delete[] tempGeometryTransforms;
@@ -603,6 +610,7 @@ void CompositeGeometry::destroy()
 		geometryTransforms[i] = 0;
 	} // for
 	delete[] geometryTransforms;
+	geometryTransforms = NULL;
 
 	if (geom && !isPartOfComposite) {
 		dGeomDestroy(geom);
@@ -683,44 +691,36 @@ dMass& HeightField::setMass(float mass, dMass& m)
 TriangleMesh::TriangleMesh(TriangleMeshLoader* loader,
 	std::string fileName)
 {
+	data = NULL;
 	loader->loadMesh(fileName, this);
-	meshData = dGeomTriMeshDataCreate();
-
-	dGeomTriMeshDataBuildSimple(meshData, (dReal*)data->vertices, data->nVertices,
-		(int*)data->triangles, data->nTriangles*3);
-//  	dGeomTriMeshDataBuildSimple1(meshData, (dReal*)data->vertices, data->nVertices,
-//  		(int*)data->triangles, data->nTriangles*3, (int*)data->normals);
+	cookedMesh = TriangleMeshCache::cook(data, identityTransformation(),
+		0, false);
+	data = cookedMesh->data;
+	meshData = cookedMesh->meshData;
 } // TriangleMesh
 
-TriangleMesh::TriangleMesh(TriangleMesh* src)
+TriangleMesh::TriangleMesh(TriangleMeshCache* cache, TriangleMeshLoader* loader,
+	std::string fileName, const TransformationData& trans)
 {
-	int i;
-
-	this->data = new TriangleMeshData;
-	this->data->nTriangles = src->data->nTriangles;
-	this->data->nVertices = src->data->nVertices;
-	this->data->vertices = new dVector3[data->nVertices];
-	this->data->triangles = new TriMeshTriangle[data->nTriangles];
-	this->data->normals = new dVector3[data->nTriangles];
-
-	for (i=0; i < (int)data->nVertices; i++)
+	data = NULL;
+	// the resolved path is needed to check the modification time of the file
+	fileName = loader->findFile(fileName);
+	cookedMesh = cache->lookup(fileName, trans);
+	if (!cookedMesh)
 	{
-		this->data->vertices[i][0] = src->data->vertices[i][0];
-		this->data->vertices[i][1] = src->data->vertices[i][1];
-		this->data->vertices[i][2] = src->data->vertices[i][2];
-	} // for
-
-	for (i=0; i < (int)data->nTriangles; i++)
-	{
-		this->data->triangles[i] = src->data->triangles[i];
-		this->data->normals[i][0] = src->data->normals[i][0];
-		this->data->normals[i][1] = src->data->normals[i][1];
-		this->data->normals[i][2] = src->data->normals[i][2];
-	} // for
+		loader->loadMesh(fileName, this);
+		cookedMesh = cache->insert(fileName, trans, data);
+	} // if
+	data = cookedMesh->data;
+	meshData = cookedMesh->meshData;
+} // TriangleMesh
 
-	meshData = dGeomTriMeshDataCreate();
-	dGeomTriMeshDataBuildSimple(meshData, (dReal*)data->vertices, data->nVertices,
-		(int*)data->triangles, data->nTriangles*3);
+TriangleMesh::TriangleMesh(TriangleMesh* src)
+{
+	// cooked mesh data is read-only and can therefore be shared with the clone
+	cookedMesh = TriangleMeshCache::addReference(src->cookedMesh);
+	data = cookedMesh->data;
+	meshData = cookedMesh->meshData;
 } // TriangleMesh
 
 Geometry* TriangleMesh::clone()
@@ -741,10 +741,9 @@ void TriangleMesh::build(dSpaceID space)
 
 TriangleMesh::~TriangleMesh()
 {
-	delete[] data->vertices;
-	delete[] data->triangles;
-	delete[] data->normals;
-	delete data;
+	// the ODE geometry has to be destroyed before the shared TriMeshData
+	Geometry::destroy();
+	TriangleMeshCache::release(cookedMesh);
 } // TriangleMesh
 
 void TriangleMesh::setData(TriangleMeshData* data)
@@ -305,6 +305,7 @@ Geometry* TriangleMeshFactory::create(std::string className, const XmlElement* e
 
 	TriangleMeshLoader* triangleMeshLoader = xmlLoader->getTriangleMeshLoader();
 	std::string fileName = "";
+	TransformationData meshTransformation = identityTransformation();
 	TriangleMesh* result= NULL;
 
 	// check for TriangleMeshLoader
@@ -316,7 +317,13 @@ Geometry* TriangleMeshFactory::create(std::string className, const XmlElement* e
 
 	if (element->hasAttribute("triangleMeshFile.url")) {
 		fileName = element->getAttributeValue("triangleMeshFile.url");
-		result = new TriangleMesh(triangleMeshLoader, fileName);
+		// optional transformation which is baked into the mesh vertices
+		if (element->hasSubElement("meshTransformation")) {
+			readTransformationDataFromXmlElement(meshTransformation,
+					element->getSubElement("meshTransformation"));
+		} // if
+		result = new TriangleMesh(xmlLoader->getTriangleMeshCache(),
+				triangleMeshLoader, fileName, meshTransformation);
 	} // if
 	else {
 		printd(ERROR,
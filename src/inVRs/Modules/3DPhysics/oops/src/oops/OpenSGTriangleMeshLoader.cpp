@@ -28,6 +28,7 @@
 #include "oops/OpenSGTriangleMeshLoader.h"
 #include <assert.h>
 #include <OpenSG/OSGSceneFileHandler.h>
+#include <OpenSG/OSGPathHandler.h>
 #include <OpenSG/OSGGeoFunctions.h>
 
 #include <OpenSG/OSGTriangleIterator.h>
@@ -147,6 +148,22 @@ void OpenSGTriangleMeshLoader::loadMesh(std::string fileName, TriangleMesh* obje
 
 } // loadMesh
 
+std::string OpenSGTriangleMeshLoader::findFile(std::string fileName)
+{
+	// relative files are searched in the paths of the OpenSG PathHandler
+#if OSG_MAJOR_VERSION >= 2
+	PathHandler* pathHandler = OSG::SceneFileHandler::the()->getPathHandler();
+#else
+	PathHandler* pathHandler = SceneFileHandler::the().getPathHandler();
+#endif
+	if (!pathHandler)
+		return fileName;
+	std::string result = pathHandler->findFile(fileName.c_str());
+	if (result.empty())
+		return fileName;
+	return result;
+} // findFile
+
 NodePtr OpenSGTriangleMeshLoader::getGeometryNode(NodePtr n)
 {
 	NodeCorePtr core;
@@ -26,7 +26,11 @@
 \*---------------------------------------------------------------------------*/
 
 #include <assert.h>
+#include <algorithm>
+#include <functional>
+#include <sstream>
 #include <gmtl/Xforms.h>
+#include <inVRs/SystemCore/WorkerPool.h>
 
 //#include <OpenSG/OSGQuaternion.h>
 //#include <OpenSG/OSGMatrix.h>
@@ -43,6 +47,7 @@
 #include "oops/GeometryFactories.h"
 //#include "oops/Interfaces/RigidBodyFactory.h"
 #include "oops/Interfaces/CollisionListenerInterface.h"
+#include "oops/oops-include-ode-step.h"
 
 // Object Oriented Physics Simulation
 namespace oops
@@ -63,11 +68,17 @@ Simulation::Simulation()
 	numberOfSteps = 1;
 	doCollisionDetection = true;
 	objectsVisible = false;
+	numberOfContacts = 0;
+	numberOfCollidingPairs = 0;
+	contactList.reserve(MAX_CONTACTS);
+	workerPool = NULL;
+	islandStepSize = 0;
 } // Simulation
 
 Simulation::~Simulation()
 {
 	fprintf(stderr, "Simulation destructor!\n");
+	delete workerPool;
 	dJointGroupDestroy(contactGroup);
 	dSpaceDestroy(space);
 	dWorldDestroy(world);
@@ -159,6 +170,50 @@ void Simulation::setAutoDisableTime(float time)
 	dWorldSetAutoDisableTime(world, time);
 } // setAutoDisableTime
 
+bool Simulation::setSpaceType(SPACETYPE type, gmtl::Vec3f center, gmtl::Vec3f extents,
+		int depth)
+{
+	dSpaceID newSpace;
+
+	if (dSpaceGetNumGeoms(space) > 0)
+	{
+		printf("Simulation::setSpaceType(): WARNING: space can not be changed after objects were added!\n");
+		return false;
+	} // if
+
+	if (type == SPACETYPE_QUADTREE)
+	{
+		dVector3 spaceCenter = {center[0], center[1], center[2], 0};
+		dVector3 spaceExtents = {extents[0], extents[1], extents[2], 0};
+		newSpace = dQuadTreeSpaceCreate(0, spaceCenter, spaceExtents, depth);
+	} // if
+	else
+		newSpace = dHashSpaceCreate(0);
+
+	dSpaceDestroy(space);
+	space = newSpace;
+	return true;
+} // setSpaceType
+
+void Simulation::setNumberOfThreads(unsigned numberOfThreads)
+{
+	// the names of the OpenSG threads must be unique
+	static unsigned poolIndex = 0;
+	std::stringstream poolName;
+
+	if (workerPool && workerPool->getNumberOfThreads() == numberOfThreads)
+		return;
+
+	delete workerPool;
+	workerPool = NULL;
+	islands.clear();
+	if (numberOfThreads == 0)
+		return;
+
+	poolName << "oopsIslands" << poolIndex++;
+	workerPool = new WorkerPool(poolName.str(), numberOfThreads);
+} // setNumberOfThreads
+
 //******************************************************
 // method to activate or deactivate rendering of objects
 //******************************************************
@@ -413,6 +468,9 @@ void Simulation::checkCollision(void* data, dGeomID o1, dGeomID o2)
 {
 	RigidBody* body1 = NULL;
 	RigidBody* body2 = NULL;
+	materials::MATERIAL material1 = materials::UNDEFINED;
+	materials::MATERIAL material2 = materials::UNDEFINED;
+	float friction;
 
 	if (dGeomIsSpace(o1) || dGeomIsSpace(o2))
 	{
@@ -432,6 +490,7 @@ void Simulation::checkCollision(void* data, dGeomID o1, dGeomID o2)
 	Geometry* geom2 = (Geometry*)dGeomGetData(o2);
 
 	bool surfaceParamSet = false;
+	bool probeContactParam = true;
 
    // exit without doing anything if the two bodies are connected by a joint
 	if (b1 == b2)
@@ -453,31 +512,43 @@ void Simulation::checkCollision(void* data, dGeomID o1, dGeomID o2)
 			return;
 	} // if
 
-	dContact *contacts = new dContact[10];
+	dContact *contacts = contactBuffer;
+
+	int numContacts = dCollide(o1, o2, MAX_CONTACTS, &contacts[0].geom, sizeof(dContact));
 
-	int numContacts = dCollide(o1, o2, 10, &contacts[0].geom, sizeof(dContact));
+	if (numContacts <= 0)
+		return;
+	numberOfContacts += numContacts;
+	numberOfCollidingPairs++;
+
+	if (geom1)
+		material1 = geom1->getMaterial();
+	if (geom2)
+		material2 = geom2->getMaterial();
+	friction = frictionTable.getFriction(material1, material2);
 
 	// Begin Create contact joint for every collision point
 	for(int i = 0; i < numContacts; ++i)
 	 {
-		if (geom1)
-			surfaceParamSet = geom1->setContactParam(contacts[i], geom2, true);
+		// the geometries are only asked for the other contacts of the pair
+		// if one of them sets the parameters of the first contact
+		surfaceParamSet = false;
+		if (probeContactParam)
+		{
+			if (geom1)
+				surfaceParamSet = geom1->setContactParam(contacts[i], geom2, true);
 
-		if (!surfaceParamSet && geom2)
-			surfaceParamSet = geom2->setContactParam(contacts[i], geom1, false);
+			if (!surfaceParamSet && geom2)
+				surfaceParamSet = geom2->setContactParam(contacts[i], geom1, false);
+
+			if (i == 0)
+				probeContactParam = surfaceParamSet;
+		} // if
 
 		if (!surfaceParamSet)
 		{
 			contacts[i].surface.mode = dContactApprox1;
-			if (geom1 && geom2)
-				contacts[i].surface.mu = getFriction(geom1->getMaterial(),
-					geom2->getMaterial());
-			else if (geom1)
-				contacts[i].surface.mu = getFriction(geom1->getMaterial(),
-					materials::UNDEFINED);
-			else
-				contacts[i].surface.mu = getFriction(geom2->getMaterial(),
-					materials::UNDEFINED);
+			contacts[i].surface.mu = friction;
 		} // if
 		dJointID c = dJointCreateContact(world, contactGroup, &contacts[i]);
 
@@ -491,7 +562,7 @@ void Simulation::checkCollision(void* data, dGeomID o1, dGeomID o2)
 	{
 		// Create list of contacts for callbacks
 		dReal *pos, *normal;
-		std::vector<ContactData> contactList;
+		contactList.clear();
 		for(int i = 0; i < numContacts; ++i)
 		{
 			ContactData contact;
@@ -528,7 +599,6 @@ void Simulation::checkCollision(void* data, dGeomID o1, dGeomID o2)
 	} // if
 
 	 // End Create contact joint for everycollision point
-	delete[] contacts;
 } // checkCollision
 
 void Simulation::checkCollisionWithWorldHelp(void* data, dGeomID o1, dGeomID o2)
@@ -557,9 +627,9 @@ void Simulation::checkCollisionWithWorld(dGeomID o1, dGeomID o2,
 	if (b1 && b2 && dAreConnectedExcluding (b1,b2,dJointTypeContact))
 		return;
 
-	dContact *odeContacts = new dContact[10];
+	dContact odeContacts[MAX_CONTACTS];
 
-	int numContacts = dCollide(o1, o2, 10, &odeContacts[0].geom,
+	int numContacts = dCollide(o1, o2, MAX_CONTACTS, &odeContacts[0].geom,
 		sizeof(dContact));
 
 	// Add new entry in contacts-list for every recognized contact
@@ -655,12 +725,18 @@ void Simulation::step(float dt)
 	// NOT IMPLEMENTED YET
 
 	// Begin Call collision detection
+	numberOfContacts = 0;
+	numberOfCollidingPairs = 0;
 	if (doCollisionDetection)
 		dSpaceCollide(space, this, checkCollisionHelp);
 	// End Call collision detection
 
 	// Begin Take simulation step
-	if (function == STEPFUNCTION_STEP)
+	// the quickstep uses the global random number generator of ODE, so only
+	// the islands of the normal step can be solved in parallel
+	if (function == STEPFUNCTION_STEP && workerPool)
+		stepIslands(dt);
+	else if (function == STEPFUNCTION_STEP)
 		dWorldStep(world, dt);
 	else if (function == STEPFUNCTION_QUICKSTEP)
 		dWorldQuickStep(world, dt);
@@ -680,6 +756,118 @@ void Simulation::step(float dt)
 	updatePosAndRot();
 } // step
 
+// Same as dxProcessIslands() of ODE 0.8 with dInternalStepIsland() as stepper,
+// but the islands are searched first and stepped afterwards in parallel. The
+// islands are searched in the same order as by ODE and every island is solved
+// by the same code, so the result is exactly the same as with dWorldStep() for
+// every number of threads.
+void Simulation::stepIslands(float dt)
+{
+	dxBody *b, *bb;
+	dxJoint *j;
+	dxJointNode *n;
+	dxGeom *geom;
+	Island island;
+	unsigned i, k, stackSize;
+
+	islands.clear();
+	if (world->nb <= 0)
+		return;
+
+	dInternalHandleAutoDisabling(world, dt);
+
+	islandBodies.resize(world->nb);
+	islandJoints.resize(world->nj);
+	islandStack.resize(world->nb);
+
+	for (b = world->firstbody; b; b = (dxBody*)b->next)
+		b->tag = 0;
+	for (j = world->firstjoint; j; j = (dxJoint*)j->next)
+		j->tag = 0;
+
+	island.firstBody = 0;
+	island.firstJoint = 0;
+	for (bb = world->firstbody; bb; bb = (dxBody*)bb->next)
+	{
+		if (bb->tag || (bb->flags & dxBodyDisabled))
+			continue;
+		bb->tag = 1;
+		island.numberOfBodies = 0;
+		island.numberOfJoints = 0;
+
+		// depth first search over the joints, the body is visited before its stack
+		stackSize = 0;
+		b = bb;
+		while (b)
+		{
+			islandBodies[island.firstBody + island.numberOfBodies++] = b;
+			for (n = b->firstjoint; n; n = n->next)
+			{
+				if (n->joint->tag)
+					continue;
+				n->joint->tag = 1;
+				islandJoints[island.firstJoint + island.numberOfJoints++] = n->joint;
+				if (n->body && !n->body->tag)
+				{
+					n->body->tag = 1;
+					islandStack[stackSize++] = n->body;
+				} // if
+			} // for
+			b = stackSize > 0 ? islandStack[--stackSize] : NULL;
+		} // while
+
+		islands.push_back(island);
+		island.firstBody += island.numberOfBodies;
+		island.firstJoint += island.numberOfJoints;
+	} // for
+
+	// dGeomMoved() reorders the geoms in the space and must not be called from
+	// the worker threads, so the geoms are detached during the parallel step
+	// and afterwards notified in the order of dWorldStep()
+	islandGeoms.resize(island.firstBody);
+	for (i = 0; i < island.firstBody; i++)
+	{
+		islandGeoms[i] = islandBodies[i]->geom;
+		islandBodies[i]->geom = NULL;
+	} // for
+
+	// start with the largest islands for a better load balance
+	islandOrder.resize(islands.size());
+	for (i = 0; i < islands.size(); i++)
+		islandOrder[i] = std::make_pair(islands[i].numberOfBodies + islands[i].numberOfJoints, i);
+	std::sort(islandOrder.begin(), islandOrder.end(), std::greater<std::pair<unsigned, unsigned> >());
+
+	islandStepSize = dt;
+	workerPool->run(stepIslandTask, islands.size(), this);
+
+	for (i = 0; i < islands.size(); i++)
+	{
+		for (k = islands[i].firstBody; k < islands[i].firstBody + islands[i].numberOfBodies; k++)
+		{
+			b = islandBodies[k];
+			b->geom = islandGeoms[k];
+			for (geom = b->geom; geom; geom = dGeomGetBodyNext(geom))
+				dGeomMoved(geom);
+			b->tag = 1;
+			b->flags &= ~dxBodyDisabled;
+		} // for
+		for (k = islands[i].firstJoint; k < islands[i].firstJoint + islands[i].numberOfJoints; k++)
+			islandJoints[k]->tag = 1;
+	} // for
+} // stepIslands
+
+void Simulation::stepIslandTask(unsigned taskIndex, void* userData)
+{
+	Simulation* simulation = (Simulation*)userData;
+	const Island& island = simulation->islands[simulation->islandOrder[taskIndex].second];
+	dxJoint* const* joints = NULL;
+
+	if (island.numberOfJoints > 0)
+		joints = &simulation->islandJoints[island.firstJoint];
+	dInternalStepIsland(simulation->world, &simulation->islandBodies[island.firstBody],
+		island.numberOfBodies, joints, island.numberOfJoints, simulation->islandStepSize);
+} // stepIslandTask
+
 void Simulation::renderObjects()
 {
 	int i;
@@ -722,6 +910,21 @@ float Simulation::getStepSize()
 	return timestep;
 } // getStepSize
 
+unsigned Simulation::getNumberOfContacts()
+{
+	return numberOfContacts;
+} // getNumberOfContacts
+
+unsigned Simulation::getNumberOfCollidingPairs()
+{
+	return numberOfCollidingPairs;
+} // getNumberOfCollidingPairs
+
+unsigned Simulation::getNumberOfIslands()
+{
+	return islands.size();
+} // getNumberOfIslands
+
 //****************************************
 // getter for registered SimulationObjects
 //****************************************
@@ -0,0 +1,636 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+#include "oops/TriangleMeshCache.h"
+#include <inVRs/SystemCore/DebugOutput.h>
+#include <gmtl/Generate.h>
+#include <gmtl/MatrixOps.h>
+#include <gmtl/VecOps.h>
+#include <gmtl/Xforms.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <sys/stat.h>
+
+#ifdef WIN32
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+namespace
+{
+
+const char CACHEFILE_MAGIC[8] = { 'O', 'O', 'P', 'S', 'M', 'S', 'H', '\0' };
+const uint32_t CACHEFILE_VERSION = 1;
+
+/**
+ * Header of a cache file. The header is followed by the key (padded to 16
+ * bytes), the vertex array, the triangle array and the normal array. Every
+ * array starts at an offset which is a multiple of 16 so that the data can be
+ * used directly from the mapped file.
+ */
+struct CacheFileHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t realSize;
+	uint32_t nVertices;
+	uint32_t nTriangles;
+	uint32_t keyLength;
+	uint32_t verticesOffset;
+	uint32_t trianglesOffset;
+	uint32_t normalsOffset;
+	uint64_t fileSize;
+	uint64_t sourceModificationTime;
+	uint64_t sourceSize;
+}; // CacheFileHeader
+
+struct WeldKey {
+	long x, y, z;
+	bool operator<(const WeldKey& rhs) const {
+		if (x != rhs.x)
+			return x < rhs.x;
+		if (y != rhs.y)
+			return y < rhs.y;
+		return z < rhs.z;
+	}
+}; // WeldKey
+
+uint32_t align16(uint32_t value) {
+	return (value + 15) & ~((uint32_t)15);
+} // align16
+
+uint32_t hashString(const std::string& str) {
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < str.size(); i++) {
+		hash ^= (uint8_t)str[i];
+		hash *= 16777619u;
+	} // for
+	return hash;
+} // hashString
+
+bool getSourceFileInfo(const std::string& fileName, uint64_t& modificationTime,
+		uint64_t& size) {
+	struct stat sb;
+	if (stat(fileName.c_str(), &sb) != 0)
+		return false;
+	modificationTime = (uint64_t)sb.st_mtime;
+	size = (uint64_t)sb.st_size;
+	return true;
+} // getSourceFileInfo
+
+/**
+ * Creates a new temporary file next to the passed file and opens it for
+ * writing. Every call gets an own name, so processes which write the same
+ * cache file at the same time never write into the same temporary file.
+ * @param tempFileName receives the name of the created file
+ * @return the opened file or NULL on error
+ */
+FILE* openTempFile(const std::string& fileName, std::string& tempFileName) {
+#ifdef WIN32
+	static unsigned counter = 0;
+	char buffer[32];
+	sprintf(buffer, ".%d.%u.tmp", _getpid(), counter++);
+	tempFileName = fileName + buffer;
+	return fopen(tempFileName.c_str(), "wb");
+#else
+	std::vector<char> name(fileName.begin(), fileName.end());
+	const char suffix[] = ".XXXXXX";
+	name.insert(name.end(), suffix, suffix + sizeof(suffix));
+	int fd = mkstemp(&name[0]);
+	if (fd < 0)
+		return NULL;
+	tempFileName = &name[0];
+	// mkstemp creates the file only readable for the owner
+	fchmod(fd, 0644);
+	FILE* file = fdopen(fd, "wb");
+	if (!file) {
+		close(fd);
+		remove(tempFileName.c_str());
+	} // if
+	return file;
+#endif
+} // openTempFile
+
+} // namespace
+
+// Object Oriented Physics Simulation
+namespace oops
+{
+
+TriangleMeshCache::TriangleMeshCache()
+{
+	diskCacheDirectory = "";
+	weldTolerance = 0;
+	recomputeNormals = false;
+} // TriangleMeshCache
+
+TriangleMeshCache::~TriangleMeshCache()
+{
+	// meshes which are still used by geometries stay alive until they are
+	// released, they only lose the connection to this cache
+	std::map<std::string, CookedTriangleMesh*>::iterator it;
+	for (it = meshMap.begin(); it != meshMap.end(); ++it)
+		it->second->cache = NULL;
+	meshMap.clear();
+} // ~TriangleMeshCache
+
+CookedTriangleMesh* TriangleMeshCache::lookup(std::string fileName,
+		const TransformationData& trans)
+{
+	std::string key = createKey(fileName, trans);
+	std::map<std::string, CookedTriangleMesh*>::iterator it = meshMap.find(key);
+	if (it != meshMap.end())
+		return addReference(it->second);
+
+	if (diskCacheDirectory.empty())
+		return NULL;
+
+	CookedTriangleMesh* mesh = readCacheFile(fileName, key);
+	if (!mesh)
+		return NULL;
+
+	mesh->cache = this;
+	meshMap[key] = mesh;
+	return mesh;
+} // lookup
+
+CookedTriangleMesh* TriangleMeshCache::insert(std::string fileName,
+		const TransformationData& trans, TriangleMeshData* rawData)
+{
+	std::string key = createKey(fileName, trans);
+	std::map<std::string, CookedTriangleMesh*>::iterator it = meshMap.find(key);
+	if (it != meshMap.end())
+	{
+		deleteTriangleMeshData(rawData);
+		return addReference(it->second);
+	} // if
+
+	CookedTriangleMesh* mesh = cook(rawData, trans, weldTolerance, recomputeNormals);
+	mesh->key = key;
+	mesh->cache = this;
+	meshMap[key] = mesh;
+
+	if (!diskCacheDirectory.empty())
+		writeCacheFile(fileName, mesh);
+
+	return mesh;
+} // insert
+
+void TriangleMeshCache::setDiskCacheDirectory(std::string directory)
+{
+	if (!directory.empty() && directory[directory.size()-1] != '/')
+		directory += "/";
+	diskCacheDirectory = directory;
+} // setDiskCacheDirectory
+
+std::string TriangleMeshCache::getDiskCacheDirectory()
+{
+	return diskCacheDirectory;
+} // getDiskCacheDirectory
+
+void TriangleMeshCache::setWeldTolerance(float tolerance)
+{
+	if (tolerance < 0)
+	{
+		printd(WARNING,
+				"TriangleMeshCache::setWeldTolerance(): invalid tolerance %f, keeping %f!\n",
+				tolerance, weldTolerance);
+		return;
+	} // if
+	weldTolerance = tolerance;
+} // setWeldTolerance
+
+float TriangleMeshCache::getWeldTolerance()
+{
+	return weldTolerance;
+} // getWeldTolerance
+
+void TriangleMeshCache::setRecomputeNormals(bool recompute)
+{
+	recomputeNormals = recompute;
+} // setRecomputeNormals
+
+bool TriangleMeshCache::getRecomputeNormals()
+{
+	return recomputeNormals;
+} // getRecomputeNormals
+
+int TriangleMeshCache::getNumberOfCachedMeshes()
+{
+	return (int)meshMap.size();
+} // getNumberOfCachedMeshes
+
+CookedTriangleMesh* TriangleMeshCache::cook(TriangleMeshData* rawData,
+		const TransformationData& trans, float weldTolerance, bool recomputeNormals)
+{
+	int i, j;
+	gmtl::Matrix44f mat, normalMat;
+	gmtl::Point3f point;
+	gmtl::Vec3f edge1, edge2, normal;
+	WeldKey weldKey;
+	std::map<WeldKey, int> weldMap;
+	std::map<WeldKey, int>::iterator weldIt;
+	std::vector<int> remap(rawData->nVertices);
+	std::vector<gmtl::Point3f> vertices;
+	std::vector<TriMeshTriangle> triangles;
+	std::vector<int> sourceTriangles;
+	TriMeshTriangle triangle;
+	bool weld = weldTolerance > 0;
+	bool transformed;
+
+	transformationDataToMatrix(trans, mat);
+	transformed = !gmtl::isEqual(mat, gmtl::Matrix44f());
+	// normals are transformed with the inverse transpose of the matrix
+	gmtl::invert(normalMat, mat);
+	gmtl::transpose(normalMat);
+	if (!rawData->normals)
+		recomputeNormals = true;
+
+	// transform vertices and merge the ones closer than weldTolerance
+	for (i=0; i < rawData->nVertices; i++)
+	{
+		point = gmtl::Point3f(rawData->vertices[i][0], rawData->vertices[i][1],
+				rawData->vertices[i][2]);
+		if (transformed)
+			point = mat * point;
+		if (!weld)
+		{
+			remap[i] = (int)vertices.size();
+			vertices.push_back(point);
+			continue;
+		} // if
+		weldKey.x = (long)floor(point[0] / weldTolerance + 0.5f);
+		weldKey.y = (long)floor(point[1] / weldTolerance + 0.5f);
+		weldKey.z = (long)floor(point[2] / weldTolerance + 0.5f);
+		weldIt = weldMap.find(weldKey);
+		if (weldIt != weldMap.end())
+		{
+			remap[i] = weldIt->second;
+		} // if
+		else
+		{
+			remap[i] = (int)vertices.size();
+			weldMap[weldKey] = remap[i];
+			vertices.push_back(point);
+		} // else
+	} // for
+
+	// remap indices and drop triangles which collapsed while welding
+	for (i=0; i < rawData->nTriangles; i++)
+	{
+		for (j=0; j < 3; j++)
+			triangle.index[j] = remap[rawData->triangles[i].index[j]];
+		if (weld && (triangle.index[0] == triangle.index[1] ||
+				triangle.index[1] == triangle.index[2] ||
+				triangle.index[0] == triangle.index[2]))
+			continue;
+		triangles.push_back(triangle);
+		sourceTriangles.push_back(i);
+	} // for
+
+	TriangleMeshData* data = new TriangleMeshData;
+	data->nVertices = (int)vertices.size();
+	data->nTriangles = (int)triangles.size();
+	data->vertices = new dVector3[data->nVertices];
+	data->triangles = new TriMeshTriangle[data->nTriangles];
+	data->normals = new dVector3[data->nTriangles];
+
+	for (i=0; i < data->nVertices; i++)
+	{
+		data->vertices[i][0] = vertices[i][0];
+		data->vertices[i][1] = vertices[i][1];
+		data->vertices[i][2] = vertices[i][2];
+		data->vertices[i][3] = 0;
+	} // for
+
+	for (i=0; i < data->nTriangles; i++)
+	{
+		data->triangles[i] = triangles[i];
+		if (recomputeNormals)
+		{
+			const gmtl::Point3f& p0 = vertices[triangles[i].index[0]];
+			edge1 = vertices[triangles[i].index[1]] - p0;
+			edge2 = vertices[triangles[i].index[2]] - p0;
+			gmtl::cross(normal, edge1, edge2);
+		} // if
+		else
+		{
+			const dVector3& srcNormal = rawData->normals[sourceTriangles[i]];
+			normal = gmtl::Vec3f(srcNormal[0], srcNormal[1], srcNormal[2]);
+			if (transformed)
+				gmtl::xform(normal, normalMat, gmtl::Vec3f(normal));
+		} // else
+		if ((recomputeNormals || transformed) && gmtl::length(normal) > 0)
+			gmtl::normalize(normal);
+		data->normals[i][0] = normal[0];
+		data->normals[i][1] = normal[1];
+		data->normals[i][2] = normal[2];
+		data->normals[i][3] = 0;
+	} // for
+
+	deleteTriangleMeshData(rawData);
+
+	CookedTriangleMesh* mesh = new CookedTriangleMesh;
+	mesh->data = data;
+	mesh->refCount = 1;
+	mesh->cache = NULL;
+	mesh->mappedFile = NULL;
+	mesh->mappedSize = 0;
+	buildODEData(mesh);
+
+	return mesh;
+} // cook
+
+CookedTriangleMesh* TriangleMeshCache::addReference(CookedTriangleMesh* mesh)
+{
+	mesh->refCount++;
+	return mesh;
+} // addReference
+
+void TriangleMeshCache::release(CookedTriangleMesh* mesh)
+{
+	if (!mesh)
+		return;
+
+	mesh->refCount--;
+	if (mesh->refCount > 0)
+		return;
+
+	if (mesh->cache)
+		mesh->cache->meshMap.erase(mesh->key);
+
+	dGeomTriMeshDataDestroy(mesh->meshData);
+
+	if (mesh->mappedFile)
+	{
+		// arrays point into the mapped file
+		delete mesh->data;
+#ifndef WIN32
+		munmap(mesh->mappedFile, mesh->mappedSize);
+#else
+		delete[] (char*)mesh->mappedFile;
+#endif
+	} // if
+	else
+	{
+		deleteTriangleMeshData(mesh->data);
+	} // else
+
+	delete mesh;
+} // release
+
+void TriangleMeshCache::deleteTriangleMeshData(TriangleMeshData* data)
+{
+	if (!data)
+		return;
+	delete[] data->vertices;
+	delete[] data->triangles;
+	delete[] data->normals;
+	delete data;
+} // deleteTriangleMeshData
+
+std::string TriangleMeshCache::createKey(std::string fileName,
+		const TransformationData& trans)
+{
+	char buffer[512];
+	sprintf(buffer,
+			"|%.6g %.6g %.6g|%.6g %.6g %.6g|%.6g %.6g %.6g %.6g|%.6g %.6g %.6g %.6g|%.6g|%d",
+			trans.position[0], trans.position[1], trans.position[2],
+			trans.scale[0], trans.scale[1], trans.scale[2],
+			trans.orientation[0], trans.orientation[1], trans.orientation[2],
+			trans.orientation[3], trans.scaleOrientation[0],
+			trans.scaleOrientation[1], trans.scaleOrientation[2],
+			trans.scaleOrientation[3], weldTolerance, recomputeNormals ? 1 : 0);
+	return fileName + buffer;
+} // createKey
+
+std::string TriangleMeshCache::getCacheFileName(std::string key)
+{
+	char buffer[32];
+	sprintf(buffer, "mesh_%08x.oopsmesh", hashString(key));
+	return diskCacheDirectory + buffer;
+} // getCacheFileName
+
+CookedTriangleMesh* TriangleMeshCache::readCacheFile(std::string fileName,
+		std::string key)
+{
+	uint64_t sourceModificationTime, sourceSize;
+	std::string cacheFileName = getCacheFileName(key);
+	void* mappedFile = NULL;
+	size_t mappedSize = 0;
+
+	if (!getSourceFileInfo(fileName, sourceModificationTime, sourceSize))
+	{
+		printd(WARNING,
+				"TriangleMeshCache::readCacheFile(): unable to access mesh file %s, disk cache is not used!\n",
+				fileName.c_str());
+		return NULL;
+	} // if
+
+#ifndef WIN32
+	int fd = open(cacheFileName.c_str(), O_RDONLY);
+	if (fd < 0)
+		return NULL;
+	struct stat sb;
+	if (fstat(fd, &sb) != 0 || (size_t)sb.st_size < sizeof(CacheFileHeader))
+	{
+		close(fd);
+		return NULL;
+	} // if
+	mappedSize = (size_t)sb.st_size;
+	mappedFile = mmap(NULL, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mappedFile == MAP_FAILED)
+		return NULL;
+#else
+	FILE* file = fopen(cacheFileName.c_str(), "rb");
+	if (!file)
+		return NULL;
+	fseek(file, 0, SEEK_END);
+	mappedSize = (size_t)ftell(file);
+	fseek(file, 0, SEEK_SET);
+	if (mappedSize < sizeof(CacheFileHeader))
+	{
+		fclose(file);
+		return NULL;
+	} // if
+	// new[] of char returns memory aligned for any fundamental type
+	mappedFile = new char[mappedSize];
+	if (fread(mappedFile, 1, mappedSize, file) != mappedSize)
+	{
+		fclose(file);
+		delete[] (char*)mappedFile;
+		return NULL;
+	} // if
+	fclose(file);
+#endif
+
+	const char* base = (const char*)mappedFile;
+	const CacheFileHeader* header = (const CacheFileHeader*)base;
+	bool valid = memcmp(header->magic, CACHEFILE_MAGIC, sizeof(CACHEFILE_MAGIC)) == 0
+			&& header->version == CACHEFILE_VERSION
+			&& header->realSize == sizeof(dReal)
+			&& header->fileSize == mappedSize
+			&& header->sourceModificationTime == sourceModificationTime
+			&& header->sourceSize == sourceSize
+			&& header->keyLength == key.size()
+			&& sizeof(CacheFileHeader) + header->keyLength <= mappedSize
+			&& memcmp(base + sizeof(CacheFileHeader), key.c_str(), key.size()) == 0
+			&& header->verticesOffset + (uint64_t)header->nVertices * sizeof(dVector3) <= mappedSize
+			&& header->trianglesOffset + (uint64_t)header->nTriangles * sizeof(TriMeshTriangle) <= mappedSize
+			&& header->normalsOffset + (uint64_t)header->nTriangles * sizeof(dVector3) <= mappedSize;
+	if (!valid)
+	{
+		printd(INFO,
+				"TriangleMeshCache::readCacheFile(): ignoring outdated or invalid cache file %s for mesh %s\n",
+				cacheFileName.c_str(), fileName.c_str());
+#ifndef WIN32
+		munmap(mappedFile, mappedSize);
+#else
+		delete[] (char*)mappedFile;
+#endif
+		return NULL;
+	} // if
+
+	TriangleMeshData* data = new TriangleMeshData;
+	data->nVertices = (int)header->nVertices;
+	data->nTriangles = (int)header->nTriangles;
+	data->vertices = (dVector3*)(base + header->verticesOffset);
+	data->triangles = (TriMeshTriangle*)(base + header->trianglesOffset);
+	data->normals = (dVector3*)(base + header->normalsOffset);
+
+	CookedTriangleMesh* mesh = new CookedTriangleMesh;
+	mesh->key = key;
+	mesh->data = data;
+	mesh->refCount = 1;
+	mesh->cache = NULL;
+	mesh->mappedFile = mappedFile;
+	mesh->mappedSize = mappedSize;
+	buildODEData(mesh);
+
+	printd(INFO, "TriangleMeshCache::readCacheFile(): mapped mesh %s from %s\n",
+			fileName.c_str(), cacheFileName.c_str());
+	return mesh;
+} // readCacheFile
+
+bool TriangleMeshCache::writeCacheFile(std::string fileName, CookedTriangleMesh* mesh)
+{
+	CacheFileHeader header;
+	uint64_t sourceModificationTime, sourceSize;
+	std::string cacheFileName = getCacheFileName(mesh->key);
+	TriangleMeshData* data = mesh->data;
+	static const char padding[16] = { 0 };
+
+	if (!getSourceFileInfo(fileName, sourceModificationTime, sourceSize))
+	{
+		printd(WARNING,
+				"TriangleMeshCache::writeCacheFile(): unable to access mesh file %s, cache file is not written!\n",
+				fileName.c_str());
+		return false;
+	} // if
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CACHEFILE_MAGIC, sizeof(CACHEFILE_MAGIC));
+	header.version = CACHEFILE_VERSION;
+	header.realSize = sizeof(dReal);
+	header.nVertices = (uint32_t)data->nVertices;
+	header.nTriangles = (uint32_t)data->nTriangles;
+	header.keyLength = (uint32_t)mesh->key.size();
+	header.verticesOffset = align16(sizeof(CacheFileHeader) + header.keyLength);
+	header.trianglesOffset = align16(header.verticesOffset +
+			header.nVertices * sizeof(dVector3));
+	header.normalsOffset = align16(header.trianglesOffset +
+			header.nTriangles * sizeof(TriMeshTriangle));
+	header.fileSize = header.normalsOffset + header.nTriangles * sizeof(dVector3);
+	header.sourceModificationTime = sourceModificationTime;
+	header.sourceSize = sourceSize;
+
+	// write to a temporary file first so that a concurrently running process
+	// never maps a partially written cache file
+	std::string tempFileName;
+	FILE* file = openTempFile(cacheFileName, tempFileName);
+	if (!file)
+	{
+		printd(WARNING,
+				"TriangleMeshCache::writeCacheFile(): unable to write cache file %s!\n",
+				cacheFileName.c_str());
+		return false;
+	} // if
+
+	uint32_t pos = sizeof(CacheFileHeader);
+	bool success = fwrite(&header, sizeof(header), 1, file) == 1;
+	success = success && fwrite(mesh->key.c_str(), 1, header.keyLength, file)
+			== header.keyLength;
+	pos += header.keyLength;
+	success = success && fwrite(padding, 1, header.verticesOffset - pos, file)
+			== header.verticesOffset - pos;
+	success = success && fwrite(data->vertices, sizeof(dVector3), header.nVertices, file)
+			== header.nVertices;
+	pos = header.verticesOffset + header.nVertices * sizeof(dVector3);
+	success = success && fwrite(padding, 1, header.trianglesOffset - pos, file)
+			== header.trianglesOffset - pos;
+	success = success && fwrite(data->triangles, sizeof(TriMeshTriangle),
+			header.nTriangles, file) == header.nTriangles;
+	pos = header.trianglesOffset + header.nTriangles * sizeof(TriMeshTriangle);
+	success = success && fwrite(padding, 1, header.normalsOffset - pos, file)
+			== header.normalsOffset - pos;
+	success = success && fwrite(data->normals, sizeof(dVector3), header.nTriangles, file)
+			== header.nTriangles;
+	success = (fclose(file) == 0) && success;
+
+	if (success)
+	{
+#ifdef WIN32
+		remove(cacheFileName.c_str());
+#endif
+		success = rename(tempFileName.c_str(), cacheFileName.c_str()) == 0;
+	} // if
+	if (!success)
+	{
+		printd(WARNING,
+				"TriangleMeshCache::writeCacheFile(): error writing cache file %s!\n",
+				cacheFileName.c_str());
+		remove(tempFileName.c_str());
+	} // if
+	return success;
+} // writeCacheFile
+
+void TriangleMeshCache::buildODEData(CookedTriangleMesh* mesh)
+{
+	TriangleMeshData* data = mesh->data;
+	mesh->meshData = dGeomTriMeshDataCreate();
+	dGeomTriMeshDataBuildSimple(mesh->meshData, (dReal*)data->vertices,
+			data->nVertices, (int*)data->triangles, data->nTriangles*3);
+} // buildODEData
+
+} // oops
@@ -70,6 +70,7 @@ XMLLoader::XMLLoader() {
 	rendererFactory = NULL;
 	triMeshLoader = NULL;
 	heightFieldLoader = NULL;
+	triMeshCache = new TriangleMeshCache;
 
 } // XMLLoader
 
@@ -91,6 +92,8 @@ XMLLoader::~XMLLoader() {
 	for (i=0; i < jointFactoryList.size(); i++)
 		delete jointFactoryList[i];
 	jointFactoryList.clear();
+
+	delete triMeshCache;
 } // XMLLoader
 
 //****************************************************
@@ -296,5 +299,9 @@ HeightFieldLoader* XMLLoader::getHeightFieldLoader() {
 	return heightFieldLoader;
 } // getHeightFieldLoader
 
+TriangleMeshCache* XMLLoader::getTriangleMeshCache() {
+	return triMeshCache;
+} // getTriangleMeshCache
+
 
 } // oops
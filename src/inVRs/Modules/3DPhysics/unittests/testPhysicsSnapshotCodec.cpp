@@ -0,0 +1,151 @@
+#include <iostream>
+#include <stdexcept>
+#include <typeinfo>
+#include <math.h>
+
+#undef INVRS3DPHYSICS_EXPORTS
+#include "inVRs/Modules/3DPhysics/PhysicsSnapshotCodec.h"
+
+#undef NDEBUG
+#include <cassert>
+
+#define test_bool_true(x) try { \
+	if ( !(x) ) \
+	{ \
+		std::cout << "Test condition ``" # x "'' failed!" <<std::endl; \
+		failed=true; \
+	} \
+} catch (std::exception &e ) \
+{ \
+	std::cout << "Exception " << typeid(e).name() << " during test ``" # x "'': " << e.what() << std::endl; \
+	failed=true;\
+}
+
+static const unsigned NUM_BODIES = 20;
+
+// every third body moves, body NUM_BODIES exists only in even steps
+static void createSnapshot(PhysicsSnapshotCodec& codec, unsigned step,
+		PhysicsSnapshotCodec::Snapshot& snapshot)
+{
+	TransformationData trans = identityTransformation();
+	gmtl::Vec3f linearVel, angularVel;
+	float angle;
+	unsigned i;
+
+	snapshot.clear();
+	for (i = 1; i <= NUM_BODIES; i++) {
+		if (i == NUM_BODIES && step % 2)
+			continue;
+		trans.position = gmtl::Vec3f((float)i, 0.5f, 0);
+		trans.orientation = gmtl::Quatf(0, 0, 0, 1);
+		linearVel = gmtl::Vec3f(0, 0, 0);
+		angularVel = gmtl::Vec3f(0, 0, 0);
+		if (i % 3 == 0) {
+			angle = 0.01f * step + i;
+			trans.position += gmtl::Vec3f(cosf(angle), 0, sinf(angle));
+			trans.orientation = gmtl::Quatf(0, sinf(angle / 2), 0, cosf(angle / 2));
+			linearVel = gmtl::Vec3f(-sinf(angle), 0, cosf(angle));
+			angularVel = gmtl::Vec3f(0, 1, 0);
+		} // if
+		codec.quantize(trans, linearVel, angularVel, snapshot[i]);
+	} // for
+}
+
+int main()
+{
+	bool failed=false;
+	PhysicsSnapshotCodec server(0.001f, 0.001f, 10);
+	PhysicsSnapshotCodec client(0.001f, 0.001f, 10);
+	PhysicsSnapshotCodec::Snapshot snapshot, decoded;
+	TransformationData trans;
+	gmtl::Vec3f linearVel, angularVel;
+	unsigned step;
+	bool delta;
+
+	// quantization keeps the state within the precision
+	createSnapshot(server, 1, snapshot);
+	server.dequantize(snapshot[3], trans, linearVel, angularVel);
+	test_bool_true ( fabs(trans.position[0] - (3 + cosf(0.01f + 3))) < 0.001f );
+	test_bool_true ( fabs(linearVel[2] - cosf(0.01f + 3)) < 0.001f );
+
+	// without acknowledgement every snapshot is encoded in full
+	for (step = 1; step <= 3; step++) {
+		NetMessage msg;
+		createSnapshot(server, step, snapshot);
+		server.addSnapshot(step, snapshot);
+		test_bool_true ( !server.encode(step, 7, &msg) );
+		test_bool_true ( client.decode(step, &msg, decoded) );
+		test_bool_true ( decoded == snapshot );
+		test_bool_true ( msg.finished() );
+	} // for
+
+	// acknowledged snapshots are used as baseline and reconstructed exactly,
+	// also when a body is removed and added again
+	server.acknowledge(7, 3);
+	for (step = 4; step <= 8; step++) {
+		NetMessage msg;
+		createSnapshot(server, step, snapshot);
+		server.addSnapshot(step, snapshot);
+		delta = server.encode(step, 7, &msg);
+		test_bool_true ( delta );
+		test_bool_true ( client.decode(step, &msg, decoded) );
+		test_bool_true ( decoded == snapshot );
+		test_bool_true ( msg.finished() );
+		server.acknowledge(7, step);
+	} // for
+
+	// a lost acknowledgement keeps the older baseline
+	{
+		NetMessage msg;
+		createSnapshot(server, 9, snapshot);
+		server.addSnapshot(9, snapshot);
+		test_bool_true ( server.encode(9, 7, &msg) );
+		test_bool_true ( client.decode(9, &msg, decoded) );
+		test_bool_true ( decoded == snapshot );
+	}
+	{
+		NetMessage msg;
+		createSnapshot(server, 10, snapshot);
+		server.addSnapshot(10, snapshot);
+		test_bool_true ( server.encode(10, 7, &msg) );
+		test_bool_true ( client.decode(10, &msg, decoded) );
+		test_bool_true ( decoded == snapshot );
+	}
+
+	// an acknowledgement older than the maximum baseline age is not used
+	for (step = 11; step <= 20; step++) {
+		createSnapshot(server, step, snapshot);
+		server.addSnapshot(step, snapshot);
+	} // for
+	{
+		NetMessage msg;
+		test_bool_true ( !server.encode(20, 7, &msg) );
+		test_bool_true ( client.decode(20, &msg, decoded) );
+		test_bool_true ( decoded == snapshot );
+	}
+
+	// a receiver without the baseline rejects the snapshot
+	{
+		PhysicsSnapshotCodec newClient(0.001f, 0.001f, 10);
+		NetMessage msg;
+		server.acknowledge(7, 20);
+		createSnapshot(server, 21, snapshot);
+		server.addSnapshot(21, snapshot);
+		test_bool_true ( server.encode(21, 7, &msg) );
+		test_bool_true ( !newClient.decode(21, &msg, decoded) );
+	}
+
+	// a user who left and rejoins with the same ID gets a full snapshot
+	server.removeUser(7);
+	{
+		PhysicsSnapshotCodec newClient(0.001f, 0.001f, 10);
+		NetMessage msg;
+		createSnapshot(server, 22, snapshot);
+		server.addSnapshot(22, snapshot);
+		test_bool_true ( !server.encode(22, 7, &msg) );
+		test_bool_true ( newClient.decode(22, &msg, decoded) );
+		test_bool_true ( decoded == snapshot );
+	}
+
+	return failed?1:0;
+}
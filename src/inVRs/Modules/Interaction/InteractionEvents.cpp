@@ -81,6 +81,7 @@ InteractionChangeStateEvent::InteractionChangeStateEvent(
 	for (i = 0; i < (int)pickedEntitiesList->size(); i++) {
 		pickedEntitiesCopy.push_back((*pickedEntitiesList)[i]);
 	}
+	setPriority(PRIORITY_CRITICAL);
 }
 
 InteractionChangeStateEvent::InteractionChangeStateEvent() {
@@ -449,6 +450,8 @@ InteractionVirtualHandManipulationActionEvent::InteractionVirtualHandManipulatio
 
 	this->beginManipulation = beginManipulation;
 	this->userId = UserDatabase::getLocalUserId();
+	// opens the manipulation pipes, must arrive before the transformations
+	setPriority(PRIORITY_CRITICAL);
 } // InteractionVirtualHandManipulationActionEvent
 
 InteractionVirtualHandManipulationActionEvent::~InteractionVirtualHandManipulationActionEvent() {
@@ -625,6 +628,8 @@ InteractionHomerManipulationActionEvent::InteractionHomerManipulationActionEvent
 
 	this->beginManipulation = beginManipulation;
 	this->userId = UserDatabase::getLocalUserId();
+	// opens the manipulation pipes, must arrive before the transformations
+	setPriority(PRIORITY_CRITICAL);
 } // InteractionHomerManipulationActionEvent
 
 
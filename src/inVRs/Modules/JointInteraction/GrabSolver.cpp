@@ -0,0 +1,135 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+#include "GrabSolver.h"
+
+#include <gmtl/QuatOps.h>
+#include <gmtl/AxisAngle.h>
+#include <gmtl/Generate.h>
+
+#include "JointInteractionMath.h"
+
+/***
+ *	Methods of class GrabSolver
+ **/
+
+GrabSolver::GrabSolver(dWorldID world)
+{
+	this->world = world;
+	orientationJoint = NULL;
+} // GrabSolver
+
+GrabSolver::~GrabSolver()
+{
+	release();
+} // ~GrabSolver
+
+/**
+ * This method adjusts the orientation and the position of the passed
+ * body towards the target transformation. The linear and angular
+ * velocity of the body are reset after each phase.
+ * @param body ODE-body of the grabbed object
+ * @param target transformation of the manipulating object
+ * @param stepsPerFrame number of simulation steps per phase
+ **/
+void GrabSolver::solve(dBodyID body, const TransformationData& target, int stepsPerFrame)
+{
+	TransformationData objectTrans;
+	gmtl::AxisAnglef AxAng;
+	gmtl::Quatf rotation;
+	gmtl::Vec3f force, torque;
+
+	const dReal* pos = dBodyGetPosition(body);
+	const dReal* rot = dBodyGetQuaternion(body);
+
+	convert(objectTrans.position, pos);
+	convert(objectTrans.orientation, rot);
+
+// STEP 1: apply Torque
+	// calculate Torque = angular offset from object orientation to current orientation
+	rotation = target.orientation;
+	rotation *= invert(objectTrans.orientation);
+	gmtl::set(AxAng, rotation);
+	torque[0] = AxAng[0]*AxAng[1];  // rotAngle*rotX
+	torque[1] = AxAng[0]*AxAng[2];  // rotAngle*rotY
+	torque[2] = AxAng[0]*AxAng[3];  // rotAngle*rotZ
+
+	// attach a Ball Joint to adjust orientation without changing the position,
+	// the joint is kept for the whole grab instead of creating it every frame
+	if (!orientationJoint)
+		orientationJoint = dJointCreateBall(world, 0);
+	dJointAttach(orientationJoint, body, 0);
+	dJointSetBallAnchor(orientationJoint, pos[0], pos[1], pos[2]);
+
+/***
+ * old way --> is very instable due to high timestep!!!
+ ***
+ *		dBodySetTorque(body, torque[0], torque[1], torque[2]);
+ * // Half way to destination
+ *		dWorldStep(world, 0.5);
+ **/
+	// take some simulation-steps for adjusting object's orientation
+	for (int i=0; i < stepsPerFrame; i++)
+	{
+		dBodySetTorque(body, torque[0], torque[1], torque[2]);
+		dWorldStep(world, 1.0f/stepsPerFrame);
+	} // for
+
+	dJointAttach(orientationJoint, 0, 0);
+
+// Reset speed and angular velocity to 0
+	dBodySetLinearVel(body, 0, 0, 0);
+	dBodySetAngularVel(body, 0, 0, 0);
+
+// STEP 2: apply force into wanted direction
+	// calculate Force = vector from object position to current position
+	force = (target.position - objectTrans.position);
+
+	// take some simulation-steps for adjusting object's position
+	for (int i=0; i < stepsPerFrame; i++)
+	{
+		dBodySetForce(body, force[0], force[1], force[2]);
+		dWorldStep(world, 1.0f/stepsPerFrame);
+	} // for
+
+// Reset speed and angular velocity to 0
+	dBodySetLinearVel(body, 0, 0, 0);
+	dBodySetAngularVel(body, 0, 0, 0);
+} // solve
+
+/**
+ * This method destroys the ball joint used for the orientation.
+ * It is called when the grab ends.
+ **/
+void GrabSolver::release()
+{
+	if (orientationJoint)
+	{
+		dJointDestroy(orientationJoint);
+		orientationJoint = NULL;
+	} // if
+} // release
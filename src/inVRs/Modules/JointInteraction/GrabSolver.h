@@ -25,70 +25,44 @@
  * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
 \*---------------------------------------------------------------------------*/
 
-/*
- * ProfilingHelper.cpp
- *
- *  Created on: Aug 13, 2008
- *      Author: landi
- */
-
-#include "ProfilingHelper.h"
-#include <inVRs/SystemCore/DebugOutput.h>
-#include <inVRs/SystemCore/Timer.h>
-#include <assert.h>
-#include <string.h>
-
-ProfilingHelper::ProfilingHelper(std::string logFile, int numValues,
-		char** dataNames) {
-	this->initialize(logFile, numValues, dataNames);
-} // ProfilingHelper
-
-ProfilingHelper::~ProfilingHelper() {
-	fclose(logFile);
-	delete[] data;
-} // ~ProfilingHelper
-
-void ProfilingHelper::start(Timer& timer) {
-	lastTime = timer.getTime();
-} // start
-
-void ProfilingHelper::dt(unsigned index, Timer& timer) {
-	assert(lastTime != 0);
-	assert((int)index < numValues);
-
-	double currentTime = timer.getTime();
-
-	data[index] += (currentTime-lastTime);
-	sumValues += (currentTime-lastTime);
-
-	lastTime = currentTime;
-} // ProfilingHelper
-
-void ProfilingHelper::stop(Timer& timer) {
-	for (int i=0; i < numValues; i++) {
-//		fprintf(logFile, "%f\t", data[i]/sumValues);
-		fprintf(logFile, "%f\t", data[i]);
-	} // for
-	fprintf(logFile, "\n");
-
-	memset(this->data, 0, sizeof(double)*numValues);
-	sumValues = 0;
-} // ProfilingHelper
+/*---------------------------------------------------------------------------*\
+ *                                Changes                                    *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+\*---------------------------------------------------------------------------*/
 
-void ProfilingHelper::initialize(std::string logFile, int numValues,
-		char** dataNames)
+#ifndef _GRABSOLVER_H
+#define _GRABSOLVER_H
+
+#include <ode/ode.h>
+#include <inVRs/SystemCore/DataTypes.h>
+
+#include "JointInteractionSharedLibraryExports.h"
+
+/**
+ * This class moves a grabbed ODE-body with Joints towards the
+ * transformation of the manipulating object. The orientation is
+ * adjusted first by applying a torque while a ball joint keeps the
+ * position, afterwards a force pulls the body to the wanted position.
+ * Each phase takes stepsPerFrame simulation steps.
+ * The steps only move enabled bodies, so all bodies which are not
+ * connected to the grabbed body have to be disabled. Then the cost
+ * of a frame only depends on the size of the grabbed island.
+ **/
+class INVRS_JOINTINTERACTION_API GrabSolver
 {
-	this->lastTime = 0;
-	this->numValues = numValues;
-	this->data = new double[numValues];
-	memset(this->data, 0, sizeof(double)*numValues);
-	this->sumValues = 0;
+protected:
+	dWorldID world;
+	dJointID orientationJoint;
 
-	this->logFile = fopen(logFile.c_str(), "w");
+public:
+	GrabSolver(dWorldID world);
+	virtual ~GrabSolver();
 
-	for (int i=0; i < numValues; i++) {
-		fprintf(this->logFile, "%s\t", dataNames[i]);
-	} // for
+	void solve(dBodyID body, const TransformationData& target, int stepsPerFrame);
+	void release();
+};
 
-	fprintf(this->logFile, "\n");
-} // initialize
+#endif
@@ -55,18 +55,21 @@ JointInteraction::JointInteraction()
 {
 	isInitialized = false;
 	incomingEvents = NULL;
+	grabSolver = NULL;
 //	SystemCore::registerModuleInterface(this);
 } // JointInteraction
 
 JointInteraction::~JointInteraction()
 {
 //	SystemCore::unregisterModuleInterface(this);
+	delete grabSolver;
 } // ~JointInteraction
 
 bool JointInteraction::loadConfig(std::string configFile)
 {
 	world = dWorldCreate();
 	space = dSimpleSpaceCreate(0);
+	grabSolver = new GrabSolver(world);
 	isGrabbing = false;
 	stepsPerFrame = 50;
 	maxDist = 20;
@@ -506,7 +509,7 @@ void JointInteraction::step()
  *	object and all connected objects. If the grabbed object has
  *	no connections to other objects (via joints) the method simply
  *	applies the passed position and orientation to the grabbed object.
- *	Otherwise the calculation of the new transformation takes place in
+ *	Otherwise the GrabSolver calculates the new transformation in
  *	two steps:
  *	First the orientational difference between the grabbed object and
  *	and the passed orientation is calculated and applied to the object
@@ -531,8 +534,6 @@ TransformationData JointInteraction::update(TransformationData trans)
 	if (!isInitialized)
 		init();
 
-	gmtl::AxisAnglef AxAng;
-	gmtl::Vec3f diff;
 	dQuaternion quat;
 
 	userTrans.position = trans.position;
@@ -550,92 +551,7 @@ TransformationData JointInteraction::update(TransformationData trans)
 	}
 	else
 	{ // Code for object with Joints
-		TransformationData objectTrans;
-		gmtl::Quatf rotation;
-		gmtl::Vec3f force, torque;
-
-		const dReal* pos = dBodyGetPosition(grabbedObject->body);
-		const dReal* rot = dBodyGetQuaternion(grabbedObject->body);
-
-		convert(objectTrans.position, pos);
-		convert(objectTrans.orientation, rot);
-
-// TODO: move this code to manipulationTerminationModel
-		// ungrab object if distance is too high
-// 		diff = userTrans.position - objectTrans.position;
-// 		if (gmtl::length(diff) > maxDist)
-// 		{
-// 			printf("JointInteraction::update(): distance %f too high!\n", gmtl::length(diff));
-// 			ungrab();
-// 			return identityTransformation();
-// 		} // if
-
-// STEP 1: apply Torque
-		// calculate Torque = angular offset from object orientation to current orientation
-		rotation = userTrans.orientation;
-		rotation *= invert(objectTrans.orientation);
-		gmtl::set(AxAng, rotation);
-		torque[0] = AxAng[0]*AxAng[1];  // rotAngle*rotX
-		torque[1] = AxAng[0]*AxAng[2];  // rotAngle*rotY
-		torque[2] = AxAng[0]*AxAng[3];  // rotAngle*rotZ
-
-// TODO: move this code to manipulationTerminationModel
-		// ungrab object if angular distance is too high
-// 		if (gmtl::length(torque) > maxRotDist)
-// 		{
-// 			printf("JointInteraction::update(): rotation %f too high!\n", gmtl::length(torque));
-// 			ungrab();
-// 			return identityTransformation();
-// 		} // if
-
-		// create a Ball Joint to adjust orientation without changing the position
-		dJointID universalJoint = dJointCreateBall(world, 0);
-		dJointAttach(universalJoint, grabbedObject->body, 0);
-		dJointSetBallAnchor(universalJoint, pos[0], pos[1], pos[2]);
-
-//		printf("Torque = %f %f %f\n", torque[0], torque[1], torque[2]);
-/***
- * old way --> is very instable due to high timestep!!!
- ***
- *		dBodySetTorque(grabbedObject->body, torque[0], torque[1], torque[2]);
- * // Half way to destination
- *		dWorldStep(world, 0.5);
- **/
-		// take some simulation-steps for adjusting object's orientation
-		for (int i=0; i < stepsPerFrame; i++)
-		{
-			dBodySetTorque(grabbedObject->body, torque[0], torque[1], torque[2]);
-			dWorldStep(world, 1.0f/stepsPerFrame);
-		} // for
-
-		dJointDestroy(universalJoint);
-
-// Reset speed and angular velocity to 0
-		dBodySetLinearVel(grabbedObject->body, 0, 0, 0);
-		dBodySetAngularVel(grabbedObject->body, 0, 0, 0);
-
-// STEP 2: apply force into wanted direction
-		// calculate Force = vector from object position to current position
-		force = (userTrans.position - objectTrans.position);
-
-//		printf("Force = %f %f %f\n", force[0], force[1], force[2]);
-/***
- * old way --> is very instable due to high timestep!!!
- ***
- *		dBodySetForce(grabbedObject->body, force[0], force[1], force[2]);
- * // Half way to destination
- *		dWorldStep(world, 0.5);
- **/
-		// take some simulation-steps for adjusting object's position
-		for (int i=0; i < stepsPerFrame; i++)
-		{
-			dBodySetForce(grabbedObject->body, force[0], force[1], force[2]);
-			dWorldStep(world, 1.0f/stepsPerFrame);
-		} // for
-
-// Reset speed and angular velocity to 0
-		dBodySetLinearVel(grabbedObject->body, 0, 0, 0);
-		dBodySetAngularVel(grabbedObject->body, 0, 0, 0);
+		grabSolver->solve(grabbedObject->body, userTrans, stepsPerFrame);
 	}
 
 // Get position and Orientation from simulated object
@@ -744,6 +660,7 @@ bool JointInteraction::ungrab()
 
 	for (i=0; i < (int)attachedJoints.size(); i++)
 		attachedJoints[i]->detach();
+	grabSolver->release();
 
 	std::map< int, ODEObject*>::iterator it = linkedObjMap.begin();
 	while (it != linkedObjMap.end())
@@ -945,6 +862,10 @@ dBodyID JointInteraction::getBodyWithID(int entityID)
 // ingnore request if Entity is not movable
 		if (!entity->getEntityType()->isFixed())
 			attachJoints(entityID);
+		// the body of a fixed Entity is never connected to a Joint, it is
+		// disabled so that the GrabSolver does not step it
+		else
+			dBodyDisable(object->body);
 	} // if
 	if (object->entity->getEntityType()->isFixed())
 		return 0;
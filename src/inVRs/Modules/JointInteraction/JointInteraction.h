@@ -44,6 +44,7 @@
 #include <irrXML.h>
 #include "Joints.h"
 #include "Constraint.h"
+#include "GrabSolver.h"
 #include <inVRs/SystemCore/WorldDatabase/Entity.h>
 #include <inVRs/SystemCore/ComponentInterfaces/ModuleInterface.h>
 #include <inVRs/SystemCore/TransformationManager/TransformationPipe.h>
@@ -103,6 +104,7 @@ protected:
 	dWorldID world;
 	dSpaceID space;
 	int stepsPerFrame;
+	GrabSolver* grabSolver;
 
 	void attachJoints(int entityID);
 	void grabEntity(Entity* entity, TransformationData offset);
@@ -0,0 +1,84 @@
+#include <inVRs/Modules/JointInteraction/GrabSolver.h>
+
+#include <inVRs/SystemCore/Timer.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+static const unsigned MEASURED_FRAMES = 100;
+static const int STEPS_PER_FRAME = 50;
+
+/** Creates a door (hinge) or a drawer (slider) connected to the static world.
+ */
+static dBodyID createJointedObject(dWorldID world, unsigned index) {
+	dBodyID body = dBodyCreate(world);
+	dJointID joint;
+	float x = (float)(index % 32) * 2;
+	float z = (float)(index / 32) * 2;
+
+	dBodySetPosition(body, x, 1, z);
+	if (index % 2) {
+		joint = dJointCreateSlider(world, 0);
+		dJointAttach(joint, body, 0);
+		dJointSetSliderAxis(joint, 0, 0, 1);
+	} else {
+		joint = dJointCreateHinge(world, 0);
+		dJointAttach(joint, body, 0);
+		dJointSetHingeAnchor(joint, x - 0.5f, 1, z);
+		dJointSetHingeAxis(joint, 0, 1, 0);
+	}
+	return body;
+}
+
+/** Measures the time per frame of the GrabSolver for a grabbed door in a
+ * world with the passed number of other doors and drawers.
+ * @param unrelatedEnabled if false the unrelated objects are disabled (as
+ * required by the GrabSolver), otherwise they are stepped with every frame
+ */
+static double run(unsigned unrelatedObjects, bool unrelatedEnabled) {
+	dWorldID world = dWorldCreate();
+	GrabSolver solver(world);
+	TransformationData target = identityTransformation();
+	unsigned i;
+
+	for (i = 0; i < unrelatedObjects; i++) {
+		dBodyID body = createJointedObject(world, i + 1);
+		if (!unrelatedEnabled)
+			dBodyDisable(body);
+	} // for
+	dBodyID door = createJointedObject(world, 0);
+
+	target.position = gmtl::Vec3f(0, 1, 0);
+	double start = inVRsUtilities::Timer::getMonotonicTime();
+	for (i = 0; i < MEASURED_FRAMES; i++) {
+		// the hand opens the door step by step
+		float angle = 0.01f * i;
+		target.orientation = gmtl::Quatf(0, sinf(angle / 2), 0, cosf(angle / 2));
+		solver.solve(door, target, STEPS_PER_FRAME);
+	} // for
+	double time = inVRsUtilities::Timer::getMonotonicTime() - start;
+
+	solver.release();
+	dWorldDestroy(world);
+	return time / MEASURED_FRAMES;
+}
+
+/** Headless benchmark for the GrabSolver of the JointInteraction module. A
+ * door is opened while a growing number of unrelated doors and drawers exists
+ * in the same ODE world. Reports the time per frame when only the grabbed
+ * island is enabled and when all objects are stepped.
+ */
+int main() {
+	static const unsigned objectCounts[] = {0, 10, 100, 1000};
+
+	printf("%s\n", "time per frame [ms]");
+	printf("%10s %22s %22s\n", "unrelated", "grabbed island only", "all objects enabled");
+	for (unsigned c = 0; c < sizeof(objectCounts) / sizeof(objectCounts[0]); c++) {
+		double isolated = run(objectCounts[c], false);
+		double all = run(objectCounts[c], true);
+		printf("%10u %22.3f %22.3f\n", objectCounts[c], isolated * 1e3, all * 1e3);
+	} // for
+	dCloseODE();
+	return 0;
+}
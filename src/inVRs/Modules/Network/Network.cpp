@@ -38,8 +38,13 @@
 #include "Network.h"
 #include "ServerThread.h"
 #include "SendReceiveThread.h"
+#ifdef INVRS_ENABLE_NETWORK_IMPAIRMENT
+#include "NetworkImpairment.h"
+#endif
 #include <inVRs/SystemCore/Configuration.h>
 #include <inVRs/SystemCore/DebugOutput.h>
+#include <inVRs/SystemCore/MessageFunctions.h>
+#include <inVRs/SystemCore/NetworkTime.h>
 #include <inVRs/SystemCore/Platform.h>
 #include <inVRs/SystemCore/UserDatabase/UserDatabase.h>
 #include <inVRs/SystemCore/UtilityFunctions.h>
@@ -116,6 +121,9 @@ Network::Network() {
 	recvListLock = NULL;
 
 	sendRecvObj = NULL;
+#ifdef INVRS_ENABLE_NETWORK_IMPAIRMENT
+	impairment = NULL;
+#endif
 	sendRecvThread = NULL;
 	serverThread = NULL;
 	newSocketListEntry = NULL;
@@ -165,6 +173,26 @@ bool Network::loadConfig(std::string configFile) {
 		ipAddress = document->getAttributeValue("network.localIP.value");
 	} // if
 
+#ifdef INVRS_ENABLE_NETWORK_IMPAIRMENT
+	impairment = new NetworkImpairment();
+	if (!impairment->loadConfig(document.get())) {
+		printd(ERROR,
+				"Network::loadConfig(): invalid <impairment> element found! Please fix your Network module configuration file!\n");
+		delete impairment;
+		impairment = NULL;
+		return false;
+	} // if
+	if (!impairment->isActive()) {
+		delete impairment;
+		impairment = NULL;
+	} // if
+#else
+	if (document->getElements("network.impairment.rule").size() > 0) {
+		printd(WARNING,
+				"Network::loadConfig(): ignoring <impairment> element, Network module is compiled without INVRS_ENABLE_NETWORK_IMPAIRMENT!\n");
+	} // if
+#endif
+
 	if (ipAddress.length() > 0) {
 		success = this->init(portTCP, portUDP, ipAddress) && success;
 	} // if
@@ -200,6 +228,14 @@ void Network::cleanup() {
 	cleanupBarrier->enter(3);
 	printd(INFO, "Network::cleanup(): leaving barrier!\n");
 
+#ifdef INVRS_ENABLE_NETWORK_IMPAIRMENT
+	if (impairment) {
+		impairment->clear();
+		delete impairment;
+		impairment = NULL;
+	} // if
+#endif
+
 	SocketListEntry* entry;
 	if (socketList.size() > 0) {
 		if (socketList[0]->prioritizedMsg != NULL)
@@ -461,6 +497,8 @@ void Network::sendTransformation(TransformationData& trans, TransformationPipe*
 	netMsg.putUInt32((unsigned)pipe->getOwner()->getId()); // cast into 32-bit just to maintain compatibility with old code
 	netMsg.putUInt64(pipe->getPipeId());
 	addTransformationToBinaryMsg(&trans, &netMsg);
+	if (NetworkTime::isSynchronised())
+		msgFunctions::encode(NetworkTime::getTime(), &netMsg);
 
 	sendMessageToGroup(&netMsg, TRANSFORMATION_MANAGER_ID, NULL, useTCP); // broadcast
 }
@@ -60,6 +60,9 @@
 #include <inVRs/Modules/Network/NetworkSharedLibraryExports.h>
 
 class SendReceiveThread;
+#ifdef INVRS_ENABLE_NETWORK_IMPAIRMENT
+class NetworkImpairment;
+#endif
 
 class SendListEntry {
 public:
@@ -110,7 +113,9 @@ public:
 	/**
 	 * Loads the configuration of the module from the passed config-file.
 	 * It currently reads the ports for UDP and TCP from the file and calls the
-	 * init-method.
+	 * init-method. The optional impairment element is only evaluated if the
+	 * module is compiled with INVRS_ENABLE_NETWORK_IMPAIRMENT (see
+	 * NetworkImpairment).
 	 */
 	virtual bool loadConfig(std::string configFile);
 
@@ -394,6 +399,9 @@ protected:
 #endif
 	SocketListEntry* newSocketListEntry;
 	SendReceiveThread* sendRecvObj;
+#ifdef INVRS_ENABLE_NETWORK_IMPAIRMENT
+	NetworkImpairment* impairment; // NULL if no impairment is configured
+#endif
 	SyncPipe<NetworkIdentification*> killedSocketsPipe; // filled by SendRecv Thread
 
 	static const uint32_t normalMsgTag;
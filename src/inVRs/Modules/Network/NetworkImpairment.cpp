@@ -0,0 +1,347 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                Changes                                    *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+\*---------------------------------------------------------------------------*/
+
+
+#include "NetworkImpairment.h"
+
+#ifdef INVRS_ENABLE_NETWORK_IMPAIRMENT
+
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+#include <inVRs/SystemCore/DebugOutput.h>
+#include <inVRs/SystemCore/Timer.h>
+#include <inVRs/SystemCore/XmlDocument.h>
+#include <inVRs/SystemCore/XmlElement.h>
+
+namespace {
+
+// offset of the channel id in a message of the send lists (behind the message tag)
+const unsigned CHANNEL_ID_OFFSET = 4;
+
+bool parseChoice(const XmlElement* element, std::string attribute, const char* first,
+		const char* second, int& dst) {
+	std::string value;
+
+	dst = -1;
+	if (!element->hasAttribute(attribute))
+		return true;
+	value = element->getAttributeValue(attribute);
+	if (value == first)
+		dst = 0;
+	else if (value == second)
+		dst = 1;
+	else if (value != "both")
+		return false;
+	return true;
+} // parseChoice
+
+double getMilliseconds(const XmlElement* element, std::string attribute, double defaultValue) {
+	if (!element->hasAttribute(attribute))
+		return defaultValue;
+	return element->getAttributeValueAsFloat(attribute) / 1000.0;
+} // getMilliseconds
+
+double getProbability(const XmlElement* element, std::string attribute) {
+	if (!element->hasAttribute(attribute))
+		return 0;
+	return element->getAttributeValueAsFloat(attribute);
+} // getProbability
+
+} // namespace
+
+NetworkImpairment::NetworkImpairment() :
+	sequenceNumber(0) {
+} // NetworkImpairment
+
+NetworkImpairment::~NetworkImpairment() {
+	clear();
+} // ~NetworkImpairment
+
+bool NetworkImpairment::loadConfig(const XmlDocument* document) {
+	std::vector<const XmlElement*> elements = document->getElements("network.impairment.rule");
+	std::vector<const XmlElement*>::iterator it;
+	uint32_t seed = 1;
+	std::string peer;
+	std::string::size_type colon;
+	Rule rule;
+
+	if (document->hasAttribute("network.impairment.seed"))
+		seed = (uint32_t)document->getAttributeValueAsInt("network.impairment.seed");
+
+	rules.clear();
+	for (it = elements.begin(); it != elements.end(); ++it) {
+		const XmlElement* element = *it;
+		memset(&rule, 0, sizeof(rule));
+		if (!parseChoice(element, "direction", "send", "receive", rule.direction)
+				|| !parseChoice(element, "protocol", "TCP", "UDP", rule.protocol)) {
+			printd(ERROR,
+					"NetworkImpairment::loadConfig(): invalid direction or protocol in rule %u!\n",
+					(unsigned)rules.size());
+			return false;
+		} // if
+
+		rule.channel = ANY;
+		if (element->hasAttribute("channel"))
+			rule.channel = element->getAttributeValueAsInt("channel");
+
+		if (element->hasAttribute("peer")) {
+			peer = element->getAttributeValue("peer");
+			colon = peer.find(':');
+			rule.peerAddress = NetworkInterface::ipAddressFromString(peer.substr(0, colon));
+			if (colon != std::string::npos)
+				rule.peerPort = (unsigned)atoi(peer.substr(colon + 1).c_str());
+		} // if
+
+		rule.latency = getMilliseconds(element, "latency", 0);
+		rule.jitter = getMilliseconds(element, "jitter", 0);
+		rule.reorderDelay = getMilliseconds(element, "reorderDelay", rule.latency + rule.jitter);
+		rule.retransmitDelay = getMilliseconds(element, "retransmitDelay", 0.2);
+		rule.loss = getProbability(element, "loss");
+		rule.duplicate = getProbability(element, "duplicate");
+		rule.reorder = getProbability(element, "reorder");
+		if (rule.latency < 0 || rule.jitter < 0 || rule.reorderDelay < 0 || rule.retransmitDelay
+				< 0 || rule.loss < 0 || rule.loss > 1 || rule.duplicate < 0 || rule.duplicate > 1
+				|| rule.reorder < 0 || rule.reorder > 1) {
+			printd(ERROR,
+					"NetworkImpairment::loadConfig(): invalid times or probabilities in rule %u!\n",
+					(unsigned)rules.size());
+			return false;
+		} // if
+
+		// independent, never zero state for every rule
+		rule.randomState = (seed ^ ((uint32_t)rules.size() * 0x9E3779B9u)) * 2654435761u;
+		if (rule.randomState == 0)
+			rule.randomState = 0x2545F491u;
+		rules.push_back(rule);
+	} // for
+
+	if (rules.size() > 0)
+		printd(WARNING, "NetworkImpairment::loadConfig(): impairing network traffic with %u rules "
+			"(seed %u)!\n", (unsigned)rules.size(), seed);
+	return true;
+} // loadConfig
+
+bool NetworkImpairment::isActive() const {
+	return rules.size() > 0;
+} // isActive
+
+bool NetworkImpairment::impairSend(NetMessage* msg, const NetworkIdentification& destination) {
+	int channelId = ANY;
+	double lossValue, delayValue, reorderValue, duplicateValue, duplicateDelayValue;
+	double now, delay;
+	Rule* rule;
+
+	if (rules.size() == 0)
+		return false;
+	if (msg->getBufferSize() > CHANNEL_ID_OFFSET)
+		channelId = msg->getBufferPointer()[CHANNEL_ID_OFFSET];
+	rule = findRule(0, 1, channelId, destination);
+	if (!rule)
+		return false;
+
+	// always draw the same random numbers, so one property does not change the others
+	lossValue = random(rule);
+	delayValue = random(rule);
+	reorderValue = random(rule);
+	duplicateValue = random(rule);
+	duplicateDelayValue = random(rule);
+	rule->messages++;
+
+	if (lossValue < rule->loss) {
+		rule->dropped++;
+		return true;
+	} // if
+
+	now = inVRsUtilities::Timer::getMonotonicTime();
+	delay = rule->latency + rule->jitter * delayValue;
+	if (reorderValue < rule->reorder) {
+		delay += rule->reorderDelay;
+		rule->reordered++;
+	} // if
+	enqueue(sendQueue, now + delay, new NetMessage(msg), destination, (uint8_t)channelId);
+
+	if (duplicateValue < rule->duplicate) {
+		enqueue(sendQueue, now + rule->latency + rule->jitter * duplicateDelayValue,
+				new NetMessage(msg), destination, (uint8_t)channelId);
+		rule->duplicated++;
+	} // if
+	return true;
+} // impairSend
+
+bool NetworkImpairment::impairReceive(NetMessage* msg, uint8_t channelId, bool tcp,
+		const NetworkIdentification& source) {
+	double lossValue, delayValue, reorderValue, duplicateValue, duplicateDelayValue;
+	double now, delay, releaseTime;
+	Rule* rule;
+
+	if (rules.size() == 0)
+		return false;
+	rule = findRule(1, tcp ? 0 : 1, channelId, source);
+	if (!rule)
+		return false;
+
+	lossValue = random(rule);
+	delayValue = random(rule);
+	reorderValue = random(rule);
+	duplicateValue = random(rule);
+	duplicateDelayValue = random(rule);
+	rule->messages++;
+
+	now = inVRsUtilities::Timer::getMonotonicTime();
+	delay = rule->latency + rule->jitter * delayValue;
+
+	if (tcp) {
+		// TCP delivers every message in order, a loss costs a retransmission
+		std::pair<uint32_t, unsigned> peer(source.address.ipAddress, source.address.portTCP);
+		if (lossValue < rule->loss) {
+			delay += rule->retransmitDelay;
+			rule->dropped++;
+		} // if
+		releaseTime = std::max(now + delay, lastTCPRelease[peer]);
+		lastTCPRelease[peer] = releaseTime;
+		enqueue(receiveQueue, releaseTime, msg, source, channelId);
+		return true;
+	} // if
+
+	if (lossValue < rule->loss) {
+		rule->dropped++;
+		delete msg;
+		return true;
+	} // if
+	if (duplicateValue < rule->duplicate) {
+		enqueue(receiveQueue, now + rule->latency + rule->jitter * duplicateDelayValue,
+				new NetMessage(msg), source, channelId);
+		rule->duplicated++;
+	} // if
+	if (reorderValue < rule->reorder) {
+		delay += rule->reorderDelay;
+		rule->reordered++;
+	} // if
+	enqueue(receiveQueue, now + delay, msg, source, channelId);
+	return true;
+} // impairReceive
+
+NetMessage* NetworkImpairment::popDueSend(double time, NetworkIdentification& destination) {
+	QueuedMessage entry;
+	NetMessage* result = popDue(sendQueue, time, entry);
+
+	if (result)
+		destination = entry.peer;
+	return result;
+} // popDueSend
+
+NetMessage* NetworkImpairment::popDueReceive(double time, uint8_t& channelId) {
+	QueuedMessage entry;
+	NetMessage* result = popDue(receiveQueue, time, entry);
+
+	if (result)
+		channelId = entry.channelId;
+	return result;
+} // popDueReceive
+
+double NetworkImpairment::getTimeout(double time, double maxTimeout) const {
+	double result = maxTimeout;
+
+	if (sendQueue.size() > 0)
+		result = std::min(result, sendQueue.begin()->first.first - time);
+	if (receiveQueue.size() > 0)
+		result = std::min(result, receiveQueue.begin()->first.first - time);
+	return std::max(result, 0.0);
+} // getTimeout
+
+void NetworkImpairment::clear() {
+	MessageQueue::iterator it;
+
+	for (it = sendQueue.begin(); it != sendQueue.end(); ++it)
+		delete it->second.msg;
+	sendQueue.clear();
+	for (it = receiveQueue.begin(); it != receiveQueue.end(); ++it)
+		delete it->second.msg;
+	receiveQueue.clear();
+	lastTCPRelease.clear();
+
+	for (unsigned i = 0; i < rules.size(); i++) {
+		if (rules[i].messages > 0)
+			printd(INFO, "NetworkImpairment::clear(): rule %u impaired %u messages, %u dropped, "
+				"%u duplicated, %u reordered\n", i, rules[i].messages, rules[i].dropped,
+					rules[i].duplicated, rules[i].reordered);
+	} // for
+} // clear
+
+NetworkImpairment::Rule* NetworkImpairment::findRule(int direction, int protocol, int channelId,
+		const NetworkIdentification& peer) {
+	for (unsigned i = 0; i < rules.size(); i++) {
+		Rule& rule = rules[i];
+		if ((rule.direction == ANY || rule.direction == direction) && (rule.protocol == ANY
+				|| rule.protocol == protocol) && (rule.channel == ANY || rule.channel == channelId)
+				&& (rule.peerAddress == 0 || rule.peerAddress == peer.address.ipAddress)
+				&& (rule.peerPort == 0 || rule.peerPort == peer.address.portTCP || rule.peerPort
+						== peer.address.portUDP))
+			return &rule;
+	} // for
+	return NULL;
+} // findRule
+
+double NetworkImpairment::random(Rule* rule) {
+	// xorshift32, independent of rand() which is used by the application
+	uint32_t x = rule->randomState;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	rule->randomState = x;
+	return x / 4294967296.0;
+} // random
+
+void NetworkImpairment::enqueue(MessageQueue& queue, double releaseTime, NetMessage* msg,
+		const NetworkIdentification& peer, uint8_t channelId) {
+	QueuedMessage entry;
+
+	entry.msg = msg;
+	entry.peer = peer;
+	entry.channelId = channelId;
+	queue[std::make_pair(releaseTime, sequenceNumber++)] = entry;
+} // enqueue
+
+NetMessage* NetworkImpairment::popDue(MessageQueue& queue, double time, QueuedMessage& dst) {
+	if (queue.size() == 0 || queue.begin()->first.first > time)
+		return NULL;
+	dst = queue.begin()->second;
+	queue.erase(queue.begin());
+	return dst.msg;
+} // popDue
+
+#endif // INVRS_ENABLE_NETWORK_IMPAIRMENT
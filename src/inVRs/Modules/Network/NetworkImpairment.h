@@ -0,0 +1,176 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                Changes                                    *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+\*---------------------------------------------------------------------------*/
+
+
+#ifndef _NETWORKIMPAIRMENT_H
+#define _NETWORKIMPAIRMENT_H
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <inVRs/SystemCore/NetMessage.h>
+#include <inVRs/SystemCore/ComponentInterfaces/NetworkInterface.h>
+
+class XmlDocument;
+
+/******************************************************************************
+ * Emulates latency, jitter, loss, duplication and reordering of messages for
+ * experiments on a local network. The stage is only compiled into the Network
+ * module if INVRS_ENABLE_NETWORK_IMPAIRMENT is defined (CMake option of the
+ * same name).
+ *
+ * Outgoing UDP messages are impaired between the sendListUDP and the socket,
+ * incoming TCP and UDP messages before they are put into the receive lists.
+ * TCP messages are never lost or reordered, a lost TCP message is delivered
+ * after an additional retransmission delay instead.
+ *
+ * The rules are read from the Network module configuration, the first rule
+ * matching a message is applied:
+ *
+ *   <impairment seed="42">
+ *     <rule direction="send" protocol="UDP" channel="2" peer="127.0.0.1:8092"
+ *         latency="50" jitter="20" loss="0.02" duplicate="0.01" reorder="0.05"
+ *         reorderDelay="30" retransmitDelay="200"/>
+ *   </impairment>
+ *
+ * direction is send, receive or both (default), protocol is TCP, UDP or both
+ * (default), channel is the channel id of the message (default: all
+ * channels) and peer is the IP address and the TCP or UDP port of the remote
+ * participant (default: all, the port may be omitted). Times are in
+ * milliseconds, probabilities between 0 and 1. Each rule draws its random
+ * numbers from an own generator seeded with seed, so a run with the same
+ * messages is impaired the same way.
+ *
+ * All methods except loadConfig() must only be called by the
+ * SendReceiveThread.
+ */
+class NetworkImpairment {
+public:
+	NetworkImpairment();
+	~NetworkImpairment();
+
+	/** Reads the impairment element of the Network configuration.
+	 * @return false if the configuration is invalid
+	 */
+	bool loadConfig(const XmlDocument* document);
+
+	/** Returns true if at least one rule is configured.
+	 */
+	bool isActive() const;
+
+	/** Impairs an outgoing UDP message to one destination.
+	 * @param msg message as it is passed to the socket (read pointer at 0)
+	 * @return false if the message has to be sent right away, true if it was
+	 *         dropped or queued (the stage sends a copy later)
+	 */
+	bool impairSend(NetMessage* msg, const NetworkIdentification& destination);
+
+	/** Impairs an incoming message whose channel id was already read.
+	 * @return false if the message has to be delivered right away, true if the
+	 *         stage took the ownership of the message
+	 */
+	bool impairReceive(NetMessage* msg, uint8_t channelId, bool tcp,
+			const NetworkIdentification& source);
+
+	/** Returns the next queued outgoing message which is due at the given time.
+	 * The caller takes the ownership of the message.
+	 */
+	NetMessage* popDueSend(double time, NetworkIdentification& destination);
+
+	/** Returns the next queued incoming message which is due at the given time.
+	 * The caller takes the ownership of the message.
+	 */
+	NetMessage* popDueReceive(double time, uint8_t& channelId);
+
+	/** Returns how long the SendReceiveThread may wait for socket activity
+	 * without delaying a queued message.
+	 */
+	double getTimeout(double time, double maxTimeout) const;
+
+	/** Deletes all queued messages and prints the statistics of the rules.
+	 */
+	void clear();
+
+private:
+	enum {
+		ANY = -1
+	};
+
+	struct Rule {
+		int direction; // 0 = send, 1 = receive
+		int protocol; // 0 = TCP, 1 = UDP
+		int channel;
+		uint32_t peerAddress; // 0 = any
+		unsigned peerPort; // 0 = any
+		double latency;
+		double jitter;
+		double loss;
+		double duplicate;
+		double reorder;
+		double reorderDelay;
+		double retransmitDelay;
+		uint32_t randomState;
+		unsigned messages;
+		unsigned dropped;
+		unsigned duplicated;
+		unsigned reordered;
+	}; // Rule
+
+	struct QueuedMessage {
+		NetMessage* msg;
+		NetworkIdentification peer;
+		uint8_t channelId;
+	}; // QueuedMessage
+
+	// ordered by release time, the sequence number keeps equal times in FIFO order
+	typedef std::map<std::pair<double, unsigned>, QueuedMessage> MessageQueue;
+
+	Rule* findRule(int direction, int protocol, int channelId, const NetworkIdentification& peer);
+	double random(Rule* rule);
+	void enqueue(MessageQueue& queue, double releaseTime, NetMessage* msg,
+			const NetworkIdentification& peer, uint8_t channelId);
+	NetMessage* popDue(MessageQueue& queue, double time, QueuedMessage& dst);
+
+	std::vector<Rule> rules;
+	MessageQueue sendQueue;
+	MessageQueue receiveQueue;
+	unsigned sequenceNumber;
+	// release time of the last TCP message per peer, TCP keeps the order
+	std::map<std::pair<uint32_t, unsigned>, double> lastTCPRelease;
+}; // NetworkImpairment
+
+#endif // _NETWORKIMPAIRMENT_H
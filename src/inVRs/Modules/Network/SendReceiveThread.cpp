@@ -31,9 +31,14 @@
 
 #include "SendReceiveThread.h"
 #include "Network.h"
+#ifdef INVRS_ENABLE_NETWORK_IMPAIRMENT
+#include "NetworkImpairment.h"
+#endif
 #include <inVRs/SystemCore/EventManager/EventManager.h>
 #include <inVRs/SystemCore/DebugOutput.h>
 #include <inVRs/SystemCore/Platform.h>
+#include <inVRs/SystemCore/Profiler.h>
+#include <inVRs/SystemCore/Timer.h>
 #include <inVRs/SystemCore/UserDatabase/UserDatabase.h>
 #include <inVRs/SystemCore/UserDatabase/UserDatabaseEvents.h>
 #include <inVRs/SystemCore/ComponentInterfaces/NetworkInterface.h>
@@ -62,36 +67,40 @@ void SendReceiveThread::run(void* dummy) {
 	// 	internalNetwork = dynamic_cast<Network*>(UserDatabase::getLocalUser()->getModuleByName("Network"));
 
 	printd(INFO, "SendReceiveThread::run(): entering method\n");
+	inVRsUtilities::Profiler::setThreadName("SendReceiveThread");
 
 	assert(internalNetwork->sendListLock != NULL);
 	assert(internalNetwork->socketListLock != NULL);
 
 	while (!me->shutdown) {
+		{
+			INVRS_PROFILE_ZONE("SendReceiveThread::updateSendList");
 #if OSG_MAJOR_VERSION >= 2
-		internalNetwork->sendListLock->acquire();
-		internalNetwork->socketListLock->acquire();
+			internalNetwork->sendListLock->acquire();
+			internalNetwork->socketListLock->acquire();
 #else //OpenSG1:
-		internalNetwork->sendListLock->aquire();
-		internalNetwork->socketListLock->aquire();
+			internalNetwork->sendListLock->aquire();
+			internalNetwork->socketListLock->aquire();
 #endif
 
-		// Setting nextMessagePointers in socketList of Network to next messages to send!!!
-		if (socketListCopy != NULL) {
-			me->adjustNextMsgPointers(socketListCopy, socketListEntries);
-		} // if
+			// Setting nextMessagePointers in socketList of Network to next messages to send!!!
+			if (socketListCopy != NULL) {
+				me->adjustNextMsgPointers(socketListCopy, socketListEntries);
+			} // if
 
-		// create array of available Sockets
-		socketListEntries = me->createLocalCopy(&socketListCopy);
-		//		 		printd(INFO, "SendReceiveThread::run(): %i number of connections found!\n", localCopyEntries);
+			// create array of available Sockets
+			socketListEntries = me->createLocalCopy(&socketListCopy);
+			//		 		printd(INFO, "SendReceiveThread::run(): %i number of connections found!\n", localCopyEntries);
 
-		// fills next messages into matching TCP-sockets in socketListCopy and grabs next UDP-message to send
-		me->updateSendListTCP(socketListCopy, socketListEntries);
-		me->updateSendListUDP(nextUDPMsg, socketListEntries);
-		internalNetwork->socketListLock->release();
-		internalNetwork->sendListLock->release();
+			// fills next messages into matching TCP-sockets in socketListCopy and grabs next UDP-message to send
+			me->updateSendListTCP(socketListCopy, socketListEntries);
+			me->updateSendListUDP(nextUDPMsg, socketListEntries);
+			internalNetwork->socketListLock->release();
+			internalNetwork->sendListLock->release();
 
-		// Check if some prioritizedMessages have to be sent!!
-		me->checkForPrioritizedMessages(socketListCopy, socketListEntries);
+			// Check if some prioritizedMessages have to be sent!!
+			me->checkForPrioritizedMessages(socketListCopy, socketListEntries);
+		}
 
 		//		printd(INFO, "SendReceiveThread::run(): FOUND %i socketListEntries!\n", socketListEntries);
 
@@ -102,6 +111,13 @@ void SendReceiveThread::run(void* dummy) {
 			// now we are setting up a socket selection which includes
 			// all sockets which have a message to deliver.
 			me->initializeSocketSelection(sel, nextUDPMsg, socketListCopy, socketListEntries);
+			INVRS_PROFILE_ZONE("SendReceiveThread::transfer");
+
+#ifdef INVRS_ENABLE_NETWORK_IMPAIRMENT
+			// send and deliver the messages held back by the impairment stage
+			if (internalNetwork->impairment)
+				me->releaseImpairedMessages();
+#endif
 
 			// check if we are allowed to send a udp message if there is one available
 			if (nextUDPMsg && sel.isSetWrite(internalNetwork->socketUDP))
@@ -298,7 +314,8 @@ int SendReceiveThread::findIndexOfMsg(NetMessage* msg) {
 	return i;
 }
 
-void SendReceiveThread::receiveMessage(NetMessage* msg, SocketListEntry* recvdBy) {
+void SendReceiveThread::receiveMessage(NetMessage* msg, SocketListEntry* recvdBy,
+		const NetworkIdentification* udpSource) {
 	uint32_t tag;
 	uint8_t channelID;
 	std::string ipAddressStr;
@@ -336,6 +353,16 @@ void SendReceiveThread::receiveMessage(NetMessage* msg, SocketListEntry* recvdBy
 	channelID = msg->getUInt8();
 
 	//	printd("SendReceiveThread::receiveMessage(): received a normal message from %s with tag %u for channel %u\n", ipAddressStr.c_str(), tag, channelID);
+#ifdef INVRS_ENABLE_NETWORK_IMPAIRMENT
+	if (internalNetwork->impairment && (recvdBy || udpSource)
+			&& internalNetwork->impairment->impairReceive(msg, channelID, recvdBy != NULL,
+					recvdBy ? recvdBy->id.netId : *udpSource))
+		return;
+#endif
+	deliverMessage(msg, channelID);
+} // receiveMessage
+
+void SendReceiveThread::deliverMessage(NetMessage* msg, uint8_t channelID) {
 #if OSG_MAJOR_VERSION >= 2
 	internalNetwork->recvListLock->acquire();
 #else //OpenSG1:
@@ -345,7 +372,7 @@ void SendReceiveThread::receiveMessage(NetMessage* msg, SocketListEntry* recvdBy
 		internalNetwork->recvList[channelID] = new std::deque<NetMessage*>;
 	internalNetwork->recvList[channelID]->push_back(msg);
 	internalNetwork->recvListLock->release();
-}
+} // deliverMessage
 
 void SendReceiveThread::decreaseReferenceCounter(SendListEntry* sendListEntry, int idxInSendList,
 		NetworkIdentification connectionCausedDec) {
@@ -514,6 +541,14 @@ void SendReceiveThread::initializeSocketSelection(SocketSelection& sel, SendList
 			sel.setWrite(*(socketListCopy[i].socketTCP));
 	} // for
 
+#ifdef INVRS_ENABLE_NETWORK_IMPAIRMENT
+	// wake up in time for the next message held back by the impairment stage
+	if (internalNetwork->impairment) {
+		sel.select(internalNetwork->impairment->getTimeout(
+				inVRsUtilities::Timer::getMonotonicTime(), 0.01));
+		return;
+	} // if
+#endif
 	sel.select(0.01);
 } // initializeSocketSelection
 
@@ -540,6 +575,12 @@ void SendReceiveThread::sendUDPMessage(SendListEntry* &nextUDPMsg, SocketListEnt
 		//		destinationPort = socketListCopy[j].id.netId.address.portUDP;
 		//		printd(INFO, "SendReceiveThread::sendUDPMessage(): sending message to %s:%u\n", destinationIP.c_str(), destinationPort);
 
+#ifdef INVRS_ENABLE_NETWORK_IMPAIRMENT
+		if (internalNetwork->impairment && internalNetwork->impairment->impairSend(
+				nextUDPMsg->msg, socketListCopy[j].id.netId))
+			continue;
+#endif
+
 		Network::sendNetMessageTo(&internalNetwork->socketUDP,
 				OSG::SocketAddress(NetworkInterface::ipAddressToString(
 						socketListCopy[j].id.netId.address.ipAddress).c_str(),
@@ -556,9 +597,48 @@ void SendReceiveThread::receiveUDPMessage() {
 
 	// 	printd("SendReceiveThread::receiveUDPMessage(): receiving a udp message\n");
 	Network::receiveNetMessageFrom(&internalNetwork->socketUDP, &dummySocketAddress, copy);
+#ifdef INVRS_ENABLE_NETWORK_IMPAIRMENT
+	if (internalNetwork->impairment) {
+		// the impairment rules match the sender by its address only
+		NetworkIdentification source;
+		source.address.ipAddress = NetworkInterface::ipAddressFromString(
+				dummySocketAddress.getHost());
+		source.address.portUDP = dummySocketAddress.getPort();
+		source.address.portTCP = 0;
+		source.processId = 0;
+		receiveMessage(copy, NULL, &source);
+		return;
+	} // if
+#endif
 	receiveMessage(copy, NULL);
 } // receiveUDPMessage
 
+#ifdef INVRS_ENABLE_NETWORK_IMPAIRMENT
+void SendReceiveThread::releaseImpairedMessages() {
+	NetworkImpairment* impairment = internalNetwork->impairment;
+	double now = inVRsUtilities::Timer::getMonotonicTime();
+	NetworkIdentification destination;
+	NetMessage* msg;
+	uint8_t channelID;
+
+	while ((msg = impairment->popDueSend(now, destination)) != NULL) {
+		try {
+			Network::sendNetMessageTo(&internalNetwork->socketUDP, OSG::SocketAddress(
+					NetworkInterface::ipAddressToString(destination.address.ipAddress).c_str(),
+					destination.address.portUDP), msg);
+		} catch (SocketException &e) {
+			printd(WARNING,
+					"SendReceiveThread::releaseImpairedMessages(): failed to send udp message: %s\n",
+					e.what());
+		} // catch
+		delete msg;
+	} // while
+
+	while ((msg = impairment->popDueReceive(now, channelID)) != NULL)
+		deliverMessage(msg, channelID);
+} // releaseImpairedMessages
+#endif
+
 void SendReceiveThread::handleConnectionRequestPrioritizedMsg(SocketListEntry* connections,
 		int entries) {
 	int i;
@@ -138,7 +138,14 @@ protected:
 	 * Beside this and as mentioned in the description for handlePrioritizedMsgs() it is
 	 * also involved in more complicated procedures (like connection requests).
 	 */
-	void receiveMessage(NetMessage* msg, SocketListEntry* recvdBy);
+	void receiveMessage(NetMessage* msg, SocketListEntry* recvdBy,
+			const NetworkIdentification* udpSource = NULL);
+
+	/**
+	 * Puts a normal message whose channel id was already read into the
+	 * recvList of the channel.
+	 */
+	void deliverMessage(NetMessage* msg, uint8_t channelID);
 	
 	/**
 	 * This method manages decreasing of the reference counters of a SendListEntry and also releases
@@ -158,6 +165,14 @@ protected:
 	void sendUDPMessage(SendListEntry* &nextUDPMsg, SocketListEntry* socketListCopy, int entries);
 	void receiveUDPMessage();
 
+#ifdef INVRS_ENABLE_NETWORK_IMPAIRMENT
+	/**
+	 * Sends and delivers the messages whose delay in the NetworkImpairment
+	 * has expired.
+	 */
+	void releaseImpairedMessages();
+#endif
+
 	/**
 	 * This method waits for the answers of all partners to the previous sent
 	 * connectionRequest. It does this by iterating over all sockets and waiting
@@ -38,6 +38,7 @@
 #include "TransformationManager/TransformationManager.h"
 #include "../InputInterface/InputInterface.h"
 #include "../OutputInterface/OutputInterface.h"
+#include "Profiler.h"
 
 ApplicationBase* ApplicationBase::_instance = NULL;
 
@@ -121,6 +122,10 @@ bool ApplicationBase::start(int argc, char** argv) {
 void ApplicationBase::globalCleanup() {
 	cleanup();
 	SystemCore::cleanup();
+	if (_profilerLogFile.size() > 0)
+		inVRsUtilities::Profiler::writeStatistics(_profilerLogFile);
+	if (_profilerTraceFile.size() > 0)
+		inVRsUtilities::Profiler::writeChromeTrace(_profilerTraceFile);
 	printd_finalize();
 	if (_logFile)
 		fclose(_logFile);
@@ -128,9 +133,9 @@ void ApplicationBase::globalCleanup() {
 } // globalCleanup
 
 void ApplicationBase::globalUpdate() {
-	_appProfiler.step("remaining display (GLUT)");
-	_appProfiler.end();
-	_appProfiler.start();
+	inVRsUtilities::Profiler::markFrame();
+	INVRS_PROFILE_ZONE("ApplicationBase::globalUpdate");
+
 	if (_lastTime <= 0)
 		_lastTime = timer.getTime();
 
@@ -140,18 +145,20 @@ void ApplicationBase::globalUpdate() {
 	// Avoid negative or zero timesteps
 	if (dt <= 0) {
 		_lastTime = currentTime;
-		_appProfiler.interrupt();
 		return;
 	} // if
 
 	float secToNextFrame = _timeToNextFrame - dt;
-	while (secToNextFrame > 0) {
-		double usecToNextFrame = ((double)secToNextFrame)*1000000;
-		usleep((unsigned int)usecToNextFrame);
-		currentTime = timer.getTime();
-		dt = currentTime - _lastTime;
-		secToNextFrame = _timeToNextFrame - dt;
-	} // while
+	if (secToNextFrame > 0) {
+		INVRS_PROFILE_ZONE("ApplicationBase.MaxFrameRate wait");
+		while (secToNextFrame > 0) {
+			double usecToNextFrame = ((double)secToNextFrame)*1000000;
+			usleep((unsigned int)usecToNextFrame);
+			currentTime = timer.getTime();
+			dt = currentTime - _lastTime;
+			secToNextFrame = _timeToNextFrame - dt;
+		} // while
+	} // if
 
 	_timeToNextFrame -= dt;
 	assert(_timeToNextFrame < 0);
@@ -162,36 +169,43 @@ void ApplicationBase::globalUpdate() {
 	if (_timeToNextFrame < 0)
 		_timeToNextFrame = 0;
 
-	_appProfiler.step("ApplicationBase.MaxFrameRate calculations");
 	// update SystemCore
-	SystemCore::step();
-	_appProfiler.step("SystemCore::step");
+	{
+		INVRS_PROFILE_ZONE("SystemCore::step");
+		SystemCore::step();
+	}
 
 	if (controllerManager && controllerManager->getController()) {
+		INVRS_PROFILE_ZONE("ApplicationBase::_updateController");
 		_updateController(dt);
 	} // if
-	_appProfiler.step("ApplicationBase::_updateController");
 
 	if (disableAutomaticModuleUpdate()) {
+		INVRS_PROFILE_ZONE("ApplicationBase::manualModuleUpdate");
 		manualModuleUpdate(dt);
-		_appProfiler.step("ApplicationBase::manualModuleUpdate");
 	} // if
 	else {
 		_updateModules(dt);
 	} // else
 
 	// call application's display method
-	display(dt);
-	_appProfiler.step("user display");
+	{
+		INVRS_PROFILE_ZONE("user display");
+		display(dt);
+	}
 
 	// execute remaining Transformation-pipes
-	TransformationManager::step(dt);
-	_appProfiler.step("TransformationManager::step(2/2)");
+	{
+		INVRS_PROFILE_ZONE("TransformationManager::step(2/2)");
+		TransformationManager::step(dt);
+	}
 
 	// TODO: check if we have to do this somewhere sooner
-	UserDatabase::updateCursors(dt);
-	WorldDatabase::updateAvatars(dt);
-	_appProfiler.step("WorldDatabase::updateAvatars");
+	{
+		INVRS_PROFILE_ZONE("WorldDatabase::updateAvatars");
+		UserDatabase::updateCursors(dt);
+		WorldDatabase::updateAvatars(dt);
+	}
 } // globalUpdate
 
 bool ApplicationBase::_init(const CommandLineArgumentWrapper& args) {
@@ -283,9 +297,15 @@ bool ApplicationBase::_loadConfiguration(std::string configFile) {
 			printd_severity(ERROR);
 	} // if
 	if (Configuration::contains("ApplicationBase.profilerLogFile")) {
-		std::string profilerLogFile = Configuration::getString("ApplicationBase.profilerLogFile");
-		_appProfiler.setLogFile(profilerLogFile);
+		_profilerLogFile = Configuration::getString("ApplicationBase.profilerLogFile");
+		inVRsUtilities::Profiler::setEnabled(true);
+	} // if
+	if (Configuration::contains("ApplicationBase.profilerTraceFile")) {
+		_profilerTraceFile = Configuration::getString("ApplicationBase.profilerTraceFile");
+		inVRsUtilities::Profiler::setEnabled(true);
 	} // if
+	if (inVRsUtilities::Profiler::isEnabled())
+		inVRsUtilities::Profiler::setThreadName("main");
 
 	if (Configuration::contains("ApplicationBase.useLogFile")) {
 		std::string logFileName = Configuration::getString("ApplicationBase.useLogFile");
@@ -384,34 +404,40 @@ void ApplicationBase::_initOutputInterface(ModuleInterface* moduleInterface) {
 void ApplicationBase::_initModule(ModuleInterface* module) {
 	// must be true because registration was after setting instance member
 	assert(_instance);
+	_instance->_moduleZoneNames[module] =
+		inVRsUtilities::Profiler::internName(module->getName() + "::update");
 	_instance->initModuleCallback(module);
 } // _initModule
 
 void ApplicationBase::_updateModules(float dt) {
 	// update Navigation
 	if (navigationModule) {
+		INVRS_PROFILE_ZONE("Navigation::update");
 		navigationModule->update(dt);
 	} // if
-	_appProfiler.step("Navigation::update");
 
 	// Make TransformationManager-step to calculate Tracking-Pipe and Navigation-Pipe
-	TransformationManager::step(dt, 0x0D000000);
-	_appProfiler.step("TransformationManager::step(1/2)");
+	{
+		INVRS_PROFILE_ZONE("TransformationManager::step(1/2)");
+		TransformationManager::step(dt, 0x0D000000);
+	}
 
 	// update Interaction
 	if (interactionModule) {
+		INVRS_PROFILE_ZONE("Interaction::step");
 		interactionModule->update(dt);
 	} // if
-	_appProfiler.step("Interaction::step");
 
 	const std::map<std::string, ModuleInterface*>& moduleMap = SystemCore::getModuleMap();
 	std::map<std::string, ModuleInterface*>::const_iterator it;
+	std::map<ModuleInterface*, const char*>::iterator zoneIt;
 	ModuleInterface* module;
 	for (it = moduleMap.begin(); it != moduleMap.end(); ++it) {
 		module = it->second;
 		if (module != navigationModule && module != interactionModule) {
+			zoneIt = _moduleZoneNames.find(module);
+			INVRS_PROFILE_ZONE(zoneIt != _moduleZoneNames.end() ? zoneIt->second : "module update");
 			module->update(dt);
-			_appProfiler.step(module->getName() + "::update");
 		} // if
 	} // for
 } // _updateModules
@@ -38,7 +38,6 @@
 
 #include "SystemCore.h"
 #include "CommandLineArguments.h"
-#include "ProfilingHelper.h"
 
 #include "UserDatabase/User.h"
 
@@ -240,8 +239,13 @@ private:
 	/// List of all active tracking pipes
 	std::vector<TransformationPipe*> _trackingPipes;
 
-	/// Profiling class to find out slow parts of the inVRs application
-	inVRsUtilities::ProfilingHelper _appProfiler;
+	/// File to which the profiler statistics are written on cleanup
+	std::string _profilerLogFile;
+	/// File to which the profiler trace is written on cleanup
+	std::string _profilerTraceFile;
+	/// Profiler zone names of the module updates, interned when the module
+	/// is initialized
+	std::map<ModuleInterface*, const char*> _moduleZoneNames;
 }; // ApplicationBase
 
 //ApplicationBase* createApplication(int argc, char** argv);
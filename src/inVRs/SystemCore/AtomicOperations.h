@@ -0,0 +1,123 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                Changes                                    *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+\*---------------------------------------------------------------------------*/
+
+
+#ifndef _ATOMICOPERATIONS_H
+#define _ATOMICOPERATIONS_H
+
+#include "Platform.h"
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+/**
+ * Minimal set of atomic operations for lock-free data structures shared
+ * between threads (e.g. single-producer/single-consumer ring buffers).
+ * All operations imply a full memory barrier.
+ */
+namespace inVRsUtilities {
+
+/**
+ * Atomically adds amount to value.
+ * @return the new value
+ */
+inline uint32_t atomicAdd(volatile uint32_t* value, uint32_t amount) {
+#ifdef WIN32
+	return (uint32_t)InterlockedExchangeAdd((volatile LONG*)value, (LONG)amount) + amount;
+#else
+	return __sync_add_and_fetch(value, amount);
+#endif
+} // atomicAdd
+
+/**
+ * Atomically increments value.
+ * @return the new value
+ */
+inline uint32_t atomicIncrement(volatile uint32_t* value) {
+	return atomicAdd(value, 1);
+} // atomicIncrement
+
+/**
+ * Atomically sets value to newValue and returns the previous value.
+ */
+inline uint32_t atomicExchange(volatile uint32_t* value, uint32_t newValue) {
+#ifdef WIN32
+	return (uint32_t)InterlockedExchange((volatile LONG*)value, (LONG)newValue);
+#else
+	return __sync_lock_test_and_set(value, newValue);
+#endif
+} // atomicExchange
+
+/**
+ * Sets value to newValue if it is equal to oldValue.
+ * @return true if value was changed
+ */
+inline bool atomicCompareAndSwap(volatile uint32_t* value, uint32_t oldValue,
+		uint32_t newValue) {
+#ifdef WIN32
+	return (uint32_t)InterlockedCompareExchange((volatile LONG*)value,
+			(LONG)newValue, (LONG)oldValue) == oldValue;
+#else
+	return __sync_bool_compare_and_swap(value, oldValue, newValue);
+#endif
+} // atomicCompareAndSwap
+
+/**
+ * Sets pointer to newValue if it is equal to oldValue.
+ * @return true if pointer was changed
+ */
+inline bool atomicCompareAndSwapPointer(void* volatile* pointer, void* oldValue,
+		void* newValue) {
+#ifdef WIN32
+	return InterlockedCompareExchangePointer(pointer, newValue, oldValue) == oldValue;
+#else
+	return __sync_bool_compare_and_swap(pointer, oldValue, newValue);
+#endif
+} // atomicCompareAndSwapPointer
+
+/**
+ * Full memory barrier: no load or store is moved across this call.
+ */
+inline void memoryBarrier() {
+#ifdef WIN32
+	MemoryBarrier();
+#else
+	__sync_synchronize();
+#endif
+} // memoryBarrier
+
+} // inVRsUtilities
+
+#endif /* _ATOMICOPERATIONS_H */
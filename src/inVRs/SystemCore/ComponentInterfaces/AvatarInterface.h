@@ -108,6 +108,31 @@ public:
 	 */
 	virtual void update(float dt) {};
 
+	/**
+	 * Splits update() into three phases so that the expensive part of the
+	 * updates of many avatars can run in parallel. beginUpdate() and
+	 * endUpdate() are called from the main thread, updateParallel() is only
+	 * called if beginUpdate() returned true and can be executed by a worker
+	 * thread concurrently with updateParallel() of other avatars.
+	 * The default implementation does the whole update in beginUpdate().
+	 * @return true if updateParallel() has to be called
+	 */
+	virtual bool beginUpdate(float dt) {
+		update(dt);
+		return false;
+	} // beginUpdate
+
+	/**
+	 * Thread safe part of the update, must not access OpenSG field containers
+	 * or data of other avatars.
+	 */
+	virtual void updateParallel() {};
+
+	/**
+	 * Finishes the update started by beginUpdate().
+	 */
+	virtual void endUpdate() {};
+
 protected:
 	friend class User;
 
@@ -132,6 +132,9 @@ public:
 	 * Visibility of Event is encoded in Event directly (visibilityLevel member)
 	 * For now the EventManager sets a key "destinationUserId" to tell the network module if the event is addressed for a specific user
 	 * The EventManager polls incomming events from the channel EVENT_MANAGER_ID
+	 * The EventManager itself sends batches of Events (see EventBatcher), this
+	 * method sends a single Event at once and bypasses the batching and the
+	 * ordering of the Event priorities.
 	 */
 	virtual void sendEvent(Event* event) = 0;
 
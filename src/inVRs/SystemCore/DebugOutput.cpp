@@ -26,17 +26,29 @@
 \*---------------------------------------------------------------------------*/
 
 #include "DebugOutput.h"
+#include "AtomicOperations.h"
+#include "Platform.h"
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
 #include <OpenSG/OSGThreadManager.h>
 #include <OpenSG/OSGThread.h>
 
-#include <sstream>
-
 #ifdef USE_PTHREADS
 	#include <pthread.h>
 	#include <execinfo.h>
 #endif
+// usleep is declared in Platform.h on Windows
+#ifndef WIN32
+	#include <unistd.h>
+#endif
+
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define snprintf _snprintf
+#endif
+
+using namespace inVRsUtilities;
 
 #if OSG_MAJOR_VERSION >= 2
 static OSG::LockRefPtr printdLock = NULL;
@@ -46,20 +58,57 @@ static OSG::Lock* printdLock = NULL;
 static FILE* _printd_stream = stderr;
 static SEVERITY _printd_severity = INFO;
 
-void printd_severity(SEVERITY severity) {
-	_printd_severity = severity;
-} // printd_severity
-
-void printd_init(FILE* stream) {
-	_printd_stream = stream;
-} // printd_init
-
-void printd_finalize() {
-	fflush(_printd_stream);
-} // printd_finalize
+//*****************************************************************************
+// asynchronous output and rate limiting
+//*****************************************************************************
+
+// number of messages per thread ring buffer (must be a power of two)
+static const uint32_t PRINTD_RINGBUFFER_SIZE = 256;
+static const uint32_t PRINTD_MESSAGE_SIZE = 256;
+// number of call sites for rate limiting (must be a power of two)
+static const uint32_t PRINTD_CALLSITE_TABLE_SIZE = 1024;
+static const uint32_t PRINTD_CALLSITE_PROBES = 8;
+
+struct PrintdMessage {
+	SEVERITY severity;
+	char text[PRINTD_MESSAGE_SIZE];
+};
+
+/**
+ * Single-producer/single-consumer ring buffer. The owning thread is the only
+ * one writing messages, readers are serialized by printdLock. Ring buffers
+ * are never freed since the writer thread may access them at any time.
+ */
+struct PrintdRingBuffer {
+	volatile uint32_t writeIndex;
+	volatile uint32_t readIndex;
+	volatile uint32_t droppedMessages;
+	unsigned int threadId;
+	PrintdRingBuffer* next;
+	PrintdMessage messages[PRINTD_RINGBUFFER_SIZE];
+};
+
+struct PrintdCallSite {
+	void* volatile fmt;
+	volatile uint32_t second;
+	volatile uint32_t count;
+	volatile uint32_t suppressed;
+};
+
+static volatile bool _printd_async = false;
+static volatile bool _printd_writer_shutdown = false;
+static bool _printd_writer_started = false;
+#if OSG_MAJOR_VERSION >= 2
+static OSG::ThreadRefPtr _printd_writer_thread = NULL;
+#else //OpenSG1:
+static OSG::Thread* _printd_writer_thread = NULL;
+#endif
+static uint32_t _printd_rate_limit = 0;
+static void* volatile _printd_ringbuffer_list = NULL;
+static INVRS_THREAD_LOCAL PrintdRingBuffer* _printd_thread_ringbuffer = NULL;
+static PrintdCallSite _printd_callsites[PRINTD_CALLSITE_TABLE_SIZE];
 
-INVRS_SYSTEMCORE_API void printd(const char* fmt, ...) {
-#ifdef DEBUGOUTP
+static void acquirePrintdLock() {
 	if (!printdLock)
 #if OSG_MAJOR_VERSION >= 2
 		printdLock = OSG::dynamic_pointer_cast<OSG::Lock> (OSG::ThreadManager::the()->getLock("printdLock",false));
@@ -73,103 +122,338 @@ INVRS_SYSTEMCORE_API void printd(const char* fmt, ...) {
 #else //OpenSG1:
 		printdLock->aquire();
 #endif
+} // acquirePrintdLock
 
-	va_list args;
-	va_start(args, fmt);
-
-	fprintf(_printd_stream, "(\?\?) ");
-#ifdef USE_PTHREADS
-	fprintf(_printd_stream, "Thread 0x%08X ", (unsigned int)pthread_self());
-#endif
-
-	vfprintf(_printd_stream, fmt, args);
-
-	va_end(args);
-
+static void releasePrintdLock() {
 	if (printdLock)
 		printdLock->release();
-#endif
-}
-
-
-INVRS_SYSTEMCORE_API void _printd(SEVERITY severity, const char* fun, unsigned int line, const char* fmt, ...) {
-#ifdef DEBUGOUTP
-	if ((int) severity < _printd_severity)
-		return;
-		
-	std::ostringstream s;
-	s << fun << ":" << line << ": " << fmt;
-	
-	va_list args;
-	va_start(args, fmt);
-	
-	vprintd(severity, s.str().c_str(), args);
-	
-	va_end(args);
-#endif
-}
+} // releasePrintdLock
 
-INVRS_SYSTEMCORE_API void vprintd(SEVERITY severity, const char* fmt, va_list args) {
-#ifdef DEBUGOUTP
-	if ((int) severity < _printd_severity)
-		return;
-	
-	if (!printdLock)
-#if OSG_MAJOR_VERSION >= 2
-		printdLock = OSG::dynamic_pointer_cast<OSG::Lock> (OSG::ThreadManager::the()->getLock("printdLock",false));
-#else //OpenSG1:
-		printdLock = dynamic_cast<OSG::Lock*> (OSG::ThreadManager::the()->getLock("printdLock"));
-#endif
-
-	if (printdLock)
-#if OSG_MAJOR_VERSION >= 2
-		printdLock->acquire();
-#else //OpenSG1:
-		printdLock->aquire();
+static unsigned int currentThreadId() {
+#ifdef USE_PTHREADS
+	return (unsigned int)pthread_self();
+#else
+	return 0;
 #endif
+} // currentThreadId
 
+static void writePrefix(SEVERITY severity, unsigned int threadId) {
 	switch(severity) {
 	case DEBUG:
-		fprintf(_printd_stream, "(DD) ");
+		fputs("(DD) ", _printd_stream);
 		break;
 	case INFO:
-		fprintf(_printd_stream, "(II) ");
+		fputs("(II) ", _printd_stream);
 		break;
 	case WARNING:
-		fprintf(_printd_stream, "(WW) ");
+		fputs("(WW) ", _printd_stream);
 		break;
 	case ERROR:
-		fprintf(_printd_stream, "(EE) ");
+		fputs("(EE) ", _printd_stream);
 		break;
 	default:
-		fprintf(_printd_stream, "(\?\?) ");
+		fputs("(\?\?) ", _printd_stream);
 	}
 
 #ifdef USE_PTHREADS
-	fprintf(_printd_stream, "Thread 0x%08X ", (unsigned int)pthread_self());
+	fprintf(_printd_stream, "Thread 0x%08X ", threadId);
 #endif
+} // writePrefix
+
+/**
+ * Writes all messages from the ring buffers to the output stream. Must only
+ * be called while holding printdLock.
+ */
+static void drainRingBuffers() {
+	PrintdRingBuffer* buffer = (PrintdRingBuffer*)_printd_ringbuffer_list;
+	uint32_t readIndex, writeIndex, dropped;
+	bool wroteMessages = false;
+
+	for (; buffer; buffer = buffer->next) {
+		readIndex = buffer->readIndex;
+		writeIndex = buffer->writeIndex;
+		// make sure that message contents are read after the write index
+		memoryBarrier();
+		for (; readIndex != writeIndex; readIndex++) {
+			PrintdMessage& message =
+				buffer->messages[readIndex & (PRINTD_RINGBUFFER_SIZE - 1)];
+			writePrefix(message.severity, buffer->threadId);
+			fputs(message.text, _printd_stream);
+			wroteMessages = true;
+		} // for
+		// release the slots only after the messages were copied
+		memoryBarrier();
+		buffer->readIndex = readIndex;
+
+		dropped = atomicExchange(&buffer->droppedMessages, 0);
+		if (dropped > 0) {
+			writePrefix(WARNING, buffer->threadId);
+			fprintf(_printd_stream, "printd: %u messages dropped because the ring buffer was full\n",
+					dropped);
+			wroteMessages = true;
+		} // if
+	} // for
+
+	if (wroteMessages)
+		fflush(_printd_stream);
+} // drainRingBuffers
+
+static void printdWriterThread(void*) {
+	while (!_printd_writer_shutdown) {
+		if (_printd_async) {
+			acquirePrintdLock();
+			drainRingBuffers();
+			releasePrintdLock();
+		} // if
+		usleep(10000);
+	} // while
+} // printdWriterThread
+
+static PrintdRingBuffer* getThreadRingBuffer() {
+	if (!_printd_thread_ringbuffer) {
+		PrintdRingBuffer* buffer = new PrintdRingBuffer;
+		buffer->writeIndex = 0;
+		buffer->readIndex = 0;
+		buffer->droppedMessages = 0;
+		buffer->threadId = currentThreadId();
+		do {
+			buffer->next = (PrintdRingBuffer*)_printd_ringbuffer_list;
+		} while (!atomicCompareAndSwapPointer(&_printd_ringbuffer_list, buffer->next, buffer));
+		_printd_thread_ringbuffer = buffer;
+	} // if
+	return _printd_thread_ringbuffer;
+} // getThreadRingBuffer
+
+static PrintdCallSite* getCallSite(const char* fmt) {
+	uint32_t hash = (uint32_t)(((size_t)fmt >> 2) * 2654435761u);
+	uint32_t i;
+	PrintdCallSite* site;
+
+	for (i = 0; i < PRINTD_CALLSITE_PROBES; i++) {
+		site = &_printd_callsites[(hash + i) & (PRINTD_CALLSITE_TABLE_SIZE - 1)];
+		if (site->fmt == fmt)
+			return site;
+		if (site->fmt == NULL &&
+				atomicCompareAndSwapPointer(&site->fmt, NULL, (void*)fmt))
+			return site;
+		if (site->fmt == fmt)
+			return site;
+	} // for
+	// table is full: do not limit this call site
+	return NULL;
+} // getCallSite
+
+/**
+ * Checks if a message from the passed call site may be printed.
+ * @param suppressedBefore set to the number of messages which were suppressed
+ *        since the last printed message of this call site
+ */
+static bool checkRateLimit(const char* fmt, uint32_t& suppressedBefore) {
+	suppressedBefore = 0;
+	uint32_t limit = _printd_rate_limit;
+	if (limit == 0)
+		return true;
+
+	PrintdCallSite* site = getCallSite(fmt);
+	if (!site)
+		return true;
+
+	uint32_t now = (uint32_t)time(NULL);
+	uint32_t second = site->second;
+	if (second != now && atomicCompareAndSwap(&site->second, second, now)) {
+		atomicExchange(&site->count, 0);
+		suppressedBefore = atomicExchange(&site->suppressed, 0);
+	} // if
+	if (atomicIncrement(&site->count) > limit) {
+		atomicIncrement(&site->suppressed);
+		return false;
+	} // if
+	return true;
+} // checkRateLimit
+
+static void enqueueMessage(SEVERITY severity, const char* fun, unsigned int line,
+		const char* fmt, va_list args) {
+	PrintdRingBuffer* buffer = getThreadRingBuffer();
+	uint32_t writeIndex = buffer->writeIndex;
+	int length = 0;
+	int result;
+
+	if (writeIndex - buffer->readIndex >= PRINTD_RINGBUFFER_SIZE) {
+		atomicIncrement(&buffer->droppedMessages);
+		return;
+	} // if
+
+	PrintdMessage& message = buffer->messages[writeIndex & (PRINTD_RINGBUFFER_SIZE - 1)];
+	message.severity = severity;
+	if (fun)
+		length = snprintf(message.text, PRINTD_MESSAGE_SIZE, "%s:%u: ", fun, line);
+	if (length < 0 || length >= (int)PRINTD_MESSAGE_SIZE)
+		length = 0;
+	result = vsnprintf(message.text + length, PRINTD_MESSAGE_SIZE - length, fmt, args);
+	if (result < 0 || result >= (int)PRINTD_MESSAGE_SIZE - length) {
+		// message was truncated: keep the line break
+		strcpy(message.text + PRINTD_MESSAGE_SIZE - 5, "...\n");
+	} // if
+
+	// the message has to be complete before the consumer sees the new index
+	memoryBarrier();
+	buffer->writeIndex = writeIndex + 1;
+} // enqueueMessage
+
+static void writeMessage(SEVERITY severity, const char* fun, unsigned int line,
+		const char* fmt, va_list args) {
+	if (_printd_async && severity != ERROR) {
+		enqueueMessage(severity, fun, line, fmt, args);
+		return;
+	} // if
+
+	acquirePrintdLock();
+
+	// keep the order of messages of the current thread
+	if (_printd_async)
+		drainRingBuffers();
 
+	writePrefix(severity, currentThreadId());
+	if (fun)
+		fprintf(_printd_stream, "%s:%u: ", fun, line);
 	vfprintf(_printd_stream, fmt, args);
 
 	if (_printd_stream != stderr && _printd_stream != stdout && severity
 			== ERROR)
 		fflush(_printd_stream);
 
-	if (printdLock)
-		printdLock->release();
+	releasePrintdLock();
+} // writeMessage
+
+static void writeNote(SEVERITY severity, const char* fun, unsigned int line,
+		const char* fmt, ...) {
+	va_list args;
+	va_start(args, fmt);
+	writeMessage(severity, fun, line, fmt, args);
+	va_end(args);
+} // writeNote
+
+static void printMessage(SEVERITY severity, const char* fun, unsigned int line,
+		const char* fmt, va_list args) {
+	uint32_t suppressedBefore;
+	if (!checkRateLimit(fmt, suppressedBefore))
+		return;
+	if (suppressedBefore > 0)
+		writeNote(severity, fun, line, "%u similar messages suppressed\n", suppressedBefore);
+	writeMessage(severity, fun, line, fmt, args);
+} // printMessage
+
+//*****************************************************************************
+// public interface
+//*****************************************************************************
+
+void printd_severity(SEVERITY severity) {
+	_printd_severity = severity;
+} // printd_severity
+
+void printd_init(FILE* stream) {
+	_printd_stream = stream;
+} // printd_init
+
+void printd_finalize() {
+	if (_printd_writer_started) {
+		_printd_async = false;
+		_printd_writer_shutdown = true;
+		// the writer must not access the stream after finalize returns
+		OSG::Thread::join(_printd_writer_thread);
+		_printd_writer_thread = NULL;
+		_printd_writer_started = false;
+		acquirePrintdLock();
+		drainRingBuffers();
+		releasePrintdLock();
+	} // if
+	fflush(_printd_stream);
+} // printd_finalize
+
+INVRS_SYSTEMCORE_API bool printd_enabled(SEVERITY severity) {
+	return (int) severity >= _printd_severity;
+} // printd_enabled
+
+INVRS_SYSTEMCORE_API void printd_async(bool enable) {
+#ifdef DEBUGOUTP
+	if (enable && !_printd_writer_started) {
+#if OSG_MAJOR_VERSION >= 2
+		_printd_writer_thread = OSG::dynamic_pointer_cast<OSG::Thread> (
+				OSG::ThreadManager::the()->getThread("printdWriterThread",false));
+#else //OpenSG1:
+		_printd_writer_thread = dynamic_cast<OSG::Thread *> (
+				OSG::ThreadManager::the()->getThread("printdWriterThread"));
+#endif
+		if (!_printd_writer_thread) {
+			fputs("(WW) printd_async(): unable to create the writer thread!\n", _printd_stream);
+			return;
+		} // if
+		_printd_writer_shutdown = false;
+		_printd_writer_thread->runFunction(printdWriterThread, 0, NULL);
+		_printd_writer_started = true;
+	} // if
+
+	if (!enable && _printd_async) {
+		_printd_async = false;
+		acquirePrintdLock();
+		drainRingBuffers();
+		releasePrintdLock();
+		return;
+	} // if
+
+	_printd_async = enable;
+#endif
+} // printd_async
+
+INVRS_SYSTEMCORE_API void printd_rate_limit(unsigned maxMessagesPerSecond) {
+	_printd_rate_limit = maxMessagesPerSecond;
+} // printd_rate_limit
+
+INVRS_SYSTEMCORE_API void printd(const char* fmt, ...) {
+#ifdef DEBUGOUTP
+	va_list args;
+	va_start(args, fmt);
+
+	printMessage(UNKNOWN, NULL, 0, fmt, args);
+
+	va_end(args);
+#endif
+}
+
+
+INVRS_SYSTEMCORE_API void _printd(SEVERITY severity, const char* fun, unsigned int line, const char* fmt, ...) {
+#ifdef DEBUGOUTP
+	if ((int) severity < _printd_severity || (int) severity < INVRS_PRINTD_MIN_SEVERITY)
+		return;
+
+	va_list args;
+	va_start(args, fmt);
+
+	printMessage(severity, fun, line, fmt, args);
+
+	va_end(args);
+#endif
+}
+
+INVRS_SYSTEMCORE_API void vprintd(SEVERITY severity, const char* fmt, va_list args) {
+#ifdef DEBUGOUTP
+	if ((int) severity < _printd_severity || (int) severity < INVRS_PRINTD_MIN_SEVERITY)
+		return;
+
+	printMessage(severity, NULL, 0, fmt, args);
 #endif
 }
 
 
 INVRS_SYSTEMCORE_API void printd(SEVERITY severity, const char* fmt, ...) {
 #ifdef DEBUGOUTP
-	if ((int) severity < _printd_severity)
+	if ((int) severity < _printd_severity || (int) severity < INVRS_PRINTD_MIN_SEVERITY)
 		return;
 		
 	va_list args;
 	va_start(args, fmt);
 
-	vprintd(severity, fmt, args);
+	printMessage(severity, NULL, 0, fmt, args);
 
 	va_end(args);
 #endif
@@ -177,19 +461,9 @@ INVRS_SYSTEMCORE_API void printd(SEVERITY severity, const char* fmt, ...) {
 
 INVRS_SYSTEMCORE_API void printStacktrace() {
 #if defined(DEBUGOUTP)
-	if (!printdLock)
-#if OSG_MAJOR_VERSION >= 2
-		printdLock = OSG::dynamic_pointer_cast<OSG::Lock> (OSG::ThreadManager::the()->getLock("printdLock",false));
-#else //OpenSG1:
-		printdLock = dynamic_cast<OSG::Lock*> (OSG::ThreadManager::the()->getLock("printdLock"));
-#endif
-
-	if (printdLock)
-#if OSG_MAJOR_VERSION >= 2
-		printdLock->acquire();
-#else //OpenSG1:
-		printdLock->aquire();
-#endif
+	acquirePrintdLock();
+	if (_printd_async)
+		drainRingBuffers();
 
 #if defined(USE_PTHREADS)
 	fprintf(_printd_stream, "(DD) BEGIN Stack information\n");
@@ -209,7 +483,6 @@ INVRS_SYSTEMCORE_API void printStacktrace() {
 #endif
 
 	fflush(_printd_stream);
-	if (printdLock)
-		printdLock->release();
+	releasePrintdLock();
 #endif
 } //printStacktrace
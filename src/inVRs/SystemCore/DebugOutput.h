@@ -56,16 +56,55 @@ enum SEVERITY {
 	DEBUG, INFO, WARNING, ERROR, UNKNOWN
 };
 
-#define PRINTD(STATUS, FMT, ...) _printd(STATUS, __FUNCTION__ ,__LINE__,FMT, ##__VA_ARGS__)
-#define PRINTD_I(FMT, ...) _printd(INFO,    __FUNCTION__ ,__LINE__,FMT, ##__VA_ARGS__)
-#define PRINTD_W(FMT, ...) _printd(WARNING, __FUNCTION__ ,__LINE__,FMT, ##__VA_ARGS__)
-#define PRINTD_E(FMT, ...) _printd(ERROR,   __FUNCTION__ ,__LINE__,FMT, ##__VA_ARGS__)
-#define PRINTD_D(FMT, ...) _printd(DEBUG,   __FUNCTION__ ,__LINE__,FMT, ##__VA_ARGS__)
+/**
+ * Messages logged via the PRINTD macros with a severity below
+ * INVRS_PRINTD_MIN_SEVERITY are removed at compile time (0 = DEBUG, 1 = INFO,
+ * 2 = WARNING, 3 = ERROR). Calls of the printd() functions are not removed,
+ * they only return before formatting the message if SystemCore was built
+ * with the same INVRS_PRINTD_MIN_SEVERITY (or if printd_severity() is set
+ * higher).
+ */
+#ifndef INVRS_PRINTD_MIN_SEVERITY
+#define INVRS_PRINTD_MIN_SEVERITY 0
+#endif
+
+/**
+ * Evaluates to true if messages of the passed severity are compiled in and
+ * not suppressed by printd_severity(). Can be used to avoid building
+ * arguments for messages which would not be printed anyway.
+ */
+#define PRINTD_ENABLED(STATUS) ((int)(STATUS) >= INVRS_PRINTD_MIN_SEVERITY && printd_enabled(STATUS))
+
+#define PRINTD(STATUS, FMT, ...) do { if ((int)(STATUS) >= INVRS_PRINTD_MIN_SEVERITY) _printd(STATUS, __FUNCTION__ ,__LINE__,FMT, ##__VA_ARGS__); } while (0)
+#define PRINTD_I(FMT, ...) PRINTD(INFO,    FMT, ##__VA_ARGS__)
+#define PRINTD_W(FMT, ...) PRINTD(WARNING, FMT, ##__VA_ARGS__)
+#define PRINTD_E(FMT, ...) PRINTD(ERROR,   FMT, ##__VA_ARGS__)
+#define PRINTD_D(FMT, ...) PRINTD(DEBUG,   FMT, ##__VA_ARGS__)
 
 
 INVRS_SYSTEMCORE_API void printd_severity(SEVERITY severity);
-void printd_init(FILE* stream);
-void printd_finalize();
+INVRS_SYSTEMCORE_API void printd_init(FILE* stream);
+INVRS_SYSTEMCORE_API void printd_finalize();
+INVRS_SYSTEMCORE_API bool printd_enabled(SEVERITY severity);
+
+/**
+ * Enables or disables asynchronous output. When enabled, messages are
+ * formatted into per-thread ring buffers without taking a lock and are
+ * written to the output stream by a background thread. Messages from
+ * different threads may therefore be written out of order. ERROR messages
+ * are always written synchronously. If a ring buffer is full the message is
+ * dropped and the number of dropped messages is reported later.
+ * printd_finalize() writes all pending messages.
+ */
+INVRS_SYSTEMCORE_API void printd_async(bool enable);
+
+/**
+ * Limits the number of messages per second which are printed from a single
+ * call site (identified by its format string). Suppressed messages are
+ * counted and reported when the next message of that call site is printed.
+ * @param maxMessagesPerSecond limit per call site, 0 disables rate limiting
+ */
+INVRS_SYSTEMCORE_API void printd_rate_limit(unsigned maxMessagesPerSecond);
 
 INVRS_SYSTEMCORE_API void printd(const char* fmt, ...);
 INVRS_SYSTEMCORE_API void _printd(SEVERITY severity, const char* fun, unsigned int line, const char* fmt, ...);
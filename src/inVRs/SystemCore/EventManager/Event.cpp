@@ -33,6 +33,8 @@
 #include "Event.h"
 #include "../UserDatabase/UserDatabase.h"
 #include "../Timer.h"
+#include "../NetworkTime.h"
+#include "../MessageFunctions.h"
 
 Event::Event() {
 	evt_eventId = 0;
@@ -41,6 +43,8 @@ Event::Event() {
 	evt_eventName = "";
 	evt_timestamp = 0;
 	evt_sequenceNumber = 0;
+	evt_networkTime = 0;
+	evt_priority = PRIORITY_NORMAL;
 }
 
 Event::Event(unsigned srcModuleId, unsigned dstModuleId, std::string eventName) {
@@ -50,6 +54,8 @@ Event::Event(unsigned srcModuleId, unsigned dstModuleId, std::string eventName)
 	this->evt_timestamp = (unsigned)timer.getTimeInMilliseconds();
 	evt_userId = UserDatabase::getLocalUserId();
 	evt_sequenceNumber = generateSequenceNumber();
+	evt_networkTime = NetworkTime::getTime();
+	evt_priority = PRIORITY_NORMAL;
 } // Event
 
 Event::~Event() {
@@ -72,6 +78,7 @@ NetMessage* Event::completeEncode() {
 	ret->putUInt32(evt_sequenceNumber);
 	ret->putUInt32(evt_timestamp);
 	ret->putUInt32(evt_userId);
+	msgFunctions::encode(evt_networkTime, ret);
 
 	encode(ret);
 
@@ -85,6 +92,7 @@ void Event::completeDecode(NetMessage* message, std::string eventName) {
 	message->getUInt32(evt_sequenceNumber);
 	message->getUInt32(evt_timestamp);
 	message->getUInt32(evt_userId);
+	msgFunctions::decode(evt_networkTime, message);
 
 	decode(message);
 }
@@ -126,6 +134,18 @@ unsigned Event::getDstModuleId() {
 	return evt_dstModuleId;
 }
 
+double Event::getNetworkTime() {
+	return evt_networkTime;
+}
+
+void Event::setPriority(PRIORITY priority) {
+	evt_priority = priority;
+}
+
+Event::PRIORITY Event::getPriority() {
+	return evt_priority;
+}
+
 unsigned Event::generateSequenceNumber() {
 	return 0; // TODO implement this properly
 }
@@ -45,6 +45,21 @@
 
 class INVRS_SYSTEMCORE_API Event {
 public:
+	/**
+	 * Transmission priority of an Event. The EventManager sends the Events of
+	 * each priority in their own queue, normal Events can therefore overtake
+	 * bulk Events and vice versa. Events of the same priority keep their
+	 * order. A critical Event is sent at once, together with all normal and
+	 * bulk Events queued before it for the same receiver, so it never
+	 * arrives before the Events it may depend on.
+	 */
+	enum PRIORITY {
+		PRIORITY_CRITICAL = 0, /// small, latency sensitive control Events (user join, grab, ...)
+		PRIORITY_NORMAL = 1, /// default priority
+		PRIORITY_BULK = 2, /// large state transfers, e.g. synchronisation
+		NUMBER_OF_PRIORITIES = 3
+	};
+
 	Event(); /// empty constructor, for network deserialization
 
 	/**
@@ -62,7 +77,7 @@ public:
 	 * Visibilty management heavily relies on a specific network module.
 	 * The content of the visibilityLevel member will not be encoded!
 	 * Arguments can be set at any time before the event has been transmitted (by the Event itself, the EventManager ...)
-	 * @see Network::sendEvent()
+	 * @see EventManager::sendEventTo()
 	 */
 	ArgumentVector visibilityLevel;
 
@@ -109,6 +124,18 @@ public:
 	unsigned getSrcModuleId();
 	unsigned getDstModuleId();
 
+	/**
+	 * Returns the NetworkTime::getTime() of the creator of the Event, use
+	 * NetworkTime::toLocalTime() to convert it into the local time base.
+	 */
+	double getNetworkTime();
+
+	/**
+	 * Sets the transmission priority, the priority is not transmitted.
+	 */
+	void setPriority(PRIORITY priority);
+	PRIORITY getPriority();
+
 protected:
 
 	friend class EventManager;
@@ -120,6 +147,8 @@ protected:
 	unsigned evt_sequenceNumber; /// only for booking
 	unsigned evt_timestamp; /// when event has been created
 	unsigned evt_userId; /// id of user who triggered the event
+	double evt_networkTime; /// NetworkTime::getTime() when event has been created
+	PRIORITY evt_priority; /// transmission priority, not encoded
 
 	/**
 	 * Return a sequence number for an Event.
@@ -0,0 +1,165 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+
+#include "EventBatcher.h"
+
+#include <string.h>
+
+const uint32_t EventBatcher::BATCH_ID = 0;
+const unsigned EventBatcher::EVENT_OVERHEAD = 8;
+
+EventBatcher::EventBatcher(unsigned maxBatchSize, double maxDelay, unsigned bulkBytesPerCall) :
+	maxBatchSize(maxBatchSize),
+	maxDelay(maxDelay),
+	bulkBytesPerCall(bulkBytesPerCall) {
+} // EventBatcher
+
+EventBatcher::~EventBatcher() {
+	unsigned i, j;
+
+	for (i = 0; i < Event::NUMBER_OF_PRIORITIES; i++) {
+		for (j = 0; j < queues[i].size(); j++)
+			delete queues[i][j].msg;
+	} // for
+} // ~EventBatcher
+
+void EventBatcher::add(NetMessage* encodedEvent, unsigned destination,
+		Event::PRIORITY priority, double time) {
+	std::deque<Batch>& queue = queues[priority];
+	Batch batch;
+
+	// the critical Event may refer to Events queued before, e.g. the pick up
+	// of an entity to its creation
+	if (priority == Event::PRIORITY_CRITICAL)
+		promoteBatches(destination);
+
+	if (queue.empty() || queue.back().destination != destination
+			|| queue.back().msg->getBufferSize() + EVENT_OVERHEAD
+					+ encodedEvent->getBufferSize() > maxBatchSize) {
+		batch.destination = destination;
+		batch.priority = priority;
+		batch.numberOfEvents = 0;
+		batch.firstEventTime = time;
+		batch.msg = new NetMessage;
+		batch.msg->putUInt32(BATCH_ID);
+		queue.push_back(batch);
+	} // if
+
+	queue.back().msg->appendMessage(encodedEvent);
+	queue.back().numberOfEvents++;
+} // add
+
+void EventBatcher::getDueBatches(double time, bool force, std::vector<Batch>& dst) {
+	unsigned priority, bulkBytes = 0;
+	bool due;
+
+	for (priority = 0; priority < Event::NUMBER_OF_PRIORITIES; priority++) {
+		std::deque<Batch>& queue = queues[priority];
+		while (!queue.empty()) {
+			// all batches except the last one are closed
+			due = force || priority == Event::PRIORITY_CRITICAL || queue.size() > 1
+					|| time - queue.front().firstEventTime >= maxDelay;
+			if (!due)
+				break;
+			if (!force && priority == Event::PRIORITY_BULK && bulkBytes > 0
+					&& bulkBytes + queue.front().msg->getBufferSize() > bulkBytesPerCall)
+				break;
+			if (priority == Event::PRIORITY_BULK)
+				bulkBytes += queue.front().msg->getBufferSize();
+			dst.push_back(queue.front());
+			queue.pop_front();
+		} // while
+	} // for
+} // getDueBatches
+
+void EventBatcher::promoteBatches(unsigned destination) {
+	std::deque<Batch>::iterator it;
+	unsigned priority, i, lastBroadcast;
+	bool hasBroadcast;
+
+	for (priority = Event::PRIORITY_CRITICAL + 1; priority < Event::NUMBER_OF_PRIORITIES;
+			priority++) {
+		std::deque<Batch>& queue = queues[priority];
+
+		// a moved broadcast must not overtake the batches queued before it
+		// for other receivers, so everything up to it is moved as well
+		hasBroadcast = false;
+		lastBroadcast = 0;
+		for (i = 0; i < queue.size(); i++) {
+			if (destination == 0 || queue[i].destination == 0) {
+				hasBroadcast = true;
+				lastBroadcast = i;
+			} // if
+		} // for
+
+		i = 0;
+		it = queue.begin();
+		while (it != queue.end()) {
+			if ((hasBroadcast && i <= lastBroadcast) || it->destination == destination) {
+				queues[Event::PRIORITY_CRITICAL].push_back(*it);
+				it = queue.erase(it);
+			} // if
+			else
+				++it;
+			i++;
+		} // while
+	} // for
+} // promoteBatches
+
+bool EventBatcher::isEmpty() const {
+	unsigned i;
+
+	for (i = 0; i < Event::NUMBER_OF_PRIORITIES; i++) {
+		if (!queues[i].empty())
+			return false;
+	} // for
+	return true;
+} // isEmpty
+
+void EventBatcher::split(NetMessage* msg, std::vector<NetMessage*>& dst) {
+	NetMessage* single;
+	uint32_t eventId;
+	unsigned remaining;
+
+	eventId = msg->getUInt32();
+	if (eventId != BATCH_ID) {
+		// single Event, copy it since the read pointer can not be moved back
+		remaining = msg->getBufferSize() - msg->getReadPointerOffset();
+		single = new NetMessage;
+		single->putUInt32(eventId);
+		if (remaining > 0)
+			memcpy(single->allocateAtEnd(remaining), msg->getBufferPointer()
+					+ msg->getReadPointerOffset(), remaining);
+		dst.push_back(single);
+	} // if
+	else {
+		while (!msg->finished())
+			dst.push_back(msg->detachMessage());
+	} // else
+	delete msg;
+} // split
@@ -0,0 +1,126 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                Changes                                    *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+\*---------------------------------------------------------------------------*/
+
+
+#ifndef _EVENTBATCHER_H
+#define _EVENTBATCHER_H
+
+#include <deque>
+#include <vector>
+
+#include "Event.h"
+
+/******************************************************************************
+ * Collects encoded Events for the network and packs them into batches, so
+ * that a burst of small Events is sent as one NetMessage instead of one
+ * message per Event. Each Event priority has its own queue of batches. A new
+ * batch is started when the destination changes or the batch would exceed
+ * the maximum size, so the Events of one priority keep their order.
+ *
+ * getDueBatches() returns the critical batches immediately and the other
+ * batches once they are full or their oldest Event has waited for the
+ * maximum delay. Adding a critical Event moves the pending normal and bulk
+ * batches of the same receiver in front of it, so that it cannot overtake
+ * Events it depends on (bulk batches moved this way ignore the byte
+ * budget). The bulk batches returned by one call are limited to a byte
+ * budget, so that a large state transfer does not fill the send queue of the
+ * network in front of later Events.
+ *
+ * The class is not thread safe, the EventManager protects it with a lock.
+ */
+class INVRS_SYSTEMCORE_API EventBatcher {
+public:
+	struct Batch {
+		unsigned destination; /// user id, 0 for all users
+		Event::PRIORITY priority;
+		unsigned numberOfEvents;
+		double firstEventTime;
+		NetMessage* msg; /// owned by the receiver of the batch
+	}; // Batch
+
+	/** Constructor.
+	 * @param maxBatchSize maximum size of a batch in bytes, a single larger
+	 *        Event is sent in its own batch
+	 * @param maxDelay maximum time an Event waits for further Events in
+	 *        seconds (not used for critical Events)
+	 * @param bulkBytesPerCall maximum number of bytes of bulk batches returned
+	 *        by one call of getDueBatches(), at least one batch is returned
+	 */
+	EventBatcher(unsigned maxBatchSize, double maxDelay, unsigned bulkBytesPerCall);
+	~EventBatcher();
+
+	/** Appends an encoded Event.
+	 * @param encodedEvent result of Event::completeEncode(), it is copied
+	 * @param destination user id, 0 for all users
+	 * @param priority transmission priority of the Event
+	 * @param time current time in seconds
+	 */
+	void add(NetMessage* encodedEvent, unsigned destination, Event::PRIORITY priority,
+			double time);
+
+	/** Moves the batches which have to be sent at the passed time to dst. The
+	 * critical batches come first, followed by the normal and bulk batches.
+	 * @param time current time in seconds
+	 * @param force return all batches and ignore the bulk budget
+	 */
+	void getDueBatches(double time, bool force, std::vector<Batch>& dst);
+
+	bool isEmpty() const;
+
+	/** Splits a received message into the encoded Events. A message which
+	 * is no batch is returned as single Event.
+	 * @param msg received message starting at the read pointer, it is deleted
+	 * @param dst receives the encoded Events (must be deleted by the caller)
+	 */
+	static void split(NetMessage* msg, std::vector<NetMessage*>& dst);
+
+private:
+	/** Moves the pending normal and bulk batches which reach the passed
+	 * destination to the end of the critical queue, keeping their order.
+	 */
+	void promoteBatches(unsigned destination);
+
+	/// Event::completeEncode() never writes an Event id of 0
+	static const uint32_t BATCH_ID;
+	/// bytes added to a batch per Event (see NetMessage::appendMessage())
+	static const unsigned EVENT_OVERHEAD;
+
+	unsigned maxBatchSize;
+	double maxDelay;
+	unsigned bulkBytesPerCall;
+	std::deque<Batch> queues[Event::NUMBER_OF_PRIORITIES];
+}; // EventBatcher
+
+#endif // _EVENTBATCHER_H
@@ -37,8 +37,11 @@
 #include "../DebugOutput.h"
 #include "../UserDatabase/UserDatabase.h"
 #include "../Platform.h"
+#include "../Profiler.h"
 #include "../IdPoolListener.h"
 #include "../UtilityFunctions.h"
+#include "../Configuration.h"
+#include "../Timer.h"
 
 // disable deprecation warning for std::auto_ptr when std::unique_ptr is not available.
 #ifndef HAS_CXX11_UNIQUE_PTR
@@ -72,6 +75,12 @@ std::map<unsigned, std::string>					EventManager::idToEventName;
 #else //OpenSG1:
 Lock*											EventManager::loggingLock;
 #endif
+#if OSG_MAJOR_VERSION >= 2
+	LockRefPtr									EventManager::sendLock;
+#else //OpenSG1:
+Lock*											EventManager::sendLock;
+#endif
+EventBatcher*									EventManager::eventBatcher = NULL;
 std::vector<std::string>						EventManager::eventLogList;
 std::string										EventManager::logFile;
 
@@ -88,8 +97,10 @@ void EventManager::init() {
 	isRunning = false;
 #if OSG_MAJOR_VERSION >= 2
 	loggingLock = OSG::dynamic_pointer_cast<OSG::Lock> (ThreadManager::the()->getLock("loggingLock",false));
+	sendLock = OSG::dynamic_pointer_cast<OSG::Lock> (ThreadManager::the()->getLock("eventSendLock",false));
 #else //OpenSG1:
 	loggingLock = dynamic_cast<Lock*> (ThreadManager::the()->getLock("loggingLock"));
+	sendLock = dynamic_cast<Lock*> (ThreadManager::the()->getLock("eventSendLock"));
 #endif
 	isLogging = false;
 	createNewLogFile = true;
@@ -163,6 +174,10 @@ void EventManager::cleanup() {
 	} // for
 	deletedFactories.clear();
 	eventFactoryMap.clear();
+	if (eventBatcher) {
+		delete eventBatcher;
+		eventBatcher = NULL;
+	} // if
 	hashEventFactoryMap.clear();
 	eventHashMap.clear();
 	dump();
@@ -205,6 +220,18 @@ void EventManager::start() {
 		return;
 	} // if
 	generateHashValues();
+
+	unsigned maxBatchSize = 16384;
+	unsigned bulkBytesPerFlush = 65536;
+	double maxSendDelay = 0.005;
+	if (Configuration::contains("EventManager.maxBatchSize"))
+		maxBatchSize = Configuration::getInt("EventManager.maxBatchSize");
+	if (Configuration::contains("EventManager.bulkBytesPerFlush"))
+		bulkBytesPerFlush = Configuration::getInt("EventManager.bulkBytesPerFlush");
+	if (Configuration::contains("EventManager.maxSendDelay"))
+		maxSendDelay = 0.001 * Configuration::getInt("EventManager.maxSendDelay");
+	eventBatcher = new EventBatcher(maxBatchSize, maxSendDelay, bulkBytesPerFlush);
+
 #if OSG_MAJOR_VERSION >= 2
 	eventRecvThread = dynamic_pointer_cast<OSG::Thread> (ThreadManager::the()->getThread("eventRecvThread",false));
 #else //OpenSG1:
@@ -233,7 +260,7 @@ void EventManager::sendEvent(Event* event, EXECUTION_MODE mode) {
 
 	if (mode != EXECUTE_LOCAL) {
 		if (networkController)
-			networkController->sendEvent(event); //broadcast event
+			queueForNetwork(event, 0); //broadcast event
 	}
 	if (mode == EXECUTE_LOCAL || mode == EXECUTE_GLOBAL) {
 		putEventInPipe(event);
@@ -279,7 +306,7 @@ void EventManager::sendEventTo(Event* event, unsigned userId) {
 	else {
 		event->visibilityLevel.push_back("destinationUserId", userId);
 		if (networkController)
-			networkController->sendEvent(event);
+			queueForNetwork(event, userId);
 
 		if (isLogging) {
 #if OSG_MAJOR_VERSION >= 2
@@ -294,6 +321,11 @@ void EventManager::sendEventTo(Event* event, unsigned userId) {
 	} // else
 } // sendEventTo
 
+void EventManager::flush() {
+	if (networkController && eventBatcher)
+		sendBatches(true);
+} // flush
+
 void EventManager::activateLogging(std::string logFile, bool append) {
 	EventManager::logFile = logFile;
 	isLogging = true;
@@ -381,6 +413,73 @@ Event* EventManager::decode(NetMessage* msg) {
 	return ret;
 } // decode
 
+void EventManager::queueForNetwork(Event* event, unsigned destination) {
+	NetMessage* msg = event->completeEncode();
+
+	if (!msg)
+		return;
+#if OSG_MAJOR_VERSION >= 2
+	sendLock->acquire();
+#else //OpenSG1:
+	sendLock->aquire();
+#endif
+	eventBatcher->add(msg, destination, event->getPriority(),
+			inVRsUtilities::Timer::getMonotonicTime());
+	sendLock->release();
+	delete msg;
+
+	// critical Events do not wait for the EventManager thread
+	if (event->getPriority() == Event::PRIORITY_CRITICAL)
+		sendBatches(false);
+} // queueForNetwork
+
+void EventManager::sendBatches(bool force) {
+	std::vector<EventBatcher::Batch> batches;
+	unsigned i;
+
+	// the lock is held while sending, so the batches of concurrent calls
+	// stay in order
+#if OSG_MAJOR_VERSION >= 2
+	sendLock->acquire();
+#else //OpenSG1:
+	sendLock->aquire();
+#endif
+	eventBatcher->getDueBatches(inVRsUtilities::Timer::getMonotonicTime(), force, batches);
+	for (i = 0; i < batches.size(); i++) {
+		if (batches[i].destination == 0)
+			networkController->sendMessageTCP(batches[i].msg, EVENT_MANAGER_ID);
+		else
+			networkController->sendMessageTCPTo(batches[i].msg, EVENT_MANAGER_ID,
+					batches[i].destination);
+		delete batches[i].msg;
+	} // for
+	sendLock->release();
+} // sendBatches
+
+void EventManager::receive(NetMessage* msg) {
+	std::vector<NetMessage*> encodedEvents;
+	Event* recvEvent;
+	unsigned i;
+
+	EventBatcher::split(msg, encodedEvents);
+	for (i = 0; i < encodedEvents.size(); i++) {
+		recvEvent = decode(encodedEvents[i]);
+		if (recvEvent) {
+			putEventInPipe(recvEvent);
+			if (isLogging) {
+#if OSG_MAJOR_VERSION >= 2
+				loggingLock->acquire();
+#else //OpenSG1:
+				loggingLock->aquire();
+#endif
+				eventLogList.push_back(recvEvent->toString());
+				loggingLock->release();
+			} // if
+		} // if
+		delete encodedEvents[i];
+	} // for
+} // receive
+
 void EventManager::generateHashValues() {
 	std::map<std::string, AbstractEventFactory*>::iterator it;
 	unsigned hashValue;
@@ -408,29 +507,19 @@ void EventManager::generateHashValues() {
 
 void EventManager::run(void* dummy) {
 	NetMessage* recvMsg;
-	Event* recvEvent;
+
+	inVRsUtilities::Profiler::setThreadName("event receive");
 
 	if (networkController) {
 		while (!shutdown) {
 
 			while (networkController->sizeRecvList(EVENT_MANAGER_ID)) {
+				INVRS_PROFILE_ZONE("EventManager::receive");
 				// 				printd("EventManager::run(): received something\n");
 				recvMsg = networkController->pop(EVENT_MANAGER_ID);
-				recvEvent = decode(recvMsg);
-				if (recvEvent) {
-					putEventInPipe(recvEvent);
-					if (isLogging) {
-#if OSG_MAJOR_VERSION >= 2
-						loggingLock->acquire();
-#else //OpenSG1:
-						loggingLock->aquire();
-#endif
-						eventLogList.push_back(recvEvent->toString());
-						loggingLock->release();
-					} // if
-				} // if
-				delete recvMsg;
+				receive(recvMsg);
 			} // while
+			sendBatches(false);
 			usleep(1000);
 		} // while
 	} // if
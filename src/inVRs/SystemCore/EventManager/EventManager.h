@@ -43,6 +43,7 @@
 
 #include "AbstractEventFactory.h"
 #include "Event.h"
+#include "EventBatcher.h"
 #include "../ModuleIds.h"
 #include "../SyncPipe.h"
 #include "../ComponentInterfaces/NetworkInterface.h"
@@ -58,6 +59,20 @@ typedef SyncPipe<Event*> EventPipe;
 /******************************************************************************
  * The EventManager asynchronously sends outgoing Events and processes
  * incoming Events and stores them in EventPipes. It runs as a separate thread.
+ * Outgoing Events are packed into batches per destination and priority (see
+ * EventBatcher). Critical Events are handed to the network immediately by
+ * the sending thread, together with the Events queued before them for the
+ * same receiver. The EventManager thread sends the other Events after
+ * at most EventManager.maxSendDelay milliseconds (default 5) plus one
+ * iteration of its loop (1 ms). The configuration entries
+ * EventManager.maxBatchSize (default 16384) and
+ * EventManager.bulkBytesPerFlush (default 65536) limit the size of a batch
+ * and the bulk data handed to the network per iteration.
+ * Because of this delay, normal and bulk Events can be overtaken by messages
+ * which are sent directly over the network, e.g. transformations and
+ * NetworkTime messages. Events which must arrive
+ * before such messages (like the opening of a TransformationPipe) have to
+ * be critical.
  * The Events can be local, remote, and global (global Events are processed both
  * locally and globally).
  * The source module of an Event uses the sendEvent() method.
@@ -133,6 +148,12 @@ public:
 	 */
 	static void sendEventTo(Event* event, unsigned userId);
 
+	/**
+	 * Hands all batched Events to the network without waiting for the
+	 * maximum send delay.
+	 */
+	static void flush();
+
 	/**
 	 * Activate logging for all sent and received Events.
 	 * The logfile will only be written, when one of the methods cleanup(),
@@ -179,6 +200,12 @@ private:
 #else //OpenSG1:
 	static OSG::Lock* loggingLock;
 #endif
+#if OSG_MAJOR_VERSION >= 2
+	static OSG::LockRefPtr sendLock;
+#else //OpenSG1:
+	static OSG::Lock* sendLock;
+#endif
+	static EventBatcher* eventBatcher;
 	static std::vector<std::string> eventLogList;
 	static bool isLogging;
 	static bool createNewLogFile;
@@ -186,6 +213,9 @@ private:
 
 	static void putEventInPipe(Event* event);
 	static Event* decode(NetMessage* msg);
+	static void queueForNetwork(Event* event, unsigned destination);
+	static void sendBatches(bool force);
+	static void receive(NetMessage* msg);
 
 	static void generateHashValues();
 
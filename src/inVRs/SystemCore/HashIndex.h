@@ -0,0 +1,210 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                Changes                                    *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+\*---------------------------------------------------------------------------*/
+
+#ifndef _HASHINDEX_H
+#define _HASHINDEX_H
+
+#include <stddef.h>
+#include <vector>
+
+#include "Platform.h"
+
+namespace inVRsUtilities {
+
+/**
+ * Hash table mapping integer ids to values with open addressing.
+ * It is meant as an index for lookups on hot paths (e.g. per network message)
+ * where a linear search through a list or the allocations of a std::map are
+ * too expensive. KEY must be an unsigned integer type (up to 64 bit), VALUE
+ * should be cheap to copy (usually a pointer).
+ *
+ * The occupied slots can be iterated by index:
+ * <code>
+ * for (unsigned i = 0; i < index.getCapacity(); i++)
+ *   if (index.isOccupied(i))
+ *     process(index.getKeyAt(i), index.getValueAt(i));
+ * </code>
+ */
+template<class KEY, class VALUE>
+class HashIndex {
+public:
+	HashIndex(unsigned initialCapacity = 16) :
+		mask(0),
+		numEntries(0),
+		numDeleted(0) {
+		unsigned capacity = 8;
+		while (capacity < initialCapacity)
+			capacity <<= 1;
+		slots.resize(capacity);
+		mask = capacity - 1;
+	} // HashIndex
+
+	/**
+	 * Returns a pointer to the value stored for key or NULL if the key is not
+	 * in the index. The pointer is valid until the next call of set().
+	 */
+	VALUE* find(KEY key) {
+		int slotIndex = findSlot(key);
+		return slotIndex < 0 ? NULL : &slots[slotIndex].value;
+	} // find
+
+	const VALUE* find(KEY key) const {
+		int slotIndex = findSlot(key);
+		return slotIndex < 0 ? NULL : &slots[slotIndex].value;
+	} // find
+
+	/**
+	 * Stores value for key, replacing an existing value.
+	 * @return false if a value was replaced
+	 */
+	bool set(KEY key, const VALUE& value) {
+		VALUE* existing = find(key);
+		if (existing) {
+			*existing = value;
+			return false;
+		} // if
+		// keep the load factor (including deleted slots) below 3/4
+		if (4 * (numEntries + numDeleted + 1) > 3 * (mask + 1))
+			rehash(4 * (numEntries + 1) > 2 * (mask + 1) ? 2 * (mask + 1) : mask + 1);
+		unsigned i = hash(key) & mask;
+		while (slots[i].state == SLOT_OCCUPIED)
+			i = (i + 1) & mask;
+		if (slots[i].state == SLOT_DELETED)
+			numDeleted--;
+		slots[i].key = key;
+		slots[i].value = value;
+		slots[i].state = SLOT_OCCUPIED;
+		numEntries++;
+		return true;
+	} // set
+
+	/**
+	 * Removes the entry for key.
+	 * @return false if there is no entry for key
+	 */
+	bool erase(KEY key) {
+		int slotIndex = findSlot(key);
+		if (slotIndex < 0)
+			return false;
+		slots[slotIndex].state = SLOT_DELETED;
+		slots[slotIndex].value = VALUE();
+		numEntries--;
+		numDeleted++;
+		return true;
+	} // erase
+
+	void clear() {
+		for (unsigned i = 0; i <= mask; i++) {
+			slots[i].state = SLOT_EMPTY;
+			slots[i].value = VALUE();
+		} // for
+		numEntries = 0;
+		numDeleted = 0;
+	} // clear
+
+	unsigned size() const {
+		return numEntries;
+	} // size
+
+	unsigned getCapacity() const {
+		return mask + 1;
+	} // getCapacity
+
+	bool isOccupied(unsigned slotIndex) const {
+		return slots[slotIndex].state == SLOT_OCCUPIED;
+	} // isOccupied
+
+	KEY getKeyAt(unsigned slotIndex) const {
+		return slots[slotIndex].key;
+	} // getKeyAt
+
+	VALUE& getValueAt(unsigned slotIndex) {
+		return slots[slotIndex].value;
+	} // getValueAt
+
+private:
+	enum SlotState {
+		SLOT_EMPTY, SLOT_OCCUPIED, SLOT_DELETED
+	};
+
+	struct Slot {
+		Slot() :
+			key(0), value(), state(SLOT_EMPTY) {
+		}
+		KEY key;
+		VALUE value;
+		unsigned char state;
+	};
+
+	static unsigned hash(KEY key) {
+		// finalizer of MurmurHash3, spreads sequential ids over the table
+		uint64_t h = (uint64_t)key;
+		h ^= h >> 33;
+		h *= (((uint64_t)0xff51afd7) << 32) | 0xed558ccd;
+		h ^= h >> 33;
+		return (unsigned)h;
+	} // hash
+
+	int findSlot(KEY key) const {
+		unsigned i = hash(key) & mask;
+		while (slots[i].state != SLOT_EMPTY) {
+			if (slots[i].state == SLOT_OCCUPIED && slots[i].key == key)
+				return (int)i;
+			i = (i + 1) & mask;
+		} // while
+		return -1;
+	} // findSlot
+
+	void rehash(unsigned newCapacity) {
+		std::vector<Slot> oldSlots(newCapacity);
+		oldSlots.swap(slots);
+		mask = newCapacity - 1;
+		numEntries = 0;
+		numDeleted = 0;
+		for (unsigned i = 0; i < oldSlots.size(); i++) {
+			if (oldSlots[i].state == SLOT_OCCUPIED)
+				set(oldSlots[i].key, oldSlots[i].value);
+		} // for
+	} // rehash
+
+	std::vector<Slot> slots;
+	unsigned mask;
+	unsigned numEntries;
+	unsigned numDeleted;
+}; // HashIndex
+
+} // inVRsUtilities
+
+#endif /* _HASHINDEX_H */
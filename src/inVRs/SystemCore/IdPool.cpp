@@ -29,16 +29,40 @@
 
 #include <assert.h>
 #include <algorithm>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 #include "DebugOutput.h"
+#include "NetMessage.h"
+
+/**
+ * Returns the index of the lowest set bit of a word which must not be 0.
+ */
+static inline unsigned lowestBit(uint32_t word) {
+#if defined(__GNUC__)
+	return __builtin_ctz(word);
+#elif defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, word);
+	return index;
+#else
+	unsigned index = 0;
+	while (!(word & 1)) {
+		word >>= 1;
+		index++;
+	} // while
+	return index;
+#endif
+} // lowestBit
 
 IdPool::IdPool(unsigned minIdx, unsigned maxIdx) {
-	assert(maxIdx> minIdx);
+	assert(maxIdx >= minIdx);
+	assert(maxIdx - minIdx < NOT_FOUND);
 	this->minIdx = minIdx;
 	this->maxIdx = maxIdx;
-	for (unsigned i = minIdx; i <= maxIdx; i++) {
-		freeIdList.push_back(i);
-	} // for
+	numIds = maxIdx - minIdx + 1;
+	nextEntry = 0;
 	hasAllocatedIds = false;
 } // IdPool
 
@@ -54,9 +78,7 @@ IdPool::~IdPool() {
 } // ~IdPool
 
 IdPool* IdPool::allocSubPool(unsigned size) {
-
-	unsigned startId = 0;
-	unsigned endId = startId + size - 1;
+	unsigned first;
 
 	if (hasAllocatedIds) {
 		printd(ERROR,
@@ -64,32 +86,28 @@ IdPool* IdPool::allocSubPool(unsigned size) {
 		return NULL;
 	} // if
 
-	std::vector<IdPool*>::iterator subPoolIterator = subPoolList.begin();
-	IdPool* subPool;
+	if (size == 0 || size > numIds) {
+		printd(ERROR,
+				"IdPool::allocSubPool(): Could not satisfy allocation request of size %u in IdPool with Id-range from %u to %u\n",
+				size, minIdx, maxIdx);
+		return NULL;
+	} // if
 
 	// find proper Id range which does not collide with other reserved IdPools
-	while (subPoolIterator != subPoolList.end()) {
-		subPool = *subPoolIterator;
-
-		// 1. check if startId + range enters range of subPool
-		// 2. check if startId lies within subPool
-		if ( (startId < subPool->minIdx && endId >= subPool->minIdx)
-				|| (startId >= subPool->minIdx && startId <= subPool->maxIdx) ) {
-			startId = subPool->maxIdx + 1;
-			endId = startId + size - 1;
-			subPoolIterator = subPoolList.begin();
-		} // if
-		else {
-			++subPoolIterator;
-		} // else
-	} // while
+	createBitmap();
+	first = findFreeRange(size);
+	if (first == NOT_FOUND) {
+		printd(ERROR,
+				"IdPool::allocSubPool(): Could not find %u continuous free Ids in IdPool with Id-range from %u to %u\n",
+				size, minIdx, maxIdx);
+		return NULL;
+	} // if
 
-	return allocSubPool(startId, size);
+	return createSubPool(first, size);
 } // allocSubPool
 
 IdPool* IdPool::allocSubPool(unsigned startIdx, unsigned size) {
-	IdPool* result;
-	unsigned endIdx = startIdx + size - 1;
+	unsigned first, reserved;
 
 	if (hasAllocatedIds) {
 		printd(ERROR,
@@ -105,7 +123,7 @@ IdPool* IdPool::allocSubPool(unsigned startIdx, unsigned size) {
 		return NULL;
 	} // if
 
-	if (startIdx + size - 1 > maxIdx) {
+	if (size == 0 || startIdx > maxIdx || size - 1 > maxIdx - startIdx) {
 		printd(
 				ERROR,
 				"IdPool::allocSubPool(): Could not satisfy allocation request of size %u, startIdx = %u, maxIdx = %u\n",
@@ -113,28 +131,18 @@ IdPool* IdPool::allocSubPool(unsigned startIdx, unsigned size) {
 		return NULL;
 	} // if
 
-	//TODO: avoid duplicate execution of this check when calling other allocSubPool method!!!
-	std::vector<IdPool*>::iterator subPoolIterator;
-	IdPool* subPool;
-
-	for (subPoolIterator = subPoolList.begin(); subPoolIterator != subPoolList.end(); ++subPoolIterator) {
-		subPool = *subPoolIterator;
-
-		// 1. check if startId + range enters range of subPool
-		// 2. check if startId lies within subPool
-		if ( (startIdx < subPool->minIdx && endIdx >= subPool->minIdx)
-				|| (startIdx >= subPool->minIdx && startIdx <= subPool->maxIdx) ) {
-			printd(
-					ERROR,
-					"IdPool::allocSubPool(): Could not satisfy allocation request because Ids from %u to %u are already allocated by SubPool (from %u to %u)!\n",
-					startIdx, endIdx, subPool->minIdx, subPool->maxIdx);
-			return NULL;
-		} // if
-	} // while
+	createBitmap();
+	first = startIdx - minIdx;
+	reserved = findReserved(first, first + size);
+	if (reserved != first + size) {
+		printd(
+				ERROR,
+				"IdPool::allocSubPool(): Could not satisfy allocation request because Id %u in the range from %u to %u is already allocated!\n",
+				minIdx + reserved, startIdx, startIdx + size - 1);
+		return NULL;
+	} // if
 
-	result = new IdPool(startIdx, endIdx);
-	subPoolList.push_back(result);
-	return result;
+	return createSubPool(first, size);
 } // allocSubPool
 
 unsigned IdPool::allocEntry(bool* succeeded) {
@@ -150,7 +158,11 @@ unsigned IdPool::allocEntry(bool* succeeded) {
 		return 0;
 	} // if
 
-	if (freeIdList.size() == 0) {
+	createBitmap();
+	result = findFree(0, nextEntry);
+	if (result == NOT_FOUND)
+		result = findFree(0, 0);
+	if (result == NOT_FOUND) {
 		printd(ERROR, "IdPool::allocEntry(): No more free Ids available!\n");
 		if (succeeded) {
 			*succeeded = false;
@@ -158,14 +170,14 @@ unsigned IdPool::allocEntry(bool* succeeded) {
 		return 0;
 	} // if
 
-	result = freeIdList.front();
-	freeIdList.pop_front();
+	setRange(result, 1, false);
+	nextEntry = result + 1;
 
 	if (!hasAllocatedIds)
 		hasAllocatedIds = true;
 	if (succeeded)
 		*succeeded = true;
-	return result;
+	return minIdx + result;
 } // allocEntry
 
 bool IdPool::allocEntryAt(unsigned id) {
@@ -184,13 +196,13 @@ bool IdPool::allocEntryAt(unsigned id) {
 		return false;
 	} // if
 
-	std::deque<unsigned>::iterator index = std::find(freeIdList.begin(), freeIdList.end(), id);
-	if (index == freeIdList.end()) {
+	createBitmap();
+	if (findReserved(id - minIdx, id - minIdx + 1) == id - minIdx) {
 		printd(ERROR, "IdPool::allocEntryAt(): requested Id %u is already in use!\n", id);
 		return false;
 	} // if
 
-	freeIdList.erase(index);
+	setRange(id - minIdx, 1, false);
 
 	if (!hasAllocatedIds)
 		hasAllocatedIds = true;
@@ -201,14 +213,20 @@ bool IdPool::allocEntryAt(unsigned id) {
 
 void IdPool::freeEntry(unsigned id) {
 	assert(subPoolList.size() == 0);
-	//TODO: maybe increase performance by using an additional bitfield for storing free/used IDs
-	std::deque<unsigned>::iterator it = std::find(freeIdList.begin(), freeIdList.end(), id);
-	if (it == freeIdList.end()) {
-		freeIdList.push_back(id);
+
+	if (id < minIdx || id > maxIdx) {
+		printd(ERROR, "IdPool::freeEntry(): ID %u is out of the IdPools Id-range from %u to %u!\n",
+				id, minIdx, maxIdx);
+		return;
 	} // if
-	else {
+
+	createBitmap();
+	if (findReserved(id - minIdx, id - minIdx + 1) != id - minIdx) {
 		printd(ERROR, "IdPool::freeEntry(): ID %u was not allocated!\n", id);
-	} // else
+		return;
+	} // if
+
+	setRange(id - minIdx, 1, true);
 } // freeEntry
 
 
@@ -225,6 +243,7 @@ bool IdPool::freeSubPool(IdPool* pool) {
 		return false;
 	} // if
 
+	setRange(pool->minIdx - minIdx, pool->numIds, true);
 	subPoolList.erase(index);
 	delete pool;
 	return true;
@@ -232,24 +251,29 @@ bool IdPool::freeSubPool(IdPool* pool) {
 
 
 unsigned IdPool::getUnallocatedSubPoolIdx() {
+	int wordIdx;
+	uint32_t reservedBits;
 
-	//TODO: add support for already freed SubPools!
 	assert(!hasAllocatedIds);
 
-	unsigned result = 0;
-
-	std::vector<IdPool*>::iterator it;
-	IdPool* subPool;
-
-	for (it = subPoolList.begin(); it != subPoolList.end(); ++it) {
-		subPool = *it;
-
-		if (result <= subPool->maxIdx) {
-			result = subPool->maxIdx + 1;
+	if (freeBits.empty())
+		return minIdx;
+
+	// search the last word containing a reserved ID
+	const std::vector<uint32_t>& words = freeBits[0];
+	for (wordIdx = (int)words.size() - 1; wordIdx >= 0; wordIdx--) {
+		reservedBits = ~words[wordIdx];
+		if ((unsigned)wordIdx == words.size() - 1 && (numIds & 31))
+			reservedBits &= (1u << (numIds & 31)) - 1;
+		if (reservedBits) {
+			unsigned highestBit = 31;
+			while (!(reservedBits & (1u << highestBit)))
+				highestBit--;
+			return minIdx + wordIdx * 32 + highestBit + 1;
 		} // if
 	} // for
 
-	return result;
+	return minIdx;
 } // getUnallocatedSubPoolIdx
 
 unsigned IdPool::getMinIdx() {
@@ -260,3 +284,182 @@ unsigned IdPool::getMaxIdx() {
 	return maxIdx;
 } // getMaxIdx
 
+void IdPool::encodeReservedRanges(NetMessage* message) {
+	unsigned first, last, previousEnd;
+	std::vector<unsigned> ranges;
+
+	if (!freeBits.empty()) {
+		first = findReserved(0, numIds);
+		while (first < numIds) {
+			last = findFree(0, first);
+			if (last == NOT_FOUND)
+				last = numIds;
+			ranges.push_back(first);
+			ranges.push_back(last - first);
+			first = findReserved(last, numIds);
+		} // while
+	} // if
+
+	message->putUInt32(minIdx);
+	message->putUInt32(maxIdx);
+	message->putUInt32((uint32_t)ranges.size() / 2);
+	previousEnd = 0;
+	for (unsigned i = 0; i < ranges.size(); i += 2) {
+		message->putUInt32(ranges[i] - previousEnd);
+		message->putUInt32(ranges[i + 1]);
+		previousEnd = ranges[i] + ranges[i + 1];
+	} // for
+} // encodeReservedRanges
+
+bool IdPool::decodeReservedRanges(NetMessage* message) {
+	uint32_t messageMinIdx, messageMaxIdx, numRanges, gap, size;
+	unsigned i, first;
+
+	message->getUInt32(messageMinIdx);
+	message->getUInt32(messageMaxIdx);
+	message->getUInt32(numRanges);
+	if (messageMinIdx != minIdx || messageMaxIdx != maxIdx) {
+		printd(ERROR,
+				"IdPool::decodeReservedRanges(): received ranges of pool (%u, %u) for pool (%u, %u)!\n",
+				messageMinIdx, messageMaxIdx, minIdx, maxIdx);
+		for (i = 0; i < 2 * numRanges; i++)
+			message->getUInt32(gap);
+		return false;
+	} // if
+
+	createBitmap();
+	first = 0;
+	for (i = 0; i < numRanges; i++) {
+		message->getUInt32(gap);
+		message->getUInt32(size);
+		first += gap;
+		if (first >= numIds || size > numIds - first) {
+			printd(ERROR, "IdPool::decodeReservedRanges(): invalid range at offset %u!\n", first);
+			return false;
+		} // if
+		setRange(first, size, false);
+		first += size;
+	} // for
+	return true;
+} // decodeReservedRanges
+
+void IdPool::createBitmap() {
+	unsigned numWords;
+
+	if (!freeBits.empty())
+		return;
+
+	// level 0: all IDs are free, the bits behind the end of the range are 0
+	numWords = (numIds + 31) / 32;
+	freeBits.push_back(std::vector<uint32_t>(numWords, 0xFFFFFFFF));
+	if (numIds & 31)
+		freeBits[0][numWords - 1] = (1u << (numIds & 31)) - 1;
+
+	// higher levels: one bit for each (non-empty) word of the level below
+	while (numWords > 1) {
+		unsigned numBits = numWords;
+		numWords = (numBits + 31) / 32;
+		freeBits.push_back(std::vector<uint32_t>(numWords, 0xFFFFFFFF));
+		if (numBits & 31)
+			freeBits.back()[numWords - 1] = (1u << (numBits & 31)) - 1;
+	} // while
+} // createBitmap
+
+unsigned IdPool::findFree(unsigned level, unsigned pos) const {
+	unsigned wordIdx = pos / 32;
+	uint32_t bits;
+
+	if (level >= freeBits.size() || wordIdx >= freeBits[level].size())
+		return NOT_FOUND;
+
+	bits = freeBits[level][wordIdx] & (0xFFFFFFFF << (pos & 31));
+	if (bits)
+		return wordIdx * 32 + lowestBit(bits);
+
+	// ask the level above for the next word containing a free bit
+	wordIdx = findFree(level + 1, wordIdx + 1);
+	if (wordIdx == NOT_FOUND)
+		return NOT_FOUND;
+	return wordIdx * 32 + lowestBit(freeBits[level][wordIdx]);
+} // findFree
+
+unsigned IdPool::findReserved(unsigned first, unsigned last) const {
+	unsigned wordIdx;
+	uint32_t bits;
+
+	if (freeBits.empty() || first >= last)
+		return last;
+
+	const std::vector<uint32_t>& words = freeBits[0];
+	wordIdx = first / 32;
+	bits = ~words[wordIdx] & (0xFFFFFFFF << (first & 31));
+	while (!bits) {
+		wordIdx++;
+		if (wordIdx * 32 >= last)
+			return last;
+		bits = ~words[wordIdx];
+	} // while
+	first = wordIdx * 32 + lowestBit(bits);
+	return first < last ? first : last;
+} // findReserved
+
+unsigned IdPool::findFreeRange(unsigned size) const {
+	unsigned first, reserved;
+
+	first = findFree(0, 0);
+	while (first != NOT_FOUND && size <= numIds - first) {
+		reserved = findReserved(first, first + size);
+		if (reserved == first + size)
+			return first;
+		first = findFree(0, reserved);
+	} // while
+	return NOT_FOUND;
+} // findFreeRange
+
+void IdPool::setRange(unsigned first, unsigned size, bool free) {
+	unsigned wordIdx, last;
+	uint32_t mask;
+
+	last = first + size;
+	while (first < last) {
+		wordIdx = first / 32;
+		mask = 0xFFFFFFFF << (first & 31);
+		if (last - wordIdx * 32 < 32)
+			mask &= (1u << (last - wordIdx * 32)) - 1;
+		if (free)
+			freeBits[0][wordIdx] |= mask;
+		else
+			freeBits[0][wordIdx] &= ~mask;
+		updateLevels(wordIdx);
+		first = (wordIdx + 1) * 32;
+	} // while
+} // setRange
+
+void IdPool::updateLevels(unsigned wordIdx) {
+	unsigned level;
+	uint32_t bit;
+	bool wasFree;
+
+	for (level = 1; level < freeBits.size(); level++) {
+		uint32_t& parent = freeBits[level][wordIdx / 32];
+		wasFree = parent != 0;
+		bit = 1u << (wordIdx & 31);
+		if (freeBits[level - 1][wordIdx])
+			parent |= bit;
+		else
+			parent &= ~bit;
+		// the levels above only change if the word switched between empty and non-empty
+		if (wasFree == (parent != 0))
+			break;
+		wordIdx /= 32;
+	} // for
+} // updateLevels
+
+IdPool* IdPool::createSubPool(unsigned first, unsigned size) {
+	IdPool* result;
+
+	setRange(first, size, false);
+	result = new IdPool(minIdx + first, minIdx + first + size - 1);
+	subPoolList.push_back(result);
+	return result;
+} // createSubPool
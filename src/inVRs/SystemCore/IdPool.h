@@ -37,9 +37,10 @@
 #define _IDPOOL_H
 
 #include <vector>
-#include <deque>
 #include "Platform.h"
 
+class NetMessage;
+
 /****************************************************************************** 
  * This class provides services for managing integer based ID numbers. It is
  * mainly used for IDs which belong to dynamically created objects (such as 
@@ -50,6 +51,13 @@
  * itself, it is intended to be used in conjunction with the IdPoolListener.
  * IdPools allways manage a continous range of IDs.
  *
+ * Internally the reserved IDs (allocated entries or IDs owned by subpools) are
+ * stored in a hierarchical bitmap: level 0 contains one bit per ID, each bit
+ * of a higher level tells whether the corresponding word of the level below
+ * contains a free ID. Allocating and releasing single IDs therefore only
+ * touches one word per level. The bitmap is created when the pool is used
+ * for the first time.
+ *
  * @see IdPoolManager
  */
 class INVRS_SYSTEMCORE_API IdPool {
@@ -86,7 +94,9 @@ public:
 
 	/** 
 	 * Allocates a single ID. If the allocated ID is not used anymore call 
-	 * <code>freeEntry()</code> on it.
+	 * <code>freeEntry()</code> on it. The IDs are handed out in ascending
+	 * order (wrapping around at the end of the range), so that a released ID
+	 * is not reused immediately.
 	 * @param succeeded if != NULL will indicated whether finding an unused ID was 
 	 * successfull
 	 * @return an unused ID, 0 on failure
@@ -137,14 +147,65 @@ public:
 	 */
 	unsigned getMaxIdx();
 
+	/**
+	 * Writes the reserved ranges of the pool (allocated IDs and subpools) into
+	 * the message. Each continuous range is written as the distance to the end
+	 * of the previous range and its length, so the size of the message depends
+	 * on the number of ranges and not on the size of the pool. The
+	 * IdPoolListenerFinalizeAllocationEvent uses it to distribute the state of
+	 * a pool to the other users after an allocation.
+	 * @param message message where to write the ranges to
+	 */
+	void encodeReservedRanges(NetMessage* message);
+
+	/**
+	 * Marks the ranges written by <code>encodeReservedRanges()</code> of a pool
+	 * with the same ID range as reserved. The ranges are not released by
+	 * <code>freeSubPool()</code>; IDs within the ranges can be released by
+	 * <code>freeEntry()</code>.
+	 * @param message message where to read the ranges from
+	 * @return false if the message was written by a pool with another ID range
+	 */
+	bool decodeReservedRanges(NetMessage* message);
+
 protected:
 
+	/// Creates the bitmap if it does not exist yet
+	void createBitmap();
+
+	/// Returns the offset of the first free ID at or after the offset pos
+	/// in the passed level of the bitmap, NOT_FOUND if none exists
+	unsigned findFree(unsigned level, unsigned pos) const;
+
+	/// Returns the offset of the first reserved ID in [first, last), last if none
+	unsigned findReserved(unsigned first, unsigned last) const;
+
+	/// Returns the offset of the first free range with the passed size
+	unsigned findFreeRange(unsigned size) const;
+
+	/// Marks the range starting at offset first as free or reserved
+	void setRange(unsigned first, unsigned size, bool free);
+
+	/// Updates the higher levels of the bitmap after word wordIdx of level 0 changed
+	void updateLevels(unsigned wordIdx);
+
+	/// Creates the subpool for the range starting at offset first
+	IdPool* createSubPool(unsigned first, unsigned size);
+
+	/// Return value of the find methods if no matching ID exists
+	static const unsigned NOT_FOUND = 0xFFFFFFFF;
+
 	std::vector<IdPool*> subPoolList;
-	std::deque<unsigned> freeIdList;
+	/// Bitmap of free IDs (bit set = free) for each level, level 0 has one bit per ID
+	std::vector<std::vector<uint32_t> > freeBits;
+	/// Offset where allocEntry() starts searching for a free ID
+	unsigned nextEntry;
 	bool hasAllocatedIds;
 
 	unsigned minIdx;
 	unsigned maxIdx;
+	/// Number of IDs in the pool
+	unsigned numIds;
 };
 
 #endif
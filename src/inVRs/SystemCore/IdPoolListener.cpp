@@ -149,26 +149,56 @@ unsigned IdPoolListenerVetoRequestEvent::generateResponse() {
  */
 IdPoolListenerFinalizeAllocationEvent::IdPoolListenerFinalizeAllocationEvent(unsigned srcModuleId, std::string poolName, std::string subPoolName, unsigned bKeep) :
 	Event(srcModuleId, SYSTEM_CORE_ID, "IdPoolListenerFinalizeAllocationEvent") {
+	IdPool* pool;
+
 	this->poolName = poolName;
 	this->subPoolName = subPoolName;
 	this->bKeep = bKeep;
+	reservedRanges = NULL;
+
+	if (bKeep) {
+		pool = localIdPoolManager.getPoolByName(poolName);
+		if (pool) {
+			reservedRanges = new NetMessage;
+			pool->encodeReservedRanges(reservedRanges);
+		}
+	}
 }
 
 IdPoolListenerFinalizeAllocationEvent::IdPoolListenerFinalizeAllocationEvent() :
 	Event() {
+	reservedRanges = NULL;
+}
 
+IdPoolListenerFinalizeAllocationEvent::~IdPoolListenerFinalizeAllocationEvent() {
+	if (reservedRanges)
+		delete reservedRanges;
 }
 
 void IdPoolListenerFinalizeAllocationEvent::encode(NetMessage* message) {
+	NetMessage emptyRanges;
+
 	message->putUInt32(bKeep);
 	message->putString(poolName);
 	message->putString(subPoolName);
+	if (bKeep) {
+		if (reservedRanges)
+			message->appendMessage(reservedRanges);
+		else
+			message->appendMessage(&emptyRanges);
+	}
 }
 
 void IdPoolListenerFinalizeAllocationEvent::decode(NetMessage* message) {
 	message->getUInt32(bKeep);
 	message->getString(poolName);
 	message->getString(subPoolName);
+	if (reservedRanges) {
+		delete reservedRanges;
+		reservedRanges = NULL;
+	}
+	if (bKeep)
+		reservedRanges = message->detachMessage();
 }
 
 void IdPoolListenerFinalizeAllocationEvent::execute() {
@@ -185,6 +215,11 @@ void IdPoolListenerFinalizeAllocationEvent::execute() {
 		if (!subPool) {
 			printd(ERROR, "IdPoolListenerFinalizeAllocationEvent::execute(): subPool %s not found on this machine!!\n", subPoolName.c_str());
 		}
+		// an empty message means the sender had no pool with this name
+		if (reservedRanges && reservedRanges->getBufferSize() > 0 &&
+				!pool->decodeReservedRanges(reservedRanges)) {
+			printd(ERROR, "IdPoolListenerFinalizeAllocationEvent::execute(): failed to apply the reserved ranges of pool %s\n", poolName.c_str());
+		}
 	} else {
 		if (!pool->freeSubPool(subPool)) {
 			printd(ERROR, "IdPoolListenerFinalizeAllocationEvent::execute(): failed to deallocate subPool with name %s\n", subPoolName.c_str());
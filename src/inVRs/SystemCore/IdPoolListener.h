@@ -82,11 +82,19 @@ protected:
 
 };
 
+/**
+ * Tells the other users whether the subpool is kept. If it is kept the Event
+ * carries the reserved ranges of the allocating user's pool (see
+ * IdPool::encodeReservedRanges()), which the receivers mark as reserved in
+ * their pool. So users which did not answer the veto request do not hand out
+ * the same IDs.
+ */
 class INVRS_SYSTEMCORE_API IdPoolListenerFinalizeAllocationEvent : public Event {
 public:
 	IdPoolListenerFinalizeAllocationEvent(unsigned srcModuleId, std::string poolName,
 			std::string subPoolName, unsigned bKeep);
 	IdPoolListenerFinalizeAllocationEvent();
+	virtual ~IdPoolListenerFinalizeAllocationEvent();
 
 	typedef EventFactory<IdPoolListenerFinalizeAllocationEvent> Factory;
 
@@ -99,6 +107,7 @@ protected:
 	std::string poolName;
 	std::string subPoolName;
 	unsigned bKeep;
+	NetMessage* reservedRanges;
 };
 
 class INVRS_SYSTEMCORE_API IdPoolListener {
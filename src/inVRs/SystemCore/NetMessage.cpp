@@ -258,7 +258,6 @@ void NetMessage::getString(std::string& dst) {
 }
 
 void NetMessage::appendMessage(NetMessage* src) {
-	unsigned i;
 	unsigned srcBufferSize;
 	uint8_t* srcBuffer;
 
@@ -269,13 +268,12 @@ void NetMessage::appendMessage(NetMessage* src) {
 	putUInt32(srcBufferSize);
 
 	// do not use getUint8() here -> that would affect the readOffset!!!
-	for (i = 0; i < srcBufferSize; i++) {
-		putUInt8(srcBuffer[i]);
-	}
+	if (srcBufferSize > 0)
+		memcpy(allocateAtEnd(srcBufferSize), srcBuffer, srcBufferSize);
 }
 
 NetMessage* NetMessage::detachMessage() {
-	unsigned int i, size, type;
+	unsigned int size, type;
 	NetMessage* ret;
 
 	type = getUInt32();
@@ -284,9 +282,10 @@ NetMessage* NetMessage::detachMessage() {
 	ret = new NetMessage();
 
 	size = getUInt32();
-	for (i = 0; i < size; i++) {
-		ret->putUInt8(getUInt8());
-	}
+	assert(readOffset + size <= getBufferSize());
+	if (size > 0)
+		memcpy(ret->allocateAtEnd(size), getBufferPointer() + readOffset, size);
+	readOffset += size;
 
 	return ret;
 }
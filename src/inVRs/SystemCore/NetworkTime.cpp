@@ -0,0 +1,317 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+
+#include "NetworkTime.h"
+
+#include <math.h>
+#include <vector>
+
+#include "SystemCore.h"
+#include "Timer.h"
+#include "Configuration.h"
+#include "DebugOutput.h"
+#include "NetMessage.h"
+#include "MessageFunctions.h"
+#include "ModuleIds.h"
+#include "ComponentInterfaces/NetworkInterface.h"
+#include "UserDatabase/UserDatabase.h"
+
+namespace {
+
+const unsigned MAX_SAMPLES = 64;
+const unsigned MIN_SAMPLES = 4;
+// samples with a delay of up to minDelay * (1 + DELAY_TOLERANCE) + DELAY_MARGIN are used
+const double DELAY_TOLERANCE = 0.1;
+const double DELAY_MARGIN = 0.0005;
+// minimum time span of the samples for the drift estimation
+const double MIN_DRIFT_SPAN = 4;
+// drift of real clocks is far below, larger values are caused by outliers
+const double MAX_DRIFT = 0.001;
+// the estimate has converged if it changed by less than CONVERGED_TOLERANCE
+// for CONVERGED_SAMPLES consecutive samples
+const double CONVERGED_TOLERANCE = 0.001;
+const unsigned CONVERGED_SAMPLES = 3;
+
+} // namespace
+
+ClockOffsetEstimator::ClockOffsetEstimator() {
+	reset();
+} // ClockOffsetEstimator
+
+void ClockOffsetEstimator::reset() {
+	samples.clear();
+	offset = 0;
+	drift = 0;
+	referenceTime = 0;
+	delay = 0;
+	stableSamples = 0;
+} // reset
+
+void ClockOffsetEstimator::addSample(double localSendTime, double remoteReceiveTime,
+		double remoteSendTime, double localReceiveTime) {
+	Sample sample;
+	double previousOffset;
+
+	sample.localTime = 0.5 * (localSendTime + localReceiveTime);
+	sample.offset = 0.5 * ((remoteReceiveTime - localSendTime) + (remoteSendTime
+			- localReceiveTime));
+	sample.delay = (localReceiveTime - localSendTime) - (remoteSendTime - remoteReceiveTime);
+	if (sample.delay < 0)
+		sample.delay = 0;
+
+	previousOffset = getOffset(sample.localTime);
+	samples.push_back(sample);
+	if (samples.size() > MAX_SAMPLES)
+		samples.pop_front();
+	update();
+
+	if (samples.size() > 1 && fabs(getOffset(sample.localTime) - previousOffset)
+			< CONVERGED_TOLERANCE)
+		stableSamples++;
+	else
+		stableSamples = 0;
+} // addSample
+
+bool ClockOffsetEstimator::isSynchronised() const {
+	return samples.size() >= MIN_SAMPLES;
+} // isSynchronised
+
+bool ClockOffsetEstimator::isConverged() const {
+	return isSynchronised() && stableSamples >= CONVERGED_SAMPLES;
+} // isConverged
+
+double ClockOffsetEstimator::getOffset(double localTime) const {
+	return offset + drift * (localTime - referenceTime);
+} // getOffset
+
+double ClockOffsetEstimator::getDrift() const {
+	return drift;
+} // getDrift
+
+double ClockOffsetEstimator::getDelay() const {
+	return delay;
+} // getDelay
+
+unsigned ClockOffsetEstimator::getNumberOfSamples() const {
+	return (unsigned)samples.size();
+} // getNumberOfSamples
+
+void ClockOffsetEstimator::update() {
+	std::vector<const Sample*> selected;
+	const Sample* best = NULL;
+	double maxDelay, meanTime, meanOffset, covariance, variance, dt;
+	unsigned i;
+
+	for (i = 0; i < samples.size(); i++) {
+		if (!best || samples[i].delay < best->delay)
+			best = &samples[i];
+	} // for
+	delay = best->delay;
+
+	maxDelay = delay * (1 + DELAY_TOLERANCE) + DELAY_MARGIN;
+	for (i = 0; i < samples.size(); i++) {
+		if (samples[i].delay <= maxDelay)
+			selected.push_back(&samples[i]);
+	} // for
+
+	if (selected.size() < 3 || selected.back()->localTime - selected.front()->localTime
+			< MIN_DRIFT_SPAN) {
+		// too few samples for a drift, keep the previous one
+		offset = best->offset;
+		referenceTime = best->localTime;
+		return;
+	} // if
+
+	// least squares fit of the offset over the local time
+	meanTime = meanOffset = 0;
+	for (i = 0; i < selected.size(); i++) {
+		meanTime += selected[i]->localTime;
+		meanOffset += selected[i]->offset;
+	} // for
+	meanTime /= selected.size();
+	meanOffset /= selected.size();
+
+	covariance = variance = 0;
+	for (i = 0; i < selected.size(); i++) {
+		dt = selected[i]->localTime - meanTime;
+		covariance += dt * (selected[i]->offset - meanOffset);
+		variance += dt * dt;
+	} // for
+
+	drift = covariance / variance;
+	if (drift > MAX_DRIFT)
+		drift = MAX_DRIFT;
+	else if (drift < -MAX_DRIFT)
+		drift = -MAX_DRIFT;
+	offset = meanOffset;
+	referenceTime = meanTime;
+} // update
+
+NetworkInterface* NetworkTime::network = NULL;
+bool NetworkTime::firstRun = true;
+unsigned NetworkTime::referenceUserId = 0;
+bool NetworkTime::isReference = true;
+double NetworkTime::lastRequestTime = 0;
+unsigned NetworkTime::nextRequestNumber = 0;
+ClockOffsetEstimator NetworkTime::estimator;
+
+void NetworkTime::step() {
+	std::vector<NetMessage*> msgList;
+	NetMessage msg;
+	double now, interval = 1;
+	unsigned i;
+
+	if (firstRun) {
+		network = (NetworkInterface*)SystemCore::getModuleByName("Network");
+		firstRun = false;
+	} // if
+	if (!network)
+		return;
+
+	updateReferenceUser();
+
+	network->popAll(SYSTEM_CORE_ID, &msgList);
+	for (i = 0; i < msgList.size(); i++) {
+		handleMessage(msgList[i]);
+		delete msgList[i];
+	} // for
+
+	if (isReference)
+		return;
+
+	if (Configuration::contains("SystemCore.clockSyncInterval"))
+		interval = Configuration::getFloat("SystemCore.clockSyncInterval");
+	if (!estimator.isConverged())
+		interval *= 0.2;
+
+	now = inVRsUtilities::Timer::getMonotonicTime();
+	if (now - lastRequestTime < interval)
+		return;
+	lastRequestTime = now;
+
+	msg.putUInt8(CLOCK_REQUEST);
+	msg.putUInt32(UserDatabase::getLocalUserId());
+	msg.putUInt32(nextRequestNumber++);
+	msgFunctions::encode(now, &msg);
+	network->sendMessageUDPTo(&msg, SYSTEM_CORE_ID, referenceUserId);
+} // step
+
+void NetworkTime::cleanup() {
+	network = NULL;
+	firstRun = true;
+	referenceUserId = 0;
+	isReference = true;
+	lastRequestTime = 0;
+	estimator.reset();
+} // cleanup
+
+double NetworkTime::getTime() {
+	return toNetworkTime(inVRsUtilities::Timer::getMonotonicTime());
+} // getTime
+
+double NetworkTime::toNetworkTime(double localTime) {
+	if (isReference)
+		return localTime;
+	return localTime + estimator.getOffset(localTime);
+} // toNetworkTime
+
+double NetworkTime::toLocalTime(double networkTime) {
+	if (isReference)
+		return networkTime;
+	// the drift is tiny, so evaluating the offset at the network time is exact enough
+	return networkTime - estimator.getOffset(networkTime);
+} // toLocalTime
+
+bool NetworkTime::isSynchronised() {
+	return isReference || estimator.isConverged();
+} // isSynchronised
+
+unsigned NetworkTime::getReferenceUserId() {
+	return referenceUserId;
+} // getReferenceUserId
+
+const ClockOffsetEstimator& NetworkTime::getEstimator() {
+	return estimator;
+} // getEstimator
+
+void NetworkTime::updateReferenceUser() {
+	unsigned userId = UserDatabase::getLocalUserId();
+	unsigned remoteUserId;
+	User* user;
+	int i;
+
+	for (i = 0; i < UserDatabase::getNumberOfRemoteUsers(); i++) {
+		user = UserDatabase::getRemoteUserByIndex(i);
+		remoteUserId = user->getId();
+		if (remoteUserId < userId)
+			userId = remoteUserId;
+	} // for
+
+	if (userId == referenceUserId)
+		return;
+
+	printd(INFO, "NetworkTime::updateReferenceUser(): using clock of user %u\n", userId);
+	referenceUserId = userId;
+	isReference = (userId == UserDatabase::getLocalUserId());
+	lastRequestTime = 0;
+	estimator.reset();
+} // updateReferenceUser
+
+void NetworkTime::handleMessage(NetMessage* msg) {
+	uint8_t type;
+	unsigned userId, requestNumber;
+	double localSendTime, remoteReceiveTime, remoteSendTime;
+	double now = inVRsUtilities::Timer::getMonotonicTime();
+	NetMessage response;
+
+	msg->getUInt8(type);
+	msg->getUInt32(userId);
+	msg->getUInt32(requestNumber);
+	msgFunctions::decode(localSendTime, msg);
+
+	if (type == CLOCK_REQUEST) {
+		response.putUInt8(CLOCK_RESPONSE);
+		response.putUInt32(UserDatabase::getLocalUserId());
+		response.putUInt32(requestNumber);
+		msgFunctions::encode(localSendTime, &response);
+		msgFunctions::encode(now, &response);
+		msgFunctions::encode(inVRsUtilities::Timer::getMonotonicTime(), &response);
+		network->sendMessageUDPTo(&response, SYSTEM_CORE_ID, userId);
+	} // if
+	else if (type == CLOCK_RESPONSE) {
+		msgFunctions::decode(remoteReceiveTime, msg);
+		msgFunctions::decode(remoteSendTime, msg);
+		// responses of a former reference user are useless
+		if (userId == referenceUserId && !isReference)
+			estimator.addSample(localSendTime, remoteReceiveTime, remoteSendTime, now);
+	} // else if
+	else {
+		printd(WARNING, "NetworkTime::handleMessage(): unknown message type %u\n",
+				(unsigned)type);
+	} // else
+} // handleMessage
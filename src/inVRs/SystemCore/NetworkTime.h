@@ -0,0 +1,183 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                Changes                                    *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+\*---------------------------------------------------------------------------*/
+
+
+#ifndef _NETWORKTIME_H
+#define _NETWORKTIME_H
+
+#include <deque>
+
+#include "Platform.h"
+
+class NetMessage;
+class NetworkInterface;
+
+/******************************************************************************
+ * Estimates the offset and drift of a remote clock from NTP-style round
+ * trips. For every round trip the local send and receive time and the remote
+ * receive and send time are passed. Only the round trips with the lowest
+ * delay of the last samples are used, since their offset is least affected
+ * by queueing delays. The drift is fitted over these samples once they span
+ * a few seconds.
+ */
+class INVRS_SYSTEMCORE_API ClockOffsetEstimator {
+public:
+	ClockOffsetEstimator();
+
+	/** Removes all samples.
+	 */
+	void reset();
+
+	/** Adds the times of a round trip.
+	 * @param localSendTime local time the request was sent
+	 * @param remoteReceiveTime remote time the request was received
+	 * @param remoteSendTime remote time the response was sent
+	 * @param localReceiveTime local time the response was received
+	 */
+	void addSample(double localSendTime, double remoteReceiveTime, double remoteSendTime,
+			double localReceiveTime);
+
+	/** Returns true if enough samples were added for a first estimate.
+	 */
+	bool isSynchronised() const;
+
+	/** Returns true if the estimate is synchronised and did not change by
+	 * more than a millisecond over the last few samples.
+	 */
+	bool isConverged() const;
+
+	/** Returns the estimated difference remote - local time at the passed
+	 * local time.
+	 */
+	double getOffset(double localTime) const;
+
+	/** Returns the estimated drift of the remote clock relative to the local
+	 * clock in seconds per second.
+	 */
+	double getDrift() const;
+
+	/** Returns the lowest round trip delay of the current samples.
+	 */
+	double getDelay() const;
+
+	unsigned getNumberOfSamples() const;
+
+protected:
+	struct Sample {
+		double localTime;
+		double offset;
+		double delay;
+	}; // Sample
+
+	void update();
+
+	std::deque<Sample> samples;
+	double offset;
+	double drift;
+	double referenceTime;
+	double delay;
+	unsigned stableSamples;
+}; // ClockOffsetEstimator
+
+/******************************************************************************
+ * Clock shared by all participants of a session. The network time is the
+ * Timer::getMonotonicTime() of the reference user, which is the participant
+ * with the lowest user id. All other participants estimate the offset to
+ * this clock with a ClockOffsetEstimator. The round trips are exchanged as
+ * UDP messages on the SYSTEM_CORE_ID channel, the requests are sent by
+ * step() every SystemCore.clockSyncInterval seconds (default 1, five times as
+ * often until the clock is synchronised).
+ *
+ * Data which is sent to other participants can carry a network time, the
+ * receiver converts it into its local time with toLocalTime().
+ */
+class INVRS_SYSTEMCORE_API NetworkTime {
+public:
+	/** Sends the clock requests and answers the requests of other users.
+	 * The method is called by SystemCore::step().
+	 */
+	static void step();
+
+	/** Resets the estimate and releases the Network module.
+	 */
+	static void cleanup();
+
+	/** Returns the current network time.
+	 */
+	static double getTime();
+
+	/** Converts a time of Timer::getMonotonicTime() into network time.
+	 */
+	static double toNetworkTime(double localTime);
+
+	/** Converts a network time into the time base of
+	 * Timer::getMonotonicTime().
+	 */
+	static double toLocalTime(double networkTime);
+
+	/** Returns true if the local user is the reference or the estimated
+	 * offset to the reference has converged. Data is only stamped with and
+	 * converted from network time after that, so that the stamps do not jump
+	 * while the first estimates are refined.
+	 */
+	static bool isSynchronised();
+
+	/** Returns the id of the user whose clock is the network time.
+	 */
+	static unsigned getReferenceUserId();
+
+	/** Returns the estimate of the offset to the reference user.
+	 */
+	static const ClockOffsetEstimator& getEstimator();
+
+private:
+	enum MESSAGE_TYPE {
+		CLOCK_REQUEST,
+		CLOCK_RESPONSE
+	}; // MESSAGE_TYPE
+
+	static void updateReferenceUser();
+	static void handleMessage(NetMessage* msg);
+
+	static NetworkInterface* network;
+	static bool firstRun;
+	static unsigned referenceUserId;
+	static bool isReference;
+	static double lastRequestTime;
+	static unsigned nextRequestNumber;
+	static ClockOffsetEstimator estimator;
+}; // NetworkTime
+
+#endif // _NETWORKTIME_H
@@ -58,6 +58,13 @@
 #	define INVRS_SYSTEMCORE_API
 #endif
 
+// thread local storage for POD variables:
+#ifdef WIN32
+#	define INVRS_THREAD_LOCAL __declspec(thread)
+#else
+#	define INVRS_THREAD_LOCAL __thread
+#endif
+
 #ifdef WIN32
 // types normally defined in stdint.h:
 typedef unsigned __int64 uint64_t;
@@ -0,0 +1,339 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+#include "Profiler.h"
+#include "AtomicOperations.h"
+#include "DebugOutput.h"
+#include "Timer.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
+#include <OpenSG/OSGThreadManager.h>
+#include <OpenSG/OSGLock.h>
+
+using namespace inVRsUtilities;
+
+namespace {
+
+enum ProfilerEventType {
+	PROFILER_EVENT_BEGIN, PROFILER_EVENT_END, PROFILER_EVENT_FRAME
+};
+
+struct ProfilerEvent {
+	const char* name;
+	double time;
+	uint32_t type;
+};
+
+const unsigned PROFILER_BLOCK_SIZE = 4096;
+
+struct ProfilerEventBlock {
+	ProfilerEvent events[PROFILER_BLOCK_SIZE];
+	ProfilerEventBlock* next;
+};
+
+/**
+ * Event buffer of a single thread. Only the owning thread appends events,
+ * other threads read the first numEvents events. New blocks are linked
+ * before numEvents is increased, so readers never see incomplete data.
+ */
+struct ProfilerThreadBuffer {
+	uint32_t threadId;
+	const char* volatile threadName;
+	ProfilerEventBlock* firstBlock;
+	ProfilerEventBlock* lastBlock;
+	volatile uint32_t numEvents;
+	/// number of zones opened in this thread which are not closed yet
+	uint32_t depth;
+	/// number of nested zones which were dropped because the buffer was full
+	uint32_t skippedDepth;
+	ProfilerThreadBuffer* next;
+};
+
+struct ZoneStatistics {
+	std::vector<double> durations;
+};
+
+} // namespace
+
+volatile bool Profiler::enabled = false;
+
+static double profilerStartTime = 0;
+static uint32_t profilerMaxEvents = 1 << 20;
+static volatile uint32_t profilerNextThreadId = 0;
+static void* volatile profilerBufferList = NULL;
+static INVRS_THREAD_LOCAL ProfilerThreadBuffer* profilerThreadBuffer = NULL;
+// name of the thread until its buffer is created with the first zone
+static INVRS_THREAD_LOCAL const char* profilerThreadName = NULL;
+static std::set<std::string> profilerNames;
+#if OSG_MAJOR_VERSION >= 2
+static OSG::LockRefPtr profilerNameLock = NULL;
+#else //OpenSG1:
+static OSG::Lock* profilerNameLock = NULL;
+#endif
+
+static ProfilerThreadBuffer* getThreadBuffer() {
+	ProfilerThreadBuffer* buffer = profilerThreadBuffer;
+	if (!buffer) {
+		buffer = new ProfilerThreadBuffer;
+		buffer->threadId = atomicIncrement(&profilerNextThreadId);
+		buffer->threadName = profilerThreadName;
+		buffer->firstBlock = new ProfilerEventBlock;
+		buffer->firstBlock->next = NULL;
+		buffer->lastBlock = buffer->firstBlock;
+		buffer->numEvents = 0;
+		buffer->depth = 0;
+		buffer->skippedDepth = 0;
+		void* head;
+		do {
+			head = profilerBufferList;
+			buffer->next = (ProfilerThreadBuffer*)head;
+		} while (!atomicCompareAndSwapPointer(&profilerBufferList, head, buffer));
+		profilerThreadBuffer = buffer;
+	} // if
+	return buffer;
+} // getThreadBuffer
+
+static void addEvent(ProfilerThreadBuffer* buffer, const char* name, uint32_t type) {
+	uint32_t index = buffer->numEvents % PROFILER_BLOCK_SIZE;
+	if (index == 0 && buffer->numEvents > 0) {
+		ProfilerEventBlock* block = new ProfilerEventBlock;
+		block->next = NULL;
+		buffer->lastBlock->next = block;
+		buffer->lastBlock = block;
+	} // if
+	ProfilerEvent& event = buffer->lastBlock->events[index];
+	event.name = name;
+	event.time = Timer::getMonotonicTime();
+	event.type = type;
+	// publish event after it is completely written
+	memoryBarrier();
+	buffer->numEvents = buffer->numEvents + 1;
+} // addEvent
+
+static const char* escapeJson(const char* name, std::string& result) {
+	result.clear();
+	for (; *name; name++) {
+		if (*name == '"' || *name == '\\')
+			result += '\\';
+		if ((unsigned char)*name < 0x20)
+			result += ' ';
+		else
+			result += *name;
+	} // for
+	return result.c_str();
+} // escapeJson
+
+static double percentile(const std::vector<double>& sortedValues, double p) {
+	size_t index = (size_t)(p * (sortedValues.size() - 1) + 0.5);
+	return sortedValues[index];
+} // percentile
+
+void Profiler::setEnabled(bool enable) {
+	if (enable && profilerStartTime == 0)
+		profilerStartTime = Timer::getMonotonicTime();
+	enabled = enable;
+} // setEnabled
+
+void Profiler::setMaxEventsPerThread(unsigned maxEvents) {
+	profilerMaxEvents = maxEvents;
+} // setMaxEventsPerThread
+
+void Profiler::setThreadName(const std::string& name) {
+	profilerThreadName = internName(name);
+	// the buffer is only allocated when the thread records its first zone
+	if (profilerThreadBuffer)
+		profilerThreadBuffer->threadName = profilerThreadName;
+} // setThreadName
+
+void Profiler::beginZone(const char* name) {
+	if (!enabled)
+		return;
+	ProfilerThreadBuffer* buffer = getThreadBuffer();
+	// keep room for the end events of all open zones
+	if (buffer->skippedDepth > 0 || buffer->numEvents + buffer->depth + 2 > profilerMaxEvents) {
+		buffer->skippedDepth++;
+		return;
+	} // if
+	addEvent(buffer, name, PROFILER_EVENT_BEGIN);
+	buffer->depth++;
+} // beginZone
+
+void Profiler::endZone() {
+	ProfilerThreadBuffer* buffer = profilerThreadBuffer;
+	if (!buffer)
+		return;
+	if (buffer->skippedDepth > 0) {
+		buffer->skippedDepth--;
+		return;
+	} // if
+	if (buffer->depth == 0)
+		return;
+	addEvent(buffer, NULL, PROFILER_EVENT_END);
+	buffer->depth--;
+} // endZone
+
+void Profiler::markFrame() {
+	if (!enabled)
+		return;
+	ProfilerThreadBuffer* buffer = getThreadBuffer();
+	if (buffer->numEvents + buffer->depth + 1 > profilerMaxEvents)
+		return;
+	addEvent(buffer, "frame", PROFILER_EVENT_FRAME);
+} // markFrame
+
+const char* Profiler::internName(const std::string& name) {
+	if (!profilerNameLock)
+#if OSG_MAJOR_VERSION >= 2
+		profilerNameLock = OSG::dynamic_pointer_cast<OSG::Lock> (OSG::ThreadManager::the()->getLock("profilerNameLock",false));
+	profilerNameLock->acquire();
+#else //OpenSG1:
+		profilerNameLock = dynamic_cast<OSG::Lock*> (OSG::ThreadManager::the()->getLock("profilerNameLock"));
+	profilerNameLock->aquire();
+#endif
+	// elements of a std::set are never moved, so the pointer stays valid
+	const char* result = profilerNames.insert(name).first->c_str();
+	profilerNameLock->release();
+	return result;
+} // internName
+
+bool Profiler::writeChromeTrace(const std::string& fileName) {
+	FILE* file = fopen(fileName.c_str(), "w");
+	if (!file) {
+		printd(ERROR, "Profiler::writeChromeTrace(): could not open file %s!\n",
+				fileName.c_str());
+		return false;
+	} // if
+
+	std::string escaped;
+	bool first = true;
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	ProfilerThreadBuffer* buffer = (ProfilerThreadBuffer*)profilerBufferList;
+	for (; buffer; buffer = buffer->next) {
+		const char* threadName = buffer->threadName;
+		if (threadName) {
+			fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+					"\"args\":{\"name\":\"%s\"}}", first ? "" : ",\n", buffer->threadId,
+					escapeJson(threadName, escaped));
+			first = false;
+		} // if
+
+		uint32_t numEvents = buffer->numEvents;
+		memoryBarrier();
+		ProfilerEventBlock* block = buffer->firstBlock;
+		for (uint32_t i = 0; i < numEvents; i++) {
+			if (i > 0 && i % PROFILER_BLOCK_SIZE == 0)
+				block = block->next;
+			const ProfilerEvent& event = block->events[i % PROFILER_BLOCK_SIZE];
+			double timeStamp = (event.time - profilerStartTime) * 1000000.0;
+			if (event.type == PROFILER_EVENT_BEGIN)
+				fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"B\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}",
+						first ? "" : ",\n", escapeJson(event.name, escaped), buffer->threadId,
+						timeStamp);
+			else if (event.type == PROFILER_EVENT_END)
+				fprintf(file, "%s{\"ph\":\"E\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}",
+						first ? "" : ",\n", buffer->threadId, timeStamp);
+			else
+				fprintf(file, "%s{\"name\":\"frame\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,"
+						"\"tid\":%u,\"ts\":%.3f}", first ? "" : ",\n", buffer->threadId,
+						timeStamp);
+			first = false;
+		} // for
+	} // for
+	fprintf(file, "\n]}\n");
+	fclose(file);
+	return true;
+} // writeChromeTrace
+
+bool Profiler::writeStatistics(const std::string& fileName) {
+	FILE* file = fopen(fileName.c_str(), "w");
+	if (!file) {
+		printd(ERROR, "Profiler::writeStatistics(): could not open file %s!\n",
+				fileName.c_str());
+		return false;
+	} // if
+
+	std::map<std::string, ZoneStatistics> zones;
+	std::vector<const ProfilerEvent*> openZones;
+	char threadName[32];
+	ProfilerThreadBuffer* buffer = (ProfilerThreadBuffer*)profilerBufferList;
+	for (; buffer; buffer = buffer->next) {
+		std::string prefix;
+		if (buffer->threadName)
+			prefix = buffer->threadName;
+		else {
+			sprintf(threadName, "thread %u", buffer->threadId);
+			prefix = threadName;
+		} // else
+		prefix += ": ";
+
+		openZones.clear();
+		const ProfilerEvent* lastFrame = NULL;
+		uint32_t numEvents = buffer->numEvents;
+		memoryBarrier();
+		ProfilerEventBlock* block = buffer->firstBlock;
+		for (uint32_t i = 0; i < numEvents; i++) {
+			if (i > 0 && i % PROFILER_BLOCK_SIZE == 0)
+				block = block->next;
+			const ProfilerEvent* event = &block->events[i % PROFILER_BLOCK_SIZE];
+			if (event->type == PROFILER_EVENT_BEGIN)
+				openZones.push_back(event);
+			else if (event->type == PROFILER_EVENT_END && !openZones.empty()) {
+				const ProfilerEvent* begin = openZones.back();
+				openZones.pop_back();
+				zones[prefix + begin->name].durations.push_back(event->time - begin->time);
+			} // else if
+			else if (event->type == PROFILER_EVENT_FRAME) {
+				if (lastFrame)
+					zones[prefix + "frame"].durations.push_back(event->time - lastFrame->time);
+				lastFrame = event;
+			} // else if
+		} // for
+	} // for
+
+	fprintf(file, "zone\tcount\tmean [ms]\tp50 [ms]\tp90 [ms]\tp95 [ms]\tp99 [ms]"
+			"\tp99.9 [ms]\tmax [ms]\n");
+	std::map<std::string, ZoneStatistics>::iterator it;
+	for (it = zones.begin(); it != zones.end(); ++it) {
+		std::vector<double>& durations = it->second.durations;
+		std::sort(durations.begin(), durations.end());
+		double sum = 0;
+		for (size_t i = 0; i < durations.size(); i++)
+			sum += durations[i];
+		fprintf(file, "%s\t%u\t%.4f\t%.4f\t%.4f\t%.4f\t%.4f\t%.4f\t%.4f\n", it->first.c_str(),
+				(unsigned)durations.size(), 1000.0 * sum / durations.size(),
+				1000.0 * percentile(durations, 0.5), 1000.0 * percentile(durations, 0.9),
+				1000.0 * percentile(durations, 0.95), 1000.0 * percentile(durations, 0.99),
+				1000.0 * percentile(durations, 0.999), 1000.0 * durations.back());
+	} // for
+	fclose(file);
+	return true;
+} // writeStatistics
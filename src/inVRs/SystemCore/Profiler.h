@@ -0,0 +1,168 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                Changes                                    *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+\*---------------------------------------------------------------------------*/
+
+#ifndef _PROFILER_H
+#define _PROFILER_H
+
+#include <string>
+
+#include "Platform.h"
+
+namespace inVRsUtilities {
+
+/**
+ * Low-overhead profiler for nested zones in multiple threads.
+ * Every thread records begin/end events of its zones into an own buffer
+ * which is only written by this thread, so recording needs no locks. The
+ * recorded data can be exported as Chrome trace (chrome://tracing,
+ * ui.perfetto.dev) or as statistics with percentiles per zone, which makes
+ * single slow frames visible that would vanish in an average.
+ *
+ * Zones are usually recorded with the INVRS_PROFILE_ZONE macro, e.g.
+ * <code>
+ * {
+ *   INVRS_PROFILE_ZONE("SystemCore::step");
+ *   SystemCore::step();
+ * }
+ * </code>
+ * The zone name must be a string which stays valid until the profiler data
+ * is written (a string literal or a string returned by internName()).
+ */
+class INVRS_SYSTEMCORE_API Profiler {
+public:
+	/**
+	 * Enables or disables the recording of zones. The profiler is disabled
+	 * by default.
+	 */
+	static void setEnabled(bool enable);
+
+	/**
+	 * Returns if zones are recorded.
+	 */
+	static bool isEnabled() {
+		return enabled;
+	} // isEnabled
+
+	/**
+	 * Sets the maximum number of events stored per thread. Further zones are
+	 * dropped when the limit is reached. The default is 1048576 events
+	 * (about 24MB per thread).
+	 */
+	static void setMaxEventsPerThread(unsigned maxEvents);
+
+	/**
+	 * Sets the name under which the calling thread is shown in the exported
+	 * data. The event buffer of the thread is not allocated before the
+	 * thread records its first zone, so the call is cheap while the profiler
+	 * is disabled.
+	 */
+	static void setThreadName(const std::string& name);
+
+	/**
+	 * Opens a new zone in the calling thread.
+	 */
+	static void beginZone(const char* name);
+
+	/**
+	 * Closes the innermost open zone of the calling thread.
+	 */
+	static void endZone();
+
+	/**
+	 * Marks the start of a new frame in the calling thread. The time between
+	 * two marks is reported as zone "frame" in the statistics.
+	 */
+	static void markFrame();
+
+	/**
+	 * Returns a pointer to a copy of the passed name which stays valid until
+	 * the program terminates. Use this for zone names which are created at
+	 * runtime and cache the result if possible, since the call needs a lock.
+	 */
+	static const char* internName(const std::string& name);
+
+	/**
+	 * Writes all recorded events in the Chrome trace event format (JSON).
+	 * @return true if the file could be written
+	 */
+	static bool writeChromeTrace(const std::string& fileName);
+
+	/**
+	 * Writes count, mean, percentiles and maximum of the duration of every
+	 * zone per thread as tab-separated table.
+	 * @return true if the file could be written
+	 */
+	static bool writeStatistics(const std::string& fileName);
+
+private:
+	static volatile bool enabled;
+}; // Profiler
+
+/**
+ * Records a zone for the lifetime of the object. Use the INVRS_PROFILE_ZONE
+ * macro instead of this class directly.
+ */
+class ProfilerZone {
+public:
+	ProfilerZone(const char* name) :
+		active(Profiler::isEnabled()) {
+		if (active)
+			Profiler::beginZone(name);
+	} // ProfilerZone
+
+	~ProfilerZone() {
+		if (active)
+			Profiler::endZone();
+	} // ~ProfilerZone
+
+private:
+	ProfilerZone(const ProfilerZone& src);
+	ProfilerZone& operator=(const ProfilerZone& rhs);
+
+	bool active;
+}; // ProfilerZone
+
+} // inVRsUtilities
+
+#ifdef INVRS_DISABLE_PROFILER
+#define INVRS_PROFILE_ZONE(NAME) do {} while (0)
+#else
+#define INVRS_PROFILE_ZONE_CONCAT2(A, B) A ## B
+#define INVRS_PROFILE_ZONE_CONCAT(A, B) INVRS_PROFILE_ZONE_CONCAT2(A, B)
+#define INVRS_PROFILE_ZONE(NAME) \
+	inVRsUtilities::ProfilerZone INVRS_PROFILE_ZONE_CONCAT(_profilerZone, __LINE__)(NAME)
+#endif
+
+#endif /* _PROFILER_H */
@@ -1,3 +1,38 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                Changes                                    *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+\*---------------------------------------------------------------------------*/
+
 /*
  * ProfilingHelper.h
  *
@@ -9,40 +44,66 @@
 #define PROFILINGHELPER_H_
 
 #include <string>
-#include <vector>
+
+#include "Profiler.h"
 
 namespace inVRsUtilities {
 
+/**
+ * DEPRECATED: use INVRS_PROFILE_ZONE and the Profiler instead.
+ * Thin wrapper which records the steps as zones of the Profiler, so the data
+ * appears in the Profiler output and nothing is recorded while the Profiler
+ * is disabled. Unlike the old implementation a step covers the time from the
+ * call of step() to the next call of step(), interrupt() or end(), and the
+ * log file gets the statistics of the Profiler when the helper is destroyed.
+ */
 class ProfilingHelper {
 public:
-	ProfilingHelper();
-	~ProfilingHelper();
+	ProfilingHelper() :
+		zoneOpen(false) {
+	} // ProfilingHelper
+
+	~ProfilingHelper() {
+		end();
+		if (logFile.size() > 0)
+			Profiler::writeStatistics(logFile);
+	} // ~ProfilingHelper
 
-	void setLogFile(std::string file);
+	void setLogFile(std::string file) {
+		logFile = file;
+	} // setLogFile
 
-	void start();
-	void step(std::string name);
-	void interrupt();
-	void end();
+	void start() {
+		end();
+		Profiler::markFrame();
+	} // start
+
+	void step(std::string name) {
+		end();
+		if (Profiler::isEnabled()) {
+			Profiler::beginZone(Profiler::internName(name));
+			zoneOpen = true;
+		} // if
+	} // step
+
+	void interrupt() {
+		end();
+	} // interrupt
+
+	void end() {
+		if (zoneOpen)
+			Profiler::endZone();
+		zoneOpen = false;
+	} // end
 
 private:
 	ProfilingHelper(const ProfilingHelper& src);
 	ProfilingHelper& operator=(const ProfilingHelper& rhs);
 
-	FILE* logFile;
-
-	bool firstRun;
-	bool invalidStep;
-	double lastTime;
-	int index;
-	int numValues;
-	std::vector<double> values;
-	std::vector<std::string> names;
-
-	void initialize(std::string logFile);
+	std::string logFile;
+	bool zoneOpen;
 }; // ProfilingHelper
 
-
 } // inVRsUtilities
 
 #endif /* PROFILINGHELPER_H_ */
@@ -39,6 +39,7 @@
 
 #include "IdPoolListener.h"
 #include "Timer.h"
+#include "NetworkTime.h"
 #include "Configuration.h"
 #include "DebugOutput.h"
 #include "WorldDatabase/WorldDatabase.h"
@@ -92,6 +93,10 @@ void SystemCore::init() {
 	EventManager::init();
 	EventManager::registerEventFactory("SystemCoreRequestSyncEvent",
 			new SystemCoreRequestSyncEvent::Factory());
+	EventManager::registerEventFactory("SystemCorePingEvent",
+			new SystemCorePingEvent::Factory());
+	EventManager::registerEventFactory("SystemCorePongEvent",
+			new SystemCorePongEvent::Factory());
 	printd(INFO, "SystemCore::init(): initializing RequestListener!\n");
 	RequestListener::init();
 	printd(INFO, "SystemCore::init(): initializing TransformationManager!\n");
@@ -218,12 +223,16 @@ void SystemCore::cleanup() {
 
 	std::map<std::string, ModuleInterface*>::reverse_iterator it;
 
+	// send the queued events while the network is still available
+	EventManager::flush();
+
 	// clean up modules
 	for (it = moduleMap.rbegin(); it != moduleMap.rend(); ++it) {
 		it->second->cleanup();
 	} // for
 
 	TransformationManager::cleanup();
+	NetworkTime::cleanup();
 	UserDatabase::cleanup();
 	WorldDatabase::cleanup();
 	EventManager::stop();
@@ -452,6 +461,7 @@ void SystemCore::synchronize() {
 
 void SystemCore::step() {
 	std::deque<Event*>* eventRecvQ = NULL;
+	std::vector<unsigned> syncedUsers;
 	Event* event;
 
 	eventRecvQ = eventPipe->makeCopyAndClear();
@@ -461,8 +471,32 @@ void SystemCore::step() {
 		delete event;
 	} // for
 	delete eventRecvQ;
+
+	NetworkTime::step();
+
+	WorldDatabase::stepSync(syncedUsers);
+	for (int i = 0; i < (int)syncedUsers.size(); i++)
+		sendModuleSyncEvents(syncedUsers[i]);
 } // step
 
+void SystemCore::sendModuleSyncEvents(unsigned userId) {
+	std::map<std::string, ModuleInterface*>::const_iterator it;
+	Event* syncEvent;
+
+	for (it = moduleMap.begin(); it != moduleMap.end(); ++it) {
+		syncEvent = it->second->createSyncEvent();
+		if (syncEvent) {
+			printd(INFO,
+					"SystemCore::sendModuleSyncEvents(): encoding and sending syncEvent from module %s!\n",
+					it->second->getName().c_str());
+			// same lane as the WorldDatabase chunks, so the modules are
+			// synchronised after the entities they refer to
+			syncEvent->setPriority(Event::PRIORITY_BULK);
+			EventManager::sendEventTo(syncEvent, userId);
+		} // if
+	} // for
+} // sendModuleSyncEvents
+
 	bool SystemCore::isModuleLoaded(std::string name) {
 		if (moduleMap.find(name) != moduleMap.end())
 			return true;
@@ -177,11 +177,21 @@ public:
 	static void synchronize();
 
 	/**
-	 * @TODO: write doxygen documentation
+	 * Executes the events of the SystemCore, exchanges the messages of the
+	 * NetworkTime and continues streaming the WorldDatabase to joining users
+	 * (see WorldDatabase::stepSync()). When
+	 * the WorldDatabase of a user is complete the synchronisation events of
+	 * all modules are sent to it.
 	 * Note: Must not be called before synchronize().
 	 */
 	static void step();
 
+	/**
+	 * Sends the synchronisation events of all modules to the passed user.
+	 * @param userId id of the user to synchronise
+	 */
+	static void sendModuleSyncEvents(unsigned userId);
+
 	/**
 	 * Sets the SceneGraphInterface. This method can be called only once. Also invokes <code>init()</code> of the SceneGraphInterface.
 	 * At the moment there is no way to remove the SceneGraphInterface (as there is no need for that). Simply call <code>delete</code> on it when everything else has been released.
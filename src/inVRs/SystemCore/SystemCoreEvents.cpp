@@ -31,6 +31,8 @@
 #include <assert.h>
 
 #include "SystemCore.h"
+#include "Timer.h"
+#include "MessageFunctions.h"
 #include "EventManager/EventManager.h"
 #include "ComponentInterfaces/NetworkInterface.h"
 #include "UserDatabase/UserDatabase.h"
@@ -38,25 +40,35 @@
 
 SystemCoreRequestSyncEvent::SystemCoreRequestSyncEvent() :
 	Event(SYSTEM_CORE_ID, SYSTEM_CORE_ID, "SystemCoreRequestSyncEvent") {
+	User* localUser = UserDatabase::getLocalUser();
+	Environment* spawnEnvironment = NULL;
+	TransformationData navigatedTransf;
+
 	requestUserId = UserDatabase::getLocalUserId(); // everything will be overwritten when event is beeing deserialized during decode()
+	if (localUser) {
+		navigatedTransf = localUser->getNavigatedTransformation();
+		spawnEnvironment = WorldDatabase::getEnvironmentAtWorldPosition(
+				navigatedTransf.position[0], navigatedTransf.position[2]);
+	} // if
+	spawnEnvironmentId = spawnEnvironment ? spawnEnvironment->getId() : ~0u;
 } // SystemCoreRequestSyncEvent
 
 void SystemCoreRequestSyncEvent::encode(NetMessage* message) {
 	printd(INFO, "SystemCoreRequestSyncEvent::encode(): encoding userId %u\n",
 			requestUserId);
 	message->putUInt32(requestUserId);
+	message->putUInt32(spawnEnvironmentId);
 } // encode
 
 void SystemCoreRequestSyncEvent::decode(NetMessage* message) {
 	message->getUInt32(requestUserId);
+	message->getUInt32(spawnEnvironmentId);
 	printd(INFO, "SystemCoreRequestSyncEvent::decode(): decoded userId %u\n",
 			requestUserId);
 } // decode
 
 void SystemCoreRequestSyncEvent::execute() {
 	NetworkInterface* netInt;
-	std::map<std::string, ModuleInterface*>::const_iterator it;
-	Event* syncEvent;
 
 	printd(INFO,
 			"SystemCoreRequestSyncEvent::execute(): running syncEvent for user %u ...\n",
@@ -65,21 +77,9 @@ void SystemCoreRequestSyncEvent::execute() {
 	netInt = (NetworkInterface*)SystemCore::getModuleByName("Network");
 	assert(netInt); // is not intended to be executed locally
 
-	const std::map<std::string, ModuleInterface*>& moduleMap = SystemCore::getModuleMap();
-
-	// sync events from non-modules:
-	syncEvent = new WorldDatabaseSyncEvent(TRANSFORMATION_MANAGER_ID);
-	EventManager::sendEventTo(syncEvent, requestUserId);
-
-	for (it = moduleMap.begin(); it != moduleMap.end(); ++it) {
-		syncEvent = it->second->createSyncEvent();
-		if (syncEvent) {
-			printd(INFO,
-					"SystemCoreRequestSyncEvent::execute(): encoding and sending syncEvent from module %s!\n",
-					it->second->getName().c_str());
-			EventManager::sendEventTo(syncEvent, requestUserId);
-		} // if
-	} // for
+	// the WorldDatabase is streamed by SystemCore::step(), which sends the
+	// sync events of the modules when the stream is complete
+	WorldDatabase::startSync(requestUserId, spawnEnvironmentId);
 	printd(INFO, "SystemCoreRequestSyncEvent::execute(): DONE!\n");
 } // execute
 
@@ -91,3 +91,92 @@ std::string SystemCoreRequestSyncEvent::toString() {
 	return ss.str();
 } // toString
 
+
+SystemCorePingEvent::SystemCorePingEvent() :
+	Event(),
+	requestUserId(0),
+	pingNumber(0),
+	sendTime(0) {
+} // SystemCorePingEvent
+
+SystemCorePingEvent::SystemCorePingEvent(unsigned replyModuleId, unsigned pingNumber,
+		unsigned payloadSize) :
+	Event(replyModuleId, SYSTEM_CORE_ID, "SystemCorePingEvent"),
+	requestUserId(UserDatabase::getLocalUserId()),
+	pingNumber(pingNumber),
+	sendTime(inVRsUtilities::Timer::getMonotonicTime()),
+	payload(payloadSize, 'p') {
+} // SystemCorePingEvent
+
+void SystemCorePingEvent::encode(NetMessage* message) {
+	msgFunctions::encode(requestUserId, message);
+	msgFunctions::encode(pingNumber, message);
+	msgFunctions::encode(sendTime, message);
+	message->putString(payload);
+} // encode
+
+void SystemCorePingEvent::decode(NetMessage* message) {
+	msgFunctions::decode(requestUserId, message);
+	msgFunctions::decode(pingNumber, message);
+	msgFunctions::decode(sendTime, message);
+	message->getString(payload);
+} // decode
+
+void SystemCorePingEvent::execute() {
+	// the source module of the ping is the module which receives the pong
+	EventManager::sendEventTo(new SystemCorePongEvent(evt_srcModuleId, pingNumber, sendTime),
+			requestUserId);
+} // execute
+
+std::string SystemCorePingEvent::toString() {
+	std::stringstream ss(std::stringstream::in | std::stringstream::out);
+
+	ss << "EVENT: SystemCorePingEvent\n";
+	ss << "requestUserId = " << requestUserId << "\tpingNumber = " << pingNumber
+			<< "\tpayload = " << payload.size() << " bytes" << std::endl;
+	return ss.str();
+} // toString
+
+SystemCorePongEvent::SystemCorePongEvent() :
+	Event(),
+	pingNumber(0),
+	sendTime(0) {
+} // SystemCorePongEvent
+
+SystemCorePongEvent::SystemCorePongEvent(unsigned replyModuleId, unsigned pingNumber,
+		double sendTime) :
+	Event(SYSTEM_CORE_ID, replyModuleId, "SystemCorePongEvent"),
+	pingNumber(pingNumber),
+	sendTime(sendTime) {
+} // SystemCorePongEvent
+
+void SystemCorePongEvent::encode(NetMessage* message) {
+	msgFunctions::encode(pingNumber, message);
+	msgFunctions::encode(sendTime, message);
+} // encode
+
+void SystemCorePongEvent::decode(NetMessage* message) {
+	msgFunctions::decode(pingNumber, message);
+	msgFunctions::decode(sendTime, message);
+} // decode
+
+void SystemCorePongEvent::execute() {
+	printd(INFO, "SystemCorePongEvent::execute(): ping %u answered after %.3f ms\n", pingNumber,
+			getRoundTripTime() * 1000.0);
+} // execute
+
+std::string SystemCorePongEvent::toString() {
+	std::stringstream ss(std::stringstream::in | std::stringstream::out);
+
+	ss << "EVENT: SystemCorePongEvent\n";
+	ss << "pingNumber = " << pingNumber << std::endl;
+	return ss.str();
+} // toString
+
+unsigned SystemCorePongEvent::getPingNumber() {
+	return pingNumber;
+} // getPingNumber
+
+double SystemCorePongEvent::getRoundTripTime() {
+	return inVRsUtilities::Timer::getMonotonicTime() - sendTime;
+} // getRoundTripTime
@@ -56,6 +56,62 @@ public:
 
 protected:
 	unsigned requestUserId;
+	unsigned spawnEnvironmentId; /// Environment of the requesting user, ~0 if unknown
 }; // SystemCoreRequestSyncEvent
 
+/******************************************************************************
+ * Event for measuring the event latency to another user. The receiver answers
+ * with a SystemCorePongEvent to the sending user, which is put into the
+ * EventPipe of the module passed as replyModuleId. The payload can be used to
+ * emulate the size of application events.
+ */
+class INVRS_SYSTEMCORE_API SystemCorePingEvent : public Event {
+public:
+	SystemCorePingEvent();
+	SystemCorePingEvent(unsigned replyModuleId, unsigned pingNumber, unsigned payloadSize = 0);
+
+	typedef EventFactory<SystemCorePingEvent> Factory;
+
+	virtual void encode(NetMessage* message);
+	virtual void decode(NetMessage* message);
+
+	virtual void execute();
+	virtual std::string toString();
+
+protected:
+	unsigned requestUserId;
+	unsigned pingNumber;
+	double sendTime; /// Timer::getMonotonicTime() of the sender
+	std::string payload;
+}; // SystemCorePingEvent
+
+/******************************************************************************
+ * Answer to a SystemCorePingEvent.
+ */
+class INVRS_SYSTEMCORE_API SystemCorePongEvent : public Event {
+public:
+	SystemCorePongEvent();
+	SystemCorePongEvent(unsigned replyModuleId, unsigned pingNumber, double sendTime);
+
+	typedef EventFactory<SystemCorePongEvent> Factory;
+
+	virtual void encode(NetMessage* message);
+	virtual void decode(NetMessage* message);
+
+	virtual void execute();
+	virtual std::string toString();
+
+	unsigned getPingNumber();
+
+	/**
+	 * Returns the time in seconds since the SystemCorePingEvent was sent. Only
+	 * valid in the process which sent the SystemCorePingEvent.
+	 */
+	double getRoundTripTime();
+
+protected:
+	unsigned pingNumber;
+	double sendTime;
+}; // SystemCorePongEvent
+
 #endif /* SYSTEMCOREEVENTS_H_ */
@@ -31,6 +31,7 @@
 #include <windows.h>
 #else
 #include <sys/time.h>
+#include <time.h>
 #endif
 
 #include <sys/timeb.h>
@@ -99,6 +100,24 @@ double Timer::getSystemTime() {
 #endif
 } // getSystemTime
 
+double Timer::getMonotonicTime() {
+#ifdef WIN32
+	static double frequency = 0;
+	LARGE_INTEGER counter;
+	if (frequency == 0) {
+		LARGE_INTEGER freq;
+		QueryPerformanceFrequency(&freq);
+		frequency = (double)freq.QuadPart;
+	} // if
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / frequency;
+#else
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0);
+#endif
+} // getMonotonicTime
+
 double Timer::getTime() {
 	if (!running)
 		return timerValue;
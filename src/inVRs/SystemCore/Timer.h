@@ -92,6 +92,14 @@ public:
 	 */
 	static double getSystemTime();
 
+	/**
+	 * Get the time of a monotonic clock since some unspecified point in the
+	 * past. In contrast to getSystemTime() this clock is not affected by
+	 * changes of the wallclock time and has a higher resolution.
+	 * @return seconds
+	 */
+	static double getMonotonicTime();
+
 	/**
 	 * Update the timer and get the current time since the timer was started.
 	 */
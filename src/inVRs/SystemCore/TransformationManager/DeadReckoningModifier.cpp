@@ -0,0 +1,209 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+
+#include "DeadReckoningModifier.h"
+
+#include <math.h>
+
+#include <gmtl/AxisAngle.h>
+#include <gmtl/Generate.h>
+#include <gmtl/QuatOps.h>
+#include <gmtl/VecOps.h>
+
+#include "../Timer.h"
+
+namespace {
+
+// samples arriving closer than this are treated as one sample
+const double MIN_SAMPLE_INTERVAL = 0.001;
+
+/**
+ * Returns the rotation from -> to as axis scaled by the angle (in radians).
+ */
+gmtl::Vec3f getRotationVector(const gmtl::Quatf& from, const gmtl::Quatf& to) {
+	gmtl::Quatf inverseFrom = from;
+	gmtl::Quatf delta = to * gmtl::invert(inverseFrom);
+	gmtl::Vec3f axis(delta[0], delta[1], delta[2]);
+	float w = delta[3];
+	float sinHalfAngle;
+
+	// use the shorter rotation
+	if (w < 0) {
+		axis = -axis;
+		w = -w;
+	} // if
+	if (w > 1)
+		w = 1;
+	sinHalfAngle = sqrtf(1 - w * w);
+	if (sinHalfAngle < 1e-6f)
+		return gmtl::Vec3f(0, 0, 0);
+	return axis * (2 * acosf(w) / sinHalfAngle);
+} // getRotationVector
+
+} // namespace
+
+DeadReckoningModel::DeadReckoningModel() {
+	reset();
+} // DeadReckoningModel
+
+void DeadReckoningModel::reset() {
+	sample = identityTransformation();
+	sampleTime = 0;
+	validSample = false;
+	velocity = gmtl::Vec3f(0, 0, 0);
+	angularVelocity = gmtl::Vec3f(0, 0, 0);
+} // reset
+
+void DeadReckoningModel::addSample(const TransformationData& data, double time) {
+	double dt = time - sampleTime;
+
+	if (validSample && dt >= MIN_SAMPLE_INTERVAL) {
+		velocity = (data.position - sample.position) / (float)dt;
+		angularVelocity = getRotationVector(sample.orientation, data.orientation) / (float)dt;
+	} // if
+	sample = data;
+	if (!validSample || dt >= MIN_SAMPLE_INTERVAL)
+		sampleTime = time;
+	validSample = true;
+} // addSample
+
+bool DeadReckoningModel::hasSample() const {
+	return validSample;
+} // hasSample
+
+double DeadReckoningModel::getSampleTime() const {
+	return sampleTime;
+} // getSampleTime
+
+void DeadReckoningModel::predict(double time, double maxExtrapolationTime,
+		TransformationData& dst) const {
+	float dt = (float)(time - sampleTime);
+	float angularSpeed = gmtl::length(angularVelocity);
+	gmtl::Quatf rotation;
+
+	if (dt < 0)
+		dt = 0;
+	else if (dt > maxExtrapolationTime)
+		dt = (float)maxExtrapolationTime;
+
+	dst = sample;
+	dst.position += velocity * dt;
+	if (angularSpeed * dt > 1e-6f) {
+		gmtl::set(rotation, gmtl::AxisAnglef(angularSpeed * dt, angularVelocity / angularSpeed));
+		dst.orientation = rotation * sample.orientation;
+		gmtl::normalize(dst.orientation);
+	} // if
+} // predict
+
+float DeadReckoningModel::getPositionError(const TransformationData& a,
+		const TransformationData& b) {
+	return gmtl::length(gmtl::Vec3f(a.position - b.position));
+} // getPositionError
+
+float DeadReckoningModel::getOrientationError(const TransformationData& a,
+		const TransformationData& b) {
+	return gmtl::length(getRotationVector(a.orientation, b.orientation));
+} // getOrientationError
+
+DeadReckoningModifier::DeadReckoningModifier(bool extrapolate, float blendTime,
+		float maxExtrapolationTime) {
+	this->extrapolate = extrapolate;
+	this->blendTime = blendTime;
+	this->maxExtrapolationTime = extrapolate ? maxExtrapolationTime : 0;
+	validLastResult = false;
+	positionOffset = gmtl::Vec3f(0, 0, 0);
+	orientationOffset = gmtl::QUAT_IDENTITYF;
+	offsetTime = 0;
+} // DeadReckoningModifier
+
+TransformationData DeadReckoningModifier::execute(TransformationData* resultLastStage,
+		TransformationPipe* currentPipe) {
+	TransformationData result;
+	gmtl::Quatf inverseOrientation, blendedOffset;
+	double now = inVRsUtilities::Timer::getMonotonicTime();
+	int size = currentPipe->size();
+	double sampleTime;
+	float factor;
+
+	if (size == 0)
+		return *resultLastStage;
+
+	// the pipe executes with the newest entry until the next update arrives
+	sampleTime = currentPipe->getTimestamp(size - 1);
+	if (!model.hasSample() || sampleTime > model.getSampleTime()) {
+		model.addSample(*resultLastStage, sampleTime);
+		if (validLastResult && blendTime > 0) {
+			// start blending from where the previous prediction left the object
+			model.predict(now, maxExtrapolationTime, result);
+			inverseOrientation = result.orientation;
+			gmtl::invert(inverseOrientation);
+			positionOffset = lastResult.position - result.position;
+			orientationOffset = lastResult.orientation * inverseOrientation;
+			offsetTime = now;
+		} // if
+	} // if
+
+	model.predict(now, maxExtrapolationTime, result);
+
+	if (blendTime > 0) {
+		factor = 1.f - (float)(now - offsetTime) / blendTime;
+		if (factor > 0) {
+			result.position += positionOffset * factor;
+			gmtl::slerp(blendedOffset, factor, gmtl::QUAT_IDENTITYF, orientationOffset);
+			result.orientation = blendedOffset * result.orientation;
+			gmtl::normalize(result.orientation);
+		} // if
+	} // if
+
+	lastResult = result;
+	validLastResult = true;
+	return result;
+} // execute
+
+DeadReckoningModifierFactory::DeadReckoningModifierFactory() {
+	className = "DeadReckoningModifier";
+} // DeadReckoningModifierFactory
+
+TransformationModifier* DeadReckoningModifierFactory::createInternal(ArgumentVector* args) {
+	bool extrapolate = true;
+	float blendTime = 0.1f;
+	float maxExtrapolationTime = 0.25f;
+
+	if (!args)
+		return new DeadReckoningModifier();
+
+	args->get("extrapolate", extrapolate);
+	args->get("blendTime", blendTime);
+	args->get("maxExtrapolationTime", maxExtrapolationTime);
+
+	return new DeadReckoningModifier(extrapolate, blendTime, maxExtrapolationTime);
+} // createInternal
+
+bool DeadReckoningModifierFactory::needInstanceForEachPipe() {
+	return true;
+} // needInstanceForEachPipe
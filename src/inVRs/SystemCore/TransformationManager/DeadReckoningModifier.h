@@ -0,0 +1,153 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                Changes                                    *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+\*---------------------------------------------------------------------------*/
+
+#ifndef _DEADRECKONINGMODIFIER_H
+#define _DEADRECKONINGMODIFIER_H
+
+#include "TransformationModifierFactory.h"
+
+/******************************************************************************
+ * Extrapolates a transformation from its last two samples. The position is
+ * moved with constant velocity, the orientation is rotated with constant
+ * angular velocity, the scale is taken from the last sample.
+ *
+ * The model is used on both sides of the network: the
+ * DeadReckoningModifier predicts remote transformations between two
+ * received updates, the TransformationDistributionModifier runs the same
+ * model for the transformations it sends and only sends an update when the
+ * prediction of the receiver would be off by more than a threshold.
+ */
+class INVRS_SYSTEMCORE_API DeadReckoningModel {
+public:
+	DeadReckoningModel();
+
+	/**
+	 * Removes all samples.
+	 */
+	void reset();
+
+	/**
+	 * Adds a sample and updates the velocities from the previous one. The
+	 * time must be in the timebase of Timer::getMonotonicTime(). Samples
+	 * closer than 1ms to the previous one replace it without changing the
+	 * velocities.
+	 */
+	void addSample(const TransformationData& data, double time);
+
+	/**
+	 * Returns true if at least one sample was added.
+	 */
+	bool hasSample() const;
+
+	/**
+	 * Returns the time of the last sample.
+	 */
+	double getSampleTime() const;
+
+	/**
+	 * Writes the transformation extrapolated to the passed time into dst.
+	 * The extrapolation stops maxExtrapolationTime seconds after the last
+	 * sample, so a lost connection does not send the object to infinity.
+	 */
+	void predict(double time, double maxExtrapolationTime, TransformationData& dst) const;
+
+	/**
+	 * Returns the distance between the positions of two transformations.
+	 */
+	static float getPositionError(const TransformationData& a, const TransformationData& b);
+
+	/**
+	 * Returns the angle (in radians) between the orientations of two
+	 * transformations.
+	 */
+	static float getOrientationError(const TransformationData& a, const TransformationData& b);
+
+protected:
+	TransformationData sample;
+	double sampleTime;
+	bool validSample;
+	gmtl::Vec3f velocity;
+	gmtl::Vec3f angularVelocity; // rotation axis scaled by radians per second
+}; // DeadReckoningModel
+
+/******************************************************************************
+ * Smoothes remote transformations which arrive with jitter or at a low rate.
+ * Between two updates the transformation is extrapolated with a
+ * DeadReckoningModel. When an update arrives, the error of the previous
+ * prediction is not applied at once but blended out over blendTime seconds.
+ *
+ * The modifier uses the timestamps of the TransformationPipe, so it must be
+ * placed in the pipe receiving the remote transformations before the writer:
+ * \verbatim
+<modifier type="DeadReckoningModifier">
+  <arguments>
+    <arg key="extrapolate"          type="bool"  value="true"/>
+    <arg key="blendTime"            type="float" value="0.1"/>
+    <arg key="maxExtrapolationTime" type="float" value="0.25"/>
+  </arguments>
+</modifier>
+\endverbatim
+ * Without extrapolation the modifier only blends between the updates.
+ */
+class INVRS_SYSTEMCORE_API DeadReckoningModifier : public TransformationModifier {
+public:
+	DeadReckoningModifier(bool extrapolate = true, float blendTime = 0.1f,
+			float maxExtrapolationTime = 0.25f);
+	virtual TransformationData execute(TransformationData* resultLastStage,
+			TransformationPipe* currentPipe);
+
+protected:
+	bool extrapolate;
+	float blendTime;
+	float maxExtrapolationTime;
+	DeadReckoningModel model;
+	TransformationData lastResult;
+	bool validLastResult;
+	// error of the previous prediction at the time of the last update
+	gmtl::Vec3f positionOffset;
+	gmtl::Quatf orientationOffset;
+	double offsetTime;
+}; // DeadReckoningModifier
+
+class INVRS_SYSTEMCORE_API DeadReckoningModifierFactory : public TransformationModifierFactory {
+public:
+	DeadReckoningModifierFactory();
+
+protected:
+	virtual TransformationModifier* createInternal(ArgumentVector* args = NULL);
+	virtual bool needInstanceForEachPipe();
+}; // DeadReckoningModifierFactory
+
+#endif // _DEADRECKONINGMODIFIER_H
@@ -30,9 +30,20 @@
 #include "TransformationManager.h"
 #include "../NetMessage.h"
 #include "../XMLTools.h"
+#include "../Timer.h"
+#include "../NetworkTime.h"
+#include "../MessageFunctions.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
 
 TransformationDistributionModifier::TransformationDistributionModifier(bool bUseTCP) {
 	this->bUseTCP = bUseTCP;
+	positionThreshold = 0;
+	orientationThreshold = 0;
+	maxSendInterval = 1;
+	maxExtrapolationTime = 0.25f;
 	network = (NetworkInterface*)SystemCore::getModuleByName("Network");
 } // TransformationDistributionModifier
 
@@ -40,13 +51,19 @@ TransformationData TransformationDistributionModifier::execute(TransformationDat
 		TransformationPipe* currentPipe) {
 	NetMessage msg;
 
+	if (network && (positionThreshold > 0 || orientationThreshold > 0)
+			&& !needsUpdate(*resultLastStage, currentPipe,
+					inVRsUtilities::Timer::getMonotonicTime()))
+		return *resultLastStage;
+
 	if (network) {
 		// 		msg.putUInt32(UserDatabase::getLocalUserId());
 		msg.putUInt32(currentPipe->getOwner()->getId());
 		msg.putUInt64(currentPipe->getPipeId());
 		addTransformationToBinaryMsg(resultLastStage, &msg);
-
-		//TODO: add timestamp to distribution!!!
+		// the receiver uses the receive time for messages without time
+		if (NetworkTime::isSynchronised())
+			msgFunctions::encode(NetworkTime::getTime(), &msg);
 
 		if (bUseTCP)
 			network->sendMessageTCP(&msg, TRANSFORMATION_MANAGER_ID);
@@ -65,6 +82,39 @@ void TransformationDistributionModifier::useUDP() {
 	bUseTCP = false;
 } // useUDP
 
+void TransformationDistributionModifier::setSendThreshold(float positionThreshold,
+		float orientationThreshold, float maxSendInterval, float maxExtrapolationTime) {
+	this->positionThreshold = positionThreshold;
+	this->orientationThreshold = orientationThreshold;
+	this->maxSendInterval = maxSendInterval;
+	this->maxExtrapolationTime = maxExtrapolationTime;
+	pipeStates.clear();
+} // setSendThreshold
+
+bool TransformationDistributionModifier::needsUpdate(const TransformationData& data,
+		TransformationPipe* pipe, double time) {
+	TransformationData prediction;
+	PipeState& state = pipeStates[pipe];
+
+	if (state.model.hasSample() && time - state.lastSendTime < maxSendInterval) {
+		// same prediction as the DeadReckoningModifier of the receiver
+		state.model.predict(time, maxExtrapolationTime, prediction);
+		if ((positionThreshold <= 0 || DeadReckoningModel::getPositionError(data, prediction)
+				<= positionThreshold) && (orientationThreshold <= 0
+				|| DeadReckoningModel::getOrientationError(data, prediction)
+						<= orientationThreshold))
+			return false;
+	} // if
+
+	state.model.addSample(data, time);
+	state.lastSendTime = time;
+	return true;
+} // needsUpdate
+
+void TransformationDistributionModifier::removePipe(TransformationPipe* pipe) {
+	pipeStates.erase(pipe);
+} // removePipe
+
 TransformationDistributionModifierFactory::TransformationDistributionModifierFactory() {
 	className = "TransformationDistributionModifier";
 }
@@ -73,14 +123,29 @@ TransformationModifier* TransformationDistributionModifierFactory::createInterna
 		ArgumentVector* args) {
 	bool useTCP = true;
 	std::string protocol;
+	float positionThreshold = 0;
+	float orientationThreshold = 0;
+	float maxSendInterval = 1;
+	float maxExtrapolationTime = 0.25f;
+	TransformationDistributionModifier* modifier;
 
-	if (args && args->get("protocol", protocol)) {
+	if (!args)
+		return new TransformationDistributionModifier();
+
+	if (args->get("protocol", protocol)) {
 		if (protocol == "UDP" || protocol == "udp" || protocol == "Udp")
 			useTCP = false;
-		return new TransformationDistributionModifier(useTCP);
 	} // if
+	modifier = new TransformationDistributionModifier(useTCP);
+
+	args->get("positionThreshold", positionThreshold);
+	args->get("orientationThreshold", orientationThreshold);
+	args->get("maxSendInterval", maxSendInterval);
+	args->get("maxExtrapolationTime", maxExtrapolationTime);
+	modifier->setSendThreshold(positionThreshold, orientationThreshold * (float)M_PI / 180.f,
+			maxSendInterval, maxExtrapolationTime);
 
-	return new TransformationDistributionModifier();
+	return modifier;
 } // create
 
 bool TransformationDistributionModifierFactory::needInstanceForEachPipeConfiguration() {
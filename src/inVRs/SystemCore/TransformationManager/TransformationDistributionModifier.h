@@ -36,12 +36,34 @@
 #ifndef _TRANSFORMATIONDISTRIBUTIONMODIFIER_H
 #define _TRANSFORMATIONDISTRIBUTIONMODIFIER_H
 
+#include <map>
+
 #include "../ComponentInterfaces/NetworkInterface.h"
 #include "TransformationModifierFactory.h"
+#include "DeadReckoningModifier.h"
 #include "../ClassFactory.h"
 
 /**
  * only one instance per pipe group allowed
+ *
+ * If a send threshold is set, the modifier runs the DeadReckoningModel the
+ * receiver uses for each pipe and only sends a transformation when the
+ * prediction of the receiver is off by more than the threshold, or when
+ * nothing was sent for maxSendInterval seconds:
+ * \verbatim
+<modifier type="TransformationDistributionModifier">
+  <arguments>
+    <arg key="protocol"             type="string" value="UDP"/>
+    <arg key="positionThreshold"    type="float"  value="0.01"/>
+    <arg key="orientationThreshold" type="float"  value="2"/>
+    <arg key="maxSendInterval"      type="float"  value="1"/>
+    <arg key="maxExtrapolationTime" type="float"  value="0.25"/>
+  </arguments>
+</modifier>
+\endverbatim
+ * The positionThreshold is in units of the world, the orientationThreshold
+ * in degrees. The receiving pipes should contain a DeadReckoningModifier
+ * with the same maxExtrapolationTime.
  */
 class INVRS_SYSTEMCORE_API TransformationDistributionModifier : public TransformationModifier {
 public:
@@ -51,9 +73,30 @@ public:
 	void useTCP();
 	void useUDP();
 
+	/**
+	 * Enables threshold based sending, a positionThreshold and
+	 * orientationThreshold (in radians) of 0 sends every transformation.
+	 */
+	void setSendThreshold(float positionThreshold, float orientationThreshold,
+			float maxSendInterval, float maxExtrapolationTime = 0.25f);
+
 protected:
+	struct PipeState {
+		DeadReckoningModel model;
+		double lastSendTime;
+	}; // PipeState
+
+	bool needsUpdate(const TransformationData& data, TransformationPipe* pipe, double time);
+	virtual void removePipe(TransformationPipe* pipe);
+
 	bool bUseTCP;
 	NetworkInterface* network;
+	float positionThreshold;
+	float orientationThreshold;
+	float maxSendInterval;
+	float maxExtrapolationTime;
+	// sender side prediction per pipe, erased when the pipe is destroyed
+	std::map<TransformationPipe*, PipeState> pipeStates;
 };
 
 class INVRS_SYSTEMCORE_API TransformationDistributionModifierFactory :
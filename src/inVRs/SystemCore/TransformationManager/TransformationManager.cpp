@@ -38,6 +38,7 @@
 #include "TrackingOffsetModifier.h"
 #include "UserTransformationWriter.h"
 #include "TransformationDistributionModifier.h"
+#include "DeadReckoningModifier.h"
 #include "ApplyNavigationModifier.h"
 #include "AvatarTransformationWriter.h"
 #include "EntityTransformationWriter.h"
@@ -51,6 +52,9 @@
 #include "../SystemCore.h"
 #include "../UserDatabase/UserDatabaseEvents.h"
 #include "../UtilityFunctions.h"
+#include "../Timer.h"
+#include "../NetworkTime.h"
+#include "../MessageFunctions.h"
 
 // disable deprecation warning for std::auto_ptr when std::unique_ptr is not available.
 #ifndef HAS_CXX11_UNIQUE_PTR
@@ -77,6 +81,8 @@ bool 										TransformationManager::initialized = false;
 NetworkInterface* 							TransformationManager::network = NULL;
 User* 										TransformationManager::localUser = NULL;
 std::vector<TransformationPipe*> 			TransformationManager::pipes;
+inVRsUtilities::HashIndex<unsigned, TransformationManager::UserPipeTable*>
+											TransformationManager::userPipeTables;
 EventPipe* 									TransformationManager::eventPipe = NULL;
 unsigned 									TransformationManager::interruptedPipePriority = 0;
 std::vector<TransformationModifierFactory*>	TransformationManager::modifierFactories;
@@ -159,6 +165,7 @@ bool TransformationManager::init() {
 	registerModifierFactory(new AssociatedEntityInterrupterFactory);
 	registerModifierFactory(new MultiPipeInterrupterFactory);
 	registerModifierFactory(new TargetPipeTransformationWriterFactory);
+	registerModifierFactory(new DeadReckoningModifierFactory);
 	loggerModifierFactory = new TransformationLoggerModifierFactory;
 	registerModifierFactory(loggerModifierFactory);
 
@@ -198,6 +205,11 @@ void TransformationManager::cleanup() {
 		delete pipes[i];
 	}
 	pipes.clear();
+	for (unsigned i = 0; i < userPipeTables.getCapacity(); i++) {
+		if (userPipeTables.isOccupied(i))
+			delete userPipeTables.getValueAt(i);
+	} // for
+	userPipeTables.clear();
 	pipeListLock->release();
 
 	// localUserTrackingPipeList is also affected by previous call
@@ -224,7 +236,6 @@ TransformationPipe* TransformationManager::getPipe(unsigned srcId, unsigned dstI
 
 	TransformationPipe* ret = NULL;
 	uint64_t pipeId;
-	std::vector<TransformationPipe*>::iterator it;
 	if (!user)
 		user = UserDatabase::getLocalUser();
 
@@ -235,18 +246,10 @@ TransformationPipe* TransformationManager::getPipe(unsigned srcId, unsigned dstI
 #else //OpenSG1:
 	pipeListLock->aquire();
 #endif
-	it = pipes.begin();
-	while (it != pipes.end()) {
-		if ((*it)->pipeId == pipeId && (*it)->getOwner() == user) {
-			ret = *it;
-			break;
-		} // if
-		else
-			++it;
-	} // while
+	ret = findPipe(user, pipeId);
 	pipeListLock->release();
 
-	if (!ret) {
+	if (!ret && PRINTD_ENABLED(INFO)) {
 		printd(
 				INFO,
 				"TransformationManager::getPipe(): PIPE with ID %s FROM USER WITH ID %i NOT FOUND!!!\n",
@@ -395,6 +398,7 @@ void TransformationManager::closePipe(TransformationPipe* pipe) {
 			printd(INFO, "TransformationManager::closePipe(): closing pipe with id %s\n",
 					getUInt64AsString(pipe->pipeId).c_str());
 			pipes.erase(it);
+			removeFromUserPipeTable(pipe);
 			printd(INFO, "TransformationManager::closePipe(): deleting Pipe.\n");
 			delete pipe;
 			printd(INFO, "TransformationManager::closePipe(): Pipe deleted.\n");
@@ -494,6 +498,45 @@ void TransformationManager::getAllPipesFromUser(User* user, std::vector<Transfor
 	}
 }
 
+TransformationPipe* TransformationManager::findPipe(User* user, uint64_t pipeId) {
+	if (!user)
+		return NULL;
+
+	UserPipeTable** userPipes = userPipeTables.find(user->getId());
+	if (!userPipes)
+		return NULL;
+
+	TransformationPipe** pipe = (*userPipes)->find(pipeId);
+	if (!pipe || (*pipe)->getOwner() != user)
+		return NULL;
+
+	return *pipe;
+} // findPipe
+
+void TransformationManager::addToUserPipeTable(TransformationPipe* pipe) {
+	UserPipeTable** userPipes = userPipeTables.find(pipe->getOwner()->getId());
+	if (!userPipes) {
+		userPipeTables.set(pipe->getOwner()->getId(), new UserPipeTable);
+		userPipes = userPipeTables.find(pipe->getOwner()->getId());
+	} // if
+	(*userPipes)->set(pipe->getPipeId(), pipe);
+} // addToUserPipeTable
+
+void TransformationManager::removeFromUserPipeTable(TransformationPipe* pipe) {
+	UserPipeTable** userPipes = userPipeTables.find(pipe->getOwner()->getId());
+	if (!userPipes)
+		return;
+
+	TransformationPipe** entry = (*userPipes)->find(pipe->getPipeId());
+	if (entry && *entry == pipe)
+		(*userPipes)->erase(pipe->getPipeId());
+
+	if ((*userPipes)->size() == 0) {
+		delete *userPipes;
+		userPipeTables.erase(pipe->getOwner()->getId());
+	} // if
+} // removeFromUserPipeTable
+
 unsigned& TransformationManager::getValueFromAttribute(const XmlElement* xml, std::string name,
 		unsigned& dst) {
 	std::string tempString = xml->getAttributeValue(name.c_str());
@@ -523,16 +566,28 @@ void TransformationManager::handleNetworkMessages() {
 	TransformationData netData;
 	unsigned netUserId;
 	uint64_t netPipeId;
+	double sendTime, now;
+	bool hasSendTime;
 	NetMessage* msg;
 	std::vector<NetMessage*> msgList;
-	std::vector<TransformationPipe*> pipesFromUser;
+	TransformationPipe* pipe;
 	User* remoteUser;
-	int i;
+	unsigned i;
 
 	network->popAll(TRANSFORMATION_MANAGER_ID, &msgList);
-	while (!msgList.empty()) {
-		msg = msgList[0];
+	for (i = 0; i < msgList.size(); i++) {
+		msg = msgList[i];
 		decodeNetMsg(msg, &netData, &netUserId, &netPipeId);
+		now = inVRsUtilities::Timer::getMonotonicTime();
+		sendTime = now;
+		hasSendTime = !msg->finished() && NetworkTime::isSynchronised();
+		if (hasSendTime) {
+			msgFunctions::decode(sendTime, msg);
+			sendTime = NetworkTime::toLocalTime(sendTime);
+			// an estimation error must not put the data into the future
+			if (sendTime > now)
+				sendTime = now;
+		} // if
 
 		netPipeId |= 1; // set network bit
 		remoteUser = UserDatabase::getUserById(netUserId);
@@ -540,31 +595,28 @@ void TransformationManager::handleNetworkMessages() {
 			printd(
 					WARNING,
 					"TransformationManager::handleNetworkMessages(): Found an incoming transformation from a remote pipe whose owner is localUser!\n");
-		pipesFromUser.clear();
-		getAllPipesFromUser(remoteUser, &pipesFromUser);
-
-		if (pipesFromUser.size() == 0)
-			printd(INFO,
-					"TransformationManager::step(): user %u does not have any pipes attached\n",
-					netUserId);
-
-		for (i = 0; i < (int)pipesFromUser.size(); i++) {
-			if (pipesFromUser[i]->getPipeId() == netPipeId) {
-				// 					printd(INFO, "TransformationManager::run(): found data for TransformationPipe with ID %s!\n", getUInt64AsString(netPipeId).c_str());
-				pipesFromUser[i]->push_back(netData);
-				break;
+		pipe = findPipe(remoteUser, netPipeId);
+		if (pipe) {
+			// 					printd(INFO, "TransformationManager::run(): found data for TransformationPipe with ID %s!\n", getUInt64AsString(netPipeId).c_str());
+			// UDP may reorder the messages, older data than the newest one is
+			// dropped. When the pipe switches from receive to send times, the
+			// first send times are older than the receive times so far; they
+			// are kept and clamped by push_back() until they caught up.
+			if (hasSendTime != pipe->remoteSendTimestamps
+					|| pipe->lastRemoteTimestamp <= sendTime) {
+				pipe->remoteSendTimestamps = hasSendTime;
+				pipe->lastRemoteTimestamp = sendTime;
+				pipe->push_back(netData, sendTime);
 			} // if
-		} // for
-
-		if (i == (int)pipesFromUser.size()) {
+		} // if
+		else if (PRINTD_ENABLED(INFO)) {
 			printd(INFO,
 					"TransformationManager::step(): cannot find any pipe with id %s owned by user %u!\n",
 					getUInt64AsString(netPipeId).c_str(), netUserId);
-		} // if
+		} // else if
 
-		msgList.erase(msgList.begin());
 		delete msg;
-	} // while
+	} // for
 } // handleNetworkMessages
 
 
@@ -727,18 +779,15 @@ TransformationPipe* TransformationManager::openPipeInternal(unsigned srcId, unsi
 	MergerData* mergerData = NULL;
 	pipeId = packPipeId(srcId, dstId, pipeType, objectClass, objectType, objectId, fromNetwork);
 
-	for (i = 0; i < (int)pipes.size(); i++) {
-		if (pipes[i]->pipeId == pipeId && pipes[i]->getOwner() == user) {
-			ret = pipes[i];
-			printd(WARNING,
-					"TransformationManager::openPipe(): found two pipes with same id / pipe already opened!\n");
-			return NULL;
-		}
-	}
-
 	if (user == NULL)
 		user = localUser;
 
+	if (findPipe(user, pipeId)) {
+		printd(WARNING,
+				"TransformationManager::openPipe(): found two pipes with same id / pipe already opened!\n");
+		return NULL;
+	} // if
+
 	if (useMTPipe)
 		ret = new TransformationPipeMT(pipeId, user);
 	else
@@ -838,6 +887,7 @@ TransformationPipe* TransformationManager::openPipeInternal(unsigned srcId, unsi
 		ret->priority = priority;
 		pipes.push_back(ret);
 	}
+	addToUserPipeTable(ret);
 	pipeListLock->release();
 
 	printd(INFO,
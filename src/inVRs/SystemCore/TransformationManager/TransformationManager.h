@@ -48,6 +48,7 @@
 #include "../EventManager/EventFactory.h"
 #include "../EventManager/Event.h"
 #include "../EventManager/EventManager.h"
+#include "../HashIndex.h"
 #include "TransformationPipe.h"
 #include "TransformationPipeMT.h"
 #include "TransformationModifierFactory.h"
@@ -276,6 +277,10 @@ private:
 #endif
 
 	static std::vector<TransformationPipe*> pipes;
+	/// pipes of a single user indexed by their pipe id
+	typedef inVRsUtilities::HashIndex<uint64_t, TransformationPipe*> UserPipeTable;
+	/// pipe tables of all users indexed by the user id
+	static inVRsUtilities::HashIndex<unsigned, UserPipeTable*> userPipeTables;
 	static std::vector<TransformationModifierFactory*> modifierFactories;
 	static std::vector<TransformationMergerFactory*> mergerFactories;
 	static std::vector<MergerTemplate*> mergerTemplates;
@@ -287,6 +292,13 @@ private:
 	static unsigned interruptedPipePriority;
 
 	static void getAllPipesFromUser(User* user, std::vector<TransformationPipe*>* dst);
+	/**
+	 * Returns the pipe with the passed id owned by user or NULL if the user
+	 * has no such pipe.
+	 */
+	static TransformationPipe* findPipe(User* user, uint64_t pipeId);
+	static void addToUserPipeTable(TransformationPipe* pipe);
+	static void removeFromUserPipeTable(TransformationPipe* pipe);
 	static unsigned& getValueFromAttribute(const XmlElement* xml, std::string name, unsigned& dst);
 
 	static void executeEvents();
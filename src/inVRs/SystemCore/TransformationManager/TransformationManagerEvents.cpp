@@ -51,6 +51,8 @@ TransformationManagerOpenPipeEvent::TransformationManagerOpenPipeEvent(unsigned
 	Event(TRANSFORMATION_MANAGER_ID, TRANSFORMATION_MANAGER_ID,
 			"TransformationManagerOpenPipeEvent") {
 	addPipe(srcId, dstId, pipeType, objectClass, objectType, objectId, priority, userId, isMTPipe);
+	// must arrive before the transformations sent through the pipe
+	setPriority(PRIORITY_CRITICAL);
 } // TransformationManagerOpenPipeEvent
 
 TransformationManagerOpenPipeEvent::~TransformationManagerOpenPipeEvent() {
@@ -188,6 +190,7 @@ TransformationManagerClosePipeEvent::TransformationManagerClosePipeEvent(Transfo
 	Event(TRANSFORMATION_MANAGER_ID, TRANSFORMATION_MANAGER_ID,
 			"TransformationManagerClosePipeEvent") {
 	addPipe(pipe);
+	setPriority(PRIORITY_CRITICAL);
 } // TransformationManagerClosePipeEvent
 
 TransformationManagerClosePipeEvent::~TransformationManagerClosePipeEvent() {
@@ -79,3 +79,6 @@ bool TransformationModifier::interrupt(TransformationData* resultLastStage,
 		TransformationPipe* currentPipe) {
 	return false;
 } // interrupt
+
+void TransformationModifier::removePipe(TransformationPipe* pipe) {
+} // removePipe
@@ -124,6 +124,11 @@ protected:
 	TransformationData executeInternal(TransformationData* resultLastStage,
 			TransformationPipe* currentPipe);
 	virtual bool interrupt(TransformationData* resultLastStage, TransformationPipe* currentPipe);
+	/**
+	 * Called by the TransformationPipe before it releases the modifier, so
+	 * that modifiers keeping state per pipe can drop it.
+	 */
+	virtual void removePipe(TransformationPipe* pipe);
 
 	friend class TransformationManager;
 	friend class TransformationPipe;
@@ -30,6 +30,8 @@
 #include <iostream>
 #include <sstream>
 #include <assert.h>
+#include <gmtl/VecOps.h>
+#include <gmtl/QuatOps.h>
 
 #include "TransformationModifier.h"
 #include "../Timer.h"
@@ -37,6 +39,85 @@
 #include "TransformationMerger.h"
 #include "TransformationManager.h"
 
+TransformationPipeBuffer::TransformationPipeBuffer(unsigned initialCapacity) :
+	maxCapacity(0),
+	numOverwritten(0),
+	mask(0),
+	first(0),
+	numEntries(0) {
+	resize(initialCapacity);
+} // TransformationPipeBuffer
+
+void TransformationPipeBuffer::setCapacity(unsigned capacity) {
+	if (capacity == 0) {
+		maxCapacity = 0;
+		return;
+	} // if
+
+	maxCapacity = 1;
+	while (maxCapacity < capacity)
+		maxCapacity <<= 1;
+	resize(maxCapacity);
+} // setCapacity
+
+bool TransformationPipeBuffer::push_back(const TransformationPipeData& data) {
+	bool overwritten = false;
+	if (numEntries > mask) {
+		if (maxCapacity == 0 || mask + 1 < maxCapacity) {
+			resize(2 * (mask + 1));
+		} else {
+			first = (first + 1) & mask;
+			numEntries--;
+			numOverwritten++;
+			overwritten = true;
+		} // else
+	} // if
+	entries[(first + numEntries) & mask] = data;
+	numEntries++;
+	return overwritten;
+} // push_back
+
+void TransformationPipeBuffer::pop_front() {
+	assert(numEntries > 0);
+	first = (first + 1) & mask;
+	numEntries--;
+} // pop_front
+
+void TransformationPipeBuffer::clear() {
+	first = 0;
+	numEntries = 0;
+} // clear
+
+int TransformationPipeBuffer::findLatestBefore(double time) const {
+	// binary search for the first entry newer than time
+	unsigned low = 0;
+	unsigned high = numEntries;
+	while (low < high) {
+		unsigned mid = (low + high) / 2;
+		if ((*this)[mid].timestamp <= time)
+			low = mid + 1;
+		else
+			high = mid;
+	} // while
+	return (int)low - 1;
+} // findLatestBefore
+
+void TransformationPipeBuffer::resize(unsigned newCapacity) {
+	unsigned capacity = 1;
+	while (capacity < newCapacity)
+		capacity <<= 1;
+
+	std::vector<TransformationPipeData> newEntries(capacity);
+	unsigned newSize = numEntries < capacity ? numEntries : capacity;
+	for (unsigned i = 0; i < newSize; i++)
+		newEntries[i] = (*this)[numEntries - newSize + i];
+
+	entries.swap(newEntries);
+	mask = capacity - 1;
+	first = 0;
+	numEntries = newSize;
+} // resize
+
 TransformationPipe::TransformationPipe(uint64_t pipeId, User* owner) {
 	this->pipeId = pipeId;
 	priority = 0;
@@ -47,6 +128,8 @@ TransformationPipe::TransformationPipe(uint64_t pipeId, User* owner) {
 	this->timeToNextExecution = 0;
 	this->merger = NULL;
 	this->mergerIndex = -1;
+	this->remoteSendTimestamps = false;
+	this->lastRemoteTimestamp = 0;
 }
 
 TransformationPipe::~TransformationPipe() {
@@ -59,6 +142,7 @@ TransformationPipe::~TransformationPipe() {
 		assert(stages[i]);
 		factory = stages[i]->getFactory();
 		assert(factory);
+		stages[i]->removePipe(this);
 		factory->releaseModifier(stages[i]);
 		stages[i] = NULL;
 	}
@@ -68,32 +152,97 @@ TransformationPipe::~TransformationPipe() {
 }
 
 void TransformationPipe::push_back(TransformationData& data) {
+	push_back(data, inVRsUtilities::Timer::getMonotonicTime());
+}
+
+void TransformationPipe::push_back(TransformationData& data, double timestamp) {
 	TransformationPipeData pipeData;
 	pipeData.transf = data;
-	pipeData.timestamp = (unsigned)timer.getTimeInMilliseconds();
-	transformationData.push_back(pipeData);
-}
+	pipeData.timestamp = timestamp;
+	if (!transformationData.empty() && transformationData.back().timestamp > timestamp)
+		pipeData.timestamp = transformationData.back().timestamp;
+	if (transformationData.push_back(pipeData)) {
+		unsigned numOverwritten = transformationData.getNumOverwritten();
+		// report the first overwrite and then at every power of two
+		if ((numOverwritten & (numOverwritten - 1)) == 0)
+			printd(WARNING,
+					"TransformationPipe::push_back(): pipe %llu is full (capacity %u), %u transformations overwritten so far\n",
+					(unsigned long long)pipeId, transformationData.getCapacity(), numOverwritten);
+	} // if
+} // push_back
 
 int TransformationPipe::size() {
 	return transformationData.size();
 }
 
-TransformationData TransformationPipe::getTransformation(unsigned index) {
+const TransformationData& TransformationPipe::getTransformation(unsigned index) {
 	assert(index < transformationData.size());
 	return transformationData[index].transf;
 } // getTransformation
 
+double TransformationPipe::getTimestamp(unsigned index) {
+	assert(index < transformationData.size());
+	return transformationData[index].timestamp;
+} // getTimestamp
+
+bool TransformationPipe::getTransformationBefore(double time, TransformationData& dst) {
+	int index = transformationData.findLatestBefore(time);
+	if (index < 0)
+		return false;
+	dst = transformationData[index].transf;
+	return true;
+} // getTransformationBefore
+
+bool TransformationPipe::interpolateTransformation(double time, TransformationData& dst) {
+	if (transformationData.empty())
+		return false;
+
+	int index = transformationData.findLatestBefore(time);
+	if (index < 0) {
+		dst = transformationData[0].transf;
+		return true;
+	} // if
+	if (index == (int)transformationData.size() - 1) {
+		dst = transformationData.back().transf;
+		return true;
+	} // if
+
+	const TransformationPipeData& from = transformationData[index];
+	const TransformationPipeData& to = transformationData[index + 1];
+	double duration = to.timestamp - from.timestamp;
+	// duration is greater than zero since to.timestamp > time >= from.timestamp
+	float t = (float)((time - from.timestamp) / duration);
+	gmtl::lerp(dst.position, t, from.transf.position, to.transf.position);
+	gmtl::lerp(dst.scale, t, from.transf.scale, to.transf.scale);
+	gmtl::slerp(dst.orientation, t, from.transf.orientation, to.transf.orientation);
+	gmtl::slerp(dst.scaleOrientation, t, from.transf.scaleOrientation,
+			to.transf.scaleOrientation);
+	return true;
+} // interpolateTransformation
+
+void TransformationPipe::setCapacity(unsigned capacity) {
+	transformationData.setCapacity(capacity);
+} // setCapacity
+
 void TransformationPipe::flush() {
-	TransformationPipeData dummy;
+	flushEntries();
+}
 
+void TransformationPipe::flushEntries() {
 	if (flushStrategy == FLUSHSTRATEGY_QUORUM) {
 		while (transformationData.size() > flushParam)
 			transformationData.pop_front();
+	} else if (flushStrategy == FLUSHSTRATEGY_TIMEOUT) {
+		if (transformationData.empty())
+			return;
+		double oldestTime = transformationData.back().timestamp - 0.001 * flushParam;
+		while (transformationData.size() > 2 && transformationData[0].timestamp < oldestTime)
+			transformationData.pop_front();
 	} else {
 		printd(WARNING, "TransformationPipe::flush(): strategy %u not implemented yet\n",
 				(unsigned)flushStrategy);
 	}
-}
+} // flushEntries
 
 void TransformationPipe::addStage(TransformationModifier* stage) {
 	assert(stage != NULL);
@@ -119,8 +268,9 @@ TransformationData TransformationPipe::execute() {
 	int i;
 	TransformationData lastResult, temp;
 
-	if (size() > 0)
-		lastResult = getTransformation(size() - 1);
+	int pipeSize = size();
+	if (pipeSize > 0)
+		lastResult = getTransformation(pipeSize - 1);
 	else
 		lastResult = identityTransformation();
 
@@ -162,6 +312,10 @@ uint64_t TransformationPipe::getPipeId() {
 	return pipeId;
 } // getPipeId
 
+bool TransformationPipe::hasRemoteSendTimestamps() {
+	return remoteSendTimestamps;
+} // hasRemoteSendTimestamps
+
 unsigned TransformationPipe::getPriority() {
 	return priority;
 } // getPriority
@@ -36,7 +36,7 @@
 #ifndef _TRANSFORMATIONPIPE_H
 #define _TRANSFORMATIONPIPE_H
 
-#include <deque>
+#include <vector>
 
 #include "../UserDatabase/UserDatabase.h"
 #include "../NetMessage.h"
@@ -49,9 +49,96 @@ class TransformationMerger;
  */
 struct TransformationPipeData {
 	TransformationData transf;
-	unsigned timestamp;
+	/// time of Timer::getMonotonicTime() when the data was pushed (in seconds)
+	double timestamp;
 };
 
+/******************************************************************************
+ * Ring buffer holding the TransformationPipeData of a pipe in the order of
+ * their timestamps. By default the buffer grows on demand like the deque it
+ * replaces. If a capacity is set with setCapacity(), the oldest entry is
+ * overwritten by push_back() once the buffer is full and the overwritten
+ * entries are counted.
+ */
+class INVRS_SYSTEMCORE_API TransformationPipeBuffer {
+public:
+	/**
+	 * Creates an unbounded buffer with storage for initialCapacity entries
+	 * (rounded up to the next power of two).
+	 */
+	TransformationPipeBuffer(unsigned initialCapacity = 32);
+
+	/**
+	 * Limits the buffer to capacity entries (rounded up to the next power of
+	 * two). If the buffer holds more entries than the new capacity, the oldest
+	 * ones are removed. A capacity of 0 makes the buffer unbounded again.
+	 */
+	void setCapacity(unsigned capacity);
+
+	/**
+	 * Returns the maximum number of entries or 0 if the buffer is unbounded.
+	 */
+	unsigned getCapacity() const {
+		return maxCapacity;
+	} // getCapacity
+
+	/**
+	 * Returns the number of entries overwritten by push_back() because the
+	 * bounded buffer was full.
+	 */
+	unsigned getNumOverwritten() const {
+		return numOverwritten;
+	} // getNumOverwritten
+
+	unsigned size() const {
+		return numEntries;
+	} // size
+
+	bool empty() const {
+		return numEntries == 0;
+	} // empty
+
+	/**
+	 * Appends an entry. If the buffer is bounded and full, the oldest entry is
+	 * overwritten and true is returned.
+	 */
+	bool push_back(const TransformationPipeData& data);
+
+	/**
+	 * Removes the oldest entry.
+	 */
+	void pop_front();
+
+	void clear();
+
+	/**
+	 * Access to an entry, index 0 is the oldest entry.
+	 */
+	const TransformationPipeData& operator[](unsigned index) const {
+		return entries[(first + index) & mask];
+	} // operator[]
+
+	const TransformationPipeData& back() const {
+		return entries[(first + numEntries - 1) & mask];
+	} // back
+
+	/**
+	 * Returns the index of the newest entry with a timestamp not greater
+	 * than time or -1 if all entries are newer.
+	 */
+	int findLatestBefore(double time) const;
+
+private:
+	void resize(unsigned newCapacity);
+
+	std::vector<TransformationPipeData> entries;
+	unsigned maxCapacity;
+	unsigned numOverwritten;
+	unsigned mask;
+	unsigned first;
+	unsigned numEntries;
+}; // TransformationPipeBuffer
+
 /******************************************************************************
  * A TransformationPipe applies a number of operations on TransformationData.
  * There are two kinds of operations:
@@ -103,15 +190,55 @@ public:
 	 */
 	virtual void push_back(TransformationData& data);
 
+	/**
+	 * Put a TransformationData with the passed timestamp into the pipe. The
+	 * timestamp must be in the timebase of Timer::getMonotonicTime(). It is
+	 * clamped to the timestamp of the newest entry so that the entries stay
+	 * ordered.
+	 */
+	virtual void push_back(TransformationData& data, double timestamp);
+
 	/**
 	 * The number of TransformationDatas in the pipe.
 	 */
 	virtual int size();
 
 	/**
-	 * Direct access to a TransformationData by its index in the deque.
+	 * Direct access to a TransformationData by its index in the pipe (index 0
+	 * is the oldest entry). The reference is valid until the next push_back()
+	 * or flush() of the pipe.
+	 */
+	virtual const TransformationData& getTransformation(unsigned index);
+
+	/**
+	 * Returns the timestamp of the entry with the passed index.
+	 * @see TransformationPipeData::timestamp
+	 */
+	virtual double getTimestamp(unsigned index);
+
+	/**
+	 * Writes the newest TransformationData which was pushed at or before the
+	 * passed time into dst.
+	 * @return false if the pipe contains no such entry
 	 */
-	virtual TransformationData getTransformation(unsigned index);
+	virtual bool getTransformationBefore(double time, TransformationData& dst);
+
+	/**
+	 * Writes the TransformationData at the passed time into dst. Positions
+	 * and scales are interpolated linearly, orientations spherically between
+	 * the two entries around time. Times outside of the stored range are
+	 * clamped to the oldest or newest entry (no extrapolation).
+	 * @return false if the pipe is empty
+	 */
+	virtual bool interpolateTransformation(double time, TransformationData& dst);
+
+	/**
+	 * Sets the maximum number of TransformationDatas the pipe can hold. When
+	 * the pipe is full, push_back() overwrites the oldest entry and reports
+	 * the overwrites with printd. The default capacity of 0 lets the pipe
+	 * grow on demand.
+	 */
+	virtual void setCapacity(unsigned capacity);
 
 	/**
 	 * Flush the TransformationPipe according to its flush strategy.
@@ -153,6 +280,14 @@ public:
 	 */
 	uint64_t getPipeId();
 
+	/**
+	 * Returns true if the timestamps of the data received from the network
+	 * are the send times of the remote participant (converted to the local
+	 * timebase) instead of the receive times.
+	 * @see NetworkTime::isSynchronised()
+	 */
+	bool hasRemoteSendTimestamps();
+
 	/**
 	 * The pipe priority.
 	 * The TransformationManager executes pipes with a higher priority first.
@@ -180,21 +315,29 @@ protected:
 	enum FLUSHSTRATEGY {
 		FLUSHSTRATEGY_QUORUM /** remove TransformationData, until size() <= flushParam (default: 2) */,
 		FLUSHSTRATEGY_TIMEOUT
-	/** not implemented yet. */
+	/** remove TransformationData older than flushParam milliseconds (the newest two are kept) */
 	};
 
 	unsigned priority; // determines execution order (higher value means higher priority)
 	User* owner;
 	unsigned flushParam;
 	FLUSHSTRATEGY flushStrategy;
-	std::deque<TransformationPipeData> transformationData;
+	TransformationPipeBuffer transformationData;
 	std::vector<TransformationModifier*> stages;
 	uint64_t pipeId; // built from several properties:
 	float executionInterval;
 	float timeToNextExecution;
 	TransformationMerger* merger;
 	int mergerIndex;
+	/// true if the last data received from the network carried a send time
+	bool remoteSendTimestamps;
+	/// (send or receive) time of the last data received from the network
+	double lastRemoteTimestamp;
 	void setFlushStrategy(FLUSHSTRATEGY stratetgy, unsigned param);
+	/**
+	 * Removes entries according to the flush strategy without locking.
+	 */
+	void flushEntries();
 	/**
 	 * current layout (order of bit significance:)
 	 * bit: (x-X is both inclusive)
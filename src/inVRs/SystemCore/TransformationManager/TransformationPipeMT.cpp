@@ -46,58 +46,71 @@ TransformationPipeMT::~TransformationPipeMT() {
 
 } // ~TransformationPipeMT
 
-TransformationData TransformationPipeMT::getTransformation(unsigned index) {
-	TransformationData result;
-#if OSG_MAJOR_VERSION >= 2
-	pipeLock->acquire();
-#else //OpenSG1:
-	pipeLock->aquire();
-#endif
-	assert(index < transformationData.size());
-	result = transformationData[index].transf;
+const TransformationData& TransformationPipeMT::getTransformation(unsigned index) {
+	acquirePipeLock();
+	readTransformation = TransformationPipe::getTransformation(index);
 	pipeLock->release();
-	return result;
+	return readTransformation;
 } // getTransformation
 
-void TransformationPipeMT::push_back(TransformationData& data) {
-	TransformationPipeData pipeData;
-	pipeData.transf = data;
-	pipeData.timestamp = (unsigned)timer.getTimeInMilliseconds();
-#if OSG_MAJOR_VERSION >= 2
-	pipeLock->acquire();
-#else //OpenSG1:
-	pipeLock->aquire();
-#endif
-	transformationData.push_back(pipeData);
+double TransformationPipeMT::getTimestamp(unsigned index) {
+	double result;
+	acquirePipeLock();
+	result = TransformationPipe::getTimestamp(index);
+	pipeLock->release();
+	return result;
+} // getTimestamp
+
+bool TransformationPipeMT::getTransformationBefore(double time, TransformationData& dst) {
+	bool result;
+	acquirePipeLock();
+	result = TransformationPipe::getTransformationBefore(time, dst);
+	pipeLock->release();
+	return result;
+} // getTransformationBefore
+
+bool TransformationPipeMT::interpolateTransformation(double time, TransformationData& dst) {
+	bool result;
+	acquirePipeLock();
+	result = TransformationPipe::interpolateTransformation(time, dst);
 	pipeLock->release();
+	return result;
+} // interpolateTransformation
+
+void TransformationPipeMT::setCapacity(unsigned capacity) {
+	acquirePipeLock();
+	TransformationPipe::setCapacity(capacity);
+	pipeLock->release();
+} // setCapacity
+
+void TransformationPipeMT::push_back(TransformationData& data) {
+	push_back(data, inVRsUtilities::Timer::getMonotonicTime());
 }
 
+void TransformationPipeMT::push_back(TransformationData& data, double timestamp) {
+	acquirePipeLock();
+	TransformationPipe::push_back(data, timestamp);
+	pipeLock->release();
+} // push_back
+
 int TransformationPipeMT::size() {
 	int result;
-#if OSG_MAJOR_VERSION >= 2
-	pipeLock->acquire();
-#else //OpenSG1:
-	pipeLock->aquire();
-#endif
+	acquirePipeLock();
 	result = transformationData.size();
 	pipeLock->release();
 	return result;
 } // size
 
 void TransformationPipeMT::flush() {
-	TransformationPipeData dummy;
+	acquirePipeLock();
+	flushEntries();
+	pipeLock->release();
+}
 
+void TransformationPipeMT::acquirePipeLock() {
 #if OSG_MAJOR_VERSION >= 2
 	pipeLock->acquire();
 #else //OpenSG1:
 	pipeLock->aquire();
 #endif
-	if (flushStrategy == FLUSHSTRATEGY_QUORUM) {
-		while (transformationData.size() > flushParam)
-			transformationData.pop_front();
-	} else {
-		printd(WARNING, "TransformationPipe::flush(): strategy %u not implemented yet\n",
-				(unsigned)flushStrategy);
-	}
-	pipeLock->release();
-}
+} // acquirePipeLock
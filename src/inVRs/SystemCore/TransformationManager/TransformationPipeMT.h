@@ -61,8 +61,18 @@ public:
 	 */
 	virtual ~TransformationPipeMT();
 
-	virtual TransformationData getTransformation(unsigned index);
+	/**
+	 * Returns a reference to a copy of the TransformationData which is
+	 * valid until the next call of this method (the pipe is only read by a
+	 * single thread).
+	 */
+	virtual const TransformationData& getTransformation(unsigned index);
+	virtual double getTimestamp(unsigned index);
+	virtual bool getTransformationBefore(double time, TransformationData& dst);
+	virtual bool interpolateTransformation(double time, TransformationData& dst);
+	virtual void setCapacity(unsigned capacity);
 	virtual void push_back(TransformationData& data);
+	virtual void push_back(TransformationData& data, double timestamp);
 	virtual int size();
 	virtual void flush();
 
@@ -77,6 +87,10 @@ protected:
 	OSG::Lock* pipeLock;
 #endif
 
+	/// Copy of the last TransformationData returned by getTransformation
+	TransformationData readTransformation;
+
+	void acquirePipeLock();
 }; // TransformationPipeMT
 
 #endif // _TRANSFORMATIONPIPEMT_H
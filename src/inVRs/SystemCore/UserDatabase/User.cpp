@@ -225,6 +225,9 @@ void User::pickUpEntity(Entity* entity, TransformationData offset) {
 	associatedEntity->entity = entity;
 	associatedEntity->pickingOffset = offset;
 	associatedEntities.push_back(associatedEntity);
+	// the index refers to the first association of an entity like the list
+	if (!associatedEntityIndex.find(entity->getTypeBasedId()))
+		associatedEntityIndex.set(entity->getTypeBasedId(), associatedEntity);
 } // pickUpEntity
 
 bool User::dropEntity(unsigned int entityId) {
@@ -239,6 +242,14 @@ bool User::dropEntity(unsigned int entityId) {
 	} // for
 	if (associatedEntity) {
 		associatedEntities.erase(it);
+		associatedEntityIndex.erase(entityId);
+		// restore the index in case the same entity was picked up twice
+		for (it = associatedEntities.begin(); it != associatedEntities.end(); ++it) {
+			if ((*it)->entity->getTypeBasedId() == entityId) {
+				associatedEntityIndex.set(entityId, *it);
+				break;
+			} // if
+		} // for
 		delete associatedEntity;
 		return true;
 	} // if
@@ -507,17 +518,9 @@ unsigned User::getNumberOfAssociatedEntities() {
 } // getNumberOfAssociatedEntities
 
 Entity* User::getAssociatedEntity(unsigned int entityId) {
-	AssociatedEntity* associatedEntity = NULL;
-	std::vector<AssociatedEntity*>::iterator it;
-
-	for (it = associatedEntities.begin(); it != associatedEntities.end(); ++it) {
-		if ((*it)->entity->getTypeBasedId() == entityId) {
-			associatedEntity = *it;
-			break;
-		} // if
-	} // for
+	AssociatedEntity** associatedEntity = associatedEntityIndex.find(entityId);
 	if (associatedEntity)
-		return associatedEntity->entity;
+		return (*associatedEntity)->entity;
 
 	return NULL;
 } // getAssociatedEntity
@@ -530,17 +533,9 @@ Entity* User::getAssociatedEntityByIndex(unsigned index) {
 } // getAssociatedEntityByIndex
 
 TransformationData User::getAssociatedEntityOffset(unsigned int entityId) {
-	AssociatedEntity* associatedEntity = NULL;
-	std::vector<AssociatedEntity*>::iterator it;
-
-	for (it = associatedEntities.begin(); it != associatedEntities.end(); ++it) {
-		if ((*it)->entity->getTypeBasedId() == entityId) {
-			associatedEntity = *it;
-			break;
-		} // if
-	} // for
+	AssociatedEntity** associatedEntity = associatedEntityIndex.find(entityId);
 	if (associatedEntity)
-		return associatedEntity->pickingOffset;
+		return (*associatedEntity)->pickingOffset;
 
 	printd(
 			WARNING,
@@ -48,6 +48,7 @@
 #include "../ComponentInterfaces/CursorRepresentationInterface.h"
 #include "../ComponentInterfaces/NetworkInterface.h"
 #include "../XmlConfigurationLoader.h"
+#include "../HashIndex.h"
 
 class EntityTransform;
 class ModuleInterface;
@@ -590,6 +591,8 @@ protected:
 	unsigned id;
 	NetworkIdentification networkId;
 	std::vector<AssociatedEntity*> associatedEntities;
+	/// index of the associatedEntities by the type based id of their entity
+	inVRsUtilities::HashIndex<unsigned, AssociatedEntity*> associatedEntityIndex;
 	CameraTransformation* camera;
 	AvatarInterface* avatar;
 	CursorRepresentationInterface* cursor;
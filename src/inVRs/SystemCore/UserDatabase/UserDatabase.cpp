@@ -49,6 +49,7 @@
 
 User*										UserDatabase::localUser = NULL;
 std::vector<User*>							UserDatabase::remoteUserList;
+inVRsUtilities::HashIndex<unsigned, User*>	UserDatabase::remoteUserIndex;
 std::vector<CursorRepresentationFactory*>	UserDatabase::cursorRepresentationFactories;
 std::vector<AbstractUserConnectCB*>			UserDatabase::userConnectCallbacks;
 std::vector<AbstractUserDisconnectCB*>		UserDatabase::userDisconnectCallbacks;
@@ -98,7 +99,6 @@ void UserDatabase::cleanup() {
 } // cleanup
 
 void UserDatabase::addRemoteUser(User* remoteUser) {
-	int i;
 	std::vector<AbstractUserConnectCB*>::iterator it;
 
 	if (remoteUser->getId() == localUser->getId()) {
@@ -108,14 +108,13 @@ void UserDatabase::addRemoteUser(User* remoteUser) {
 				remoteUser->getId());
 		return;
 	} // if
-	for (i = 0; i < (int)remoteUserList.size(); i++) {
-		if (remoteUser->getId() == remoteUserList[i]->getId()) {
-			printd(WARNING, "UserDatabase::addRemoteUser(): a user with id %u already exists\n",
-					remoteUser->getId());
-			return;
-		} // if
-	} // for
+	if (remoteUserIndex.find(remoteUser->getId())) {
+		printd(WARNING, "UserDatabase::addRemoteUser(): a user with id %u already exists\n",
+				remoteUser->getId());
+		return;
+	} // if
 	remoteUserList.push_back(remoteUser);
+	remoteUserIndex.set(remoteUser->getId(), remoteUser);
 
 	for (it = userConnectCallbacks.begin(); it != userConnectCallbacks.end(); ++it)
 		(*it)->call(remoteUser);
@@ -131,6 +130,7 @@ void UserDatabase::removeRemoteUser(unsigned userId) {
 			printd(INFO, "UserDatabase::removeRemoteUser(): removing user %u\n", userId);
 			user = remoteUserList[i];
 			remoteUserList.erase(remoteUserList.begin() + i);
+			remoteUserIndex.erase(userId);
 
 			for (it = userDisconnectCallbacks.begin(); it != userDisconnectCallbacks.end(); ++it)
 				(*it)->call(user);
@@ -217,14 +217,12 @@ int UserDatabase::getNumberOfRemoteUsers() {
 } // getNumberOfRemoteUsers
 
 User* UserDatabase::getUserById(unsigned userId) {
-	int i;
 	if (localUser->getId() == userId)
 		return localUser;
 
-	for (i = 0; i < (int)remoteUserList.size(); i++) {
-		if (remoteUserList[i]->getId() == userId)
-			return remoteUserList[i];
-	} // for
+	User** remoteUser = remoteUserIndex.find(userId);
+	if (remoteUser)
+		return *remoteUser;
 
 	printd(INFO, "UserDatabase::getUserById(): cannot find a user with id %u\n", userId);
 	return NULL;
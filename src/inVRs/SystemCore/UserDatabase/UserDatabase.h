@@ -39,6 +39,7 @@
 #include <assert.h>
 
 #include "User.h"
+#include "../HashIndex.h"
 #include "../ComponentInterfaces/CursorRepresentationInterface.h"
 
 class UserDatabaseEventsFactory;
@@ -305,6 +306,8 @@ private:
 	static CursorRepresentationInterface* loadCursorRepresentation(std::string configFile);
 
 	static std::vector<User*> remoteUserList;
+	/// index of the remote users by their id
+	static inVRsUtilities::HashIndex<unsigned, User*> remoteUserIndex;
 	static User* localUser;
 	static std::vector<CursorRepresentationFactory*> cursorRepresentationFactories;
 	static std::vector<AbstractUserConnectCB*> userConnectCallbacks;
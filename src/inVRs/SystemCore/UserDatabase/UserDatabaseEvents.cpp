@@ -50,6 +50,7 @@ UserDatabasePickUpEntityEvent::UserDatabasePickUpEntityEvent(User* userPickingUp
 	userIdPickingUp = userPickingUp->getId();
 	typeBasedEntityId = entity->getTypeBasedId();
 	this->offset = offset;
+	setPriority(PRIORITY_CRITICAL);
 }
 
 void UserDatabasePickUpEntityEvent::encode(NetMessage* message) {
@@ -87,6 +88,7 @@ UserDatabaseDropEntityEvent::UserDatabaseDropEntityEvent(User* userDropingDown,
 	Event(USER_DATABASE_ID, SYSTEM_CORE_ID, "UserDatabaseDropEntityEvent") {
 	userIdDropingDown = userDropingDown->getId();
 	typeBasedEntityId = entity->getTypeBasedId();
+	setPriority(PRIORITY_CRITICAL);
 }
 
 void UserDatabaseDropEntityEvent::encode(NetMessage* message) {
@@ -113,6 +115,8 @@ void UserDatabaseDropEntityEvent::execute() {
 UserDatabaseAddUserEvent::UserDatabaseAddUserEvent(User* user) :
 	Event(SYSTEM_CORE_ID, SYSTEM_CORE_ID, "UserDatabaseAddUserEvent") {
 	CursorTransformationModel* cursorTransformationModel;
+
+	setPriority(PRIORITY_CRITICAL);
 	this->name = user->getName();
 	this->userId = user->getId();
 	this->networkId = user->getNetworkId();
@@ -282,6 +286,7 @@ UserDatabaseRemoveUserEvent::UserDatabaseRemoveUserEvent(User* user) :
 
 	name = user->getName();
 	userId = user->getId();
+	setPriority(PRIORITY_CRITICAL);
 } // UserDatabaseRemoveUserEvent
 
 UserDatabaseRemoveUserEvent::UserDatabaseRemoveUserEvent() :
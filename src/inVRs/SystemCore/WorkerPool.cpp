@@ -0,0 +1,166 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+#include "WorkerPool.h"
+
+#include <sstream>
+
+#include <OpenSG/OSGThreadManager.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "AtomicOperations.h"
+#include "DebugOutput.h"
+
+WorkerPool::WorkerPool(std::string name, unsigned numberOfThreads) :
+	startBarrier(NULL),
+	finishBarrier(NULL),
+	nextTask(0),
+	numberOfTasks(0),
+	function(NULL),
+	userData(NULL),
+	shutdown(false) {
+	if (numberOfThreads == 0)
+		return;
+
+#if OSG_MAJOR_VERSION >= 2
+	startBarrier = OSG::dynamic_pointer_cast<OSG::Barrier> (OSG::ThreadManager::the()->getBarrier(
+			(name + "StartBarrier").c_str(), false));
+	finishBarrier = OSG::dynamic_pointer_cast<OSG::Barrier> (OSG::ThreadManager::the()->getBarrier(
+			(name + "FinishBarrier").c_str(), false));
+#else //OpenSG1:
+	startBarrier = dynamic_cast<OSG::Barrier*> (OSG::ThreadManager::the()->getBarrier(
+			(name + "StartBarrier").c_str()));
+	finishBarrier = dynamic_cast<OSG::Barrier*> (OSG::ThreadManager::the()->getBarrier(
+			(name + "FinishBarrier").c_str()));
+#endif
+	if (!startBarrier || !finishBarrier) {
+		printd(ERROR, "WorkerPool::WorkerPool(): unable to create barriers for pool %s!\n",
+				name.c_str());
+		return;
+	} // if
+
+	for (unsigned i = 0; i < numberOfThreads; i++) {
+		std::stringstream threadName;
+		threadName << name << "Worker" << i;
+#if OSG_MAJOR_VERSION >= 2
+		OSG::ThreadRefPtr thread = OSG::dynamic_pointer_cast<OSG::Thread> (
+				OSG::ThreadManager::the()->getThread(threadName.str().c_str(), false));
+#else //OpenSG1:
+		OSG::Thread* thread = dynamic_cast<OSG::Thread*> (
+				OSG::ThreadManager::the()->getThread(threadName.str().c_str()));
+#endif
+		if (!thread) {
+			printd(WARNING, "WorkerPool::WorkerPool(): unable to create thread %s!\n",
+					threadName.str().c_str());
+			break;
+		} // if
+		threads.push_back(thread);
+	} // for
+
+	// the threads can only be started when their number is known because the
+	// barriers have to wait for all of them
+	for (unsigned i = 0; i < threads.size(); i++) {
+		threads[i]->runFunction(workerMain, 0, this);
+	} // for
+} // WorkerPool
+
+WorkerPool::~WorkerPool() {
+	if (threads.empty())
+		return;
+
+	shutdown = true;
+	startBarrier->enter(threads.size() + 1);
+	for (unsigned i = 0; i < threads.size(); i++) {
+		OSG::Thread::join(threads[i]);
+	} // for
+	threads.clear();
+} // ~WorkerPool
+
+void WorkerPool::run(TaskFunction function, unsigned numberOfTasks, void* userData) {
+	unsigned i;
+
+	// not worth waking up the workers
+	if (threads.empty() || numberOfTasks < 2) {
+		for (i = 0; i < numberOfTasks; i++)
+			function(i, userData);
+		return;
+	} // if
+
+	this->function = function;
+	this->numberOfTasks = numberOfTasks;
+	this->userData = userData;
+	nextTask = 0;
+
+	startBarrier->enter(threads.size() + 1);
+	processTasks();
+	finishBarrier->enter(threads.size() + 1);
+} // run
+
+unsigned WorkerPool::getNumberOfThreads() const {
+	return threads.size();
+} // getNumberOfThreads
+
+unsigned WorkerPool::getDefaultNumberOfThreads() {
+	long processors;
+#ifdef WIN32
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+	processors = systemInfo.dwNumberOfProcessors;
+#else
+	processors = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	if (processors <= 1)
+		return 0;
+	return (unsigned)processors - 1;
+} // getDefaultNumberOfThreads
+
+void WorkerPool::workerMain(void* pool) {
+	WorkerPool* workerPool = (WorkerPool*)pool;
+	unsigned numberOfBarrierThreads = workerPool->threads.size() + 1;
+
+	while (true) {
+		workerPool->startBarrier->enter(numberOfBarrierThreads);
+		if (workerPool->shutdown)
+			break;
+		workerPool->processTasks();
+		workerPool->finishBarrier->enter(numberOfBarrierThreads);
+	} // while
+} // workerMain
+
+void WorkerPool::processTasks() {
+	uint32_t task;
+	// tasks are fetched one by one so that expensive tasks do not delay
+	// the others
+	while ((task = inVRsUtilities::atomicIncrement(&nextTask) - 1) < numberOfTasks) {
+		function(task, userData);
+	} // while
+} // processTasks
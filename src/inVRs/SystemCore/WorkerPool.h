@@ -0,0 +1,113 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                Changes                                    *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+\*---------------------------------------------------------------------------*/
+
+#ifndef _WORKERPOOL_H
+#define _WORKERPOOL_H
+
+#include <string>
+#include <vector>
+
+#include <OpenSG/OSGConfig.h>
+#include <OpenSG/OSGThread.h>
+#include <OpenSG/OSGBarrier.h>
+
+#include "Platform.h"
+
+/******************************************************************************
+ * Set of worker threads which execute independent tasks in parallel.
+ * The run method distributes the tasks dynamically over the worker threads
+ * and the calling thread and returns when all tasks are finished. The worker
+ * threads sleep in a barrier between two calls of run. The tasks must not
+ * modify OpenSG field containers, this has to be done by the calling thread
+ * before or after the parallel section.
+ */
+class INVRS_SYSTEMCORE_API WorkerPool {
+public:
+	/** Function executed for every task.
+	 * @param taskIndex index of the task (0 to numberOfTasks-1)
+	 * @param userData pointer passed to the run method
+	 */
+	typedef void (*TaskFunction)(unsigned taskIndex, void* userData);
+
+	/** Starts the passed number of worker threads.
+	 * If numberOfThreads is 0 all tasks are executed by the calling thread.
+	 * @param name prefix for the names of the OpenSG threads and barriers
+	 * @param numberOfThreads number of additional threads
+	 */
+	WorkerPool(std::string name, unsigned numberOfThreads);
+
+	/** Stops and joins all worker threads.
+	 */
+	~WorkerPool();
+
+	/** Executes function for all tasks and waits until they are finished.
+	 * Must only be called from the thread which created the pool.
+	 * @param function function which is executed for every task
+	 * @param numberOfTasks number of tasks
+	 * @param userData pointer passed to the function
+	 */
+	void run(TaskFunction function, unsigned numberOfTasks, void* userData);
+
+	/** Returns the number of worker threads (without the calling thread).
+	 */
+	unsigned getNumberOfThreads() const;
+
+	/** Returns the number of available processors minus one (for the
+	 * calling thread).
+	 */
+	static unsigned getDefaultNumberOfThreads();
+
+private:
+	static void workerMain(void* pool);
+	void processTasks();
+
+#if OSG_MAJOR_VERSION >= 2
+	std::vector<OSG::ThreadRefPtr> threads;
+	OSG::BarrierRefPtr startBarrier;
+	OSG::BarrierRefPtr finishBarrier;
+#else //OpenSG1:
+	std::vector<OSG::Thread*> threads;
+	OSG::Barrier* startBarrier;
+	OSG::Barrier* finishBarrier;
+#endif
+	/// index of the next task which is not yet started
+	volatile uint32_t nextTask;
+	unsigned numberOfTasks;
+	TaskFunction function;
+	void* userData;
+	bool shutdown;
+}; // WorkerPool
+
+#endif // _WORKERPOOL_H
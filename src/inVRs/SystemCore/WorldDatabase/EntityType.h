@@ -181,6 +181,7 @@ protected:
 	friend class WorldDatabase;
 	friend class SystemCore;
 	friend class WorldDatabaseSyncEvent;
+	friend class WorldDatabaseSyncReceiver;
 	friend class WorldDatabaseCreateEntityEvent;
 
 	/**
@@ -518,6 +518,7 @@ private:
 	friend class SystemCore;
 	friend class WorldDatabase;
 	friend class WorldDatabaseSyncEvent;
+	friend class WorldDatabaseSyncReceiver;
 	friend class WorldDatabaseCreateEntityEvent;
 	friend class WorldDatabaseDestroyEntityEvent;
 
@@ -46,6 +46,8 @@
 #include "../../OutputInterface/OutputInterface.h"
 #include "../EventManager/EventManager.h"
 #include "../UtilityFunctions.h"
+#include "../UserDatabase/UserDatabase.h"
+#include "../WorkerPool.h"
 
 // disable deprecation warning for std::auto_ptr when std::unique_ptr is not available.
 #ifndef HAS_CXX11_UNIQUE_PTR
@@ -80,6 +82,12 @@ std::vector<EntityTypeFactory*> WorldDatabase::entityTypeFactories;
 std::vector<AvatarFactory*> WorldDatabase::avatarFactories;
 
 std::vector<AvatarInterface*> WorldDatabase::avatarList;
+std::vector<AvatarInterface*> WorldDatabase::parallelUpdateList;
+WorkerPool* WorldDatabase::avatarUpdatePool = NULL;
+
+std::vector<WorldDatabase::SyncStream> WorldDatabase::syncStreams;
+WorldDatabaseSyncReceiver WorldDatabase::syncReceiver;
+unsigned WorldDatabase::syncVersion = 0;
 
 int WorldDatabase::xSpacing;
 int WorldDatabase::zSpacing;
@@ -111,6 +119,12 @@ void WorldDatabase::init() {
 
 	EventManager::registerEventFactory("WorldDatabaseSyncEvent",
 			new WorldDatabaseSyncEvent::Factory());
+	EventManager::registerEventFactory("WorldDatabaseSyncBeginEvent",
+			new WorldDatabaseSyncBeginEvent::Factory());
+	EventManager::registerEventFactory("WorldDatabaseSyncChunkEvent",
+			new WorldDatabaseSyncChunkEvent::Factory());
+	EventManager::registerEventFactory("WorldDatabaseSyncEndEvent",
+			new WorldDatabaseSyncEndEvent::Factory());
 	EventManager::registerEventFactory("WorldDatabaseCreateEntityEvent",
 			new WorldDatabaseCreateEntityEvent::Factory());
 	EventManager::registerEventFactory("WorldDatabaseDestroyEntityEvent",
@@ -151,6 +165,15 @@ void WorldDatabase::cleanup() {
 		delete avatarList[i];
 	avatarList.clear();
 
+	if (avatarUpdatePool) {
+		delete avatarUpdatePool;
+		avatarUpdatePool = NULL;
+	} // if
+
+	for (i = 0; i < (int)syncStreams.size(); i++)
+		delete syncStreams[i].streamer;
+	syncStreams.clear();
+
 	for (i = 0; i < (int)avatarFactories.size(); i++)
 		delete avatarFactories[i];
 	avatarFactories.clear();
@@ -727,7 +750,7 @@ Entity* WorldDatabase::getEntityWithTypeInstanceId(unsigned short entityTypeId,
 		return NULL;
 	} // if
 	Entity* ret = type->getEntityByInstanceId(instanceId);
-	if (!ret) {
+	if (!ret && PRINTD_ENABLED(INFO)) {
 		printd(
 				INFO,
 				"WorldDatabase::getEntityWithTypeInstanceId(): cannot find a entity with type based id %i and instance based id %i\n",
@@ -986,10 +1009,119 @@ void WorldDatabase::removeAvatar(AvatarInterface* avatarInt) {
 
 void WorldDatabase::updateAvatars(float dt) {
 	int i;
+
+	parallelUpdateList.clear();
+	for (i = 0; i < (int)avatarList.size(); i++) {
+		if (avatarList[i]->beginUpdate(dt))
+			parallelUpdateList.push_back(avatarList[i]);
+	} // for
+
+	if (parallelUpdateList.size() > 1 && !avatarUpdatePool) {
+		unsigned numberOfThreads = WorkerPool::getDefaultNumberOfThreads();
+		if (Configuration::contains("WorldDatabase.avatarUpdateThreads")) {
+			int configuredThreads = Configuration::getInt("WorldDatabase.avatarUpdateThreads");
+			numberOfThreads = configuredThreads > 0 ? configuredThreads : 0;
+		} // if
+		avatarUpdatePool = new WorkerPool("avatarUpdate", numberOfThreads);
+	} // if
+	if (avatarUpdatePool) {
+		avatarUpdatePool->run(updateAvatarParallel, parallelUpdateList.size(),
+				&parallelUpdateList);
+	} // if
+	else if (parallelUpdateList.size() == 1) {
+		parallelUpdateList[0]->updateParallel();
+	} // else if
+
 	for (i = 0; i < (int)avatarList.size(); i++)
-		avatarList[i]->update(dt);
+		avatarList[i]->endUpdate();
 } // updateAvatars
 
+void WorldDatabase::startSync(unsigned userId, unsigned spawnEnvironmentId) {
+	std::vector<WorldDatabaseSyncEntity> snapshot;
+	std::vector<unsigned> environmentOrder;
+	WorldDatabaseSyncStreamer* streamer;
+	SyncStream stream;
+	unsigned chunkSize = 8192;
+
+	if (Configuration::contains("WorldDatabase.syncChunkSize"))
+		chunkSize = Configuration::getInt("WorldDatabase.syncChunkSize");
+
+	WorldDatabaseSyncStreamer::captureWorldDatabase(snapshot);
+	WorldDatabaseSyncStreamer::getEnvironmentOrder(spawnEnvironmentId, environmentOrder);
+	streamer = new WorldDatabaseSyncStreamer(++syncVersion, snapshot, environmentOrder,
+			chunkSize);
+
+	printd(INFO,
+			"WorldDatabase::startSync(): streaming %u entities in %u chunks to user %u\n",
+			(unsigned)snapshot.size(), streamer->getNumberOfChunks(), userId);
+	EventManager::sendEventTo(new WorldDatabaseSyncBeginEvent(TRANSFORMATION_MANAGER_ID,
+			streamer->getVersion(), streamer->getNumberOfChunks(),
+			streamer->getNumberOfSpawnChunks()), userId);
+
+	stream.userId = userId;
+	stream.streamer = streamer;
+	syncStreams.push_back(stream);
+} // startSync
+
+void WorldDatabase::stepSync(std::vector<unsigned>& completedUsers) {
+	std::vector<SyncStream>::iterator it;
+	std::vector<WorldDatabaseSyncEntity> entities;
+	std::vector<WorldDatabaseSyncEntity> changed;
+	std::vector<unsigned> removed;
+	WorldDatabaseSyncStreamer* streamer;
+	unsigned chunksPerStep = 1;
+	unsigned i, chunkIndex;
+
+	completedUsers.clear();
+	if (syncStreams.empty())
+		return;
+
+	if (Configuration::contains("WorldDatabase.syncChunksPerStep")) {
+		int configuredChunks = Configuration::getInt("WorldDatabase.syncChunksPerStep");
+		chunksPerStep = configuredChunks > 1 ? configuredChunks : 1;
+	} // if
+
+	it = syncStreams.begin();
+	while (it != syncStreams.end()) {
+		streamer = it->streamer;
+		if (!UserDatabase::getUserById(it->userId)) {
+			printd(WARNING, "WorldDatabase::stepSync(): user %u left during synchronisation\n",
+					it->userId);
+			delete streamer;
+			it = syncStreams.erase(it);
+			continue;
+		} // if
+
+		for (i = 0; i < chunksPerStep && streamer->hasNextChunk(); i++) {
+			chunkIndex = streamer->getNextChunk(entities);
+			EventManager::sendEventTo(new WorldDatabaseSyncChunkEvent(TRANSFORMATION_MANAGER_ID,
+					streamer->getVersion(), chunkIndex, entities), it->userId);
+		} // for
+
+		if (streamer->hasNextChunk()) {
+			++it;
+			continue;
+		} // if
+
+		// all chunks are sent, catch up with the changes since the snapshot
+		WorldDatabaseSyncStreamer::captureWorldDatabase(entities);
+		streamer->getDelta(entities, changed, removed);
+		EventManager::sendEventTo(new WorldDatabaseSyncEndEvent(TRANSFORMATION_MANAGER_ID,
+				streamer->getVersion(), changed, removed), it->userId);
+		completedUsers.push_back(it->userId);
+		delete streamer;
+		it = syncStreams.erase(it);
+	} // while
+} // stepSync
+
+WorldDatabaseSyncReceiver* WorldDatabase::getSyncReceiver() {
+	return &syncReceiver;
+} // getSyncReceiver
+
+void WorldDatabase::updateAvatarParallel(unsigned index, void* avatarList) {
+	(*(std::vector<AvatarInterface*>*)avatarList)[index]->updateParallel();
+} // updateAvatarParallel
+
 int WorldDatabase::getXSpacing() {
 	return xSpacing;
 } // getXSpacing
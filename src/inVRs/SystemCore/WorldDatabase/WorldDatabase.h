@@ -45,12 +45,14 @@
 #include "Entity.h"
 #include "Environment.h"
 #include "SimpleAvatar.h"
+#include "WorldDatabaseSync.h"
 #include "../Configuration.h"
 #include "../../OutputInterface/SceneGraphInterface.h"
 #include "../XmlConfigurationConverter.h"
 #include "../XmlElement.h"
 
 class EntityTypeFactory;
+class WorkerPool;
 
 /******************************************************************************
  * The WorldDatabase acts as a DB for the logical objects of the VE. Entities,
@@ -357,7 +359,10 @@ public:
 	/**
 	 * Updates all registered avatars.
 	 * It iterates over all elements of the avatarList and calls their
-	 * update-methods.
+	 * beginUpdate-methods. The parallel parts of the updates are executed by
+	 * a WorkerPool (the number of threads can be set with the configuration
+	 * entry WorldDatabase.avatarUpdateThreads), afterwards endUpdate is called
+	 * for all avatars.
 	 * @author landi
 	 * @param dt elapsed time since last call
 	 */
@@ -424,6 +429,31 @@ public:
 	 */
 	static const WorldDatabase::PrivateAccessor& getPrivateAccessor();
 
+	/**
+	 * Starts streaming the WorldDatabase to a joining user.
+	 * A snapshot of all Entities is taken and sent in chunks of at most
+	 * WorldDatabase.syncChunkSize bytes by stepSync(). The Entities of the
+	 * spawn Environment are sent first, followed by the other Environments
+	 * ordered by their distance to it. Changes made during the transmission
+	 * are sent as delta at the end.
+	 * @param userId id of the joining user
+	 * @param spawnEnvironmentId Environment the joining user starts in
+	 */
+	static void startSync(unsigned userId, unsigned spawnEnvironmentId);
+
+	/**
+	 * Sends the next WorldDatabase.syncChunksPerStep chunks of each running
+	 * stream. The method is called by SystemCore::step().
+	 * @param completedUsers returns the users whose stream was finished
+	 */
+	static void stepSync(std::vector<unsigned>& completedUsers);
+
+	/**
+	 * Returns the state of the snapshot which is received from a remote user.
+	 * @return receiver of the current snapshot
+	 */
+	static WorldDatabaseSyncReceiver* getSyncReceiver();
+
 	/**
 	 * @deprecated
 	 */
@@ -550,6 +580,24 @@ private:
 
 	/// List of all registered Avatars
 	static std::vector<AvatarInterface*> avatarList;
+	/// Avatars which need updateParallel in the current frame
+	static std::vector<AvatarInterface*> parallelUpdateList;
+	/// Threads for the parallel part of the avatar updates
+	static WorkerPool* avatarUpdatePool;
+
+	static void updateAvatarParallel(unsigned index, void* avatarList);
+
+	struct SyncStream {
+		unsigned userId;
+		WorldDatabaseSyncStreamer* streamer;
+	}; // SyncStream
+
+	/// Snapshots which are currently streamed to joining users
+	static std::vector<SyncStream> syncStreams;
+	/// Snapshot which is currently received
+	static WorldDatabaseSyncReceiver syncReceiver;
+	/// Version of the last snapshot taken
+	static unsigned syncVersion;
 
 	/// horizontal and vertical spacing (units per tile)
 	static int xSpacing;
@@ -198,6 +198,140 @@ void WorldDatabaseSyncEvent::execute() {
 }
 
 
+WorldDatabaseSyncBeginEvent::WorldDatabaseSyncBeginEvent(unsigned srcModuleId, unsigned version,
+		unsigned numberOfChunks, unsigned numberOfSpawnChunks) :
+	Event(srcModuleId, TRANSFORMATION_MANAGER_ID, "WorldDatabaseSyncBeginEvent"),
+	version(version),
+	numberOfChunks(numberOfChunks),
+	numberOfSpawnChunks(numberOfSpawnChunks) {
+}
+
+WorldDatabaseSyncBeginEvent::WorldDatabaseSyncBeginEvent() :
+	Event(),
+	version(0),
+	numberOfChunks(0),
+	numberOfSpawnChunks(0) {
+}
+
+void WorldDatabaseSyncBeginEvent::encode(NetMessage* message) {
+	message->putUInt32(version);
+	message->putUInt32(numberOfChunks);
+	message->putUInt32(numberOfSpawnChunks);
+}
+
+void WorldDatabaseSyncBeginEvent::decode(NetMessage* message) {
+	message->getUInt32(version);
+	message->getUInt32(numberOfChunks);
+	message->getUInt32(numberOfSpawnChunks);
+}
+
+void WorldDatabaseSyncBeginEvent::execute() {
+	printd(INFO,
+			"WorldDatabaseSyncBeginEvent::execute(): receiving snapshot %u in %u chunks (%u for the spawn environment)\n",
+			version, numberOfChunks, numberOfSpawnChunks);
+	WorldDatabase::getSyncReceiver()->begin(version, numberOfChunks, numberOfSpawnChunks);
+}
+
+WorldDatabaseSyncChunkEvent::WorldDatabaseSyncChunkEvent(unsigned srcModuleId, unsigned version,
+		unsigned chunkIndex, const std::vector<WorldDatabaseSyncEntity>& entities) :
+	Event(srcModuleId, TRANSFORMATION_MANAGER_ID, "WorldDatabaseSyncChunkEvent"),
+	version(version),
+	chunkIndex(chunkIndex),
+	entities(entities) {
+	// the chunks must not delay the events of the running session
+	setPriority(PRIORITY_BULK);
+}
+
+WorldDatabaseSyncChunkEvent::WorldDatabaseSyncChunkEvent() :
+	Event(),
+	version(0),
+	chunkIndex(0) {
+}
+
+void WorldDatabaseSyncChunkEvent::encode(NetMessage* message) {
+	unsigned i;
+
+	message->putUInt32(version);
+	message->putUInt32(chunkIndex);
+	message->putUInt32(entities.size());
+	for (i = 0; i < entities.size(); i++)
+		msgFunctions::encode(entities[i], message);
+}
+
+void WorldDatabaseSyncChunkEvent::decode(NetMessage* message) {
+	uint32_t i, size;
+
+	message->getUInt32(version);
+	message->getUInt32(chunkIndex);
+	message->getUInt32(size);
+	entities.resize(size);
+	for (i = 0; i < size; i++)
+		msgFunctions::decode(entities[i], message);
+}
+
+void WorldDatabaseSyncChunkEvent::execute() {
+	unsigned i;
+
+	if (!WorldDatabase::getSyncReceiver()->addChunk(version, chunkIndex, entities))
+		return;
+	for (i = 0; i < entities.size(); i++)
+		WorldDatabaseSyncReceiver::applyToWorldDatabase(entities[i]);
+}
+
+WorldDatabaseSyncEndEvent::WorldDatabaseSyncEndEvent(unsigned srcModuleId, unsigned version,
+		const std::vector<WorldDatabaseSyncEntity>& changed, const std::vector<unsigned>& removed) :
+	Event(srcModuleId, TRANSFORMATION_MANAGER_ID, "WorldDatabaseSyncEndEvent"),
+	version(version),
+	changed(changed),
+	removed(removed) {
+	// sent in the same lane as the chunks so that it arrives after them
+	setPriority(PRIORITY_BULK);
+}
+
+WorldDatabaseSyncEndEvent::WorldDatabaseSyncEndEvent() :
+	Event(),
+	version(0) {
+}
+
+void WorldDatabaseSyncEndEvent::encode(NetMessage* message) {
+	unsigned i;
+
+	message->putUInt32(version);
+	message->putUInt32(changed.size());
+	for (i = 0; i < changed.size(); i++)
+		msgFunctions::encode(changed[i], message);
+	message->putUInt32(removed.size());
+	for (i = 0; i < removed.size(); i++)
+		message->putUInt32(removed[i]);
+}
+
+void WorldDatabaseSyncEndEvent::decode(NetMessage* message) {
+	uint32_t i, size;
+
+	message->getUInt32(version);
+	message->getUInt32(size);
+	changed.resize(size);
+	for (i = 0; i < size; i++)
+		msgFunctions::decode(changed[i], message);
+	message->getUInt32(size);
+	removed.resize(size);
+	for (i = 0; i < size; i++)
+		message->getUInt32(removed[i]);
+}
+
+void WorldDatabaseSyncEndEvent::execute() {
+	WorldDatabaseSyncReceiver* receiver = WorldDatabase::getSyncReceiver();
+	unsigned i;
+
+	if (!receiver->finish(version, changed, removed))
+		return;
+	for (i = 0; i < changed.size(); i++)
+		WorldDatabaseSyncReceiver::applyToWorldDatabase(changed[i]);
+	receiver->removeUnsynchronisedEntities();
+	printd(INFO, "WorldDatabaseSyncEndEvent::execute(): snapshot %u complete\n", version);
+}
+
+
 WorldDatabaseCreateEntityEvent::WorldDatabaseCreateEntityEvent(unsigned typeBasedId,
 		unsigned environmentBasedId, TransformationData initialTrans, unsigned srcModuleId) :
 	Event(srcModuleId, TRANSFORMATION_MANAGER_ID, "WorldDatabaseCreateEntityEvent") {
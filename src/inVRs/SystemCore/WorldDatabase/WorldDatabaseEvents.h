@@ -37,6 +37,7 @@
 #define _WORLDDATABASEEVENTS_H
 
 #include "WorldDatabase.h"
+#include "WorldDatabaseSync.h"
 #include "../DataTypes.h"
 #include "../EventManager/Event.h"
 #include "../EventManager/EventFactory.h"
@@ -44,6 +45,12 @@
 /******************************************************************************
  *
  */
+/******************************************************************************
+ * Transmits the whole WorldDatabase in one message. The SystemCore uses the
+ * chunked WorldDatabaseSyncBeginEvent, WorldDatabaseSyncChunkEvent and
+ * WorldDatabaseSyncEndEvent instead, this event is only kept for
+ * compatibility.
+ */
 class INVRS_SYSTEMCORE_API WorldDatabaseSyncEvent : public Event {
 public:
 
@@ -76,6 +83,74 @@ protected:
 	// 	virtual std::string toString();
 };
 
+/******************************************************************************
+ * Announces a snapshot of the WorldDatabase which is streamed to a joining
+ * user by WorldDatabase::stepSync().
+ */
+class INVRS_SYSTEMCORE_API WorldDatabaseSyncBeginEvent : public Event {
+public:
+	WorldDatabaseSyncBeginEvent(unsigned srcModuleId, unsigned version, unsigned numberOfChunks,
+			unsigned numberOfSpawnChunks); // constructor for application
+	WorldDatabaseSyncBeginEvent(); // constructor for factory
+
+	typedef EventFactory<WorldDatabaseSyncBeginEvent> Factory;
+
+	virtual void encode(NetMessage* message);
+	virtual void decode(NetMessage* message);
+	virtual void execute();
+
+protected:
+	unsigned version;
+	unsigned numberOfChunks;
+	unsigned numberOfSpawnChunks;
+};
+
+/******************************************************************************
+ * Contains one chunk of a snapshot announced by a WorldDatabaseSyncBeginEvent.
+ * The Entities are applied to the WorldDatabase immediately.
+ */
+class INVRS_SYSTEMCORE_API WorldDatabaseSyncChunkEvent : public Event {
+public:
+	WorldDatabaseSyncChunkEvent(unsigned srcModuleId, unsigned version, unsigned chunkIndex,
+			const std::vector<WorldDatabaseSyncEntity>& entities); // constructor for application
+	WorldDatabaseSyncChunkEvent(); // constructor for factory
+
+	typedef EventFactory<WorldDatabaseSyncChunkEvent> Factory;
+
+	virtual void encode(NetMessage* message);
+	virtual void decode(NetMessage* message);
+	virtual void execute();
+
+protected:
+	unsigned version;
+	unsigned chunkIndex;
+	std::vector<WorldDatabaseSyncEntity> entities;
+};
+
+/******************************************************************************
+ * Finishes a snapshot with the changes made to the WorldDatabase while the
+ * chunks were streamed. Entities which were neither part of the snapshot nor
+ * of the changes are removed afterwards.
+ */
+class INVRS_SYSTEMCORE_API WorldDatabaseSyncEndEvent : public Event {
+public:
+	WorldDatabaseSyncEndEvent(unsigned srcModuleId, unsigned version,
+			const std::vector<WorldDatabaseSyncEntity>& changed,
+			const std::vector<unsigned>& removed); // constructor for application
+	WorldDatabaseSyncEndEvent(); // constructor for factory
+
+	typedef EventFactory<WorldDatabaseSyncEndEvent> Factory;
+
+	virtual void encode(NetMessage* message);
+	virtual void decode(NetMessage* message);
+	virtual void execute();
+
+protected:
+	unsigned version;
+	std::vector<WorldDatabaseSyncEntity> changed;
+	std::vector<unsigned> removed;
+};
+
 /******************************************************************************
  *
  */
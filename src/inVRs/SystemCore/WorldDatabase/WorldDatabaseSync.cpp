@@ -0,0 +1,383 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+
+#include "WorldDatabaseSync.h"
+
+#include <algorithm>
+#include <map>
+#include <stdlib.h>
+
+#include "WorldDatabase.h"
+#include "Entity.h"
+#include "EntityType.h"
+#include "Environment.h"
+#include "../DebugOutput.h"
+
+namespace {
+
+// version, chunk index and number of Entities of a WorldDatabaseSyncChunkEvent
+const unsigned CHUNK_HEADER_SIZE = 12;
+
+/**
+ * Orders Entities by the rank of their Environment, Entities of unknown
+ * Environments are sorted to the end.
+ */
+struct EnvironmentRankCompare {
+	EnvironmentRankCompare(const std::map<unsigned, unsigned>& rank) :
+		rank(rank) {
+	} // EnvironmentRankCompare
+
+	unsigned getRank(unsigned environmentId) const {
+		std::map<unsigned, unsigned>::const_iterator it = rank.find(environmentId);
+		if (it == rank.end())
+			return (unsigned)rank.size();
+		return it->second;
+	} // getRank
+
+	bool operator()(const WorldDatabaseSyncEntity& a, const WorldDatabaseSyncEntity& b) const {
+		return getRank(a.environmentId) < getRank(b.environmentId);
+	} // operator()
+
+	const std::map<unsigned, unsigned>& rank;
+}; // EnvironmentRankCompare
+
+struct EnvironmentDistance {
+	unsigned id;
+	int distance;
+
+	bool operator<(const EnvironmentDistance& other) const {
+		return distance < other.distance;
+	} // operator<
+}; // EnvironmentDistance
+
+bool isEqual(const WorldDatabaseSyncEntity& a, const WorldDatabaseSyncEntity& b) {
+	return a.envBasedId == b.envBasedId && a.environmentId == b.environmentId
+			&& a.transf.position == b.transf.position && a.transf.scale == b.transf.scale
+			&& a.transf.orientation == b.transf.orientation
+			&& a.transf.scaleOrientation == b.transf.scaleOrientation;
+} // isEqual
+
+} // namespace
+
+void msgFunctions::encode(const WorldDatabaseSyncEntity& entity, NetMessage* msg) {
+	TransformationData transf = entity.transf;
+
+	msg->putUInt32(entity.typeBasedId);
+	msg->putUInt32(entity.envBasedId);
+	msg->putUInt32(entity.environmentId);
+	addTransformationToBinaryMsg(&transf, msg);
+} // encode
+
+void msgFunctions::decode(WorldDatabaseSyncEntity& entity, NetMessage* msg) {
+	msg->getUInt32(entity.typeBasedId);
+	msg->getUInt32(entity.envBasedId);
+	msg->getUInt32(entity.environmentId);
+	entity.transf = readTransformationFrom(msg);
+} // decode
+
+WorldDatabaseSyncStreamer::WorldDatabaseSyncStreamer(unsigned version,
+		const std::vector<WorldDatabaseSyncEntity>& snapshot,
+		const std::vector<unsigned>& environmentOrder, unsigned maxChunkSize) :
+	version(version),
+	entities(snapshot),
+	numberOfSpawnEntities(0),
+	nextEntity(0) {
+	std::map<unsigned, unsigned> rank;
+	unsigned i;
+
+	for (i = 0; i < environmentOrder.size(); i++)
+		rank[environmentOrder[i]] = i;
+	// stable, so the Entities of an Environment keep their order
+	std::stable_sort(entities.begin(), entities.end(), EnvironmentRankCompare(rank));
+
+	if (environmentOrder.size() > 0) {
+		for (i = 0; i < entities.size(); i++) {
+			if (entities[i].environmentId == environmentOrder[0])
+				numberOfSpawnEntities++;
+		} // for
+	} // if
+
+	entitiesPerChunk = 1;
+	if (maxChunkSize > CHUNK_HEADER_SIZE + getEntitySize())
+		entitiesPerChunk = (maxChunkSize - CHUNK_HEADER_SIZE) / getEntitySize();
+} // WorldDatabaseSyncStreamer
+
+unsigned WorldDatabaseSyncStreamer::getVersion() const {
+	return version;
+} // getVersion
+
+unsigned WorldDatabaseSyncStreamer::getNumberOfChunks() const {
+	return (unsigned)(entities.size() + entitiesPerChunk - 1) / entitiesPerChunk;
+} // getNumberOfChunks
+
+unsigned WorldDatabaseSyncStreamer::getNumberOfSpawnChunks() const {
+	return (numberOfSpawnEntities + entitiesPerChunk - 1) / entitiesPerChunk;
+} // getNumberOfSpawnChunks
+
+bool WorldDatabaseSyncStreamer::hasNextChunk() const {
+	return nextEntity < entities.size();
+} // hasNextChunk
+
+unsigned WorldDatabaseSyncStreamer::getNextChunk(std::vector<WorldDatabaseSyncEntity>& dst) {
+	unsigned chunkIndex = nextEntity / entitiesPerChunk;
+	unsigned end = std::min((unsigned)entities.size(), nextEntity + entitiesPerChunk);
+
+	dst.assign(entities.begin() + nextEntity, entities.begin() + end);
+	nextEntity = end;
+	return chunkIndex;
+} // getNextChunk
+
+void WorldDatabaseSyncStreamer::getDelta(const std::vector<WorldDatabaseSyncEntity>& current,
+		std::vector<WorldDatabaseSyncEntity>& changed, std::vector<unsigned>& removed) const {
+	std::map<unsigned, const WorldDatabaseSyncEntity*> snapshot;
+	std::map<unsigned, const WorldDatabaseSyncEntity*>::iterator it;
+	unsigned i;
+
+	for (i = 0; i < entities.size(); i++)
+		snapshot[entities[i].typeBasedId] = &entities[i];
+
+	changed.clear();
+	removed.clear();
+	for (i = 0; i < current.size(); i++) {
+		it = snapshot.find(current[i].typeBasedId);
+		if (it == snapshot.end()) {
+			changed.push_back(current[i]);
+			continue;
+		} // if
+		if (!isEqual(*it->second, current[i]))
+			changed.push_back(current[i]);
+		snapshot.erase(it);
+	} // for
+
+	// the remaining Entities of the snapshot do not exist any more
+	for (it = snapshot.begin(); it != snapshot.end(); ++it)
+		removed.push_back(it->first);
+} // getDelta
+
+unsigned WorldDatabaseSyncStreamer::getEntitySize() {
+	static unsigned size = 0;
+
+	if (size == 0) {
+		NetMessage msg;
+		WorldDatabaseSyncEntity entity;
+		entity.typeBasedId = entity.envBasedId = entity.environmentId = 0;
+		entity.transf = identityTransformation();
+		msgFunctions::encode(entity, &msg);
+		size = msg.getBufferSize();
+	} // if
+	return size;
+} // getEntitySize
+
+void WorldDatabaseSyncStreamer::captureWorldDatabase(std::vector<WorldDatabaseSyncEntity>& dst) {
+	const std::vector<Environment*>& environmentList = WorldDatabase::getEnvironmentList();
+	WorldDatabaseSyncEntity entity;
+	Entity* ent;
+	unsigned i, j;
+
+	dst.clear();
+	for (i = 0; i < environmentList.size(); i++) {
+		const std::vector<Entity*>& entityList = environmentList[i]->getEntityList();
+		for (j = 0; j < entityList.size(); j++) {
+			ent = entityList[j];
+			entity.typeBasedId = ent->getTypeBasedId();
+			entity.envBasedId = ent->getEnvironmentBasedId();
+			entity.environmentId = ent->getEnvironment()->getId();
+			entity.transf = ent->getEnvironmentTransformation();
+			dst.push_back(entity);
+		} // for
+	} // for
+} // captureWorldDatabase
+
+void WorldDatabaseSyncStreamer::getEnvironmentOrder(unsigned spawnEnvironmentId,
+		std::vector<unsigned>& dst) {
+	const std::vector<Environment*>& environmentList = WorldDatabase::getEnvironmentList();
+	Environment* spawn = NULL;
+	std::vector<EnvironmentDistance> distances;
+	EnvironmentDistance distance;
+	Environment* env;
+	unsigned i;
+
+	if (spawnEnvironmentId <= 0xFFFF)
+		spawn = WorldDatabase::getEnvironmentWithId((unsigned short)spawnEnvironmentId);
+
+	for (i = 0; i < environmentList.size(); i++) {
+		env = environmentList[i];
+		distance.id = env->getId();
+		distance.distance = 0;
+		if (spawn && env != spawn) {
+			// distance of the centers in spacing coordinates (doubled to stay integral)
+			distance.distance = 1 + abs(2 * env->getXPosition() + env->getXSize() - 2
+					* spawn->getXPosition() - spawn->getXSize()) + abs(2 * env->getZPosition()
+					+ env->getZSize() - 2 * spawn->getZPosition() - spawn->getZSize());
+		} // if
+		distances.push_back(distance);
+	} // for
+	std::stable_sort(distances.begin(), distances.end());
+
+	dst.clear();
+	// without a spawn Environment no Environment is preferred
+	if (!spawn)
+		dst.push_back(~0u);
+	for (i = 0; i < distances.size(); i++)
+		dst.push_back(distances[i].id);
+} // getEnvironmentOrder
+
+WorldDatabaseSyncReceiver::WorldDatabaseSyncReceiver() :
+	version(0),
+	numberOfChunks(0),
+	numberOfSpawnChunks(0),
+	receivedChunks(0),
+	receivedSpawnChunks(0),
+	active(false),
+	complete(false) {
+} // WorldDatabaseSyncReceiver
+
+void WorldDatabaseSyncReceiver::begin(unsigned version, unsigned numberOfChunks,
+		unsigned numberOfSpawnChunks) {
+	this->version = version;
+	this->numberOfChunks = numberOfChunks;
+	this->numberOfSpawnChunks = numberOfSpawnChunks;
+	receivedChunks = 0;
+	receivedSpawnChunks = 0;
+	active = true;
+	complete = false;
+	entities.clear();
+} // begin
+
+bool WorldDatabaseSyncReceiver::addChunk(unsigned version, unsigned chunkIndex,
+		const std::vector<WorldDatabaseSyncEntity>& entities) {
+	unsigned i;
+
+	if (!active || version != this->version) {
+		printd(WARNING,
+				"WorldDatabaseSyncReceiver::addChunk(): ignoring chunk %u of snapshot %u!\n",
+				chunkIndex, version);
+		return false;
+	} // if
+
+	for (i = 0; i < entities.size(); i++)
+		this->entities.insert(entities[i].typeBasedId);
+	receivedChunks++;
+	if (chunkIndex < numberOfSpawnChunks)
+		receivedSpawnChunks++;
+	return true;
+} // addChunk
+
+bool WorldDatabaseSyncReceiver::finish(unsigned version,
+		const std::vector<WorldDatabaseSyncEntity>& changed, const std::vector<unsigned>& removed) {
+	unsigned i;
+
+	if (!active || version != this->version) {
+		printd(WARNING,
+				"WorldDatabaseSyncReceiver::finish(): ignoring delta of snapshot %u!\n", version);
+		return false;
+	} // if
+	if (receivedChunks != numberOfChunks) {
+		printd(WARNING,
+				"WorldDatabaseSyncReceiver::finish(): received %u of %u chunks of snapshot %u!\n",
+				receivedChunks, numberOfChunks, version);
+	} // if
+
+	for (i = 0; i < changed.size(); i++)
+		entities.insert(changed[i].typeBasedId);
+	for (i = 0; i < removed.size(); i++)
+		entities.erase(removed[i]);
+	active = false;
+	complete = true;
+	return true;
+} // finish
+
+bool WorldDatabaseSyncReceiver::isUsable() const {
+	return complete || (active && receivedSpawnChunks >= numberOfSpawnChunks);
+} // isUsable
+
+bool WorldDatabaseSyncReceiver::isComplete() const {
+	return complete;
+} // isComplete
+
+bool WorldDatabaseSyncReceiver::contains(unsigned typeBasedId) const {
+	return entities.find(typeBasedId) != entities.end();
+} // contains
+
+void WorldDatabaseSyncReceiver::applyToWorldDatabase(const WorldDatabaseSyncEntity& entity) {
+	unsigned short entTypeId, entInstId, entEnvId, entInEnvId;
+	EntityType* entType;
+	Environment* env;
+	Entity* ent;
+
+	split(entity.typeBasedId, entTypeId, entInstId);
+	split(entity.envBasedId, entEnvId, entInEnvId);
+	env = WorldDatabase::getEnvironmentWithId((unsigned short)entity.environmentId);
+	if (!env) {
+		printd(ERROR,
+				"WorldDatabaseSyncReceiver::applyToWorldDatabase(): unknown Environment %u for entity %u!\n",
+				entity.environmentId, entity.typeBasedId);
+		return;
+	} // if
+
+	ent = WorldDatabase::getEntityWithTypeInstanceId(entity.typeBasedId);
+	if (!ent) {
+		entType = WorldDatabase::getEntityTypeWithId(entTypeId);
+		if (!entType) {
+			printd(ERROR,
+					"WorldDatabaseSyncReceiver::applyToWorldDatabase(): entity creation failed, couldn't find entity type with id %u\n",
+					entTypeId);
+			return;
+		} // if
+		ent = entType->createInstanceUnchecked(entInstId, entEnvId, entInEnvId);
+		if (!env->addNewEntity(ent))
+			printd(ERROR,
+					"WorldDatabaseSyncReceiver::applyToWorldDatabase(): Could not add Entity with ID %u to Environment %u\n",
+					entInEnvId, entEnvId);
+	} else if (ent->getEnvironment() != env) {
+		ent->changeEnvironment(env);
+	} // else if
+	ent->setEnvironmentTransformation(entity.transf);
+} // applyToWorldDatabase
+
+void WorldDatabaseSyncReceiver::removeUnsynchronisedEntities() const {
+	const std::vector<Environment*>& environmentList = WorldDatabase::getEnvironmentList();
+	std::vector<Entity*> entitiesToRemove;
+	unsigned i, j;
+
+	for (i = 0; i < environmentList.size(); i++) {
+		const std::vector<Entity*>& entityList = environmentList[i]->getEntityList();
+		for (j = 0; j < entityList.size(); j++) {
+			if (!contains(entityList[j]->getTypeBasedId()))
+				entitiesToRemove.push_back(entityList[j]);
+		} // for
+		for (j = 0; j < entitiesToRemove.size(); j++) {
+			printd(INFO,
+					"WorldDatabaseSyncReceiver::removeUnsynchronisedEntities(): deleting entity %u\n",
+					entitiesToRemove[j]->getTypeBasedId());
+			environmentList[i]->removeEntity(entitiesToRemove[j]);
+			delete entitiesToRemove[j];
+		} // for
+		entitiesToRemove.clear();
+	} // for
+} // removeUnsynchronisedEntities
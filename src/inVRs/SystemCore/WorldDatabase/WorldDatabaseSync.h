@@ -0,0 +1,205 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                Changes                                    *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+\*---------------------------------------------------------------------------*/
+
+#ifndef _WORLDDATABASESYNC_H
+#define _WORLDDATABASESYNC_H
+
+#include <set>
+#include <vector>
+
+#include "../DataTypes.h"
+#include "../NetMessage.h"
+
+/**
+ * State of an Entity as it is transferred to a joining user.
+ */
+struct WorldDatabaseSyncEntity {
+	unsigned typeBasedId;
+	unsigned envBasedId;
+	unsigned environmentId;
+	TransformationData transf;
+}; // WorldDatabaseSyncEntity
+
+namespace msgFunctions {
+
+INVRS_SYSTEMCORE_API void encode(const WorldDatabaseSyncEntity& entity, NetMessage* msg);
+INVRS_SYSTEMCORE_API void decode(WorldDatabaseSyncEntity& entity, NetMessage* msg);
+
+} // msgFunctions
+
+/******************************************************************************
+ * Splits a snapshot of the WorldDatabase into chunks of bounded size for a
+ * joining user. The Entities are ordered by the distance of their
+ * Environment to the spawn Environment of the joining user, so the
+ * surrounding of the user is complete first. Changes made while the chunks
+ * are transferred are collected by getDelta() at the end.
+ *
+ * The streamer itself does not access the WorldDatabase or the network, the
+ * WorldDatabase sends the chunks with the WorldDatabaseSyncBeginEvent,
+ * WorldDatabaseSyncChunkEvent and WorldDatabaseSyncEndEvent (see
+ * WorldDatabase::startSync()).
+ */
+class INVRS_SYSTEMCORE_API WorldDatabaseSyncStreamer {
+public:
+	/**
+	 * Creates the chunks for a snapshot.
+	 * @param version version of the snapshot, used by the receiver to
+	 *        discard chunks of an older snapshot
+	 * @param snapshot state of all Entities
+	 * @param environmentOrder Environment ids ordered by distance, the first
+	 *        one is the spawn Environment. Entities of other Environments are
+	 *        sent last.
+	 * @param maxChunkSize maximum number of bytes of the Entities of a chunk
+	 */
+	WorldDatabaseSyncStreamer(unsigned version, const std::vector<WorldDatabaseSyncEntity>& snapshot,
+			const std::vector<unsigned>& environmentOrder, unsigned maxChunkSize);
+
+	unsigned getVersion() const;
+	unsigned getNumberOfChunks() const;
+
+	/**
+	 * Returns the number of chunks which are needed to transfer all Entities
+	 * of the spawn Environment. The world is usable for the joining user
+	 * when these chunks arrived.
+	 */
+	unsigned getNumberOfSpawnChunks() const;
+
+	bool hasNextChunk() const;
+
+	/**
+	 * Writes the Entities of the next chunk into dst.
+	 * @return index of the chunk
+	 */
+	unsigned getNextChunk(std::vector<WorldDatabaseSyncEntity>& dst);
+
+	/**
+	 * Compares the snapshot with the current state of the world.
+	 * @param current current state of all Entities
+	 * @param changed Entities which were created or changed since the snapshot
+	 * @param removed type based ids of Entities which were removed
+	 */
+	void getDelta(const std::vector<WorldDatabaseSyncEntity>& current,
+			std::vector<WorldDatabaseSyncEntity>& changed, std::vector<unsigned>& removed) const;
+
+	/**
+	 * Returns the number of bytes of an encoded WorldDatabaseSyncEntity.
+	 */
+	static unsigned getEntitySize();
+
+	/**
+	 * Writes the state of all Entities of the WorldDatabase into dst.
+	 */
+	static void captureWorldDatabase(std::vector<WorldDatabaseSyncEntity>& dst);
+
+	/**
+	 * Writes the ids of all Environments of the WorldDatabase ordered by the
+	 * distance to the passed Environment into dst.
+	 */
+	static void getEnvironmentOrder(unsigned spawnEnvironmentId, std::vector<unsigned>& dst);
+
+protected:
+	unsigned version;
+	std::vector<WorldDatabaseSyncEntity> entities;
+	unsigned entitiesPerChunk;
+	unsigned numberOfSpawnEntities;
+	unsigned nextEntity;
+}; // WorldDatabaseSyncStreamer
+
+/******************************************************************************
+ * Keeps track of the chunks of a snapshot received by a joining user.
+ */
+class INVRS_SYSTEMCORE_API WorldDatabaseSyncReceiver {
+public:
+	WorldDatabaseSyncReceiver();
+
+	/**
+	 * Starts receiving a new snapshot, chunks of older snapshots are ignored
+	 * afterwards.
+	 */
+	void begin(unsigned version, unsigned numberOfChunks, unsigned numberOfSpawnChunks);
+
+	/**
+	 * Marks the Entities of a chunk as synchronised.
+	 * @return false if the chunk belongs to another snapshot
+	 */
+	bool addChunk(unsigned version, unsigned chunkIndex,
+			const std::vector<WorldDatabaseSyncEntity>& entities);
+
+	/**
+	 * Applies the delta sent after the last chunk.
+	 * @return false if the delta belongs to another snapshot
+	 */
+	bool finish(unsigned version, const std::vector<WorldDatabaseSyncEntity>& changed,
+			const std::vector<unsigned>& removed);
+
+	/**
+	 * Returns true when all chunks of the spawn Environment arrived.
+	 */
+	bool isUsable() const;
+
+	/**
+	 * Returns true when the delta of the snapshot was applied.
+	 */
+	bool isComplete() const;
+
+	/**
+	 * Returns true if the Entity with the passed type based id is part of
+	 * the received snapshot (and was not removed by the delta).
+	 */
+	bool contains(unsigned typeBasedId) const;
+
+	/**
+	 * Creates or updates the Entity in the WorldDatabase.
+	 */
+	static void applyToWorldDatabase(const WorldDatabaseSyncEntity& entity);
+
+	/**
+	 * Removes all Entities from the WorldDatabase which are not part of the
+	 * received snapshot.
+	 */
+	void removeUnsynchronisedEntities() const;
+
+protected:
+	unsigned version;
+	unsigned numberOfChunks;
+	unsigned numberOfSpawnChunks;
+	unsigned receivedChunks;
+	unsigned receivedSpawnChunks;
+	bool active;
+	bool complete;
+	std::set<unsigned> entities;
+}; // WorldDatabaseSyncReceiver
+
+#endif // _WORLDDATABASESYNC_H
@@ -0,0 +1,491 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+#include "XmlBinaryCache.h"
+
+#include <map>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef WIN32
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include "XmlDocument.h"
+#include "DebugOutput.h"
+
+namespace
+{
+
+const char CACHEFILE_MAGIC[8] = { 'I', 'N', 'V', 'R', 'S', 'X', 'M', 'L' };
+const uint32_t CACHEFILE_VERSION = 2;
+const uint32_t NO_STRING = 0xFFFFFFFF;
+
+/**
+ * Header of a cache file. The header is followed by the path of the source
+ * file, the key, the string offset table, the element records, the attribute records, the entity dtd
+ * records and the string data. All tables start at a multiple of 8 bytes.
+ */
+struct CacheFileHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t sourcePathLength;
+	uint32_t keyLength;
+	uint32_t padding;
+	uint64_t fileSize;
+	uint64_t sourceModificationTime;
+	uint64_t sourceSize;
+	uint32_t nStrings;
+	uint32_t nElements;
+	uint32_t nAttributes;
+	uint32_t nEntityDtds;
+	uint32_t documentDtdName;
+	uint32_t documentDtd;
+	uint32_t stringOffsetsOffset;
+	uint32_t elementsOffset;
+	uint32_t attributesOffset;
+	uint32_t entityDtdsOffset;
+	uint32_t stringDataOffset;
+	uint32_t stringDataSize;
+}; // CacheFileHeader
+
+/**
+ * Element in breadth-first order. The children of an element are the
+ * elements firstChild to firstChild+nChildren-1, its attributes the
+ * attributes firstAttribute to firstAttribute+nAttributes-1.
+ */
+struct ElementRecord {
+	uint32_t name;
+	uint32_t content;
+	uint32_t firstChild;
+	uint32_t nChildren;
+	uint32_t firstAttribute;
+	uint32_t nAttributes;
+}; // ElementRecord
+
+struct StringPairRecord {
+	uint32_t first;
+	uint32_t second;
+}; // StringPairRecord
+
+/**
+ * Collects the tables of a cache file, every string is stored only once.
+ */
+struct CacheFileContent {
+	std::map<std::string, uint32_t> stringMap;
+	std::vector<uint32_t> stringOffsets;
+	std::string stringData;
+	std::vector<ElementRecord> elements;
+	std::vector<StringPairRecord> attributes;
+	std::vector<StringPairRecord> entityDtds;
+
+	uint32_t intern(const std::string& str) {
+		std::map<std::string, uint32_t>::iterator it = stringMap.find(str);
+		if (it != stringMap.end())
+			return it->second;
+		uint32_t index = (uint32_t)stringOffsets.size();
+		stringMap[str] = index;
+		stringOffsets.push_back((uint32_t)stringData.size());
+		stringData.append(str.c_str(), str.size() + 1);
+		return index;
+	} // intern
+}; // CacheFileContent
+
+uint32_t align8(uint32_t value) {
+	return (value + 7) & ~((uint32_t)7);
+} // align8
+
+uint32_t hashString(const std::string& str) {
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < str.size(); i++) {
+		hash ^= (uint8_t)str[i];
+		hash *= 16777619u;
+	} // for
+	return hash;
+} // hashString
+
+bool getSourceFileInfo(const std::string& fileName, uint64_t& modificationTime,
+		uint64_t& size) {
+	struct stat sb;
+	if (stat(fileName.c_str(), &sb) != 0)
+		return false;
+	modificationTime = (uint64_t)sb.st_mtime;
+	size = (uint64_t)sb.st_size;
+	return true;
+} // getSourceFileInfo
+
+bool writeTable(FILE* file, const void* data, uint32_t size, uint32_t offset, uint32_t& pos) {
+	static const char padding[8] = { 0 };
+	if (offset - pos > 0 && fwrite(padding, 1, offset - pos, file) != offset - pos)
+		return false;
+	if (size > 0 && fwrite(data, 1, size, file) != size)
+		return false;
+	pos = offset + size;
+	return true;
+} // writeTable
+
+void unmapFile(void* mappedFile, size_t mappedSize) {
+#ifndef WIN32
+	munmap(mappedFile, mappedSize);
+#else
+	delete[] (char*)mappedFile;
+#endif
+} // unmapFile
+
+/**
+ * Creates a new temporary file next to the passed file and opens it for
+ * writing. Every call gets an own name, so processes which write the same
+ * cache file at the same time never write into the same temporary file.
+ * @param tempFileName receives the name of the created file
+ * @return the opened file or NULL on error
+ */
+FILE* openTempFile(const std::string& fileName, std::string& tempFileName) {
+#ifdef WIN32
+	static unsigned counter = 0;
+	char buffer[32];
+	sprintf(buffer, ".%d.%u.tmp", _getpid(), counter++);
+	tempFileName = fileName + buffer;
+	return fopen(tempFileName.c_str(), "wb");
+#else
+	std::vector<char> name(fileName.begin(), fileName.end());
+	const char suffix[] = ".XXXXXX";
+	name.insert(name.end(), suffix, suffix + sizeof(suffix));
+	int fd = mkstemp(&name[0]);
+	if (fd < 0)
+		return NULL;
+	tempFileName = &name[0];
+	// mkstemp creates the file only readable for the owner
+	fchmod(fd, 0644);
+	FILE* file = fdopen(fd, "wb");
+	if (!file) {
+		close(fd);
+		remove(tempFileName.c_str());
+	} // if
+	return file;
+#endif
+} // openTempFile
+
+} // namespace
+
+XmlDocument* XmlBinaryCache::read(const std::string& cacheDirectory, const std::string& file,
+		const std::string& key) {
+	uint64_t sourceModificationTime, sourceSize;
+	std::string cacheFileName = getCacheFileName(cacheDirectory, file, key);
+	void* mappedFile = NULL;
+	size_t mappedSize = 0;
+	uint32_t i, j;
+
+	if (!getSourceFileInfo(file, sourceModificationTime, sourceSize))
+		return NULL;
+
+#ifndef WIN32
+	int fd = open(cacheFileName.c_str(), O_RDONLY);
+	if (fd < 0)
+		return NULL;
+	struct stat sb;
+	if (fstat(fd, &sb) != 0 || (size_t)sb.st_size < sizeof(CacheFileHeader)) {
+		close(fd);
+		return NULL;
+	} // if
+	mappedSize = (size_t)sb.st_size;
+	mappedFile = mmap(NULL, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mappedFile == MAP_FAILED)
+		return NULL;
+#else
+	FILE* in = fopen(cacheFileName.c_str(), "rb");
+	if (!in)
+		return NULL;
+	fseek(in, 0, SEEK_END);
+	mappedSize = (size_t)ftell(in);
+	fseek(in, 0, SEEK_SET);
+	if (mappedSize < sizeof(CacheFileHeader)) {
+		fclose(in);
+		return NULL;
+	} // if
+	// new[] of char returns memory aligned for any fundamental type
+	mappedFile = new char[mappedSize];
+	if (fread(mappedFile, 1, mappedSize, in) != mappedSize) {
+		fclose(in);
+		delete[] (char*)mappedFile;
+		return NULL;
+	} // if
+	fclose(in);
+#endif
+
+	const char* base = (const char*)mappedFile;
+	const CacheFileHeader* header = (const CacheFileHeader*)base;
+	bool valid = memcmp(header->magic, CACHEFILE_MAGIC, sizeof(CACHEFILE_MAGIC)) == 0
+			&& header->version == CACHEFILE_VERSION
+			&& header->fileSize == mappedSize
+			&& header->sourceModificationTime == sourceModificationTime
+			&& header->sourceSize == sourceSize
+			&& sizeof(CacheFileHeader) + (uint64_t)header->sourcePathLength + header->keyLength
+					<= mappedSize
+			&& header->nElements > 0
+			&& header->stringOffsetsOffset + (uint64_t)header->nStrings * sizeof(uint32_t) <= mappedSize
+			&& header->elementsOffset + (uint64_t)header->nElements * sizeof(ElementRecord) <= mappedSize
+			&& header->attributesOffset + (uint64_t)header->nAttributes * sizeof(StringPairRecord) <= mappedSize
+			&& header->entityDtdsOffset + (uint64_t)header->nEntityDtds * sizeof(StringPairRecord) <= mappedSize
+			&& header->stringDataOffset + (uint64_t)header->stringDataSize <= mappedSize
+			&& header->stringDataSize > 0
+			&& base[header->stringDataOffset + header->stringDataSize - 1] == '\0';
+	if (!valid) {
+		printd(INFO,
+				"XmlBinaryCache::read(): ignoring outdated or invalid cache file %s for %s\n",
+				cacheFileName.c_str(), file.c_str());
+		unmapFile(mappedFile, mappedSize);
+		return NULL;
+	} // if
+
+	// the file name is only a hash of source path and key, so a cache file of
+	// another document may end up under the same name
+	const char* storedSourcePath = base + sizeof(CacheFileHeader);
+	const char* storedKey = storedSourcePath + header->sourcePathLength;
+	if (header->sourcePathLength != file.size()
+			|| memcmp(storedSourcePath, file.data(), file.size()) != 0
+			|| header->keyLength != key.size()
+			|| memcmp(storedKey, key.data(), key.size()) != 0) {
+		printd(WARNING,
+				"XmlBinaryCache::read(): cache file %s was written for %s, not for %s\n",
+				cacheFileName.c_str(), std::string(storedSourcePath,
+						header->sourcePathLength).c_str(), file.c_str());
+		unmapFile(mappedFile, mappedSize);
+		return NULL;
+	} // if
+
+	const uint32_t* stringOffsets = (const uint32_t*)(base + header->stringOffsetsOffset);
+	const ElementRecord* elementRecords = (const ElementRecord*)(base + header->elementsOffset);
+	const StringPairRecord* attributeRecords =
+			(const StringPairRecord*)(base + header->attributesOffset);
+	const StringPairRecord* entityDtdRecords =
+			(const StringPairRecord*)(base + header->entityDtdsOffset);
+	const char* stringData = base + header->stringDataOffset;
+
+	// every string is created only once, the elements share them
+	std::vector<std::string> strings(header->nStrings);
+	for (i = 0; valid && i < header->nStrings; i++) {
+		valid = stringOffsets[i] < header->stringDataSize;
+		if (valid)
+			strings[i] = stringData + stringOffsets[i];
+	} // for
+
+	// the children of the elements have to follow each other in breadth-first
+	// order, otherwise the file does not describe a tree
+	uint32_t nextChild = 1;
+	for (i = 0; valid && i < header->nElements; i++) {
+		const ElementRecord& record = elementRecords[i];
+		valid = record.name < header->nStrings
+				&& (record.content == NO_STRING || record.content < header->nStrings)
+				&& (record.nChildren == 0 || record.firstChild == nextChild)
+				&& (uint64_t)record.firstAttribute + record.nAttributes <= header->nAttributes;
+		nextChild += record.nChildren;
+		for (j = 0; valid && j < record.nAttributes; j++) {
+			valid = attributeRecords[record.firstAttribute + j].first < header->nStrings
+					&& attributeRecords[record.firstAttribute + j].second < header->nStrings;
+		} // for
+	} // for
+	valid = valid && nextChild == header->nElements;
+	for (i = 0; valid && i < header->nEntityDtds; i++) {
+		valid = entityDtdRecords[i].first < header->nStrings
+				&& entityDtdRecords[i].second < header->nStrings;
+	} // for
+	valid = valid && (header->documentDtdName == NO_STRING
+			|| (header->documentDtdName < header->nStrings && header->documentDtd < header->nStrings));
+	if (!valid) {
+		printd(WARNING, "XmlBinaryCache::read(): corrupt cache file %s for %s\n",
+				cacheFileName.c_str(), file.c_str());
+		unmapFile(mappedFile, mappedSize);
+		return NULL;
+	} // if
+
+	std::vector<XmlElement*> elements(header->nElements);
+	for (i = 0; i < header->nElements; i++) {
+		const ElementRecord& record = elementRecords[i];
+		XmlElement* element = new XmlElement(strings[record.name]);
+		if (record.content != NO_STRING)
+			element->content = strings[record.content];
+		element->attributes.reserve(record.nAttributes);
+		for (j = 0; j < record.nAttributes; j++) {
+			const StringPairRecord& attribute = attributeRecords[record.firstAttribute + j];
+			element->attributes.push_back(new XmlAttribute(strings[attribute.first],
+					strings[attribute.second]));
+		} // for
+		elements[i] = element;
+	} // for
+	for (i = 0; i < header->nElements; i++) {
+		const ElementRecord& record = elementRecords[i];
+		elements[i]->subElements.reserve(record.nChildren);
+		for (j = 0; j < record.nChildren; j++) {
+			elements[i]->subElements.push_back(elements[record.firstChild + j]);
+			elements[record.firstChild + j]->parentElement = elements[i];
+		} // for
+	} // for
+
+	XmlDocument* document = new XmlDocument();
+	document->rootElement = elements[0];
+	if (header->documentDtdName != NO_STRING) {
+		document->documentDtd = new XmlDtdReference(strings[header->documentDtdName],
+				strings[header->documentDtd]);
+	} // if
+	for (i = 0; i < header->nEntityDtds; i++) {
+		document->entityDtds.push_back(new XmlDtdReference(strings[entityDtdRecords[i].first],
+				strings[entityDtdRecords[i].second]));
+	} // for
+
+	unmapFile(mappedFile, mappedSize);
+	return document;
+} // read
+
+bool XmlBinaryCache::write(const std::string& cacheDirectory, const std::string& file,
+		const std::string& key, const XmlDocument* document) {
+	CacheFileHeader header;
+	CacheFileContent content;
+	uint64_t sourceModificationTime, sourceSize;
+	std::string cacheFileName = getCacheFileName(cacheDirectory, file, key);
+	std::vector<const XmlElement*> elements;
+	std::vector<XmlAttribute*>::const_iterator attIt;
+	std::vector<XmlElement*>::const_iterator seIt;
+	std::vector<XmlDtdReference*>::const_iterator dtdIt;
+
+	if (!document->rootElement || !getSourceFileInfo(file, sourceModificationTime, sourceSize))
+		return false;
+
+	// breadth-first traversal, the children of an element are appended to the
+	// list before the next element is visited
+	elements.push_back(document->rootElement);
+	for (size_t i = 0; i < elements.size(); i++) {
+		const XmlElement* element = elements[i];
+		ElementRecord record;
+		record.name = content.intern(element->elementName);
+		record.content = element->content.empty() ? NO_STRING : content.intern(element->content);
+		record.firstChild = (uint32_t)elements.size();
+		record.nChildren = (uint32_t)element->subElements.size();
+		record.firstAttribute = (uint32_t)content.attributes.size();
+		record.nAttributes = (uint32_t)element->attributes.size();
+		for (attIt = element->attributes.begin(); attIt != element->attributes.end(); ++attIt) {
+			StringPairRecord attribute;
+			attribute.first = content.intern((*attIt)->getKey());
+			attribute.second = content.intern((*attIt)->getValue());
+			content.attributes.push_back(attribute);
+		} // for
+		for (seIt = element->subElements.begin(); seIt != element->subElements.end(); ++seIt) {
+			elements.push_back(*seIt);
+		} // for
+		content.elements.push_back(record);
+	} // for
+	for (dtdIt = document->entityDtds.begin(); dtdIt != document->entityDtds.end(); ++dtdIt) {
+		StringPairRecord entityDtd;
+		entityDtd.first = content.intern((*dtdIt)->getName());
+		entityDtd.second = content.intern((*dtdIt)->getDtd());
+		content.entityDtds.push_back(entityDtd);
+	} // for
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CACHEFILE_MAGIC, sizeof(CACHEFILE_MAGIC));
+	header.version = CACHEFILE_VERSION;
+	header.sourcePathLength = (uint32_t)file.size();
+	header.keyLength = (uint32_t)key.size();
+	header.sourceModificationTime = sourceModificationTime;
+	header.sourceSize = sourceSize;
+	header.documentDtdName = NO_STRING;
+	header.documentDtd = NO_STRING;
+	if (document->documentDtd) {
+		header.documentDtdName = content.intern(document->documentDtd->getName());
+		header.documentDtd = content.intern(document->documentDtd->getDtd());
+	} // if
+	header.nStrings = (uint32_t)content.stringOffsets.size();
+	header.nElements = (uint32_t)content.elements.size();
+	header.nAttributes = (uint32_t)content.attributes.size();
+	header.nEntityDtds = (uint32_t)content.entityDtds.size();
+	header.stringDataSize = (uint32_t)content.stringData.size();
+	header.stringOffsetsOffset = align8(sizeof(CacheFileHeader) + header.sourcePathLength
+			+ header.keyLength);
+	header.elementsOffset = align8(header.stringOffsetsOffset +
+			header.nStrings * sizeof(uint32_t));
+	header.attributesOffset = align8(header.elementsOffset +
+			header.nElements * sizeof(ElementRecord));
+	header.entityDtdsOffset = align8(header.attributesOffset +
+			header.nAttributes * sizeof(StringPairRecord));
+	header.stringDataOffset = align8(header.entityDtdsOffset +
+			header.nEntityDtds * sizeof(StringPairRecord));
+	header.fileSize = header.stringDataOffset + header.stringDataSize;
+
+	// write to a temporary file first so that a concurrently running process
+	// never maps a partially written cache file
+	std::string tempFileName;
+	FILE* out = openTempFile(cacheFileName, tempFileName);
+	if (!out) {
+		printd(WARNING, "XmlBinaryCache::write(): unable to write cache file %s!\n",
+				cacheFileName.c_str());
+		return false;
+	} // if
+
+	uint32_t pos = 0;
+	bool success = writeTable(out, &header, sizeof(header), 0, pos)
+			&& writeTable(out, file.data(), header.sourcePathLength, pos, pos)
+			&& writeTable(out, key.data(), header.keyLength, pos, pos)
+			&& writeTable(out, &content.stringOffsets[0], header.nStrings * sizeof(uint32_t),
+					header.stringOffsetsOffset, pos)
+			&& writeTable(out, &content.elements[0], header.nElements * sizeof(ElementRecord),
+					header.elementsOffset, pos)
+			&& writeTable(out, content.attributes.empty() ? NULL : &content.attributes[0],
+					header.nAttributes * sizeof(StringPairRecord), header.attributesOffset, pos)
+			&& writeTable(out, content.entityDtds.empty() ? NULL : &content.entityDtds[0],
+					header.nEntityDtds * sizeof(StringPairRecord), header.entityDtdsOffset, pos)
+			&& writeTable(out, content.stringData.data(), header.stringDataSize,
+					header.stringDataOffset, pos);
+	success = (fclose(out) == 0) && success;
+
+	if (success) {
+#ifdef WIN32
+		remove(cacheFileName.c_str());
+#endif
+		success = rename(tempFileName.c_str(), cacheFileName.c_str()) == 0;
+	} // if
+	if (!success) {
+		printd(WARNING, "XmlBinaryCache::write(): error writing cache file %s!\n",
+				cacheFileName.c_str());
+		remove(tempFileName.c_str());
+	} // if
+	return success;
+} // write
+
+std::string XmlBinaryCache::getCacheFileName(const std::string& cacheDirectory,
+		const std::string& file, const std::string& key) {
+	char buffer[32];
+	sprintf(buffer, "xml_%08x.xmlcache", hashString(file + "|" + key));
+	return cacheDirectory + buffer;
+} // getCacheFileName
@@ -0,0 +1,85 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                Changes                                    *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+ *                                                                           *
+\*---------------------------------------------------------------------------*/
+
+#ifndef _XMLBINARYCACHE_H
+#define _XMLBINARYCACHE_H
+
+#include <string>
+#include "Platform.h"
+
+class XmlDocument;
+
+/******************************************************************************
+ * On-disk cache for (converted) XmlDocuments.
+ * A document is stored in a compact binary form which is mapped into memory
+ * when it is read again. All element names, attribute keys, values and
+ * contents are interned into a single string table, the elements are stored
+ * in breadth-first order so that the children of every element form a
+ * contiguous index range. Reading a cache file therefore needs neither the
+ * XML parser nor any name comparisons.
+ * A cache file is only used if the modification time and size of the source
+ * file and the passed key (e.g. the versions of the registered converters)
+ * match the ones stored in the cache file. The source path and the key are
+ * stored in full, so a cache file whose name collides with the one of another
+ * document is rejected.
+ */
+class INVRS_SYSTEMCORE_API XmlBinaryCache {
+public:
+	/** Reads the cached document for the passed source file.
+	 * @param cacheDirectory directory containing the cache files
+	 * @param file path of the XML source file
+	 * @param key additional key which has to match the one used for writing
+	 * @return cached document or NULL if no valid cache file exists
+	 */
+	static XmlDocument* read(const std::string& cacheDirectory, const std::string& file,
+			const std::string& key);
+
+	/** Writes the passed document to the cache directory.
+	 * @param cacheDirectory directory containing the cache files
+	 * @param file path of the XML source file the document was loaded from
+	 * @param key additional key which is stored in the cache file
+	 * @param document document which should be cached
+	 * @return true if the cache file was written successfully
+	 */
+	static bool write(const std::string& cacheDirectory, const std::string& file,
+			const std::string& key, const XmlDocument* document);
+
+	/** Returns the name of the cache file for the passed source file and key.
+	 */
+	static std::string getCacheFileName(const std::string& cacheDirectory,
+			const std::string& file, const std::string& key);
+}; // XmlBinaryCache
+
+#endif // _XMLBINARYCACHE_H
@@ -14,6 +14,7 @@
 #include "XMLTools.h"
 #include "Configuration.h"
 #include "UtilityFunctions.h"
+#include "XmlBinaryCache.h"
 
 // disable deprecation warning for std::auto_ptr when std::unique_ptr is not available.
 #ifndef HAS_CXX11_UNIQUE_PTR
@@ -125,11 +126,22 @@ const XmlDocument* XmlConfigurationLoader::loadConfiguration(std::string file,
 		bool automaticUpdateIfConfigured) {
 	bool updateFile = false;
 	bool successfullBackup = false;
+	std::string cacheDirectory;
+	std::string cacheKey;
 
 	if (automaticUpdateIfConfigured && Configuration::contains("XmlConfigLoader.updateFiles")) {
 		updateFile = Configuration::getBool("XmlConfigLoader.updateFiles");
 	} // if
 
+	// converted documents are stored in this directory and mapped on later runs
+	if (Configuration::containsPath("XmlConfigurationCache")) {
+		cacheDirectory = Configuration::getPath("XmlConfigurationCache");
+		cacheKey = getCacheKey();
+		XmlDocument* cachedDocument = XmlBinaryCache::read(cacheDirectory, file, cacheKey);
+		if (cachedDocument)
+			return cachedDocument;
+	} // if
+
 	XmlDocument* document = XmlDocument::loadXmlDocument(file);
 	if (!document || !document->getRootElement()) {
 		printd(ERROR,
@@ -193,6 +205,9 @@ const XmlDocument* XmlConfigurationLoader::loadConfiguration(std::string file,
 					file.c_str(), version.toString().c_str(), latestVersion.toString().c_str());
 		} // else if
 	} // if
+	if (!cacheDirectory.empty()) {
+		XmlBinaryCache::write(cacheDirectory, file, cacheKey, document);
+	} // if
 	return document;
 } // loadConfiguration
 
@@ -217,6 +232,17 @@ Version XmlConfigurationLoader::getLatestVersion() const {
 } // getLatestVersion
 
 
+std::string XmlConfigurationLoader::getCacheKey() const {
+	// a cached document is only valid for the same set of converters
+	std::string result = "converters";
+	std::vector<XmlConfigurationConverter*>::const_iterator it;
+	for (it = converterList.begin(); it != converterList.end(); ++it) {
+		result += " " + (*it)->getMinimumVersion().toString() + "-"
+				+ (*it)->getDestinationVersion().toString();
+	} // for
+	return result;
+} // getCacheKey
+
 Version XmlConfigurationLoader::getConfigurationVersion(XmlDocument* document) {
 	Version version = UndefinedVersion;
 	if (document->getRootElement()->hasAttribute("version")) {
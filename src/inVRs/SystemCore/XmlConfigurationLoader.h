@@ -42,7 +42,10 @@ public:
 	void registerConverter(XmlConfigurationConverter* converter);
 
 	/**
-	 *
+	 * Loads the passed file and converts it to the latest version. If the path
+	 * XmlConfigurationCache is configured the converted document is stored
+	 * there by the XmlBinaryCache and read from the cache on later runs as long
+	 * as the file is unchanged.
 	 */
 	const XmlDocument* loadConfiguration(std::string file, bool automaticUpdateIfConfigured = true);
 
@@ -71,6 +74,12 @@ private:
 	bool convertDocumentToVersion(XmlDocument* document, Version& version,
 			const Version& dstVersion, std::string configFile);
 
+	/**
+	 * Returns the key which identifies the registered converters in the
+	 * XmlBinaryCache.
+	 */
+	std::string getCacheKey() const;
+
 	/// List of all configuration converters in order
 	std::vector<XmlConfigurationConverter*> converterList;
 	/// Latest version
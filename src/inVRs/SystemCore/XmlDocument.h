@@ -184,6 +184,8 @@ public:
 	bool dumpToFile(std::string fileName) const;
 
 private:
+	friend class XmlBinaryCache;
+
 	/**
 	 * Avoid construction of XmlDocument
 	 */
@@ -239,6 +239,8 @@ public:
 
 
 private:
+	friend class XmlBinaryCache;
+
 	/**
 	 *
 	 */
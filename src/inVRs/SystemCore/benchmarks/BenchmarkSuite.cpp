@@ -0,0 +1,225 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+#include "BenchmarkSuite.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <inVRs/SystemCore/Timer.h>
+
+Benchmark::Benchmark(std::string name, unsigned operations) :
+	name(name),
+	operations(operations) {
+} // Benchmark
+
+Benchmark::~Benchmark() {
+} // ~Benchmark
+
+void Benchmark::setUp() {
+} // setUp
+
+void Benchmark::tearDown() {
+} // tearDown
+
+std::string Benchmark::getName() const {
+	return name;
+} // getName
+
+unsigned Benchmark::getOperations() const {
+	return operations;
+} // getOperations
+
+const std::map<std::string, double>& Benchmark::getMetrics() const {
+	return metrics;
+} // getMetrics
+
+void Benchmark::setMetric(std::string metricName, double value) {
+	metrics[metricName] = value;
+} // setMetric
+
+BenchmarkSuite::BenchmarkSuite() :
+	repetitions(7),
+	tolerance(0.25) {
+} // BenchmarkSuite
+
+BenchmarkSuite::~BenchmarkSuite() {
+	for (unsigned i = 0; i < benchmarks.size(); i++)
+		delete benchmarks[i];
+	benchmarks.clear();
+} // ~BenchmarkSuite
+
+void BenchmarkSuite::add(Benchmark* benchmark) {
+	benchmarks.push_back(benchmark);
+} // add
+
+int BenchmarkSuite::main(int argc, char** argv) {
+	std::string outputFile, baselineFile, filter;
+	std::vector<Result> results;
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--output") && i + 1 < argc)
+			outputFile = argv[++i];
+		else if (!strcmp(argv[i], "--baseline") && i + 1 < argc)
+			baselineFile = argv[++i];
+		else if (!strcmp(argv[i], "--tolerance") && i + 1 < argc)
+			tolerance = atof(argv[++i]);
+		else if (!strcmp(argv[i], "--repetitions") && i + 1 < argc)
+			repetitions = std::max(atoi(argv[++i]), 1);
+		else if (!strcmp(argv[i], "--filter") && i + 1 < argc)
+			filter = argv[++i];
+		else {
+			fprintf(stderr, "usage: %s [--output FILE] [--baseline FILE] [--tolerance X] "
+				"[--repetitions N] [--filter TEXT]\n", argv[0]);
+			return 2;
+		} // else
+	} // for
+
+	for (i = 0; i < (int)benchmarks.size(); i++) {
+		if (benchmarks[i]->getName().find(filter) == std::string::npos)
+			continue;
+		results.push_back(runBenchmark(benchmarks[i]));
+		fprintf(stderr, "%-36s %12.2f ns/op (min %.2f)\n", results.back().name.c_str(),
+				results.back().medianNsPerOp, results.back().minNsPerOp);
+		std::map<std::string, double>::const_iterator it;
+		for (it = results.back().metrics.begin(); it != results.back().metrics.end(); ++it)
+			fprintf(stderr, "%-36s %12.3f %s\n", "", it->second, it->first.c_str());
+	} // for
+
+	if (!writeResults(results, outputFile))
+		return 2;
+
+	if (baselineFile.size() > 0) {
+		std::map<std::string, double> baseline;
+		if (!readBaseline(baselineFile, baseline))
+			return 2;
+		if (!compareWithBaseline(results, baseline))
+			return 1;
+	} // if
+	return 0;
+} // main
+
+BenchmarkSuite::Result BenchmarkSuite::runBenchmark(Benchmark* benchmark) {
+	std::vector<double> times;
+	double start;
+	Result result;
+
+	benchmark->setUp();
+	benchmark->run();
+	for (unsigned i = 0; i < repetitions; i++) {
+		start = inVRsUtilities::Timer::getMonotonicTime();
+		benchmark->run();
+		times.push_back(inVRsUtilities::Timer::getMonotonicTime() - start);
+	} // for
+	benchmark->tearDown();
+
+	std::sort(times.begin(), times.end());
+	result.name = benchmark->getName();
+	result.operations = benchmark->getOperations();
+	result.medianNsPerOp = times[times.size() / 2] * 1e9 / result.operations;
+	result.minNsPerOp = times[0] * 1e9 / result.operations;
+	result.metrics = benchmark->getMetrics();
+	return result;
+} // runBenchmark
+
+bool BenchmarkSuite::writeResults(const std::vector<Result>& results, std::string fileName) {
+	FILE* file = stdout;
+
+	if (fileName.size() > 0) {
+		file = fopen(fileName.c_str(), "w");
+		if (!file) {
+			fprintf(stderr, "BenchmarkSuite::writeResults(): could not open %s!\n",
+					fileName.c_str());
+			return false;
+		} // if
+	} // if
+
+	// one result per line, readBaseline() relies on that
+	fprintf(file, "{\n  \"suite\": \"inVRsBenchmarks\",\n  \"repetitions\": %u,\n"
+		"  \"results\": [\n", repetitions);
+	for (unsigned i = 0; i < results.size(); i++) {
+		fprintf(file, "    {\"name\": \"%s\", \"operations\": %u, \"medianNsPerOp\": %.3f, "
+			"\"minNsPerOp\": %.3f, \"opsPerSecond\": %.1f", results[i].name.c_str(),
+				results[i].operations, results[i].medianNsPerOp, results[i].minNsPerOp,
+				1e9 / results[i].medianNsPerOp);
+		std::map<std::string, double>::const_iterator it;
+		for (it = results[i].metrics.begin(); it != results[i].metrics.end(); ++it)
+			fprintf(file, ", \"%s\": %.3f", it->first.c_str(), it->second);
+		fprintf(file, "}%s\n", (i + 1 < results.size()) ? "," : "");
+	} // for
+	fprintf(file, "  ]\n}\n");
+
+	if (file != stdout)
+		fclose(file);
+	return true;
+} // writeResults
+
+bool BenchmarkSuite::readBaseline(std::string fileName, std::map<std::string, double>& dst) {
+	char line[1024];
+	char name[256];
+	unsigned operations;
+	double median;
+
+	FILE* file = fopen(fileName.c_str(), "r");
+	if (!file) {
+		fprintf(stderr, "BenchmarkSuite::readBaseline(): could not open %s!\n",
+				fileName.c_str());
+		return false;
+	} // if
+
+	while (fgets(line, sizeof(line), file)) {
+		const char* entry = strstr(line, "{\"name\": \"");
+		if (entry && sscanf(entry, "{\"name\": \"%255[^\"]\", \"operations\": %u, "
+			"\"medianNsPerOp\": %lf", name, &operations, &median) == 3)
+			dst[name] = median;
+	} // while
+	fclose(file);
+	return true;
+} // readBaseline
+
+bool BenchmarkSuite::compareWithBaseline(const std::vector<Result>& results,
+		const std::map<std::string, double>& baseline) {
+	std::map<std::string, double>::const_iterator it;
+	bool success = true;
+
+	for (unsigned i = 0; i < results.size(); i++) {
+		it = baseline.find(results[i].name);
+		if (it == baseline.end()) {
+			fprintf(stderr, "%-36s not in baseline\n", results[i].name.c_str());
+			continue;
+		} // if
+		if (results[i].medianNsPerOp > it->second * (1 + tolerance)) {
+			fprintf(stderr, "%-36s REGRESSION: %.2f ns/op, baseline %.2f ns/op\n",
+					results[i].name.c_str(), results[i].medianNsPerOp, it->second);
+			success = false;
+		} // if
+	} // for
+	return success;
+} // compareWithBaseline
@@ -0,0 +1,117 @@
+/*---------------------------------------------------------------------------*\
+ *           interactive networked Virtual Reality system (inVRs)            *
+ *                                                                           *
+ *    Copyright (C) 2005-2009 by the Johannes Kepler University, Linz        *
+ *                                                                           *
+ *                            www.inVRs.org                                  *
+ *                                                                           *
+ *              contact: canthes@inVRs.org, rlander@inVRs.org                *
+\*---------------------------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*\
+ *                                License                                    *
+ *                                                                           *
+ * This library is free software; you can redistribute it and/or modify it   *
+ * under the terms of the GNU Library General Public License as published    *
+ * by the Free Software Foundation, version 2.                               *
+ *                                                                           *
+ * This library is distributed in the hope that it will be useful, but       *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of                *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU         *
+ * Library General Public License for more details.                          *
+ *                                                                           *
+ * You should have received a copy of the GNU Library General Public         *
+ * License along with this library; if not, write to the Free Software       *
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.                 *
+\*---------------------------------------------------------------------------*/
+
+#ifndef _BENCHMARKSUITE_H
+#define _BENCHMARKSUITE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ * A single microbenchmark of the inVRsBenchmarks suite.
+ * The suite calls setUp() once, then run() once for warming up and then
+ * repeatedly for the measurement, and finally tearDown(). Every call of run()
+ * has to execute the same number of operations, the results are reported as
+ * time per operation and operations per second. A benchmark can report
+ * additional values (e.g. a latency percentile) with setMetric().
+ */
+class Benchmark {
+public:
+	/** Constructor.
+	 * @param name Unique name of the benchmark (e.g. NetMessage.putGet)
+	 * @param operations Number of operations executed by each run() call
+	 */
+	Benchmark(std::string name, unsigned operations);
+	virtual ~Benchmark();
+
+	virtual void setUp();
+	virtual void run() = 0;
+	virtual void tearDown();
+
+	std::string getName() const;
+	unsigned getOperations() const;
+	const std::map<std::string, double>& getMetrics() const;
+
+protected:
+	/** Sets an additional result of the benchmark, the value of the last
+	 * run() call is reported.
+	 */
+	void setMetric(std::string metricName, double value);
+
+	std::string name;
+	unsigned operations;
+	std::map<std::string, double> metrics;
+}; // Benchmark
+
+/******************************************************************************
+ * Runs the registered benchmarks and writes the results as JSON, so that a
+ * CI job can compare them against a stored baseline.
+ *
+ * Command line options of the inVRsBenchmarks executable:
+ *   --output FILE      write the results as JSON into FILE (default: stdout)
+ *   --baseline FILE    compare the results with a previous JSON output, the
+ *                      exit code is 1 if a benchmark got slower
+ *   --tolerance X      allowed slowdown against the baseline (default 0.25)
+ *   --repetitions N    number of measured runs (default 7)
+ *   --filter TEXT      only run benchmarks whose name contains TEXT
+ */
+class BenchmarkSuite {
+public:
+	BenchmarkSuite();
+	~BenchmarkSuite();
+
+	/** Adds a benchmark, the suite takes the ownership.
+	 */
+	void add(Benchmark* benchmark);
+
+	/** Parses the command line, runs the benchmarks and writes the results.
+	 * @return exit code for main()
+	 */
+	int main(int argc, char** argv);
+
+private:
+	struct Result {
+		std::string name;
+		unsigned operations;
+		double medianNsPerOp;
+		double minNsPerOp;
+		std::map<std::string, double> metrics;
+	}; // Result
+
+	Result runBenchmark(Benchmark* benchmark);
+	bool writeResults(const std::vector<Result>& results, std::string fileName);
+	bool readBaseline(std::string fileName, std::map<std::string, double>& dst);
+	bool compareWithBaseline(const std::vector<Result>& results,
+			const std::map<std::string, double>& baseline);
+
+	std::vector<Benchmark*> benchmarks;
+	unsigned repetitions;
+	double tolerance;
+}; // BenchmarkSuite
+
+#endif // _BENCHMARKSUITE_H
@@ -0,0 +1,95 @@
+// compile DEBUG messages out of the PRINTD macros for this benchmark:
+#define INVRS_PRINTD_MIN_SEVERITY 1
+
+#undef INVRSSYSTEMCORE_EXPORTS
+#include <OpenSG/OSGConfig.h>
+#if OSG_MAJOR_VERSION >= 2
+#include <OpenSG/OSGBaseInitFunctions.h>
+#else
+#include <OpenSG/OSGBaseFunctions.h>
+#endif
+#include <inVRs/SystemCore/DebugOutput.h>
+#include <inVRs/SystemCore/Timer.h>
+
+#include <stdio.h>
+
+OSG_USING_NAMESPACE
+
+static const int ITERATIONS = 1000000;
+
+static void report(const char* name, double start, double end) {
+	printf("%-40s %10.1f ns/call\n", name, (end - start) * 1e9 / ITERATIONS);
+} // report
+
+/** Microbenchmark for the per-call overhead of printd.
+ * All messages are written to the null device, so only the cost on the
+ * calling thread is measured.
+ */
+int main(int argc, char **argv) {
+	// needed for printd locks and the writer thread:
+	osgInit(argc, argv);
+
+	int i;
+	double start;
+#ifdef WIN32
+	FILE* nullStream = fopen("NUL", "w");
+#else
+	FILE* nullStream = fopen("/dev/null", "w");
+#endif
+	if (!nullStream) {
+		fprintf(stderr, "Unable to open null device!\n");
+		return 1;
+	} // if
+	printd_init(nullStream);
+	printd_severity(INFO);
+
+	start = inVRsUtilities::Timer::getSystemTime();
+	for (i = 0; i < ITERATIONS; i++)
+		PRINTD_D("compiled out message %i\n", i);
+	report("PRINTD_D (compiled out)", start, inVRsUtilities::Timer::getSystemTime());
+
+	start = inVRsUtilities::Timer::getSystemTime();
+	for (i = 0; i < ITERATIONS; i++)
+		printd(DEBUG, "suppressed message %i\n", i);
+	report("printd DEBUG (suppressed by severity)", start, inVRsUtilities::Timer::getSystemTime());
+
+	start = inVRsUtilities::Timer::getSystemTime();
+	for (i = 0; i < ITERATIONS; i++)
+		printd(INFO, "synchronous message %i\n", i);
+	report("printd INFO (synchronous)", start, inVRsUtilities::Timer::getSystemTime());
+
+	start = inVRsUtilities::Timer::getSystemTime();
+	for (i = 0; i < ITERATIONS; i++)
+		PRINTD_I("synchronous message %i\n", i);
+	report("PRINTD_I (synchronous)", start, inVRsUtilities::Timer::getSystemTime());
+
+	printd_rate_limit(100);
+	start = inVRsUtilities::Timer::getSystemTime();
+	for (i = 0; i < ITERATIONS; i++)
+		printd(INFO, "rate limited message %i\n", i);
+	report("printd INFO (synchronous, rate limited)", start, inVRsUtilities::Timer::getSystemTime());
+	printd_rate_limit(0);
+
+	printd_async(true);
+	start = inVRsUtilities::Timer::getSystemTime();
+	for (i = 0; i < ITERATIONS; i++)
+		printd(INFO, "asynchronous message %i\n", i);
+	report("printd INFO (asynchronous)", start, inVRsUtilities::Timer::getSystemTime());
+
+	start = inVRsUtilities::Timer::getSystemTime();
+	for (i = 0; i < ITERATIONS; i++)
+		PRINTD_I("asynchronous message %i\n", i);
+	report("PRINTD_I (asynchronous)", start, inVRsUtilities::Timer::getSystemTime());
+
+	printd_rate_limit(100);
+	start = inVRsUtilities::Timer::getSystemTime();
+	for (i = 0; i < ITERATIONS; i++)
+		printd(INFO, "rate limited message %i\n", i);
+	report("printd INFO (asynchronous, rate limited)", start, inVRsUtilities::Timer::getSystemTime());
+
+	printd_finalize();
+	fclose(nullStream);
+
+	osgExit();
+	return 0;
+}
@@ -0,0 +1,114 @@
+#undef INVRSSYSTEMCORE_EXPORTS
+#include <OpenSG/OSGConfig.h>
+#if OSG_MAJOR_VERSION >= 2
+#include <OpenSG/OSGBaseInitFunctions.h>
+#else
+#include <OpenSG/OSGBaseFunctions.h>
+#endif
+#include <inVRs/SystemCore/SystemCore.h>
+#include <inVRs/SystemCore/DebugOutput.h>
+#include <inVRs/SystemCore/Timer.h>
+#include <inVRs/SystemCore/UserDatabase/UserDatabase.h>
+#include <inVRs/SystemCore/TransformationManager/TransformationManager.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+OSG_USING_NAMESPACE
+
+static const int LOOKUPS = 1000000;
+static const unsigned FIRST_USER_ID = 1000;
+
+/** Stress benchmark for routing incoming transformations to their pipe.
+ * For N remote users with M network pipes each, the lookup of the user by
+ * id and of the pipe by id (as done per message in
+ * TransformationManager::handleNetworkMessages()) is compared with a linear
+ * search through all pipes as it was done before the hash indices.
+ */
+int main(int argc, char **argv) {
+	static const unsigned userCounts[] = {1, 8, 32, 128};
+	static const unsigned pipeCounts[] = {4, 16, 64};
+
+	osgInit(argc, argv);
+	printd_severity(WARNING);
+	SystemCore::init();
+
+	printf("%6s %6s %22s %22s\n", "users", "pipes", "hash index [ns/msg]", "linear scan [ns/msg]");
+	for (unsigned u = 0; u < sizeof(userCounts) / sizeof(userCounts[0]); u++) {
+		for (unsigned p = 0; p < sizeof(pipeCounts) / sizeof(pipeCounts[0]); p++) {
+			unsigned numUsers = userCounts[u];
+			unsigned numPipes = pipeCounts[p];
+			std::vector<User*> users;
+			std::vector<TransformationPipe*> allPipes;
+			unsigned i, j;
+
+			for (i = 0; i < numUsers; i++) {
+				UserSetupData setupData;
+				setupData.id = FIRST_USER_ID + i;
+				User* user = new User(&setupData);
+				UserDatabase::addRemoteUser(user);
+				users.push_back(user);
+				for (j = 0; j < numPipes; j++) {
+					allPipes.push_back(TransformationManager::openPipe(0, 1, 1, 1, j % 16, j / 16,
+							0, true, user));
+				} // for
+			} // for
+
+			srand(42);
+			std::vector<unsigned> userIds(LOOKUPS);
+			std::vector<uint64_t> pipeIds(LOOKUPS);
+			for (i = 0; i < (unsigned)LOOKUPS; i++) {
+				unsigned pipe = rand() % numPipes;
+				userIds[i] = FIRST_USER_ID + rand() % numUsers;
+				pipeIds[i] = TransformationManager::packPipeId(0, 1, 1, 1, pipe % 16, pipe / 16, true);
+			} // for
+
+			unsigned found = 0;
+			double start = inVRsUtilities::Timer::getMonotonicTime();
+			for (i = 0; i < (unsigned)LOOKUPS; i++) {
+				unsigned srcId, dstId, pipeType, objectClass, objectType, objectId;
+				bool fromNetwork;
+				User* user = UserDatabase::getUserById(userIds[i]);
+				TransformationManager::unpackPipeId(pipeIds[i], &srcId, &dstId, &pipeType,
+						&objectClass, &objectType, &objectId, &fromNetwork);
+				if (TransformationManager::getPipe(srcId, dstId, pipeType, objectClass, objectType,
+						objectId, 0, fromNetwork, user))
+					found++;
+			} // for
+			double hashTime = inVRsUtilities::Timer::getMonotonicTime() - start;
+
+			start = inVRsUtilities::Timer::getMonotonicTime();
+			for (i = 0; i < (unsigned)LOOKUPS; i++) {
+				User* user = NULL;
+				for (j = 0; j < users.size(); j++) {
+					if (users[j]->getId() == userIds[i]) {
+						user = users[j];
+						break;
+					} // if
+				} // for
+				for (j = 0; j < allPipes.size(); j++) {
+					if (allPipes[j]->getPipeId() == pipeIds[i] && allPipes[j]->getOwner() == user) {
+						found++;
+						break;
+					} // if
+				} // for
+			} // for
+			double linearTime = inVRsUtilities::Timer::getMonotonicTime() - start;
+
+			if (found != 2 * (unsigned)LOOKUPS)
+				fprintf(stderr, "Only %u of %u pipes found!\n", found, 2 * LOOKUPS);
+			printf("%6u %6u %22.1f %22.1f\n", numUsers, numPipes, hashTime * 1e9 / LOOKUPS,
+					linearTime * 1e9 / LOOKUPS);
+
+			for (i = 0; i < allPipes.size(); i++)
+				TransformationManager::closePipe(allPipes[i]);
+			for (i = 0; i < users.size(); i++)
+				UserDatabase::removeRemoteUser(users[i]->getId());
+		} // for
+	} // for
+
+	SystemCore::cleanup();
+	osgExit();
+	return 0;
+}
@@ -0,0 +1,600 @@
+// compile DEBUG messages out of the PRINTD macros for this benchmark:
+#define INVRS_PRINTD_MIN_SEVERITY 1
+
+#undef INVRSSYSTEMCORE_EXPORTS
+#include <OpenSG/OSGConfig.h>
+#if OSG_MAJOR_VERSION >= 2
+#include <OpenSG/OSGBaseInitFunctions.h>
+#else
+#include <OpenSG/OSGBaseFunctions.h>
+#endif
+#include <OpenSG/OSGThread.h>
+#include <OpenSG/OSGThreadManager.h>
+
+#include <inVRs/SystemCore/SystemCore.h>
+#include <inVRs/SystemCore/DebugOutput.h>
+#include <inVRs/SystemCore/IdPool.h>
+#include <inVRs/SystemCore/NetMessage.h>
+#include <inVRs/SystemCore/SyncPipe.h>
+#include <inVRs/SystemCore/XmlBinaryCache.h>
+#include <inVRs/SystemCore/XmlDocument.h>
+#include <inVRs/SystemCore/EventManager/Event.h>
+#include <inVRs/SystemCore/EventManager/EventBatcher.h>
+#include <inVRs/SystemCore/EventManager/EventFactory.h>
+#include <inVRs/SystemCore/TransformationManager/TransformationPipe.h>
+#include <inVRs/SystemCore/TransformationManager/TrackingOffsetModifier.h>
+#include <inVRs/SystemCore/UserDatabase/User.h>
+
+#include "BenchmarkSuite.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <sstream>
+#include <vector>
+
+OSG_USING_NAMESPACE
+
+static TransformationData createTransformation(unsigned seed) {
+	TransformationData result = identityTransformation();
+	result.position = gmtl::Vec3f(seed * 0.25f, 1.7f, seed * -0.5f);
+	gmtl::set(result.orientation, gmtl::AxisAnglef(seed * 0.01f, 0, 1, 0));
+	return result;
+} // createTransformation
+
+/******************************************************************************
+ * Writes and reads the primitive types of a NetMessage.
+ */
+class NetMessagePutGetBenchmark : public Benchmark {
+public:
+	NetMessagePutGetBenchmark() :
+		Benchmark("NetMessage.putGet", 10000) {
+	}
+
+	virtual void run() {
+		uint32_t intValue;
+		float floatValue;
+		std::string stringValue;
+		for (unsigned i = 0; i < operations; i++) {
+			message.clear();
+			message.putUInt32(i);
+			message.putReal32(i * 0.5f);
+			message.putString("benchmark");
+			message.reset();
+			message.getUInt32(intValue);
+			message.getReal32(floatValue);
+			message.getString(stringValue);
+		} // for
+	} // run
+
+private:
+	NetMessage message;
+}; // NetMessagePutGetBenchmark
+
+/******************************************************************************
+ * Encodes and decodes TransformationData as done for every transformation
+ * sent by the TransformationManager.
+ */
+class NetMessageTransformationBenchmark : public Benchmark {
+public:
+	NetMessageTransformationBenchmark() :
+		Benchmark("NetMessage.transformation", 10000) {
+	}
+
+	virtual void setUp() {
+		transformation = createTransformation(3);
+	} // setUp
+
+	virtual void run() {
+		for (unsigned i = 0; i < operations; i++) {
+			message.clear();
+			addTransformationToBinaryMsg(&transformation, &message);
+			message.reset();
+			transformation = readTransformationFrom(&message);
+		} // for
+	} // run
+
+private:
+	NetMessage message;
+	TransformationData transformation;
+}; // NetMessageTransformationBenchmark
+
+/******************************************************************************
+ * Producer threads push NetMessages into a SyncPipe while the main thread
+ * drains it, as the network receive threads and the EventManager do.
+ */
+class SyncPipeContentionBenchmark : public Benchmark {
+public:
+	SyncPipeContentionBenchmark() :
+		Benchmark("SyncPipe.contention", NUM_PRODUCERS * MESSAGES_PER_PRODUCER) {
+	}
+
+	virtual void setUp() {
+		messages.resize(operations);
+	} // setUp
+
+	virtual void run() {
+#if OSG_MAJOR_VERSION >= 2
+		ThreadRefPtr threads[NUM_PRODUCERS];
+#else //OpenSG1:
+		Thread* threads[NUM_PRODUCERS];
+#endif
+		ProducerData producers[NUM_PRODUCERS];
+		std::deque<NetMessage*>* drained;
+		unsigned i, received = 0;
+
+		for (i = 0; i < NUM_PRODUCERS; i++) {
+			producers[i].pipe = &pipe;
+			producers[i].messages = &messages[i * MESSAGES_PER_PRODUCER];
+			std::stringstream threadName;
+			threadName << "SyncPipeProducer" << i;
+#if OSG_MAJOR_VERSION >= 2
+			threads[i] = dynamic_pointer_cast<Thread> (ThreadManager::the()->getThread(
+					threadName.str().c_str(), false));
+#else //OpenSG1:
+			threads[i] = dynamic_cast<Thread*> (ThreadManager::the()->getThread(
+					threadName.str().c_str()));
+#endif
+			threads[i]->runFunction(produce, 0, &producers[i]);
+		} // for
+
+		while (received < operations) {
+			drained = pipe.makeCopyAndClear();
+			received += drained->size();
+			delete drained;
+		} // while
+
+		for (i = 0; i < NUM_PRODUCERS; i++)
+			Thread::join(threads[i]);
+	} // run
+
+private:
+	static const unsigned NUM_PRODUCERS = 3;
+	static const unsigned MESSAGES_PER_PRODUCER = 20000;
+
+	struct ProducerData {
+		SyncPipe<NetMessage*>* pipe;
+		NetMessage* messages;
+	}; // ProducerData
+
+	static void produce(void* arg) {
+		ProducerData* data = (ProducerData*)arg;
+		for (unsigned i = 0; i < MESSAGES_PER_PRODUCER; i++)
+			data->pipe->push_back(&data->messages[i]);
+	} // produce
+
+	SyncPipe<NetMessage*> pipe;
+	std::vector<NetMessage> messages;
+}; // SyncPipeContentionBenchmark
+
+/******************************************************************************
+ * Pushes tracking data into a TransformationPipe and executes it with the
+ * modifier chain of a typical head/hand pipe.
+ */
+class TransformationPipeBenchmark : public Benchmark {
+public:
+	TransformationPipeBenchmark() :
+		Benchmark("TransformationPipe.execute", 10000),
+		user(NULL),
+		pipe(NULL) {
+	}
+
+	virtual void setUp() {
+		UserSetupData setupData;
+		ArgumentVector handArguments;
+
+		setupData.id = 1000;
+		setupData.cursorModelArguments = NULL;
+		user = new User(&setupData);
+		user->setSensorTransformation(0, createTransformation(1));
+		user->setSensorTransformation(1, createTransformation(2));
+
+		handArguments.push_back("useHeadSensor", false);
+		handArguments.push_back("removeYAxis", true);
+		pipe = new TransformationPipe(0, user);
+		pipe->addStage(factory.create(NULL, NULL));
+		pipe->addStage(factory.create(&handArguments, NULL));
+	} // setUp
+
+	virtual void run() {
+		for (unsigned i = 0; i < operations; i++) {
+			TransformationData data = createTransformation(i);
+			pipe->push_back(data);
+			result = pipe->execute();
+		} // for
+	} // run
+
+	virtual void tearDown() {
+		delete pipe;
+		delete user;
+		pipe = NULL;
+		user = NULL;
+	} // tearDown
+
+private:
+	TrackingOffsetModifierFactory factory;
+	User* user;
+	TransformationPipe* pipe;
+	TransformationData result;
+}; // TransformationPipeBenchmark
+
+/******************************************************************************
+ * Event with a typical payload (an entity id and a transformation).
+ */
+class BenchmarkEvent : public Event {
+public:
+	BenchmarkEvent() :
+		entityId(0) {
+		evt_eventName = "BenchmarkEvent";
+		evt_eventId = 1;
+		evt_userId = 0;
+	}
+
+	BenchmarkEvent(unsigned entityId, TransformationData transformation) :
+		entityId(entityId),
+		transformation(transformation) {
+		evt_eventName = "BenchmarkEvent";
+		evt_eventId = 1;
+		evt_userId = 0;
+	}
+
+	virtual void encode(NetMessage* message) {
+		message->putUInt32(entityId);
+		addTransformationToBinaryMsg(&transformation, message);
+	} // encode
+
+	virtual void decode(NetMessage* message) {
+		message->getUInt32(entityId);
+		transformation = readTransformationFrom(message);
+	} // decode
+
+	virtual void execute() {
+	} // execute
+
+private:
+	uint32_t entityId;
+	TransformationData transformation;
+}; // BenchmarkEvent
+
+/******************************************************************************
+ * Encodes an Event and decodes it again via the factory lookup done by
+ * EventManager::decode().
+ */
+class EventEncodeDecodeBenchmark : public Benchmark {
+public:
+	EventEncodeDecodeBenchmark() :
+		Benchmark("Event.encodeDecode", 10000) {
+	}
+
+	virtual void setUp() {
+		factories[1] = new EventFactory<BenchmarkEvent>;
+		eventNames[1] = "BenchmarkEvent";
+	} // setUp
+
+	virtual void run() {
+		BenchmarkEvent event(17, createTransformation(5));
+		for (unsigned i = 0; i < operations; i++) {
+			NetMessage* message = event.completeEncode();
+			message->reset();
+			delete decode(message);
+			delete message;
+		} // for
+	} // run
+
+	virtual void tearDown() {
+		delete factories[1];
+		factories.clear();
+		eventNames.clear();
+	} // tearDown
+
+private:
+	Event* decode(NetMessage* message) {
+		unsigned eventId;
+		message->getUInt32(eventId);
+		std::string eventName = eventNames[eventId];
+		Event* result = factories[eventId]->create(eventName);
+		result->completeDecode(message, eventName);
+		return result;
+	} // decode
+
+	std::map<unsigned, AbstractEventFactory*> factories;
+	std::map<unsigned, std::string> eventNames;
+}; // EventEncodeDecodeBenchmark
+
+/******************************************************************************
+ * Sends a mix of critical, normal and bulk Events through the EventBatcher of
+ * the EventManager and a simulated network link with limited bandwidth. Every
+ * 200 ms a world state of 2 MB is sent as bulk Events (as done for a joining
+ * user), the critical and normal Events are sent continuously. The time per
+ * operation is the CPU time for encoding, batching and splitting one Event.
+ * The metrics are the 99th percentile of the simulated time from sending an
+ * Event until its batch has left the link, which shows whether the bulk
+ * transfer blocks the other Events.
+ */
+class EventMixedLoadBenchmark : public Benchmark {
+public:
+	EventMixedLoadBenchmark() :
+		Benchmark("Event.mixedLoad", TICKS * (CRITICAL_PER_TICK + NORMAL_PER_TICK)
+				+ (TICKS / BULK_INTERVAL) * BULK_EVENTS) {
+	}
+
+	virtual void setUp() {
+		bulkMessage = new NetMessage;
+		bulkMessage->putUInt32(2);
+		for (unsigned i = 0; i < BULK_EVENT_SIZE / 4; i++)
+			bulkMessage->putUInt32(i);
+	} // setUp
+
+	virtual void run() {
+		EventBatcher batcher(16384, 0.005, 65536);
+		BenchmarkEvent event(17, createTransformation(5));
+		std::vector<EventBatcher::Batch> batches;
+		std::vector<NetMessage*> events;
+		std::deque<LinkEntry> link;
+		std::vector<double> criticalLatency, normalLatency;
+		LinkEntry entry;
+		NetMessage* message;
+		double now, linkBudget, finishTime;
+		unsigned tick, i, j;
+
+		for (tick = 0; tick < TICKS; tick++) {
+			now = tick * TICK;
+			if (tick % BULK_INTERVAL == 0) {
+				for (i = 0; i < BULK_EVENTS; i++)
+					batcher.add(bulkMessage, 2, Event::PRIORITY_BULK, now);
+			} // if
+			for (i = 0; i < CRITICAL_PER_TICK + NORMAL_PER_TICK; i++) {
+				message = event.completeEncode();
+				batcher.add(message, 0, i < CRITICAL_PER_TICK ? Event::PRIORITY_CRITICAL
+						: Event::PRIORITY_NORMAL, now);
+				delete message;
+			} // for
+
+			// sending: the link gets the batches, the receiver splits them
+			batcher.getDueBatches(now, false, batches);
+			for (i = 0; i < batches.size(); i++) {
+				entry.batch = batches[i];
+				entry.remainingBytes = batches[i].msg->getBufferSize();
+				link.push_back(entry);
+				EventBatcher::split(batches[i].msg, events);
+				for (j = 0; j < events.size(); j++)
+					delete events[j];
+				events.clear();
+			} // for
+			batches.clear();
+
+			// transmission of the link until the next tick
+			linkBudget = BANDWIDTH * TICK;
+			while (!link.empty() && link.front().remainingBytes <= linkBudget) {
+				linkBudget -= link.front().remainingBytes;
+				finishTime = now + TICK - linkBudget / BANDWIDTH;
+				if (link.front().batch.priority == Event::PRIORITY_CRITICAL)
+					criticalLatency.insert(criticalLatency.end(),
+							link.front().batch.numberOfEvents,
+							finishTime - link.front().batch.firstEventTime);
+				else if (link.front().batch.priority == Event::PRIORITY_NORMAL)
+					normalLatency.insert(normalLatency.end(), link.front().batch.numberOfEvents,
+							finishTime - link.front().batch.firstEventTime);
+				link.pop_front();
+			} // while
+			if (!link.empty())
+				link.front().remainingBytes -= linkBudget;
+		} // for
+
+		setMetric("criticalP99LatencyMs", 1000 * percentile(criticalLatency, 0.99));
+		setMetric("normalP99LatencyMs", 1000 * percentile(normalLatency, 0.99));
+	} // run
+
+	virtual void tearDown() {
+		delete bulkMessage;
+	} // tearDown
+
+private:
+	struct LinkEntry {
+		EventBatcher::Batch batch;
+		double remainingBytes;
+	}; // LinkEntry
+
+	static double percentile(std::vector<double>& values, double fraction) {
+		if (values.empty())
+			return 0;
+		std::vector<double>::iterator it = values.begin() + (unsigned)(fraction
+				* (values.size() - 1));
+		std::nth_element(values.begin(), it, values.end());
+		return *it;
+	} // percentile
+
+	static const unsigned TICKS = 400;
+	static const unsigned CRITICAL_PER_TICK = 4;
+	static const unsigned NORMAL_PER_TICK = 10;
+	static const unsigned BULK_INTERVAL = 200;
+	static const unsigned BULK_EVENTS = 256;
+	static const unsigned BULK_EVENT_SIZE = 8192;
+	static const double TICK;
+	static const double BANDWIDTH;
+
+	NetMessage* bulkMessage;
+}; // EventMixedLoadBenchmark
+
+const double EventMixedLoadBenchmark::TICK = 0.001;
+// bytes per second, about a 1 GBit/s network
+const double EventMixedLoadBenchmark::BANDWIDTH = 100e6;
+
+/******************************************************************************
+ * Entity churn: half of the pool is in use, then entities are destroyed and
+ * created in random order (one allocEntry() or allocEntryAt() per
+ * freeEntry()), as it happens for the entity ids of an environment.
+ */
+class IdPoolChurnBenchmark : public Benchmark {
+public:
+	/** Constructor.
+	 * @param range Number of ids in the pool
+	 * @param useAllocAt recreate entities with their old id (e.g. received
+	 *        from the network) instead of allocating a new one
+	 */
+	IdPoolChurnBenchmark(unsigned range, bool useAllocAt) :
+		Benchmark(createName(range, useAllocAt), 100000),
+		range(range),
+		useAllocAt(useAllocAt),
+		pool(NULL) {
+	}
+
+	virtual void setUp() {
+		pool = new IdPool(0, range - 1);
+		srand(42);
+		for (unsigned i = 0; i < range / 2; i++)
+			live.push_back(pool->allocEntry());
+	} // setUp
+
+	virtual void run() {
+		for (unsigned i = 0; i < operations; i++) {
+			unsigned index = rand() % live.size();
+			pool->freeEntry(live[index]);
+			if (useAllocAt)
+				pool->allocEntryAt(live[index]);
+			else
+				live[index] = pool->allocEntry();
+		} // for
+	} // run
+
+	virtual void tearDown() {
+		delete pool;
+		pool = NULL;
+		live.clear();
+	} // tearDown
+
+private:
+	static std::string createName(unsigned range, bool useAllocAt) {
+		std::stringstream name;
+		name << (useAllocAt ? "IdPool.churnAllocAt." : "IdPool.churn.") << range;
+		return name.str();
+	} // createName
+
+	unsigned range;
+	bool useAllocAt;
+	IdPool* pool;
+	std::vector<unsigned> live;
+}; // IdPoolChurnBenchmark
+
+/******************************************************************************
+ * Loads a world database like configuration file, either with the XML parser
+ * (cold start) or from the XmlBinaryCache (warm start). The sizes of the XML
+ * and the cache file are reported as metrics.
+ */
+class XmlDocumentLoadBenchmark : public Benchmark {
+public:
+	/** Constructor.
+	 * @param entities Number of entities in the configuration file
+	 * @param useCache read the document from the XmlBinaryCache
+	 */
+	XmlDocumentLoadBenchmark(int entities, bool useCache) :
+		Benchmark(createName(entities, useCache), 5),
+		entities(entities),
+		useCache(useCache) {
+	}
+
+	virtual void setUp() {
+		FILE* file = fopen(XML_FILE, "w");
+		fprintf(file, "<?xml version=\"1.0\"?>\n"
+				"<!DOCTYPE environment SYSTEM \"http://dtd.inVRs.org/environment_v1.0a4.dtd\">\n"
+				"<environment version=\"1.0a4\">\n");
+		for (int i = 0; i < entities; i++) {
+			fprintf(file, "  <entity typeId=\"%i\" id=\"%i\" name=\"entity_%i\">\n"
+					"    <transformation>\n"
+					"      <translation x=\"%i.5\" y=\"0\" z=\"%i.25\"/>\n"
+					"      <rotation x=\"0\" y=\"1\" z=\"0\" angleDeg=\"%i\"/>\n"
+					"      <scale x=\"1\" y=\"1\" z=\"1\"/>\n"
+					"    </transformation>\n"
+					"    <arguments>\n"
+					"      <arg key=\"description\" type=\"string\" value=\"generated\"/>\n"
+					"    </arguments>\n"
+					"  </entity>\n", i % 16, i, i, i % 100, i / 100, i % 360);
+		} // for
+		fprintf(file, "</environment>\n");
+		fclose(file);
+
+		XmlDocument* document = XmlDocument::loadXmlDocument(XML_FILE);
+		XmlBinaryCache::write("", XML_FILE, "benchmark", document);
+		delete document;
+		setMetric("xmlBytes", getFileSize(XML_FILE));
+		setMetric("cacheBytes", getFileSize(getCacheFileName()));
+	} // setUp
+
+	virtual void run() {
+		for (unsigned i = 0; i < operations; i++) {
+			if (useCache)
+				delete XmlBinaryCache::read("", XML_FILE, "benchmark");
+			else
+				delete XmlDocument::loadXmlDocument(XML_FILE);
+		} // for
+	} // run
+
+	virtual void tearDown() {
+		remove(getCacheFileName().c_str());
+		remove(XML_FILE);
+	} // tearDown
+
+private:
+	static std::string createName(int entities, bool useCache) {
+		std::stringstream name;
+		name << (useCache ? "XmlBinaryCache.read." : "XmlDocument.load.") << entities;
+		return name.str();
+	} // createName
+
+	static std::string getCacheFileName() {
+		return XmlBinaryCache::getCacheFileName("", XML_FILE, "benchmark");
+	} // getCacheFileName
+
+	static double getFileSize(std::string fileName) {
+		long size = 0;
+		FILE* file = fopen(fileName.c_str(), "rb");
+		if (file) {
+			fseek(file, 0, SEEK_END);
+			size = ftell(file);
+			fclose(file);
+		} // if
+		return (double)size;
+	} // getFileSize
+
+	int entities;
+	bool useCache;
+	static const char* XML_FILE;
+}; // XmlDocumentLoadBenchmark
+
+const char* XmlDocumentLoadBenchmark::XML_FILE = "inVRsBenchmarks.xml";
+
+/** Repeatable microbenchmarks of the SystemCore hot paths. The results are
+ * written as JSON and can be compared against a stored baseline, see
+ * BenchmarkSuite for the command line options. None of the benchmarks needs
+ * a display or a network connection.
+ */
+int main(int argc, char **argv) {
+	BenchmarkSuite suite;
+	int result;
+
+	osgInit(argc, argv);
+	printd_severity(WARNING);
+	SystemCore::init();
+
+	suite.add(new NetMessagePutGetBenchmark);
+	suite.add(new NetMessageTransformationBenchmark);
+	suite.add(new SyncPipeContentionBenchmark);
+	suite.add(new TransformationPipeBenchmark);
+	suite.add(new EventEncodeDecodeBenchmark);
+	suite.add(new EventMixedLoadBenchmark);
+	suite.add(new IdPoolChurnBenchmark(4096, false));
+	suite.add(new IdPoolChurnBenchmark(65536, false));
+	suite.add(new IdPoolChurnBenchmark(1 << 20, false));
+	suite.add(new IdPoolChurnBenchmark(65536, true));
+	suite.add(new XmlDocumentLoadBenchmark(2000, false));
+	suite.add(new XmlDocumentLoadBenchmark(2000, true));
+	suite.add(new XmlDocumentLoadBenchmark(10000, false));
+	suite.add(new XmlDocumentLoadBenchmark(10000, true));
+	result = suite.main(argc, argv);
+
+	SystemCore::cleanup();
+	osgExit();
+	return result;
+}
@@ -0,0 +1,79 @@
+#include <iostream>
+#include <stdexcept>
+#include <typeinfo>
+#include <math.h>
+
+#undef INVRSSYSTEMCORE_EXPORTS
+#include "inVRs/SystemCore/TransformationManager/DeadReckoningModifier.h"
+
+#undef NDEBUG
+#include <cassert>
+
+#define test_bool_true(x) try { \
+	if ( !(x) ) \
+	{ \
+		std::cout << "Test condition ``" # x "'' failed!" <<std::endl; \
+		failed=true; \
+	} \
+} catch (std::exception &e ) \
+{ \
+	std::cout << "Exception " << typeid(e).name() << " during test ``" # x "'': " << e.what() << std::endl; \
+	failed=true;\
+}
+
+static TransformationData pose(float x, float angle)
+{
+	TransformationData result = identityTransformation();
+	result.position[0] = x;
+	// rotation around the y-axis
+	result.orientation = gmtl::Quatf(0, sinf(angle / 2), 0, cosf(angle / 2));
+	return result;
+}
+
+static bool near(float a, float b)
+{
+	return fabs(a - b) < 1e-4f;
+}
+
+int main()
+{
+	bool failed=false;
+	TransformationData data;
+	DeadReckoningModel model;
+
+	test_bool_true ( !model.hasSample() );
+
+	// a single sample is held
+	model.addSample(pose(1, 0), 10.0);
+	model.predict(11.0, 1.0, data);
+	test_bool_true ( model.hasSample() );
+	test_bool_true ( near(data.position[0], 1) );
+
+	// constant velocity of 2 units and 0.5 radians per second
+	model.addSample(pose(2, 0.25f), 10.5);
+	model.predict(10.75, 1.0, data);
+	test_bool_true ( near(data.position[0], 2.5f) );
+	test_bool_true ( near(DeadReckoningModel::getOrientationError(data, pose(0, 0.375f)), 0) );
+
+	// the extrapolation is limited
+	model.predict(20.0, 0.5, data);
+	test_bool_true ( near(data.position[0], 3) );
+	test_bool_true ( near(DeadReckoningModel::getOrientationError(data, pose(0, 0.5f)), 0) );
+
+	// times before the last sample return the sample
+	model.predict(5.0, 1.0, data);
+	test_bool_true ( near(data.position[0], 2) );
+
+	// samples closer than 1ms replace the last one but keep the velocity
+	model.addSample(pose(2.2f, 0.25f), 10.5001);
+	model.predict(11.0, 1.0, data);
+	test_bool_true ( near(data.position[0], 3.2f) );
+
+	test_bool_true ( near(DeadReckoningModel::getPositionError(pose(1, 0), pose(4, 0)), 3) );
+	test_bool_true ( near(DeadReckoningModel::getOrientationError(pose(0, 0.1f), pose(0, -0.2f)), 0.3f) );
+
+	model.reset();
+	test_bool_true ( !model.hasSample() );
+
+	return (failed) ? 1 : 0;
+}
@@ -0,0 +1,213 @@
+#include <iostream>
+#include <stdexcept>
+#include <typeinfo>
+#include <vector>
+
+#undef INVRSSYSTEMCORE_EXPORTS
+#include "inVRs/SystemCore/EventManager/EventBatcher.h"
+
+#undef NDEBUG
+#include <cassert>
+
+#define test_bool_true(x) try { \
+	if ( !(x) ) \
+	{ \
+		std::cout << "Test condition ``" # x "'' failed!" <<std::endl; \
+		failed=true; \
+	} \
+} catch (std::exception &e ) \
+{ \
+	std::cout << "Exception " << typeid(e).name() << " during test ``" # x "'': " << e.what() << std::endl; \
+	failed=true;\
+}
+
+// message in the layout of Event::completeEncode(): event id, sequence
+// number and a payload of the given size
+static NetMessage* encodedEvent(unsigned eventId, unsigned sequenceNumber, unsigned payload)
+{
+	NetMessage* msg = new NetMessage;
+	unsigned i;
+	msg->putUInt32(eventId);
+	msg->putUInt32(sequenceNumber);
+	for (i = 0; i < payload; i++)
+		msg->putUInt8(i & 0xFF);
+	return msg;
+}
+
+static void add(EventBatcher& batcher, unsigned sequenceNumber, unsigned destination,
+		Event::PRIORITY priority, double time, unsigned payload = 16)
+{
+	NetMessage* msg = encodedEvent(100 + priority, sequenceNumber, payload);
+	batcher.add(msg, destination, priority, time);
+	delete msg;
+}
+
+// splits the batch like the receiving EventManager, the batch is deleted
+static std::vector<unsigned> sequenceNumbers(const EventBatcher::Batch& batch)
+{
+	std::vector<NetMessage*> events;
+	std::vector<unsigned> result;
+	uint32_t eventId, sequenceNumber;
+	unsigned i;
+
+	EventBatcher::split(batch.msg, events);
+	for (i = 0; i < events.size(); i++) {
+		events[i]->getUInt32(eventId);
+		events[i]->getUInt32(sequenceNumber);
+		result.push_back(sequenceNumber);
+		delete events[i];
+	}
+	return result;
+}
+
+int main()
+{
+	bool failed=false;
+	std::vector<EventBatcher::Batch> batches;
+	std::vector<unsigned> numbers;
+	unsigned i;
+
+	{
+		// small Events are packed, the last batch waits for the delay
+		EventBatcher batcher(16384, 0.005, 65536);
+		for (i = 0; i < 10; i++)
+			add(batcher, i, 0, Event::PRIORITY_NORMAL, 1.0);
+		batcher.getDueBatches(1.004, false, batches);
+		test_bool_true ( batches.empty() );
+		batcher.getDueBatches(1.006, false, batches);
+		test_bool_true ( batches.size() == 1 );
+		test_bool_true ( batches[0].numberOfEvents == 10 );
+		numbers = sequenceNumbers(batches[0]);
+		test_bool_true ( numbers.size() == 10 );
+		for (i = 0; i < numbers.size(); i++)
+			test_bool_true ( numbers[i] == i );
+		test_bool_true ( batcher.isEmpty() );
+		batches.clear();
+	}
+
+	{
+		// a change of the destination or a full batch closes the batch
+		EventBatcher batcher(200, 0.005, 65536);
+		add(batcher, 0, 0, Event::PRIORITY_NORMAL, 1.0);
+		add(batcher, 1, 7, Event::PRIORITY_NORMAL, 1.0);
+		add(batcher, 2, 7, Event::PRIORITY_NORMAL, 1.0, 150);
+		add(batcher, 3, 0, Event::PRIORITY_NORMAL, 1.0);
+		batcher.getDueBatches(1.0, false, batches);
+		test_bool_true ( batches.size() == 3 );
+		test_bool_true ( batches[0].destination == 0 && batches[0].numberOfEvents == 1 );
+		test_bool_true ( batches[1].destination == 7 && batches[1].numberOfEvents == 1 );
+		test_bool_true ( batches[2].destination == 7 && batches[2].numberOfEvents == 1 );
+		for (i = 0; i < batches.size(); i++)
+			test_bool_true ( sequenceNumbers(batches[i])[0] == i );
+		batches.clear();
+		batcher.getDueBatches(1.0, true, batches);
+		test_bool_true ( batches.size() == 1 );
+		test_bool_true ( sequenceNumbers(batches[0])[0] == 3 );
+		batches.clear();
+	}
+
+	{
+		// critical Events are not delayed and overtake a large bulk transfer
+		// to another receiver
+		EventBatcher batcher(1024, 0.005, 4096);
+		for (i = 0; i < 100; i++)
+			add(batcher, i, 3, Event::PRIORITY_BULK, 1.0, 1000);
+		add(batcher, 1000, 5, Event::PRIORITY_CRITICAL, 1.001);
+		batcher.getDueBatches(1.001, false, batches);
+		test_bool_true ( batches.size() == 5 );
+		test_bool_true ( batches[0].priority == Event::PRIORITY_CRITICAL );
+		test_bool_true ( sequenceNumbers(batches[0])[0] == 1000 );
+		unsigned bulkBytes = 0;
+		for (i = 1; i < batches.size(); i++) {
+			test_bool_true ( batches[i].priority == Event::PRIORITY_BULK );
+			bulkBytes += batches[i].msg->getBufferSize();
+			test_bool_true ( sequenceNumbers(batches[i])[0] == i - 1 );
+		}
+		test_bool_true ( bulkBytes <= 4096 );
+		batches.clear();
+
+		// the bulk transfer continues in order with the next calls
+		unsigned next = 4;
+		while (!batcher.isEmpty()) {
+			batcher.getDueBatches(1.01, false, batches);
+			test_bool_true ( !batches.empty() );
+			for (i = 0; i < batches.size(); i++)
+				test_bool_true ( sequenceNumbers(batches[i])[0] == next++ );
+			batches.clear();
+		}
+		test_bool_true ( next == 100 );
+	}
+
+	{
+		// a critical Event does not overtake the Events queued before it for
+		// the same receiver, Events for other receivers keep waiting
+		EventBatcher batcher(16384, 0.005, 65536);
+		add(batcher, 0, 4, Event::PRIORITY_NORMAL, 1.0);
+		add(batcher, 1, 9, Event::PRIORITY_NORMAL, 1.0);
+		add(batcher, 2, 4, Event::PRIORITY_BULK, 1.0);
+		add(batcher, 3, 9, Event::PRIORITY_NORMAL, 1.0);
+		add(batcher, 4, 4, Event::PRIORITY_CRITICAL, 1.001);
+		batcher.getDueBatches(1.001, false, batches);
+		numbers.clear();
+		for (i = 0; i < batches.size(); i++) {
+			std::vector<unsigned> batchNumbers = sequenceNumbers(batches[i]);
+			numbers.insert(numbers.end(), batchNumbers.begin(), batchNumbers.end());
+		}
+		test_bool_true ( numbers.size() == 3 && numbers[0] == 0 && numbers[1] == 2
+				&& numbers[2] == 4 );
+		batches.clear();
+		batcher.getDueBatches(1.006, false, batches);
+		test_bool_true ( batches.size() == 1 );
+		numbers = sequenceNumbers(batches[0]);
+		test_bool_true ( numbers.size() == 2 && numbers[0] == 1 && numbers[1] == 3 );
+		test_bool_true ( batcher.isEmpty() );
+		batches.clear();
+
+		// a broadcast reaches the receiver of the critical Event, it is sent
+		// together with the batches queued before it for other receivers
+		add(batcher, 5, 9, Event::PRIORITY_NORMAL, 2.0);
+		add(batcher, 6, 0, Event::PRIORITY_NORMAL, 2.0);
+		add(batcher, 7, 7, Event::PRIORITY_NORMAL, 2.0);
+		add(batcher, 8, 4, Event::PRIORITY_CRITICAL, 2.0);
+		batcher.getDueBatches(2.0, false, batches);
+		test_bool_true ( batches.size() == 3 );
+		test_bool_true ( batches.size() == 3 && sequenceNumbers(batches[0])[0] == 5
+				&& sequenceNumbers(batches[1])[0] == 6 && sequenceNumbers(batches[2])[0] == 8 );
+		batches.clear();
+
+		// a critical broadcast sends everything queued before it
+		add(batcher, 9, 0, Event::PRIORITY_CRITICAL, 2.0);
+		batcher.getDueBatches(2.0, false, batches);
+		test_bool_true ( batches.size() == 2 );
+		test_bool_true ( batches.size() == 2 && sequenceNumbers(batches[0])[0] == 7
+				&& sequenceNumbers(batches[1])[0] == 9 );
+		test_bool_true ( batcher.isEmpty() );
+		batches.clear();
+	}
+
+	{
+		// messages of senders without batching are accepted as single Event
+		std::vector<NetMessage*> events;
+		uint32_t eventId, sequenceNumber;
+		NetMessage* msg = new NetMessage;
+		msg->putUInt8(2); // channel id, consumed by the network
+		msg->putUInt32(42);
+		msg->putUInt32(17);
+		msg->putUInt64(0);
+		msg->getUInt8();
+		EventBatcher::split(msg, events);
+		test_bool_true ( events.size() == 1 );
+		events[0]->getUInt32(eventId);
+		events[0]->getUInt32(sequenceNumber);
+		test_bool_true ( eventId == 42 );
+		test_bool_true ( sequenceNumber == 17 );
+		test_bool_true ( events[0]->getBufferSize() == 16 );
+		delete events[0];
+	}
+
+	if (failed) {
+		std::cout << "FAILED" << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,121 @@
+#include <iostream>
+#include <stdexcept>
+#include <typeinfo>
+#include <set>
+#include <stdlib.h>
+
+#undef INVRSSYSTEMCORE_EXPORTS
+#include "inVRs/SystemCore/IdPool.h"
+#include "inVRs/SystemCore/NetMessage.h"
+
+#undef NDEBUG
+#include <cassert>
+
+#define test_bool_true(x) try { \
+	if ( !(x) ) \
+	{ \
+		std::cout << "Test condition ``" # x "'' failed!" <<std::endl; \
+		failed=true; \
+	} \
+} catch (std::exception &e ) \
+{ \
+	std::cout << "Exception " << typeid(e).name() << " during test ``" # x "'': " << e.what() << std::endl; \
+	failed=true;\
+}
+
+int main()
+{
+	bool failed=false;
+	bool succeeded;
+	unsigned i;
+
+	// entries are handed out in ascending order, freed ones are not reused at once
+	IdPool pool(100, 1099);
+	test_bool_true ( pool.allocEntry() == 100 );
+	test_bool_true ( pool.allocEntry() == 101 );
+	pool.freeEntry(100);
+	test_bool_true ( pool.allocEntry() == 102 );
+	test_bool_true ( pool.allocEntryAt(500) );
+	test_bool_true ( !pool.allocEntryAt(500) );
+	test_bool_true ( !pool.allocEntryAt(99) );
+	test_bool_true ( pool.allocSubPool(10) == NULL );
+
+	// exhaust the pool and wrap around
+	for (i = 0; i < 997; i++)
+		pool.allocEntry(&succeeded);
+	test_bool_true ( succeeded );
+	pool.allocEntry(&succeeded);
+	test_bool_true ( !succeeded );
+	pool.freeEntry(777);
+	test_bool_true ( pool.allocEntry() == 777 );
+
+	// subpools
+	IdPool parent(0, 0xFFFF);
+	IdPool* loadTime = parent.allocSubPool(0, 4096);
+	test_bool_true ( loadTime && loadTime->getMinIdx() == 0 && loadTime->getMaxIdx() == 4095 );
+	test_bool_true ( parent.allocSubPool(4000, 200) == NULL );
+	IdPool* sub1 = parent.allocSubPool(4096);
+	test_bool_true ( sub1 && sub1->getMinIdx() == 4096 );
+	IdPool* sub2 = parent.allocSubPool(10000, 100);
+	test_bool_true ( parent.getUnallocatedSubPoolIdx() == 10100 );
+	test_bool_true ( parent.allocEntry(&succeeded) == 0 && !succeeded );
+	test_bool_true ( parent.freeSubPool(sub1) );
+	// the freed range is reused by the first fitting subpool
+	IdPool* sub3 = parent.allocSubPool(5000);
+	test_bool_true ( sub3 && sub3->getMinIdx() == 4096 );
+	IdPool* sub4 = parent.allocSubPool(4000);
+	test_bool_true ( sub4 && sub4->getMinIdx() == 10100 );
+	test_bool_true ( parent.allocSubPool(0x10000) == NULL );
+
+	// wire form: only the reserved ranges are transmitted
+	NetMessage msg;
+	parent.encodeReservedRanges(&msg);
+	test_bool_true ( msg.getBufferSize() == 4 * (3 + 2 * 2) );
+	IdPool remote(0, 0xFFFF);
+	test_bool_true ( remote.decodeReservedRanges(&msg) );
+	test_bool_true ( remote.getUnallocatedSubPoolIdx() == 14100 );
+	test_bool_true ( remote.allocSubPool(8000, 10) == NULL );
+	IdPool* remoteSub = remote.allocSubPool(100);
+	test_bool_true ( remoteSub && remoteSub->getMinIdx() == 9096 );
+	IdPool other(0, 10);
+	msg.clear();
+	parent.encodeReservedRanges(&msg);
+	test_bool_true ( !other.decodeReservedRanges(&msg) );
+	(void)sub2;
+
+	// random churn compared with a std::set
+	IdPool churn(0, 100000);
+	std::set<unsigned> used;
+	srand(7);
+	for (i = 0; i < 200000; i++) {
+		unsigned id = rand() % 100001;
+		switch (rand() % 3) {
+		case 0:
+			id = churn.allocEntry(&succeeded);
+			if (!succeeded || used.count(id))
+				failed = true;
+			used.insert(id);
+			break;
+		case 1:
+			if (!used.count(id)) {
+				if (!churn.allocEntryAt(id))
+					failed = true;
+				used.insert(id);
+			}
+			break;
+		default:
+			if (used.count(id)) {
+				churn.freeEntry(id);
+				used.erase(id);
+			}
+			break;
+		}
+	}
+	for (std::set<unsigned>::iterator it = used.begin(); it != used.end(); ++it)
+		churn.freeEntry(*it);
+	for (i = 0; i <= 100000; i++)
+		churn.allocEntry(&succeeded);
+	test_bool_true ( succeeded );
+
+	return (failed) ? 1 : 0;
+}
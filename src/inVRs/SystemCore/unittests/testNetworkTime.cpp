@@ -0,0 +1,97 @@
+#include <iostream>
+#include <stdexcept>
+#include <typeinfo>
+#include <math.h>
+
+#undef INVRSSYSTEMCORE_EXPORTS
+#include "inVRs/SystemCore/NetworkTime.h"
+
+#undef NDEBUG
+#include <cassert>
+
+#define test_bool_true(x) try { \
+	if ( !(x) ) \
+	{ \
+		std::cout << "Test condition ``" # x "'' failed!" <<std::endl; \
+		failed=true; \
+	} \
+} catch (std::exception &e ) \
+{ \
+	std::cout << "Exception " << typeid(e).name() << " during test ``" # x "'': " << e.what() << std::endl; \
+	failed=true;\
+}
+
+// remote clock: 123.4 s ahead and 50 ppm faster than the local clock
+static const double OFFSET = 123.4;
+static const double DRIFT = 50e-6;
+
+static double remoteTime(double localTime)
+{
+	return OFFSET + localTime * (1 + DRIFT);
+}
+
+// loopback transport with a base latency and occasional queueing delays
+static unsigned seed = 12345;
+
+static double latency(double base)
+{
+	double random;
+	seed = seed * 1103515245 + 12345;
+	random = ((seed >> 8) & 0xFFFF) / 65536.0;
+	// every fourth message is delayed by up to 40 ms
+	if (random < 0.25)
+		return base + random * 0.16;
+	return base + random * 0.002;
+}
+
+int main()
+{
+	bool failed=false;
+	ClockOffsetEstimator estimator;
+	double t0, t1, t2, t3, time = 10;
+	unsigned i;
+
+	test_bool_true ( !estimator.isSynchronised() );
+	test_bool_true ( !estimator.isConverged() );
+
+	for (i = 0; i < 60; i++) {
+		t0 = time;
+		// asymmetric path: 10 ms to the remote, 12 ms back
+		t1 = remoteTime(t0 + latency(0.010));
+		t2 = t1 + 0.0005; // processing time of the remote
+		t3 = (t2 - OFFSET) / (1 + DRIFT) + latency(0.012);
+		estimator.addSample(t0, t1, t2, t3);
+		time += estimator.isSynchronised() ? 1.0 : 0.2;
+
+		if (i == 1) {
+			// the first estimates are not trusted yet
+			test_bool_true ( !estimator.isConverged() );
+		}
+
+		if (i == 5) {
+			// converged to the offset after a few round trips
+			test_bool_true ( estimator.isSynchronised() );
+			test_bool_true ( fabs(estimator.getOffset(t3) - (remoteTime(t3) - t3)) < 0.003 );
+		}
+	}
+
+	test_bool_true ( estimator.isConverged() );
+
+	// the error is bounded by half the asymmetry of the path (1 ms)
+	test_bool_true ( fabs(estimator.getOffset(time) - (remoteTime(time) - time)) < 0.002 );
+	test_bool_true ( fabs(estimator.getDrift() - DRIFT) < 20e-6 );
+	test_bool_true ( estimator.getDelay() >= 0.022 && estimator.getDelay() < 0.025 );
+
+	// the prediction holds between two round trips
+	test_bool_true ( fabs(estimator.getOffset(time + 1) - (remoteTime(time + 1) - time - 1)) < 0.002 );
+
+	std::cout << "offset error: " << (estimator.getOffset(time) - (remoteTime(time) - time)) * 1000
+			<< " ms, drift: " << estimator.getDrift() * 1e6 << " ppm" << std::endl;
+
+	estimator.reset();
+	test_bool_true ( !estimator.isSynchronised() );
+	test_bool_true ( !estimator.isConverged() );
+	test_bool_true ( estimator.getNumberOfSamples() == 0 );
+
+	return failed?1:0;
+}
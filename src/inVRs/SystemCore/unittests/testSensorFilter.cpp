@@ -0,0 +1,237 @@
+#include <iostream>
+#include <stdexcept>
+#include <typeinfo>
+#include <math.h>
+#include <vector>
+
+#undef INVRSSYSTEMCORE_EXPORTS
+#undef INVRSINPUTINTERFACE_EXPORTS
+#include "inVRs/InputInterface/SensorFilter.h"
+
+#include <gmtl/QuatOps.h>
+#include <gmtl/VecOps.h>
+
+#undef NDEBUG
+#include <cassert>
+
+#define test_bool_true(x) try { \
+	if ( !(x) ) \
+	{ \
+		std::cout << "Test condition ``" # x "'' failed!" <<std::endl; \
+		failed=true; \
+	} \
+} catch (std::exception &e ) \
+{ \
+	std::cout << "Exception " << typeid(e).name() << " during test ``" # x "'': " << e.what() << std::endl; \
+	failed=true;\
+}
+
+// tracker rate and duration of the synthetic recording
+static const double SAMPLE_INTERVAL = 1.0 / 90.0;
+static const int NUM_SAMPLES = 900;
+// standard deviation of the tracker noise
+static const float POSITION_NOISE = 0.003f;
+static const float ORIENTATION_NOISE = 0.005f;
+static const double PREDICTION_TIME = 0.03;
+
+static SensorData pose(float x, float angle)
+{
+	SensorData result = identitySensorData();
+	result.position[0] = x;
+	// rotation around the y-axis
+	result.orientation = gmtl::Quatf(0, sinf(angle / 2), 0, cosf(angle / 2));
+	return result;
+}
+
+static float getAngle(const SensorData& data)
+{
+	gmtl::Quatf q = data.orientation;
+	if (q[3] < 0)
+		q = -q;
+	return 2 * atan2f(q[1], q[3]);
+}
+
+/**
+ * Hand movement: 30cm and 0.5 radians back and forth
+ */
+static SensorData trajectory(double time)
+{
+	return pose(0.3f * (float)sin(2 * M_PI * 0.5 * time),
+			0.5f * (float)sin(2 * M_PI * 0.3 * time));
+}
+
+/**
+ * Deterministic noise with zero mean and unit standard deviation
+ */
+static float noise()
+{
+	static unsigned seed = 12345;
+	float sum = 0;
+	for (int i = 0; i < 12; i++) {
+		seed = seed * 1103515245 + 12345;
+		sum += ((seed >> 8) & 0xFFFF) / 65536.f;
+	}
+	return sum - 6;
+}
+
+struct Result {
+	std::vector<double> times;
+	std::vector<SensorData> raw;
+	std::vector<SensorData> filtered;
+	std::vector<SensorData> predicted;
+};
+
+static Result run(SensorFilter& filter, bool moving)
+{
+	Result result;
+	filter.reset();
+	for (int i = 0; i < NUM_SAMPLES; i++) {
+		double time = i * SAMPLE_INTERVAL;
+		SensorData truth = moving ? trajectory(time) : trajectory(0);
+		SensorData sample = pose(truth.position[0] + POSITION_NOISE * noise(),
+				getAngle(truth) + ORIENTATION_NOISE * noise());
+		SensorData data;
+		filter.addSample(sample, time);
+		result.times.push_back(time);
+		result.raw.push_back(sample);
+		filter.predict(time, 1.0, data);
+		result.filtered.push_back(data);
+		filter.predict(time + PREDICTION_TIME, 1.0, data);
+		result.predicted.push_back(data);
+	}
+	return result;
+}
+
+/**
+ * RMS position error against the true trajectory delayed by lag (the first
+ * second is skipped while the filter settles). The resting sensor stays at
+ * the start of the trajectory.
+ */
+static float positionError(const Result& result, const std::vector<SensorData>& data,
+		double lag, bool moving = true)
+{
+	double sum = 0;
+	int count = 0;
+	for (unsigned i = 90; i < data.size(); i++) {
+		double time = moving ? result.times[i] - lag : 0;
+		float error = data[i].position[0] - trajectory(time).position[0];
+		sum += error * error;
+		count++;
+	}
+	return (float)sqrt(sum / count);
+}
+
+static float orientationError(const std::vector<SensorData>& data)
+{
+	double sum = 0;
+	int count = 0;
+	for (unsigned i = 90; i < data.size(); i++) {
+		float error = getAngle(data[i]) - getAngle(trajectory(0));
+		sum += error * error;
+		count++;
+	}
+	return (float)sqrt(sum / count);
+}
+
+/**
+ * Added latency: the lag of the true trajectory which fits the output best
+ */
+static double latency(const Result& result, const std::vector<SensorData>& data)
+{
+	double bestLag = 0;
+	float bestError = positionError(result, data, 0);
+	for (double lag = -0.1; lag <= 0.1; lag += 0.001) {
+		float error = positionError(result, data, lag);
+		if (error < bestError) {
+			bestError = error;
+			bestLag = lag;
+		}
+	}
+	return bestLag;
+}
+
+/**
+ * Measures the jitter of a resting sensor and the latency and error of a
+ * moving sensor with and without filtering.
+ */
+static bool evaluate(const char* name, SensorFilter& filter, float maxJitterRatio, double maxLatency)
+{
+	bool failed = false;
+	Result rest = run(filter, false);
+	float rawJitter = positionError(rest, rest.raw, 0, false);
+	float filteredJitter = positionError(rest, rest.filtered, 0, false);
+	float rawAngleJitter = orientationError(rest.raw);
+	float filteredAngleJitter = orientationError(rest.filtered);
+
+	Result movement = run(filter, true);
+	float rawError = positionError(movement, movement.raw, 0);
+	float filteredError = positionError(movement, movement.filtered, 0);
+	// the unfiltered pose is displayed PREDICTION_TIME after it was measured
+	float lateError = positionError(movement, movement.raw, -PREDICTION_TIME);
+	float predictedError = positionError(movement, movement.predicted, -PREDICTION_TIME);
+	double filterLatency = latency(movement, movement.filtered);
+
+	std::cout << name << ": jitter at rest " << rawJitter * 1000 << "mm / " << rawAngleJitter
+			<< "rad raw, " << filteredJitter * 1000 << "mm / " << filteredAngleJitter
+			<< "rad filtered; error in motion " << rawError * 1000 << "mm raw, "
+			<< filteredError * 1000 << "mm filtered; added latency " << filterLatency * 1000
+			<< "ms; error at display time " << lateError * 1000 << "mm raw, "
+			<< predictedError * 1000 << "mm predicted" << std::endl;
+
+	test_bool_true ( filteredJitter < maxJitterRatio * rawJitter );
+	test_bool_true ( filteredAngleJitter < maxJitterRatio * rawAngleJitter );
+	test_bool_true ( filterLatency < maxLatency );
+	test_bool_true ( predictedError < lateError );
+	return !failed;
+}
+
+static bool near(float a, float b)
+{
+	return fabs(a - b) < 1e-3f;
+}
+
+int main()
+{
+	bool failed=false;
+	OneEuroSensorFilter oneEuro;
+	KalmanSensorFilter kalman;
+	SensorData data;
+
+	test_bool_true ( !kalman.hasSample() );
+
+	// constant velocity of 2 units and 0.5 radians per second is followed
+	// and predicted without error
+	for (int i = 0; i <= 20; i++)
+		kalman.addSample(pose(2 * i * 0.01f, 0.5f * i * 0.01f), 10 + i * 0.01);
+	test_bool_true ( kalman.hasSample() );
+	kalman.predict(10.3, 1.0, data);
+	test_bool_true ( near(data.position[0], 0.6f) );
+	test_bool_true ( near(getAngle(data), 0.15f) );
+
+	// the extrapolation is limited
+	kalman.predict(20.0, 0.1, data);
+	test_bool_true ( near(data.position[0], 0.6f) );
+
+	// samples which are not newer are ignored
+	kalman.addSample(pose(5, 0), 10.2);
+	kalman.predict(10.2, 1.0, data);
+	test_bool_true ( near(data.position[0], 0.4f) );
+
+	kalman.reset();
+	test_bool_true ( !kalman.hasSample() );
+
+	// a resting sensor is not moved
+	for (int i = 0; i <= 20; i++)
+		oneEuro.addSample(pose(1, 0.2f), i * 0.01);
+	oneEuro.predict(0.5, 1.0, data);
+	test_bool_true ( near(data.position[0], 1) );
+	test_bool_true ( near(getAngle(data), 0.2f) );
+	oneEuro.reset();
+
+	// noisy hand movement: the One Euro filter removes more jitter at rest,
+	// the Kalman filter adds no latency
+	test_bool_true ( evaluate("OneEuro", oneEuro, 0.5f, 0.015) );
+	test_bool_true ( evaluate("Kalman", kalman, 0.75f, 0.005) );
+
+	return (failed) ? 1 : 0;
+}
@@ -0,0 +1,84 @@
+#include <iostream>
+#include <stdexcept>
+#include <typeinfo>
+
+#undef INVRSSYSTEMCORE_EXPORTS
+#include "inVRs/SystemCore/TransformationManager/TransformationPipe.h"
+
+#undef NDEBUG
+#include <cassert>
+
+#define test_bool_true(x) try { \
+	if ( !(x) ) \
+	{ \
+		std::cout << "Test condition ``" # x "'' failed!" <<std::endl; \
+		failed=true; \
+	} \
+} catch (std::exception &e ) \
+{ \
+	std::cout << "Exception " << typeid(e).name() << " during test ``" # x "'': " << e.what() << std::endl; \
+	failed=true;\
+}
+
+static TransformationData translation(float x)
+{
+	TransformationData result = identityTransformation();
+	result.position[0] = x;
+	return result;
+}
+
+int main()
+{
+	bool failed=false;
+	TransformationData data;
+	TransformationPipeBuffer buffer(3);
+	TransformationPipeData entry;
+
+	// an unbounded buffer grows on demand
+	test_bool_true ( buffer.getCapacity() == 0 );
+	for (int i = 0; i < 6; i++) {
+		entry.transf = translation((float)i);
+		entry.timestamp = i;
+		test_bool_true ( !buffer.push_back(entry) );
+	}
+	test_bool_true ( buffer.size() == 6 );
+	test_bool_true ( buffer[0].timestamp == 0 );
+	test_bool_true ( buffer.back().timestamp == 5 );
+	test_bool_true ( buffer.findLatestBefore(-0.5) == -1 );
+	test_bool_true ( buffer.findLatestBefore(3.5) == 3 );
+	test_bool_true ( buffer.findLatestBefore(10) == 5 );
+
+	// a bounded buffer keeps the newest entries and counts the overwrites,
+	// the capacity is rounded up to a power of two
+	buffer.setCapacity(3);
+	test_bool_true ( buffer.getCapacity() == 4 );
+	test_bool_true ( buffer.size() == 4 );
+	test_bool_true ( buffer[0].timestamp == 2 );
+	entry.timestamp = 6;
+	test_bool_true ( buffer.push_back(entry) );
+	test_bool_true ( buffer.size() == 4 );
+	test_bool_true ( buffer[0].timestamp == 3 );
+	test_bool_true ( buffer.back().timestamp == 6 );
+	test_bool_true ( buffer.getNumOverwritten() == 1 );
+
+	TransformationPipe pipe(0, NULL);
+	test_bool_true ( !pipe.interpolateTransformation(1, data) );
+	data = translation(0);
+	pipe.push_back(data, 10.0);
+	data = translation(4);
+	pipe.push_back(data, 12.0);
+	// timestamps are clamped to keep the pipe ordered
+	data = translation(8);
+	pipe.push_back(data, 11.0);
+	test_bool_true ( pipe.size() == 3 );
+	test_bool_true ( pipe.getTimestamp(2) == 12.0 );
+	test_bool_true ( pipe.getTransformation(2).position[0] == 8 );
+
+	test_bool_true ( pipe.getTransformationBefore(11.9, data) && data.position[0] == 0 );
+	test_bool_true ( !pipe.getTransformationBefore(9, data) );
+	test_bool_true ( pipe.interpolateTransformation(11, data) && data.position[0] == 2 );
+	test_bool_true ( pipe.interpolateTransformation(5, data) && data.position[0] == 0 );
+	test_bool_true ( pipe.interpolateTransformation(20, data) && data.position[0] == 8 );
+
+	return (failed) ? 1 : 0;
+}
@@ -0,0 +1,163 @@
+#include <iostream>
+#include <stdexcept>
+#include <typeinfo>
+#include <map>
+
+#undef INVRSSYSTEMCORE_EXPORTS
+#include "inVRs/SystemCore/WorldDatabase/WorldDatabaseSync.h"
+
+#undef NDEBUG
+#include <cassert>
+
+#define test_bool_true(x) try { \
+	if ( !(x) ) \
+	{ \
+		std::cout << "Test condition ``" # x "'' failed!" <<std::endl; \
+		failed=true; \
+	} \
+} catch (std::exception &e ) \
+{ \
+	std::cout << "Exception " << typeid(e).name() << " during test ``" # x "'': " << e.what() << std::endl; \
+	failed=true;\
+}
+
+typedef std::map<unsigned, WorldDatabaseSyncEntity> World;
+
+static const unsigned NUMBER_OF_ENVIRONMENTS = 5;
+static const unsigned NUMBER_OF_ENTITIES = 3000;
+static const unsigned CHUNK_SIZE = 4096;
+static const unsigned SPAWN_ENVIRONMENT = 2;
+
+static WorldDatabaseSyncEntity entity(unsigned id, unsigned environmentId, float x)
+{
+	WorldDatabaseSyncEntity result;
+	result.typeBasedId = id;
+	result.envBasedId = (environmentId << 16) | (id & 0xFFFF);
+	result.environmentId = environmentId;
+	result.transf = identityTransformation();
+	result.transf.position[0] = x;
+	return result;
+}
+
+static void capture(const World& world, std::vector<WorldDatabaseSyncEntity>& dst)
+{
+	dst.clear();
+	for (World::const_iterator it = world.begin(); it != world.end(); ++it)
+		dst.push_back(it->second);
+}
+
+// the "network": encodes the entities like the WorldDatabaseSyncChunkEvent
+static unsigned transmit(const std::vector<WorldDatabaseSyncEntity>& src,
+		std::vector<WorldDatabaseSyncEntity>& dst)
+{
+	NetMessage msg;
+	uint32_t size;
+	unsigned bytes;
+
+	msg.putUInt32(0); // version
+	msg.putUInt32(0); // chunk index
+	msg.putUInt32(src.size());
+	for (unsigned i = 0; i < src.size(); i++)
+		msgFunctions::encode(src[i], &msg);
+	bytes = msg.getBufferSize();
+
+	msg.getUInt32(size);
+	msg.getUInt32(size);
+	msg.getUInt32(size);
+	dst.resize(size);
+	for (unsigned i = 0; i < size; i++)
+		msgFunctions::decode(dst[i], &msg);
+	return bytes;
+}
+
+int main()
+{
+	bool failed=false;
+	World server, client;
+	std::vector<WorldDatabaseSyncEntity> snapshot, chunk, received, changed;
+	std::vector<unsigned> environmentOrder, removed;
+	WorldDatabaseSyncReceiver receiver;
+	unsigned i, bytes, peakBytes = 0, iterations = 0, firstUsableIteration = 0;
+	bool spawnComplete = true;
+
+	for (i = 0; i < NUMBER_OF_ENTITIES; i++)
+		server[i + 1] = entity(i + 1, i % NUMBER_OF_ENVIRONMENTS, (float)i);
+	// client knows an entity which does not exist any more
+	client[99999] = entity(99999, 0, 0);
+
+	environmentOrder.push_back(SPAWN_ENVIRONMENT);
+	for (i = 0; i < NUMBER_OF_ENVIRONMENTS; i++)
+		if (i != SPAWN_ENVIRONMENT)
+			environmentOrder.push_back(i);
+
+	capture(server, snapshot);
+	WorldDatabaseSyncStreamer streamer(7, snapshot, environmentOrder, CHUNK_SIZE);
+	test_bool_true ( streamer.getNumberOfChunks() > 1 );
+	test_bool_true ( streamer.getNumberOfSpawnChunks() < streamer.getNumberOfChunks() );
+
+	receiver.begin(streamer.getVersion(), streamer.getNumberOfChunks(),
+			streamer.getNumberOfSpawnChunks());
+	test_bool_true ( !receiver.isUsable() );
+
+	// a chunk of another snapshot is rejected
+	test_bool_true ( !receiver.addChunk(6, 0, chunk) );
+
+	while (streamer.hasNextChunk()) {
+		unsigned chunkIndex = streamer.getNextChunk(chunk);
+		bytes = transmit(chunk, received);
+		if (bytes > peakBytes)
+			peakBytes = bytes;
+		test_bool_true ( receiver.addChunk(streamer.getVersion(), chunkIndex, received) );
+		for (i = 0; i < received.size(); i++)
+			client[received[i].typeBasedId] = received[i];
+		iterations++;
+
+		if (!firstUsableIteration && receiver.isUsable()) {
+			firstUsableIteration = iterations;
+			// the whole spawn environment is present
+			for (World::iterator it = server.begin(); it != server.end(); ++it)
+				if (it->second.environmentId == SPAWN_ENVIRONMENT && !client.count(it->first))
+					spawnComplete = false;
+		}
+
+		// the world changes during the transmission
+		if (iterations == 2) {
+			server[5].transf.position[1] = 42;
+			server.erase(NUMBER_OF_ENTITIES);
+			server[NUMBER_OF_ENTITIES + 1] = entity(NUMBER_OF_ENTITIES + 1, 1, 0);
+		}
+	}
+
+	test_bool_true ( peakBytes <= CHUNK_SIZE );
+	test_bool_true ( firstUsableIteration == streamer.getNumberOfSpawnChunks() );
+	test_bool_true ( spawnComplete );
+	test_bool_true ( !receiver.isComplete() );
+
+	capture(server, snapshot);
+	streamer.getDelta(snapshot, changed, removed);
+	test_bool_true ( changed.size() == 2 );
+	test_bool_true ( removed.size() == 1 && removed[0] == NUMBER_OF_ENTITIES );
+	test_bool_true ( receiver.finish(streamer.getVersion(), changed, removed) );
+	test_bool_true ( receiver.isComplete() );
+
+	for (i = 0; i < changed.size(); i++)
+		client[changed[i].typeBasedId] = changed[i];
+	for (World::iterator it = client.begin(); it != client.end();) {
+		if (!receiver.contains(it->first))
+			client.erase(it++);
+		else
+			++it;
+	}
+
+	test_bool_true ( client.size() == server.size() );
+	test_bool_true ( client.count(99999) == 0 );
+	test_bool_true ( client.count(NUMBER_OF_ENTITIES) == 0 );
+	test_bool_true ( client.count(NUMBER_OF_ENTITIES + 1) == 1 );
+	test_bool_true ( client[5].transf.position[1] == 42 );
+
+	std::cout << "entities: " << NUMBER_OF_ENTITIES << ", chunks: " << iterations
+			<< ", iterations until usable: " << firstUsableIteration
+			<< ", peak bytes per iteration: " << peakBytes << std::endl;
+
+	return failed?1:0;
+}
@@ -0,0 +1,197 @@
+#include <iostream>
+#include <stdexcept>
+#include <typeinfo>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#ifdef WIN32
+#include <direct.h>
+#include <sys/utime.h>
+#else
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+#undef INVRSSYSTEMCORE_EXPORTS
+#include "inVRs/SystemCore/XmlBinaryCache.h"
+#include "inVRs/SystemCore/XmlDocument.h"
+
+#define test_bool_true(x) try { \
+	if ( !(x) ) \
+	{ \
+		std::cout << "Test condition ``" # x "'' failed!" <<std::endl; \
+		failed=true; \
+	} \
+} catch (std::exception &e ) \
+{ \
+	std::cout << "Exception " << typeid(e).name() << " during test ``" # x "'': " << e.what() << std::endl; \
+	failed=true;\
+}
+
+static const char* XML_CONTENT = "<?xml version=\"1.0\"?>\n"
+		"<!DOCTYPE test SYSTEM \"http://dtd.inVRs.org/test_v1.0.dtd\">\n"
+		"<test version=\"1.0\">\n"
+		"  <paths root=\"../\">\n"
+		"    <path name=\"Models\" directory=\"models/\"/>\n"
+		"    <path name=\"Tiles\" directory=\"tiles/\"/>\n"
+		"  </paths>\n"
+		"  <description>some content</description>\n"
+		"  <empty/>\n"
+		"</test>\n";
+
+/** Creates an empty temporary directory and returns its path with a
+ * trailing separator.
+ */
+static std::string createTempDirectory()
+{
+#ifdef WIN32
+	char* name = _tempnam(NULL, "invrs");
+	std::string path = name ? name : "invrsXmlBinaryCache";
+	free(name);
+	if (_mkdir(path.c_str()) != 0)
+		return "";
+	return path + "\\";
+#else
+	char path[] = "/tmp/invrsXmlBinaryCacheXXXXXX";
+	if (!mkdtemp(path))
+		return "";
+	return std::string(path) + "/";
+#endif
+}
+
+static void removeDirectory(const std::string& path)
+{
+#ifdef WIN32
+	_rmdir(path.c_str());
+#else
+	rmdir(path.c_str());
+#endif
+}
+
+static void writeFile(const std::string& fileName, const char* content)
+{
+	FILE* file = fopen(fileName.c_str(), "w");
+	if (file) {
+		fputs(content, file);
+		fclose(file);
+	}
+}
+
+static void setModificationTime(const std::string& fileName, time_t time)
+{
+#ifdef WIN32
+	struct _utimbuf times;
+	times.actime = time;
+	times.modtime = time;
+	_utime(fileName.c_str(), &times);
+#else
+	struct utimbuf times;
+	times.actime = time;
+	times.modtime = time;
+	utime(fileName.c_str(), &times);
+#endif
+}
+
+static bool copyFile(const std::string& src, const std::string& dst)
+{
+	char buffer[4096];
+	size_t size;
+	FILE* in = fopen(src.c_str(), "rb");
+	FILE* out = fopen(dst.c_str(), "wb");
+	bool success = in && out;
+	while (success && (size = fread(buffer, 1, sizeof(buffer), in)) > 0)
+		success = fwrite(buffer, 1, size, out) == size;
+	if (in)
+		fclose(in);
+	if (out)
+		fclose(out);
+	return success;
+}
+
+static bool equalElements(const XmlElement* a, const XmlElement* b)
+{
+	if (a->getName() != b->getName() || a->getContent() != b->getContent())
+		return false;
+	std::vector<const XmlElement*> subA = a->getAllSubElements();
+	std::vector<const XmlElement*> subB = b->getAllSubElements();
+	if (subA.size() != subB.size())
+		return false;
+	for (size_t i = 0; i < subA.size(); i++) {
+		if (subA[i]->getParentElement() != a || subB[i]->getParentElement() != b
+				|| !equalElements(subA[i], subB[i]))
+			return false;
+	}
+	return true;
+}
+
+int main()
+{
+	bool failed=false;
+	std::string dir = createTempDirectory();
+	test_bool_true ( !dir.empty() );
+	if (dir.empty())
+		return 1;
+	std::string xmlFile = dir + "test.xml";
+	std::string otherXmlFile = dir + "other.xml";
+	std::string cacheFile = XmlBinaryCache::getCacheFileName(dir, xmlFile, "key");
+	writeFile(xmlFile, XML_CONTENT);
+	setModificationTime(xmlFile, 1000000000);
+
+	XmlDocument* original = XmlDocument::loadXmlDocument(xmlFile.c_str());
+	test_bool_true ( original != NULL );
+	if (!original)
+		return 1;
+
+	test_bool_true ( XmlBinaryCache::read(dir, xmlFile, "key") == NULL );
+	test_bool_true ( XmlBinaryCache::write(dir, xmlFile, "key", original) );
+	XmlDocument* cached = XmlBinaryCache::read(dir, xmlFile, "key");
+	test_bool_true ( cached != NULL );
+	if (cached) {
+		test_bool_true ( equalElements(original->getRootElement(), cached->getRootElement()) );
+		test_bool_true ( cached->getRootElement()->getParentElement() == NULL );
+		test_bool_true ( cached->getAttributeValue("test.version") == "1.0" );
+		test_bool_true ( cached->getAttributeValue("test.paths.root") == "../" );
+		test_bool_true ( cached->getElement("test")->getSubElement("paths")
+				->getSubElements("path").size() == 2 );
+		test_bool_true ( cached->getElementContent("test.description") == "some content" );
+		test_bool_true ( cached->getDtd() && original->getDtd()
+				&& cached->getDtd()->getName() == original->getDtd()->getName()
+				&& cached->getDtd()->getDtd() == original->getDtd()->getDtd() );
+		delete cached;
+	}
+
+	// a different converter key must not use the cache file
+	test_bool_true ( XmlBinaryCache::read(dir, xmlFile, "otherKey") == NULL );
+
+	// a cache file ending up under the name of another document (hash
+	// collision) is rejected, even if size and modification time match
+	writeFile(otherXmlFile, XML_CONTENT);
+	setModificationTime(otherXmlFile, 1000000000);
+	std::string otherCacheFile = XmlBinaryCache::getCacheFileName(dir, otherXmlFile, "key");
+	test_bool_true ( copyFile(cacheFile, otherCacheFile) );
+	test_bool_true ( XmlBinaryCache::read(dir, otherXmlFile, "key") == NULL );
+
+	// a changed modification time of the source invalidates the cache file
+	setModificationTime(xmlFile, 1000000100);
+	test_bool_true ( XmlBinaryCache::read(dir, xmlFile, "key") == NULL );
+	test_bool_true ( XmlBinaryCache::write(dir, xmlFile, "key", original) );
+	cached = XmlBinaryCache::read(dir, xmlFile, "key");
+	test_bool_true ( cached != NULL );
+	delete cached;
+
+	// a changed size of the source invalidates the cache file, even with the
+	// modification time of the cached version
+	writeFile(xmlFile, "<test version=\"1.0\"/>\n");
+	setModificationTime(xmlFile, 1000000100);
+	test_bool_true ( XmlBinaryCache::read(dir, xmlFile, "key") == NULL );
+
+	remove(cacheFile.c_str());
+	remove(otherCacheFile.c_str());
+	remove(xmlFile.c_str());
+	remove(otherXmlFile.c_str());
+	removeDirectory(dir);
+	delete original;
+
+	return (failed) ? 1 : 0;
+}
@@ -0,0 +1,52 @@
+#include "LatencyStatistics.h"
+
+#include <algorithm>
+
+LatencyStatistics::LatencyStatistics() :
+	sum(0),
+	max(0),
+	sorted(true) {
+} // LatencyStatistics
+
+void LatencyStatistics::addSample(double latency) {
+	samples.push_back(latency);
+	sum += latency;
+	if (latency > max)
+		max = latency;
+	sorted = false;
+} // addSample
+
+void LatencyStatistics::merge(const LatencyStatistics& other) {
+	for (unsigned i = 0; i < other.samples.size(); i++)
+		addSample(other.samples[i]);
+} // merge
+
+unsigned LatencyStatistics::getNumberOfSamples() const {
+	return samples.size();
+} // getNumberOfSamples
+
+double LatencyStatistics::getMean() const {
+	if (samples.size() == 0)
+		return 0;
+	return sum / samples.size();
+} // getMean
+
+double LatencyStatistics::getMax() const {
+	return max;
+} // getMax
+
+double LatencyStatistics::getPercentile(double percentile) {
+	unsigned index;
+
+	if (samples.size() == 0)
+		return 0;
+	if (!sorted) {
+		std::sort(samples.begin(), samples.end());
+		sorted = true;
+	} // if
+
+	index = (unsigned)(percentile / 100.0 * (samples.size() - 1) + 0.5);
+	if (index >= samples.size())
+		index = samples.size() - 1;
+	return samples[index];
+} // getPercentile
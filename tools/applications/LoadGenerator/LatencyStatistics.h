@@ -0,0 +1,33 @@
+#ifndef _LATENCYSTATISTICS_H
+#define _LATENCYSTATISTICS_H
+
+#include <vector>
+
+/******************************************************************************
+ * Collects latency samples (in seconds) and evaluates mean, percentiles and
+ * maximum for the report of the LoadGenerator.
+ */
+class LatencyStatistics {
+public:
+	LatencyStatistics();
+
+	void addSample(double latency);
+	void merge(const LatencyStatistics& other);
+
+	unsigned getNumberOfSamples() const;
+	double getMean() const;
+	double getMax() const;
+
+	/** Returns the given percentile (0 to 100) of the samples or 0 if there
+	 * are no samples.
+	 */
+	double getPercentile(double percentile);
+
+private:
+	std::vector<double> samples;
+	double sum;
+	double max;
+	bool sorted;
+}; // LatencyStatistics
+
+#endif // _LATENCYSTATISTICS_H
@@ -0,0 +1,458 @@
+#include "LoadGenerator.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include <OpenSG/OSGBaseFunctions.h>
+
+#include <inVRs/SystemCore/Configuration.h>
+#include <inVRs/SystemCore/DebugOutput.h>
+#include <inVRs/SystemCore/NetMessage.h>
+#include <inVRs/SystemCore/SystemCoreEvents.h>
+#include <inVRs/SystemCore/Timer.h>
+#include <inVRs/SystemCore/EventManager/EventManager.h>
+#include <inVRs/SystemCore/TransformationManager/TransformationManager.h>
+#include <inVRs/SystemCore/UserDatabase/UserDatabase.h>
+
+#include "TransformationLatencyModifier.h"
+
+OSG_USING_NAMESPACE
+
+// user id, pipe id and 14 values of the transformation, see TransformationDistributionModifier
+static const unsigned TRANSFORMATION_MESSAGE_SIZE = 4 + 8 + 14 * 4;
+// every synthetic user manipulates the entity for this time, one after the other
+static const double MANIPULATION_TIME = 2;
+// upper limit for the sleep between two frames, limits the error of the round trip times
+static const double MAX_SLEEP_TIME = 0.001;
+
+std::map<unsigned, LatencyStatistics> LoadGenerator::transformationLatency;
+
+LoadGenerator::LoadGenerator() :
+	configFile("config/general.xml"),
+	nodeName("127.0.0.1:8081"),
+	numberOfUsers(10),
+	duration(30),
+	updateRate(60),
+	eventRate(10),
+	payloadSize(0),
+	manipulateEntity(false),
+	entityType(0),
+	entityId(0),
+	nodeProcessId(0),
+	network(NULL),
+	nodeUserId(0),
+	nodeUserFound(false),
+	nextPingNumber(0),
+	pingSize(0),
+	runTime(0),
+	loopbackBytes(0),
+	loopbackBytesValid(false) {
+	cpuTime.generator = 0;
+	cpuTime.node = 0;
+} // LoadGenerator
+
+LoadGenerator::~LoadGenerator() {
+	for (unsigned i = 0; i < users.size(); i++)
+		delete users[i];
+	users.clear();
+} // ~LoadGenerator
+
+bool LoadGenerator::parseArguments(int argc, char** argv) {
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--config") && i + 1 < argc)
+			configFile = argv[++i];
+		else if (!strcmp(argv[i], "--modules") && i + 1 < argc)
+			modulesFile = argv[++i];
+		else if (!strcmp(argv[i], "--connect") && i + 1 < argc)
+			nodeName = argv[++i];
+		else if (!strcmp(argv[i], "--users") && i + 1 < argc)
+			numberOfUsers = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--duration") && i + 1 < argc)
+			duration = atof(argv[++i]);
+		else if (!strcmp(argv[i], "--rate") && i + 1 < argc)
+			updateRate = atof(argv[++i]);
+		else if (!strcmp(argv[i], "--event-rate") && i + 1 < argc)
+			eventRate = atof(argv[++i]);
+		else if (!strcmp(argv[i], "--payload") && i + 1 < argc)
+			payloadSize = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--entity") && i + 1 < argc) {
+			if (sscanf(argv[++i], "%u:%u", &entityType, &entityId) != 2)
+				return false;
+			manipulateEntity = true;
+		} // else if
+		else if (!strcmp(argv[i], "--node-pid") && i + 1 < argc)
+			nodeProcessId = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--output") && i + 1 < argc)
+			outputFile = argv[++i];
+		else
+			return false;
+	} // for
+	return numberOfUsers > 0 && duration > 0 && updateRate > 0;
+} // parseArguments
+
+bool LoadGenerator::init() {
+	NetMessage msg;
+	NetworkIdentification localId;
+
+	SystemCore::registerCoreComponentInitCallback(initCoreComponents);
+	if (!Configuration::loadConfig(configFile)) {
+		printd(ERROR, "LoadGenerator::init(): could not load configuration %s!\n",
+				configFile.c_str());
+		return false;
+	} // if
+	if (modulesFile.size() == 0)
+		modulesFile = Configuration::getString("Modules.modulesConfiguration");
+
+	if (!SystemCore::configure(Configuration::getString("SystemCore.systemCoreConfiguration"),
+			"", "", modulesFile)) {
+		printd(ERROR, "LoadGenerator::init(): failed to setup SystemCore!\n");
+		return false;
+	} // if
+
+	network = (NetworkInterface*)SystemCore::getModuleByName("Network");
+	if (!network) {
+		printd(ERROR, "LoadGenerator::init(): Network module not loaded!\n");
+		return false;
+	} // if
+	if (!network->connect(nodeName)) {
+		printd(ERROR, "LoadGenerator::init(): could not connect to %s!\n", nodeName.c_str());
+		return false;
+	} // if
+	SystemCore::synchronize();
+
+	UserConnectCB<LoadGenerator> connectCallback(this, &LoadGenerator::userConnected);
+	UserDatabase::registerUserConnectCallback(connectCallback);
+
+	localId = network->getLocalIdentification();
+	knownNetworkIds.push_back(localId);
+	for (unsigned i = 0; i < numberOfUsers; i++) {
+		users.push_back(new SyntheticUser(UserDatabase::getLocalUserId() + 1 + i, i, localId));
+		users.back()->connect();
+	} // for
+	userStatistics.resize(numberOfUsers);
+
+	SystemCorePingEvent ping(USER_DEFINED_ID, 0, payloadSize);
+	ping.encode(&msg);
+	pingSize = msg.getBufferSize();
+	return true;
+} // init
+
+void LoadGenerator::run() {
+	double start, now, time, sleepTime;
+	double lastFrame, nextUpdate = 0, nextEvent = 0;
+	double startLoopbackBytes = 0;
+	CpuTime startCpuTime;
+
+	startCpuTime = getCpuTime();
+	loopbackBytesValid = getLoopbackBytes(startLoopbackBytes);
+	start = lastFrame = inVRsUtilities::Timer::getMonotonicTime();
+
+	while ((now = inVRsUtilities::Timer::getMonotonicTime()) - start < duration) {
+		time = now - start;
+		SystemCore::step();
+		receivePongs();
+		if (!nodeUserFound)
+			findNodeUser();
+
+		if (time >= nextUpdate) {
+			if (manipulateEntity)
+				updateManipulation(time);
+			for (unsigned i = 0; i < users.size(); i++)
+				users[i]->update(time);
+			nextUpdate += 1.0 / updateRate;
+		} // if
+		if (eventRate > 0 && time >= nextEvent) {
+			sendPings();
+			nextEvent += 1.0 / eventRate;
+		} // if
+
+		TransformationManager::step((float)(now - lastFrame));
+		lastFrame = now;
+
+		sleepTime = nextUpdate - (inVRsUtilities::Timer::getMonotonicTime() - start);
+		if (sleepTime > MAX_SLEEP_TIME)
+			sleepTime = MAX_SLEEP_TIME;
+		if (sleepTime > 0)
+			usleep((useconds_t)(sleepTime * 1e6));
+	} // while
+
+	runTime = inVRsUtilities::Timer::getMonotonicTime() - start;
+	cpuTime = getCpuTime();
+	cpuTime.generator -= startCpuTime.generator;
+	cpuTime.node -= startCpuTime.node;
+	if (loopbackBytesValid && getLoopbackBytes(loopbackBytes))
+		loopbackBytes -= startLoopbackBytes;
+	else
+		loopbackBytesValid = false;
+} // run
+
+bool LoadGenerator::writeReport() {
+	FILE* file = stdout;
+	LatencyStatistics allRoundTrips;
+	unsigned i, transformations = 0, pings = 0;
+	std::map<unsigned, LatencyStatistics>::iterator it;
+
+	if (outputFile.size() > 0) {
+		file = fopen(outputFile.c_str(), "w");
+		if (!file) {
+			printd(ERROR, "LoadGenerator::writeReport(): could not open %s!\n",
+					outputFile.c_str());
+			return false;
+		} // if
+	} // if
+
+	fprintf(file, "inVRs LoadGenerator: %u users on %s for %.1f s, %.1f Hz updates, "
+		"%.1f Hz events with %u bytes payload\n", numberOfUsers, nodeName.c_str(), runTime,
+			updateRate, eventRate, payloadSize);
+	if (!nodeUserFound)
+		fprintf(file, "WARNING: node did not announce its user, no events were sent!\n");
+
+	fprintf(file, "\n%-16s %10s %10s %10s %8s %9s %9s %9s %9s\n", "user", "id", "trans/s",
+			"kB/s", "events", "rtt mean", "rtt p95", "rtt p99", "rtt max");
+	for (i = 0; i < users.size(); i++) {
+		UserStatistics& stats = userStatistics[i];
+		unsigned userTransformations = users[i]->getNumberOfTransformations();
+		transformations += userTransformations;
+		pings += stats.pingsSent;
+		allRoundTrips.merge(stats.eventRoundTrip);
+		fprintf(file, "%-16s %10u %10.1f %10.2f %4u/%-3u %9.3f %9.3f %9.3f %9.3f\n",
+				users[i]->getUser()->getName().c_str(), users[i]->getId(),
+				userTransformations / runTime, (userTransformations
+						* TRANSFORMATION_MESSAGE_SIZE + stats.pingsSent * pingSize) / runTime
+						/ 1024.0, stats.eventRoundTrip.getNumberOfSamples(), stats.pingsSent,
+				stats.eventRoundTrip.getMean() * 1000.0,
+				stats.eventRoundTrip.getPercentile(95) * 1000.0,
+				stats.eventRoundTrip.getPercentile(99) * 1000.0,
+				stats.eventRoundTrip.getMax() * 1000.0);
+	} // for
+	fprintf(file, "%-16s %10s %10.1f %10.2f %4u/%-3u %9.3f %9.3f %9.3f %9.3f\n", "all", "",
+			transformations / runTime, (transformations * TRANSFORMATION_MESSAGE_SIZE + pings
+					* pingSize) / runTime / 1024.0, allRoundTrips.getNumberOfSamples(), pings,
+			allRoundTrips.getMean() * 1000.0, allRoundTrips.getPercentile(95) * 1000.0,
+			allRoundTrips.getPercentile(99) * 1000.0, allRoundTrips.getMax() * 1000.0);
+	fprintf(file, "(round trip times in ms, kB/s is the sent application payload)\n");
+
+	fprintf(file, "\nbandwidth: %.2f kB/s payload sent (%.2f kB/s per user)",
+			(transformations * TRANSFORMATION_MESSAGE_SIZE + pings * pingSize) / runTime / 1024.0,
+			(transformations * TRANSFORMATION_MESSAGE_SIZE + pings * pingSize) / runTime / 1024.0
+					/ numberOfUsers);
+	if (loopbackBytesValid)
+		fprintf(file, ", %.2f kB/s on loopback interface", loopbackBytes / runTime / 1024.0);
+	fprintf(file, "\ncpu: generator %.1f %% (%.3f %% per user)", cpuTime.generator / runTime
+			* 100.0, cpuTime.generator / runTime * 100.0 / numberOfUsers);
+	if (nodeProcessId > 0)
+		fprintf(file, ", node %.1f %% (%.3f %% per user)", cpuTime.node / runTime * 100.0,
+				cpuTime.node / runTime * 100.0 / numberOfUsers);
+	fprintf(file, "\n");
+
+	if (transformationLatency.size() > 0) {
+		fprintf(file, "\ntransformation latency of remote users:\n");
+		fprintf(file, "%10s %10s %9s %9s %9s %9s\n", "id", "samples", "mean", "p95", "p99",
+				"max");
+		for (it = transformationLatency.begin(); it != transformationLatency.end(); ++it) {
+			fprintf(file, "%10u %10u %9.3f %9.3f %9.3f %9.3f\n", it->first,
+					it->second.getNumberOfSamples(), it->second.getMean() * 1000.0,
+					it->second.getPercentile(95) * 1000.0, it->second.getPercentile(99) * 1000.0,
+					it->second.getMax() * 1000.0);
+		} // for
+	} // if
+
+	if (file != stdout)
+		fclose(file);
+	return true;
+} // writeReport
+
+void LoadGenerator::cleanup() {
+	UserConnectCB<LoadGenerator> connectCallback(this, &LoadGenerator::userConnected);
+	UserDatabase::unregisterUserConnectCallback(connectCallback);
+
+	for (unsigned i = 0; i < users.size(); i++)
+		delete users[i];
+	users.clear();
+	// give the network some time to send the UserDatabaseRemoveUserEvents
+	if (network)
+		usleep(100000);
+	SystemCore::cleanup();
+} // cleanup
+
+void LoadGenerator::userConnected(User* user) {
+	if (isKnownNetworkId(user->getNetworkId()))
+		return;
+
+	// participants which connected after the synthetic users were announced
+	knownNetworkIds.push_back(user->getNetworkId());
+	for (unsigned i = 0; i < users.size(); i++)
+		users[i]->announceTo(user->getId());
+} // userConnected
+
+void LoadGenerator::initCoreComponents(CoreComponents comp) {
+	if (comp == TRANSFORMATIONMANAGER)
+		TransformationManager::registerModifierFactory(new TransformationLatencyModifierFactory(
+				&transformationLatency));
+} // initCoreComponents
+
+void LoadGenerator::printUsage(const char* name) {
+	fprintf(stderr, "usage: %s [options]\n"
+		"  --config FILE       general configuration (default: config/general.xml)\n"
+		"  --modules FILE      modules configuration, overrides the general configuration\n"
+		"  --connect HOST:PORT node to connect to (default: 127.0.0.1:8081)\n"
+		"  --users N           number of synthetic users (default: 10)\n"
+		"  --duration S        duration of the test in seconds (default: 30)\n"
+		"  --rate HZ           tracking and navigation update rate (default: 60)\n"
+		"  --event-rate HZ     events per user and second, 0 disables them (default: 10)\n"
+		"  --payload BYTES     additional payload of each event (default: 0)\n"
+		"  --entity TYPE:ID    the users take turns in manipulating this entity\n"
+		"  --node-pid PID      process id of the node for measuring its cpu usage\n"
+		"  --output FILE       write the report into FILE (default: stdout)\n", name);
+} // printUsage
+
+void LoadGenerator::findNodeUser() {
+	unsigned short nodePort = 8081;
+	std::string::size_type colon = nodeName.rfind(':');
+
+	if (colon != std::string::npos)
+		nodePort = (unsigned short)atoi(nodeName.substr(colon + 1).c_str());
+
+	// the node is the participant we connected to, not one of its synthetic users
+	for (int i = 0; i < UserDatabase::getNumberOfRemoteUsers(); i++) {
+		User* user = UserDatabase::getRemoteUserByIndex(i);
+		if (user->getNetworkId().address.portTCP == nodePort) {
+			nodeUserId = user->getId();
+			nodeUserFound = true;
+			printd(INFO, "LoadGenerator::findNodeUser(): node user is %s (id %u)\n",
+					user->getName().c_str(), nodeUserId);
+			return;
+		} // if
+	} // for
+} // findNodeUser
+
+void LoadGenerator::sendPings() {
+	if (!nodeUserFound)
+		return;
+
+	for (unsigned i = 0; i < users.size(); i++) {
+		pendingPings[nextPingNumber] = i;
+		EventManager::sendEventTo(new SystemCorePingEvent(USER_DEFINED_ID, nextPingNumber,
+				payloadSize), nodeUserId);
+		userStatistics[i].pingsSent++;
+		nextPingNumber++;
+	} // for
+} // sendPings
+
+void LoadGenerator::receivePongs() {
+	Event* event;
+	SystemCorePongEvent* pong;
+	std::map<unsigned, unsigned>::iterator it;
+	EventPipe* incomingEvents = EventManager::getPipe(USER_DEFINED_ID);
+
+	while (incomingEvents->size() > 0) {
+		event = incomingEvents->pop_front();
+		pong = dynamic_cast<SystemCorePongEvent*>(event);
+		if (pong) {
+			it = pendingPings.find(pong->getPingNumber());
+			if (it != pendingPings.end()) {
+				userStatistics[it->second].eventRoundTrip.addSample(pong->getRoundTripTime());
+				pendingPings.erase(it);
+			} // if
+		} // if
+		delete event;
+	} // while
+} // receivePongs
+
+void LoadGenerator::updateManipulation(double time) {
+	unsigned current = ((unsigned)(time / MANIPULATION_TIME)) % users.size();
+
+	// stop first, so the entity never has two manipulation pipes
+	for (unsigned i = 0; i < users.size(); i++) {
+		if (i != current && users[i]->isManipulating())
+			users[i]->stopManipulation();
+	} // for
+	if (!users[current]->isManipulating())
+		users[current]->startManipulation(entityType, entityId);
+} // updateManipulation
+
+bool LoadGenerator::isKnownNetworkId(const NetworkIdentification& networkId) {
+	for (unsigned i = 0; i < knownNetworkIds.size(); i++) {
+		if (knownNetworkIds[i].address.ipAddress == networkId.address.ipAddress
+				&& knownNetworkIds[i].address.portTCP == networkId.address.portTCP
+				&& knownNetworkIds[i].processId == networkId.processId)
+			return true;
+	} // for
+	return false;
+} // isKnownNetworkId
+
+LoadGenerator::CpuTime LoadGenerator::getCpuTime() {
+	CpuTime result;
+	struct rusage usage;
+	char fileName[64];
+	unsigned long userTicks, systemTicks;
+
+	getrusage(RUSAGE_SELF, &usage);
+	result.generator = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6
+			+ usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+	result.node = 0;
+
+	if (nodeProcessId > 0) {
+		// utime and stime are the 14th and 15th field, the 2nd field may contain spaces
+		snprintf(fileName, sizeof(fileName), "/proc/%d/stat", nodeProcessId);
+		FILE* file = fopen(fileName, "r");
+		char line[1024];
+		if (file && fgets(line, sizeof(line), file)) {
+			const char* fields = strrchr(line, ')');
+			if (fields && sscanf(fields + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu",
+					&userTicks, &systemTicks) == 2)
+				result.node = (double)(userTicks + systemTicks) / sysconf(_SC_CLK_TCK);
+		} // if
+		if (file)
+			fclose(file);
+	} // if
+	return result;
+} // getCpuTime
+
+bool LoadGenerator::getLoopbackBytes(double& dst) {
+	char line[512];
+	double sent;
+	bool success = false;
+	FILE* file = fopen("/proc/net/dev", "r");
+
+	if (!file)
+		return false;
+	while (fgets(line, sizeof(line), file)) {
+		const char* entry = strstr(line, "lo:");
+		if (entry && sscanf(entry + 3, "%*f %*f %*f %*f %*f %*f %*f %*f %lf", &sent) == 1) {
+			// every packet on the loopback interface is sent and received
+			dst = sent;
+			success = true;
+			break;
+		} // if
+	} // while
+	fclose(file);
+	return success;
+} // getLoopbackBytes
+
+int main(int argc, char** argv) {
+	LoadGenerator generator;
+	bool success;
+
+	osgInit(argc, argv);
+	printd_severity(WARNING);
+
+	if (!generator.parseArguments(argc, argv)) {
+		LoadGenerator::printUsage(argv[0]);
+		return 2;
+	} // if
+
+	success = generator.init();
+	if (success) {
+		generator.run();
+		success = generator.writeReport();
+	} // if
+	generator.cleanup();
+
+	osgExit();
+	return success ? 0 : 1;
+} // main
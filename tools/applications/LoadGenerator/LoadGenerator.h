@@ -0,0 +1,117 @@
+#ifndef _LOADGENERATOR_H
+#define _LOADGENERATOR_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <inVRs/SystemCore/SystemCore.h>
+#include <inVRs/SystemCore/ComponentInterfaces/NetworkInterface.h>
+
+#include "LatencyStatistics.h"
+#include "SyntheticUser.h"
+
+/******************************************************************************
+ * Headless application which connects a number of SyntheticUsers to a running
+ * inVRs node and measures how the node copes with them.
+ *
+ * Every synthetic user writes navigation, head and hand sensor data with the
+ * configured rate and sends SystemCorePingEvents to the node, which are
+ * answered with SystemCorePongEvents. Optionally the synthetic users take
+ * turns in manipulating an entity of the world. At the end a report with the
+ * event round trip time, the bandwidth and the CPU usage per user is written.
+ * The latency of the transformations is measured by a second LoadGenerator
+ * connected to the same node (see TransformationLatencyModifier).
+ */
+class LoadGenerator {
+public:
+	LoadGenerator();
+	~LoadGenerator();
+
+	/** Parses the command line.
+	 * @return false if the command line is invalid
+	 */
+	bool parseArguments(int argc, char** argv);
+
+	/** Configures the SystemCore and connects to the node.
+	 */
+	bool init();
+
+	/** Runs the synthetic users for the configured duration.
+	 */
+	void run();
+
+	/** Writes the report into the output file or to stdout.
+	 */
+	bool writeReport();
+
+	void cleanup();
+
+	/** Announces the synthetic users to participants connecting later.
+	 */
+	void userConnected(User* user);
+
+	/** Registers the TransformationLatencyModifierFactory before the
+	 * TransformationManager configuration is loaded.
+	 */
+	static void initCoreComponents(CoreComponents comp);
+
+	static void printUsage(const char* name);
+
+private:
+	struct UserStatistics {
+		UserStatistics() : pingsSent(0) {}
+
+		unsigned pingsSent;
+		LatencyStatistics eventRoundTrip;
+	}; // UserStatistics
+
+	struct CpuTime {
+		double generator;
+		double node;
+	}; // CpuTime
+
+	void findNodeUser();
+	void sendPings();
+	void receivePongs();
+	void updateManipulation(double time);
+	bool isKnownNetworkId(const NetworkIdentification& networkId);
+	CpuTime getCpuTime();
+	bool getLoopbackBytes(double& dst);
+
+	// configuration
+	std::string configFile;
+	std::string modulesFile;
+	std::string nodeName;
+	unsigned numberOfUsers;
+	double duration;
+	double updateRate;
+	double eventRate;
+	unsigned payloadSize;
+	bool manipulateEntity;
+	unsigned entityType;
+	unsigned entityId;
+	int nodeProcessId;
+	std::string outputFile;
+
+	NetworkInterface* network;
+	unsigned nodeUserId;
+	bool nodeUserFound;
+	std::vector<SyntheticUser*> users;
+	std::vector<UserStatistics> userStatistics;
+	std::vector<NetworkIdentification> knownNetworkIds;
+	std::map<unsigned, unsigned> pendingPings; // ping number -> user index
+	unsigned nextPingNumber;
+	unsigned pingSize;
+
+	// filled by the TransformationLatencyModifier, the key is the user id
+	static std::map<unsigned, LatencyStatistics> transformationLatency;
+
+	// measurement
+	double runTime;
+	CpuTime cpuTime;
+	double loopbackBytes;
+	bool loopbackBytesValid;
+}; // LoadGenerator
+
+#endif // _LOADGENERATOR_H
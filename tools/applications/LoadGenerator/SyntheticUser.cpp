@@ -0,0 +1,167 @@
+#include "SyntheticUser.h"
+
+#include <math.h>
+#include <sstream>
+
+#include <inVRs/SystemCore/DebugOutput.h>
+#include <inVRs/SystemCore/EventManager/EventManager.h>
+#include <inVRs/SystemCore/TransformationManager/TransformationManager.h>
+#include <inVRs/SystemCore/TransformationManager/TransformationManagerEvents.h>
+#include <inVRs/SystemCore/UserDatabase/User.h>
+#include <inVRs/SystemCore/UserDatabase/UserDatabaseEvents.h>
+
+namespace {
+
+const unsigned NUMBER_OF_SENSORS = 2;
+const double WALK_RADIUS = 5;
+const double WALK_SPEED = 0.2; // rad/s on the circle
+
+/**
+ * The UserDatabaseAddUserEvent takes the number of sensors only from the
+ * ControllerManager of the local user, synthetic users set it directly. The
+ * event is received as regular UserDatabaseAddUserEvent.
+ */
+class SyntheticUserAddUserEvent : public UserDatabaseAddUserEvent {
+public:
+	SyntheticUserAddUserEvent(User* user, unsigned numberOfSensors) :
+		UserDatabaseAddUserEvent(user) {
+		this->numberOfSensors = numberOfSensors;
+	} // SyntheticUserAddUserEvent
+}; // SyntheticUserAddUserEvent
+
+gmtl::Quatf rotationY(double angle) {
+	return gmtl::Quatf(0, (float)sin(angle / 2), 0, (float)cos(angle / 2));
+} // rotationY
+
+} // namespace
+
+SyntheticUser::SyntheticUser(unsigned id, unsigned index, NetworkIdentification networkId) :
+	numberOfTransformations(0),
+	navigationPipe(NULL),
+	headPipe(NULL),
+	handPipe(NULL),
+	manipulationPipe(NULL) {
+	UserSetupData setupData;
+	std::stringstream name;
+
+	name << "SyntheticUser" << index;
+	setupData.name = name.str();
+	setupData.id = id;
+	setupData.cursorModelArguments = NULL;
+	setupData.userTransformationModelArguments = NULL;
+	setupData.networkId = networkId;
+	user = new User(&setupData);
+
+	// golden angle, so that the users are spread evenly on the circle
+	phase = fmod(index * 2.39996323, 2 * M_PI);
+	handTransformation = identityTransformation();
+} // SyntheticUser
+
+SyntheticUser::~SyntheticUser() {
+	disconnect();
+	delete user;
+} // ~SyntheticUser
+
+void SyntheticUser::connect() {
+	if (navigationPipe)
+		return;
+
+	EventManager::sendEvent(new SyntheticUserAddUserEvent(user, NUMBER_OF_SENSORS),
+			EventManager::EXECUTE_REMOTE);
+
+	// same pipes as opened for a remote user by UserDatabaseAddUserEvent::execute()
+	navigationPipe = TransformationManager::openPipe(NAVIGATION_MODULE_ID,
+			TRANSFORMATION_MANAGER_ID, 0, 0, 0, 0, 0, false, user);
+	headPipe = TransformationManager::openPipe(INPUT_INTERFACE_ID, USER_DATABASE_ID, 0, 0, 0,
+			0, 0xD0000000, false, user);
+	handPipe = TransformationManager::openPipe(INPUT_INTERFACE_ID, USER_DATABASE_ID, 1, 0, 0,
+			0, 0xD0000001, false, user);
+} // connect
+
+void SyntheticUser::announceTo(unsigned userId) {
+	EventManager::sendEventTo(new SyntheticUserAddUserEvent(user, NUMBER_OF_SENSORS), userId);
+} // announceTo
+
+void SyntheticUser::disconnect() {
+	if (!navigationPipe)
+		return;
+
+	stopManipulation();
+	TransformationManager::closePipe(navigationPipe);
+	TransformationManager::closePipe(headPipe);
+	TransformationManager::closePipe(handPipe);
+	navigationPipe = headPipe = handPipe = NULL;
+
+	EventManager::sendEvent(new UserDatabaseRemoveUserEvent(user), EventManager::EXECUTE_REMOTE);
+} // disconnect
+
+void SyntheticUser::update(double time) {
+	TransformationData navigation, head, hand;
+	double angle = phase + time * WALK_SPEED;
+
+	if (!navigationPipe)
+		return;
+
+	navigation = identityTransformation();
+	navigation.position = gmtl::Vec3f((float)(WALK_RADIUS * cos(angle)), 0,
+			(float)(WALK_RADIUS * sin(angle)));
+	navigation.orientation = rotationY(-angle);
+
+	head = identityTransformation();
+	head.position = gmtl::Vec3f(0, (float)(1.7 + 0.03 * sin(4 * M_PI * time + phase)), 0);
+	head.orientation = rotationY(0.3 * sin(0.5 * time + phase));
+
+	hand = identityTransformation();
+	hand.position = gmtl::Vec3f(0.25f, (float)(1.2 + 0.15 * sin(2 * M_PI * time + phase)),
+			(float)(-0.3 + 0.1 * cos(2 * M_PI * time + phase)));
+
+	multiply(handTransformation, navigation, hand);
+
+	navigationPipe->push_back(navigation);
+	headPipe->push_back(head);
+	handPipe->push_back(hand);
+	numberOfTransformations += 3;
+
+	if (manipulationPipe) {
+		manipulationPipe->push_back(handTransformation);
+		numberOfTransformations++;
+	} // if
+} // update
+
+void SyntheticUser::startManipulation(unsigned entityType, unsigned entityId) {
+	if (!navigationPipe || manipulationPipe)
+		return;
+
+	// same pipe as opened by the Interaction module
+	manipulationPipe = TransformationManager::openPipe(INTERACTION_MODULE_ID, WORLD_DATABASE_ID,
+			1, 0, entityType, entityId, 0, false, user);
+	EventManager::sendEvent(new TransformationManagerOpenPipeEvent(INTERACTION_MODULE_ID,
+			WORLD_DATABASE_ID, 1, 0, entityType, entityId, 0, user->getId()),
+			EventManager::EXECUTE_REMOTE);
+} // startManipulation
+
+void SyntheticUser::stopManipulation() {
+	if (!manipulationPipe)
+		return;
+
+	EventManager::sendEvent(new TransformationManagerClosePipeEvent(manipulationPipe),
+			EventManager::EXECUTE_REMOTE);
+	TransformationManager::closePipe(manipulationPipe);
+	manipulationPipe = NULL;
+} // stopManipulation
+
+bool SyntheticUser::isManipulating() {
+	return manipulationPipe != NULL;
+} // isManipulating
+
+unsigned SyntheticUser::getId() {
+	return user->getId();
+} // getId
+
+User* SyntheticUser::getUser() {
+	return user;
+} // getUser
+
+unsigned SyntheticUser::getNumberOfTransformations() {
+	return numberOfTransformations;
+} // getNumberOfTransformations
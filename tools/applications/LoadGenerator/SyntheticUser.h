@@ -0,0 +1,76 @@
+#ifndef _SYNTHETICUSER_H
+#define _SYNTHETICUSER_H
+
+#include <inVRs/SystemCore/DataTypes.h>
+#include <inVRs/SystemCore/ComponentInterfaces/NetworkInterface.h>
+
+class User;
+class TransformationPipe;
+
+/******************************************************************************
+ * A user without a display or tracking system which is simulated by the
+ * LoadGenerator. The user walks on a circle through the world, its head and
+ * hand sensor data follow a scripted motion. All synthetic users of one
+ * process share the network connection of the local user (the Network module
+ * supports only one instance per process), the other participants see them as
+ * independent users with two tracking sensors.
+ *
+ * The transformations are written into the same TransformationPipes a real
+ * user would use (navigation, head and hand sensor and the manipulation pipe
+ * of an entity), the TransformationDistributionModifier configured for these
+ * pipes sends them to the other participants.
+ */
+class SyntheticUser {
+public:
+	/** Constructor.
+	 * @param id user id announced to the other participants
+	 * @param index index of the user, used for the phase of the motion
+	 * @param networkId network identification of the local process
+	 */
+	SyntheticUser(unsigned id, unsigned index, NetworkIdentification networkId);
+	~SyntheticUser();
+
+	/** Announces the user to the other participants and opens the pipes.
+	 */
+	void connect();
+
+	/** Announces the user to a participant which connected after connect().
+	 */
+	void announceTo(unsigned userId);
+
+	/** Closes all pipes and removes the user at the other participants.
+	 */
+	void disconnect();
+
+	/** Writes the scripted navigation and sensor data for the given time.
+	 * @param time time since start of the generator in seconds
+	 */
+	void update(double time);
+
+	/** Opens the manipulation pipe for the given entity locally and at the
+	 * other participants. Following calls of update() move the entity with
+	 * the hand of the user.
+	 */
+	void startManipulation(unsigned entityType, unsigned entityId);
+	void stopManipulation();
+	bool isManipulating();
+
+	unsigned getId();
+	User* getUser();
+
+	/** Returns the number of TransformationData written into the pipes.
+	 */
+	unsigned getNumberOfTransformations();
+
+private:
+	User* user;
+	double phase;
+	unsigned numberOfTransformations;
+	TransformationPipe* navigationPipe;
+	TransformationPipe* headPipe;
+	TransformationPipe* handPipe;
+	TransformationPipe* manipulationPipe;
+	TransformationData handTransformation;
+}; // SyntheticUser
+
+#endif // _SYNTHETICUSER_H
@@ -0,0 +1,46 @@
+#include "TransformationLatencyModifier.h"
+
+#include <inVRs/SystemCore/Timer.h>
+#include <inVRs/SystemCore/TransformationManager/TransformationPipe.h>
+#include <inVRs/SystemCore/UserDatabase/User.h>
+
+TransformationLatencyModifier::TransformationLatencyModifier(
+		std::map<unsigned, LatencyStatistics>* statistics) :
+	statistics(statistics),
+	lastTimestamp(0) {
+} // TransformationLatencyModifier
+
+TransformationData TransformationLatencyModifier::execute(TransformationData* resultLastStage,
+		TransformationPipe* currentPipe) {
+	double sendTime;
+	User* owner = currentPipe->getOwner();
+	int size = currentPipe->size();
+
+	if (!owner || size == 0 || !currentPipe->hasRemoteSendTimestamps())
+		return *resultLastStage;
+
+	// the pipe executes with the newest entry until the next update arrives
+	sendTime = currentPipe->getTimestamp(size - 1);
+	if (sendTime > lastTimestamp) {
+		lastTimestamp = sendTime;
+		(*statistics)[owner->getId()].addSample(
+				inVRsUtilities::Timer::getMonotonicTime() - sendTime);
+	} // if
+
+	return *resultLastStage;
+} // execute
+
+TransformationLatencyModifierFactory::TransformationLatencyModifierFactory(
+		std::map<unsigned, LatencyStatistics>* statistics) :
+	statistics(statistics) {
+	className = "TransformationLatencyModifier";
+} // TransformationLatencyModifierFactory
+
+TransformationModifier* TransformationLatencyModifierFactory::createInternal(
+		ArgumentVector*) {
+	return new TransformationLatencyModifier(statistics);
+} // createInternal
+
+bool TransformationLatencyModifierFactory::needInstanceForEachPipe() {
+	return true;
+} // needInstanceForEachPipe
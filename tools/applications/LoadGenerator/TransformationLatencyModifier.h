@@ -0,0 +1,45 @@
+#ifndef _TRANSFORMATIONLATENCYMODIFIER_H
+#define _TRANSFORMATIONLATENCYMODIFIER_H
+
+#include <map>
+
+#include <inVRs/SystemCore/TransformationManager/TransformationModifierFactory.h>
+
+#include "LatencyStatistics.h"
+
+/******************************************************************************
+ * Measures the latency of TransformationData received from the network. The
+ * latency is the time between the send time stamped by the TransformationManager
+ * of the sender and the first execution of the pipe with the data, it is
+ * stored per pipe owner. Data received before the network time of both
+ * processes is synchronised has no send time and is ignored.
+ * @see TransformationPipe::hasRemoteSendTimestamps()
+ */
+class TransformationLatencyModifier : public TransformationModifier {
+public:
+	TransformationLatencyModifier(std::map<unsigned, LatencyStatistics>* statistics);
+
+	virtual TransformationData execute(TransformationData* resultLastStage,
+			TransformationPipe* currentPipe);
+
+protected:
+	std::map<unsigned, LatencyStatistics>* statistics;
+	/// send time of the last measured entry of the pipe
+	double lastTimestamp;
+}; // TransformationLatencyModifier
+
+class TransformationLatencyModifierFactory : public TransformationModifierFactory {
+public:
+	/** Constructor.
+	 * @param statistics map where the latency of each user is stored
+	 */
+	TransformationLatencyModifierFactory(std::map<unsigned, LatencyStatistics>* statistics);
+
+protected:
+	virtual TransformationModifier* createInternal(ArgumentVector*);
+	virtual bool needInstanceForEachPipe();
+
+	std::map<unsigned, LatencyStatistics>* statistics;
+}; // TransformationLatencyModifierFactory
+
+#endif // _TRANSFORMATIONLATENCYMODIFIER_H
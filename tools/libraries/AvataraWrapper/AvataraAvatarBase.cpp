@@ -31,6 +31,7 @@
 #include <memory>
 
 #include <gmtl/MatrixOps.h>
+#include <gmtl/VecOps.h>
 
 #include <irrXML.h>
 
@@ -40,12 +41,18 @@
 #include <inVRs/SystemCore/DebugOutput.h>
 #include <inVRs/SystemCore/Configuration.h>
 #include <inVRs/SystemCore/UserDatabase/User.h>
+#include <inVRs/SystemCore/UserDatabase/UserDatabase.h>
 #include <inVRs/SystemCore/UtilityFunctions.h>
 
 using namespace io;
 
 const int AvataraAvatarBase::defaultTransitionTime = 250;
 XmlConfigurationLoader AvataraAvatarBase::xmlConfigLoader;
+std::map<std::string, AvataraAvatarBase::SharedResource<Avatara::Model> >
+		AvataraAvatarBase::sharedModels;
+std::map<std::string, AvataraAvatarBase::SharedResource<Avatara::Animation> >
+		AvataraAvatarBase::sharedAnimations;
+Avatara::PoseCache AvataraAvatarBase::poseCache;
 
 AvataraAvatarBase::AvataraAvatarBase() :
 	smoothAnimation(true),
@@ -58,7 +65,14 @@ AvataraAvatarBase::AvataraAvatarBase() :
 	avatarInitialized(false),
 	avatarGeometryBuilt(false),
 	avatar(NULL),
-	modelTransform(IdentityTransformation) {
+	modelTransform(IdentityTransformation),
+	lodNearDistance(10.f),
+	lodFarDistance(50.f),
+	lodMinUpdateRate(10.f),
+	timeSinceGeoUpdate(0),
+	geoUpdatePending(false),
+	avatarPosition(0, 0, 0),
+	model(NULL) {
 	if (!xmlConfigLoader.hasConverters()) {
 		xmlConfigLoader.registerConverter(new ConverterToV1_0a4);
 	}
@@ -66,13 +80,16 @@ AvataraAvatarBase::AvataraAvatarBase() :
 
 AvataraAvatarBase::~AvataraAvatarBase() {
 	std::vector<Avatara::Animation*>::iterator it;
+
+	delete avatar;
+
 	for (it = animations.begin(); it != animations.end(); ++it) {
-		delete *it;
+		releaseAnimation(*it);
 	} // for
 	animations.clear();
 
-	delete avatar;
-	//TODO delete also the model?
+	if (model)
+		releaseModel(model);
 
 } // ~AvataraAvatarBase
 
@@ -100,7 +117,8 @@ bool AvataraAvatarBase::loadConfig(std::string configFile) {
 	// load avatar model
 	std::string avatarPath = Configuration::getPath("Avatars");
 	std::string modelFile = document->getAttributeValue("avataraAvatar.representation.file.name");
-	if (!model.Load((avatarPath + modelFile).c_str())) {
+	model = acquireModel(avatarPath + modelFile);
+	if (!model) {
 		printd(ERROR, "AvatatarAvatar::loadConfig(): error loading model %s!\n", modelFile.c_str());
 		success = false;
 	} // if
@@ -126,6 +144,17 @@ bool AvataraAvatarBase::loadConfig(std::string configFile) {
 	} // if
 	defaultAnimation = document->getAttributeValue("avataraAvatar.animations.default");
 
+	// read level of detail for the geometry updates
+	if (document->hasAttribute("avataraAvatar.lod.nearDistance")) {
+		lodNearDistance = document->getAttributeValueAsFloat("avataraAvatar.lod.nearDistance");
+	} // if
+	if (document->hasAttribute("avataraAvatar.lod.farDistance")) {
+		lodFarDistance = document->getAttributeValueAsFloat("avataraAvatar.lod.farDistance");
+	} // if
+	if (document->hasAttribute("avataraAvatar.lod.minUpdateRate")) {
+		lodMinUpdateRate = document->getAttributeValueAsFloat("avataraAvatar.lod.minUpdateRate");
+	} // if
+
 	// read animations
 	std::vector<const XmlElement*> animationElements =
 		document->getElements("avataraAvatar.animations.animation");
@@ -134,14 +163,15 @@ bool AvataraAvatarBase::loadConfig(std::string configFile) {
 	std::string animationFile;
 	std::string animationName;
 	for (animIt = animationElements.begin(); animIt != animationElements.end(); ++animIt) {
-		anim = new Avatara::Animation();
 		animationFile = (*animIt)->getAttributeValue("file");
 		printd(INFO, "AvataraAvatarBase::loadConfig(): Trying to load animation %s\n", (avatarPath + animationFile).c_str());
-		if (!anim->Load((avatarPath+animationFile).c_str())) {
+		anim = acquireAnimation(avatarPath + animationFile);
+		if (!anim) {
 			printd(ERROR, "AvataraAvatarBase::loadConfig(): error loading animation %s!\n", animationFile.c_str());
 			success = false;
 			break;
 		} // if
+		animations.push_back(anim);
 		animationName = (*animIt)->getAttributeValue("name");
 		animationSet.Add(animationName, anim);
 	} // for
@@ -196,6 +226,7 @@ void AvataraAvatarBase::setTransformation(TransformationData trans) {
 
 	gmtl::Matrix44f matrix;
 	transformationDataToMatrix(trans, matrix);
+	avatarPosition = trans.position;
 
 	setAvatarTransformation(matrix);
 } // setTransformation
@@ -226,8 +257,9 @@ void AvataraAvatarBase::checkAvatarBuilt() {
 
 	avatar = buildAvatar();
 
-	avatar->SetModel(&model);
+	avatar->SetModel(model);
 	avatar->SetAnimations(&animationSet);
+	avatar->SetPoseCache(&poseCache);
 	avatar->SmoothAnimation(smoothAnimation);
 	avatar->SetSpeed(speed);
 
@@ -271,10 +303,15 @@ bool AvataraAvatarBase::isVisible() {
 } // isVisible
 
 void AvataraAvatarBase::update(float dt) {
-	int animTime;
+	if (beginUpdate(dt))
+		updateParallel();
+	endUpdate();
+} // update
 
-	if (avatarGeometryBuilt)
-		updateAvatarGeo(avatar);
+bool AvataraAvatarBase::beginUpdate(float dt) {
+	int animTime;
+	float distance, updateInterval;
+	bool geometryBuilt = avatarGeometryBuilt;
 
 	if (singleRunAnimation) {
 		animTime = avatar->GetAnimationTime();
@@ -291,7 +328,53 @@ void AvataraAvatarBase::update(float dt) {
 
 	setHeadTransformation(owner->getUserHeadTransformation());
 	setHandTransformation(owner->getUserHandTransformation());
-} // update
+
+	geoUpdatePending = false;
+	if (!geometryBuilt)
+		return false;
+
+	timeSinceGeoUpdate += dt;
+	if (!isVisible())
+		return false;
+
+	// reduce the update rate of distant avatars
+	updateInterval = 0;
+	User* localUser = UserDatabase::getLocalUser();
+	if (localUser && localUser != owner && lodMinUpdateRate > 0) {
+		distance = gmtl::length(gmtl::Vec3f(avatarPosition -
+				localUser->getWorldHeadTransformation().position));
+		if (distance >= lodFarDistance)
+			updateInterval = 1.f / lodMinUpdateRate;
+		else if (distance > lodNearDistance)
+			updateInterval = (distance - lodNearDistance) / (lodFarDistance - lodNearDistance)
+					/ lodMinUpdateRate;
+	} // if
+	if (timeSinceGeoUpdate < updateInterval)
+		return false;
+
+	timeSinceGeoUpdate = 0;
+	geoUpdatePending = true;
+	beginAvatarGeoUpdate(avatar);
+	return true;
+} // beginUpdate
+
+void AvataraAvatarBase::updateParallel() {
+	if (geoUpdatePending)
+		skinAvatarGeo(avatar);
+} // updateParallel
+
+void AvataraAvatarBase::endUpdate() {
+	if (geoUpdatePending)
+		endAvatarGeoUpdate(avatar);
+	geoUpdatePending = false;
+} // endUpdate
+
+void AvataraAvatarBase::setUpdateRateLod(float nearDistance, float farDistance,
+		float minUpdateRate) {
+	lodNearDistance = nearDistance;
+	lodFarDistance = farDistance;
+	lodMinUpdateRate = minUpdateRate;
+} // setUpdateRateLod
 
 bool AvataraAvatarBase::startAnimation(std::string animationType, int transitionTime) {
 	printd(INFO, "AvataraAvatarBase::startAnimation(): Trying to start Animation %s\n",
@@ -323,6 +406,75 @@ void AvataraAvatarBase::stopAnimation() {
 
 
 
+//*****************************************************************************
+// Resources shared by all avatars
+//*****************************************************************************
+Avatara::Model* AvataraAvatarBase::acquireModel(std::string file) {
+	std::map<std::string, SharedResource<Avatara::Model> >::iterator it;
+	it = sharedModels.find(file);
+	if (it != sharedModels.end()) {
+		it->second.refCount++;
+		return it->second.resource;
+	} // if
+
+	Avatara::Model* model = new Avatara::Model();
+	if (!model->Load(file.c_str())) {
+		delete model;
+		return NULL;
+	} // if
+	SharedResource<Avatara::Model>& entry = sharedModels[file];
+	entry.resource = model;
+	entry.refCount = 1;
+	return model;
+} // acquireModel
+
+void AvataraAvatarBase::releaseModel(Avatara::Model* model) {
+	std::map<std::string, SharedResource<Avatara::Model> >::iterator it;
+	for (it = sharedModels.begin(); it != sharedModels.end(); ++it) {
+		if (it->second.resource != model)
+			continue;
+		if (--it->second.refCount == 0) {
+			poseCache.Remove(&model->GetSkeleton());
+			delete model;
+			sharedModels.erase(it);
+		} // if
+		return;
+	} // for
+} // releaseModel
+
+Avatara::Animation* AvataraAvatarBase::acquireAnimation(std::string file) {
+	std::map<std::string, SharedResource<Avatara::Animation> >::iterator it;
+	it = sharedAnimations.find(file);
+	if (it != sharedAnimations.end()) {
+		it->second.refCount++;
+		return it->second.resource;
+	} // if
+
+	Avatara::Animation* animation = new Avatara::Animation();
+	if (!animation->Load(file.c_str())) {
+		delete animation;
+		return NULL;
+	} // if
+	SharedResource<Avatara::Animation>& entry = sharedAnimations[file];
+	entry.resource = animation;
+	entry.refCount = 1;
+	return animation;
+} // acquireAnimation
+
+void AvataraAvatarBase::releaseAnimation(Avatara::Animation* animation) {
+	std::map<std::string, SharedResource<Avatara::Animation> >::iterator it;
+	for (it = sharedAnimations.begin(); it != sharedAnimations.end(); ++it) {
+		if (it->second.resource != animation)
+			continue;
+		if (--it->second.refCount == 0) {
+			poseCache.Remove(animation);
+			delete animation;
+			sharedAnimations.erase(it);
+		} // if
+		return;
+	} // for
+} // releaseAnimation
+
 //*****************************************************************************
 // Configuration loading
 //*****************************************************************************
@@ -38,9 +38,11 @@
 
 #include "AvataraWrapperExports.h"
 
+#include <map>
 #include <string>
 
 #include <avatara/Avatar.h>
+#include <avatara/PoseCache.h>
 
 #include <inVRs/SystemCore/DataTypes.h>
 #include <inVRs/SystemCore/XmlConfigurationConverter.h>
@@ -96,6 +98,32 @@ public:
 	 */
 	virtual void update(float dt);
 
+	/**
+	 * Updates the animation state and decides if the geometry has to be
+	 * skinned in this frame (see setUpdateRateLod).
+	 * @return true if updateParallel() has to be called
+	 */
+	virtual bool beginUpdate(float dt);
+
+	/**
+	 * Skins the avatar geometry, may be called from a worker thread.
+	 */
+	virtual void updateParallel();
+
+	/**
+	 * Commits the skinned geometry.
+	 */
+	virtual void endUpdate();
+
+	/**
+	 * Sets the level of detail for the geometry updates. Avatars closer than
+	 * nearDistance to the local user are skinned every frame, the update rate
+	 * of avatars further away is reduced linearly down to minUpdateRate (in
+	 * updates per second) at farDistance. The avatar of the local user is
+	 * always skinned every frame.
+	 */
+	void setUpdateRateLod(float nearDistance, float farDistance, float minUpdateRate);
+
 	/**
 	 * Starts an animation loop using the animation with the passed name.
 	 */
@@ -113,7 +141,9 @@ public:
 
 protected:
 	virtual Avatara::Avatar* buildAvatar() = 0;
-	virtual void updateAvatarGeo(Avatara::Avatar* avatar) = 0;
+	virtual void beginAvatarGeoUpdate(Avatara::Avatar* avatar) = 0;
+	virtual void skinAvatarGeo(Avatara::Avatar* avatar) = 0;
+	virtual void endAvatarGeoUpdate(Avatara::Avatar* avatar) = 0;
 	virtual ModelInterface* buildAvatarModel() = 0;
 	virtual void setAvatarOffset(gmtl::Matrix44f m) = 0;
 	virtual void setAvatarTransformation(gmtl::Matrix44f m) = 0;
@@ -164,15 +194,44 @@ private:
 
 	TransformationData modelTransform;	// model transformation (from config file)
 
-	/// Avatar model.
-	Avatara::Model model;
-	/// Avatar animation.
+	float lodNearDistance;			// distance up to which the geometry is updated every frame
+	float lodFarDistance;			// distance from which on minUpdateRate is used
+	float lodMinUpdateRate;			// geometry updates per second at lodFarDistance
+	float timeSinceGeoUpdate;		// time since the last geometry update
+	bool geoUpdatePending;			// stores if the geometry is skinned in the current frame
+	gmtl::Vec3f avatarPosition;		// world position of the avatar
+
+	/// Avatar model (shared by all avatars using the same model file).
+	Avatara::Model* model;
+	/// Avatar animations (shared by all avatars using the same animation file).
 	std::vector<Avatara::Animation*> animations;
 	/// Animation set for all avatar animations.
 	Avatara::AnimationSet animationSet;
 
 	ModelInterface* avatarModel;
 
+//*****************************************************************************
+// Resources shared by all avatars
+//*****************************************************************************
+private:
+	template <class T>
+	struct SharedResource {
+		T* resource;
+		int refCount;
+	}; // SharedResource
+
+	static Avatara::Model* acquireModel(std::string file);
+	static void releaseModel(Avatara::Model* model);
+	static Avatara::Animation* acquireAnimation(std::string file);
+	static void releaseAnimation(Avatara::Animation* animation);
+
+	/// Loaded models, indexed by file name
+	static std::map<std::string, SharedResource<Avatara::Model> > sharedModels;
+	/// Loaded animations, indexed by file name
+	static std::map<std::string, SharedResource<Avatara::Animation> > sharedAnimations;
+	/// Poses of the shared animations, evaluated once per animation phase
+	static Avatara::PoseCache poseCache;
+
 //*****************************************************************************
 // Configuration loading
 //*****************************************************************************
@@ -77,9 +77,19 @@ void OpenSGAvataraAvatar::setAvatarOffset(gmtl::Matrix44f matrix) {
 #endif
 }
 
-void OpenSGAvataraAvatar::updateAvatarGeo(Avatara::Avatar* a) {
+void OpenSGAvataraAvatar::beginAvatarGeoUpdate(Avatara::Avatar* a) {
 	Avatara::OSGAvatar* avatar = dynamic_cast<Avatara::OSGAvatar*>(a);
-	avatar->UpdateAvatarGeo();
+	avatar->BeginAvatarGeoUpdate();
+}
+
+void OpenSGAvataraAvatar::skinAvatarGeo(Avatara::Avatar* a) {
+	Avatara::OSGAvatar* avatar = static_cast<Avatara::OSGAvatar*>(a);
+	avatar->SkinAvatarGeo();
+}
+
+void OpenSGAvataraAvatar::endAvatarGeoUpdate(Avatara::Avatar* a) {
+	Avatara::OSGAvatar* avatar = dynamic_cast<Avatara::OSGAvatar*>(a);
+	avatar->EndAvatarGeoUpdate();
 }
 
 ModelInterface* OpenSGAvataraAvatar::buildAvatarModel() {
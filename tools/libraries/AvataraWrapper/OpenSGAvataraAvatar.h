@@ -51,7 +51,9 @@ protected:
 	Avatara::Avatar* buildAvatar();
 	ModelInterface* buildAvatarModel();
 
-	void updateAvatarGeo(Avatara::Avatar* avatar);
+	void beginAvatarGeoUpdate(Avatara::Avatar* avatar);
+	void skinAvatarGeo(Avatara::Avatar* avatar);
+	void endAvatarGeoUpdate(Avatara::Avatar* avatar);
 
 	void setAvatarTransformation(gmtl::Matrix44f m);
 	void setAvatarOffset(gmtl::Matrix44f m);
@@ -0,0 +1,120 @@
+// compile DEBUG messages out of the PRINTD macros for this benchmark:
+#define INVRS_PRINTD_MIN_SEVERITY 1
+
+#include <inVRs/SystemCore/DebugOutput.h>
+#include <inVRs/SystemCore/Timer.h>
+
+#include <avatara/Avatar.h>
+#include <avatara/PoseCache.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#ifndef BENCHMARK_AVATAR_DIR
+#define BENCHMARK_AVATAR_DIR "tutorials/GoingImmersive/models/avatars/undead/"
+#endif
+
+static const unsigned NUM_AVATARS = 100;
+static const unsigned NUM_PHASES = 4;
+static const unsigned NUM_FRAMES = 200;
+static const int FRAME_TIME = 16;
+
+/** Avatar which evaluates the animation at a given time.
+ */
+class BenchmarkAvatar : public Avatara::Avatar {
+public:
+	void evaluate(int time) {
+		SetAnimationTime(time);
+		currentPose.time = time - FRAME_TIME;
+		CalculatePose();
+	} // evaluate
+
+	const Algebra::Matrix& getBoneMatrix(int boneID) const {
+		return pBoneMatrices[boneID];
+	} // getBoneMatrix
+}; // BenchmarkAvatar
+
+static double evaluateCrowd(std::vector<BenchmarkAvatar*>& avatars, int animationLength) {
+	unsigned i, frame;
+	double start = inVRsUtilities::Timer::getMonotonicTime();
+	for (frame = 0; frame < NUM_FRAMES; frame++) {
+		for (i = 0; i < avatars.size(); i++) {
+			int phase = (i % NUM_PHASES) * animationLength / NUM_PHASES;
+			avatars[i]->evaluate((phase + frame * FRAME_TIME) % animationLength);
+		} // for
+	} // for
+	return inVRsUtilities::Timer::getMonotonicTime() - start;
+} // evaluateCrowd
+
+/** Benchmark for the animation pose evaluation of a crowd of Avatara avatars
+ * walking in a few distinct animation phases (like remote users started by
+ * the same AvatarAnimationWriter event).
+ * The evaluation of every avatar on its own is compared with avatars sharing
+ * a PoseCache. The path to the undead model of the GoingImmersive tutorial
+ * can be passed as first argument.
+ */
+int main(int argc, char **argv) {
+	unsigned i;
+	std::string avatarDir = (argc > 1) ? argv[1] : BENCHMARK_AVATAR_DIR;
+	Avatara::Model model;
+	Avatara::Animation animation;
+	Avatara::AnimationSet animationSet;
+	Avatara::PoseCache poseCache;
+
+	printd_severity(WARNING);
+
+	if (!model.Load((avatarDir + "undead.mdl").c_str()) ||
+			!animation.Load((avatarDir + "undead_walking.ani").c_str())) {
+		fprintf(stderr, "Could not load the avatar from %s\n", avatarDir.c_str());
+		return 1;
+	} // if
+	animationSet.Add("walk", &animation);
+
+	std::vector<BenchmarkAvatar*> avatars;
+	for (i = 0; i < NUM_AVATARS; i++) {
+		BenchmarkAvatar* avatar = new BenchmarkAvatar;
+		avatar->SetModel(&model);
+		avatar->SetAnimations(&animationSet);
+		avatar->SmoothAnimation(true);
+		avatar->SetAnimation("walk");
+		avatar->StartAnimation();
+		avatars.push_back(avatar);
+	} // for
+
+	double uncachedTime = evaluateCrowd(avatars, animation.GetAnimationLength());
+	std::vector<Algebra::Matrix> reference;
+	for (i = 0; i < NUM_PHASES; i++)
+		reference.push_back(avatars[i]->getBoneMatrix(model.GetSkeleton().GetNoOfBones() - 1));
+
+	for (i = 0; i < NUM_AVATARS; i++)
+		avatars[i]->SetPoseCache(&poseCache);
+	double cachedTime = evaluateCrowd(avatars, animation.GetAnimationLength());
+
+	float maxError = 0;
+	for (i = 0; i < NUM_PHASES; i++) {
+		const Algebra::Matrix& m = avatars[i]->getBoneMatrix(model.GetSkeleton().GetNoOfBones()
+				- 1);
+		for (int row = 0; row < 4; row++) {
+			for (int column = 0; column < 4; column++) {
+				float error = fabsf(m.M(row, column) - reference[i].M(row, column));
+				if (error > maxError)
+					maxError = error;
+			} // for
+		} // for
+	} // for
+
+	printf("%u avatars in %u animation phases, %d bones, time quantum %d ms\n", NUM_AVATARS,
+			NUM_PHASES, model.GetSkeleton().GetNoOfBones(), poseCache.GetTimeQuantum());
+	printf("%28s %12s\n", "", "[us/avatar]");
+	printf("%28s %12.3f\n", "own pose per avatar", uncachedTime * 1e6 / (NUM_FRAMES
+			* NUM_AVATARS));
+	printf("%28s %12.3f\n", "shared PoseCache", cachedTime * 1e6 / (NUM_FRAMES * NUM_AVATARS));
+	printf("cached poses %d, hits %d, misses %d, max. difference %f\n", poseCache.GetNoOfPoses(),
+			poseCache.GetNoOfHits(), poseCache.GetNoOfMisses(), maxError);
+
+	for (i = 0; i < NUM_AVATARS; i++)
+		delete avatars[i];
+	return 0;
+}
@@ -0,0 +1,137 @@
+// compile DEBUG messages out of the PRINTD macros for this benchmark:
+#define INVRS_PRINTD_MIN_SEVERITY 1
+
+#include <inVRs/SystemCore/DebugOutput.h>
+#include <inVRs/SystemCore/Timer.h>
+#include <inVRs/SystemCore/WorkerPool.h>
+
+#include <avatara/Avatar.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#ifndef BENCHMARK_AVATAR_DIR
+#define BENCHMARK_AVATAR_DIR "tutorials/GoingImmersive/models/avatars/undead/"
+#endif
+
+static const unsigned NUM_AVATARS = 30;
+static const unsigned NUM_FRAMES = 100;
+
+/** Avatar which allows to set the pose directly.
+ */
+class BenchmarkAvatar : public Avatara::Avatar {
+public:
+	void setPose(int time) {
+		SetAnimationTime(time);
+		CalculatePose();
+	} // setPose
+}; // BenchmarkAvatar
+
+struct SkinningJob {
+	std::vector<BenchmarkAvatar*>* avatars;
+	std::vector<std::vector<float> >* positions;
+	std::vector<std::vector<float> >* normals;
+};
+
+/** Skinning as done before SkinVertices: every vertex is skinned by its own.
+ */
+static void skinVertexByVertex(Avatara::Avatar* avatar, const Avatara::Model& model,
+		std::vector<float>& positions) {
+	int i;
+	for (i = 0; i < model.GetNoOfVertices(); i++) {
+		Algebra::Vector pnt = avatar->SkinVertex(model.GetVertex(i));
+		positions[3*i] = pnt.X();
+		positions[3*i+1] = pnt.Y();
+		positions[3*i+2] = pnt.Z();
+	} // for
+} // skinVertexByVertex
+
+static void skinAvatar(unsigned index, void* userData) {
+	SkinningJob* job = (SkinningJob*)userData;
+	(*job->avatars)[index]->SkinVertices(&(*job->positions)[index][0],
+			&(*job->normals)[index][0], 3);
+} // skinAvatar
+
+/** Benchmark for the skinning of a crowd of Avatara avatars.
+ * The per-vertex SkinVertex loop of the old OSGAvatar::UpdateAvatarGeo is
+ * compared with the batched SkinVertices kernel, run serially and in a
+ * WorkerPool. The path to the undead model of the GoingImmersive tutorial
+ * can be passed as first argument.
+ */
+int main(int argc, char **argv) {
+	unsigned i, frame;
+	std::string avatarDir = (argc > 1) ? argv[1] : BENCHMARK_AVATAR_DIR;
+	Avatara::Model model;
+	Avatara::Animation animation;
+	Avatara::AnimationSet animationSet;
+
+	printd_severity(WARNING);
+
+	if (!model.Load((avatarDir + "undead.mdl").c_str()) ||
+			!animation.Load((avatarDir + "undead_walking.ani").c_str())) {
+		fprintf(stderr, "Could not load the avatar from %s\n", avatarDir.c_str());
+		return 1;
+	} // if
+	animationSet.Add("walk", &animation);
+
+	unsigned noOfVertices = model.GetNoOfVertices();
+	std::vector<BenchmarkAvatar*> avatars;
+	std::vector<std::vector<float> > reference(NUM_AVATARS, std::vector<float>(3*noOfVertices));
+	std::vector<std::vector<float> > positions(NUM_AVATARS, std::vector<float>(3*noOfVertices));
+	std::vector<std::vector<float> > normals(NUM_AVATARS, std::vector<float>(3*noOfVertices));
+	for (i = 0; i < NUM_AVATARS; i++) {
+		BenchmarkAvatar* avatar = new BenchmarkAvatar;
+		avatar->SetModel(&model);
+		avatar->SetAnimations(&animationSet);
+		avatar->SetAnimation("walk");
+		avatar->setPose(37 * i);
+		avatars.push_back(avatar);
+	} // for
+
+	double start = inVRsUtilities::Timer::getMonotonicTime();
+	for (frame = 0; frame < NUM_FRAMES; frame++) {
+		for (i = 0; i < NUM_AVATARS; i++)
+			skinVertexByVertex(avatars[i], model, reference[i]);
+	} // for
+	double vertexTime = inVRsUtilities::Timer::getMonotonicTime() - start;
+
+	start = inVRsUtilities::Timer::getMonotonicTime();
+	for (frame = 0; frame < NUM_FRAMES; frame++) {
+		for (i = 0; i < NUM_AVATARS; i++)
+			avatars[i]->SkinVertices(&positions[i][0], &normals[i][0], 3);
+	} // for
+	double batchTime = inVRsUtilities::Timer::getMonotonicTime() - start;
+
+	float maxError = 0;
+	for (i = 0; i < NUM_AVATARS; i++) {
+		for (unsigned j = 0; j < 3*noOfVertices; j++) {
+			float error = fabsf(positions[i][j] - reference[i][j]);
+			if (error > maxError)
+				maxError = error;
+		} // for
+	} // for
+
+	WorkerPool pool("benchmarkAvataraSkinning", WorkerPool::getDefaultNumberOfThreads());
+	SkinningJob job = { &avatars, &positions, &normals };
+	start = inVRsUtilities::Timer::getMonotonicTime();
+	for (frame = 0; frame < NUM_FRAMES; frame++)
+		pool.run(skinAvatar, NUM_AVATARS, &job);
+	double poolTime = inVRsUtilities::Timer::getMonotonicTime() - start;
+
+	if (maxError > 1e-3f)
+		fprintf(stderr, "SkinVertices differs from SkinVertex by %f!\n", maxError);
+
+	printf("%u avatars with %u vertices, %u bones\n", NUM_AVATARS, noOfVertices,
+			model.GetSkeleton().GetNoOfBones());
+	printf("%36s %12s\n", "", "[ms/frame]");
+	printf("%36s %12.3f\n", "SkinVertex per vertex", vertexTime * 1e3 / NUM_FRAMES);
+	printf("%36s %12.3f\n", "SkinVertices (positions, normals)", batchTime * 1e3 / NUM_FRAMES);
+	printf("%33s %2u %12.3f\n", "SkinVertices, WorkerPool threads", pool.getNumberOfThreads(),
+			poolTime * 1e3 / NUM_FRAMES);
+
+	for (i = 0; i < NUM_AVATARS; i++)
+		delete avatars[i];
+	return 0;
+}
@@ -38,11 +38,14 @@
 #include <inVRs/SystemCore/Configuration.h>
 #include <inVRs/SystemCore/DebugOutput.h>
 
+/// distance kept between the user and a collision line after a contact
+static const float CONTACT_DISTANCE = 0.001f;
+
 CheckCollisionModifierBase::CheckCollisionModifierBase(CollisionMap* collisionMap) {
 	printd(INFO, "CheckCollisionModifierBase(): Constructor init!\n");
 	this->collisionMap = collisionMap;
-	// No repeats by default!
-	this->maxRepeats = 0;
+	// slide along at most two further contacts (e.g. in a corner)
+	this->maxSlides = 2;
 	printd(INFO, "CheckCollisionModifierBase(): Constructor done!\n");
 } // CheckCollisionModifierBase
 
@@ -58,11 +61,12 @@ CheckCollisionModifierBase::~CheckCollisionModifierBase() {
 
 TransformationData CheckCollisionModifierBase::execute(TransformationData* resultLastStage,
 		TransformationPipe* currentPipe) {
-	bool didCorrection;
-	gmtl::Vec3f movement;
-	std::vector<CollisionData*> collisions;
-	std::vector<CollisionData*>::iterator it;
+	int slide;
+	float timeOfImpact;
+	gmtl::Vec2f normal;
+	gmtl::Vec3f movement, position, normal3D;
 	TransformationData currentTrans = *resultLastStage;
+	TransformationData sweepStart, sweepEnd;
 	TransformationData *lastResult;
 	unsigned userId = currentPipe->getOwner()->getId();
 
@@ -74,34 +78,29 @@ TransformationData CheckCollisionModifierBase::execute(TransformationData* resul
 		return currentTrans;
 	} // if
 
-	collisionMap->checkCollision(currentTrans, collisions);
-	movement = currentTrans.position - lastResult->position;
-	int repeatCounter = -1;
-
-	do {
-		didCorrection = false;
-		for (it = collisions.begin(); it != collisions.end(); ++it) {
-			gmtl::Vec3f normal3D = -1.f * gmtl::Vec3f((*it)->normal1[0], 0, (*it)->normal1[1]);
-			gmtl::normalize(normal3D);
-			// TODO: Check if this code only works for CIRCLES!!!
-			float normalFraction = gmtl::dot(movement, normal3D);
-
-			// otherwise we already move away from collision
-			if (normalFraction < -0.0001) {
-				gmtl::Vec3f movementCorrection = normal3D * (-normalFraction);
-				currentTrans.position += movementCorrection;
-				movement += movementCorrection;
-				didCorrection = true;
-			} // if
-		} // for
-		repeatCounter++;
-	} while (didCorrection == true && repeatCounter < maxRepeats);
-//	if (repeatCounter > 0)
-//		printd(INFO, "CheckCollisionModifierBase::execute(): found %i repeats!\n", repeatCounter);
-
-	for (it = collisions.begin(); it != collisions.end(); ++it) {
-		delete (*it);
+	position = lastResult->position;
+	movement = currentTrans.position - position;
+	movement[1] = 0;
+	sweepStart = currentTrans;
+	sweepEnd = currentTrans;
+
+	for (slide = 0; slide <= maxSlides; slide++) {
+		sweepStart.position = position;
+		sweepEnd.position = position + movement;
+		if (!collisionMap->sweepUser(sweepStart, sweepEnd, timeOfImpact, normal)) {
+			position += movement;
+			break;
+		} // if
+
+		// move to the contact and slide along the line with the remaining movement
+		normal3D = gmtl::Vec3f(normal[0], 0, normal[1]);
+		position += movement * timeOfImpact + normal3D * CONTACT_DISTANCE;
+		movement *= 1.f - timeOfImpact;
+		movement -= normal3D * gmtl::dot(movement, normal3D);
 	} // for
+
+	currentTrans.position[0] = position[0];
+	currentTrans.position[2] = position[2];
 	*lastResult = currentTrans;
 
 	return currentTrans;
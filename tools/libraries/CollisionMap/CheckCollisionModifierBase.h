@@ -41,10 +41,17 @@
 #include <inVRs/SystemCore/TransformationManager/TransformationModifierFactory.h>
 
 /******************************************************************************
- *
+ * Modifier which stops the user at the collision lines of a CollisionMap.
+ * The user's CollisionCircle is swept from the last corrected position to the
+ * new position. At the first contact the user is moved to the time of impact
+ * and the remaining movement slides along the contact, so the user cannot
+ * pass through walls independent of speed and frame rate.
  */
 class CheckCollisionModifierBase : public TransformationModifier {
 public:
+	/** Constructor.
+	 * @param collisionMap CollisionMap used for the collision tests (deleted in destructor)
+	 */
 	CheckCollisionModifierBase(CollisionMap* collisionMap);
 
 	~CheckCollisionModifierBase();
@@ -55,7 +62,8 @@ public:
 protected:
 	CollisionMap* collisionMap;
 	std::map<unsigned, TransformationData*> lastUserTransformation;
-	int maxRepeats;
+	/// maximum number of times the remaining movement slides along a contact
+	int maxSlides;
 };
 
 /******************************************************************************
@@ -34,7 +34,8 @@
 #include "CollisionMap.h"
 #include <inVRs/SystemCore/DebugOutput.h>
 
-CollisionCircle::CollisionCircle(float radius) {
+CollisionCircle::CollisionCircle(float radius) :
+	CollisionObject(COLLISIONOBJECT_CIRCLE) {
 	this->radius = radius;
 } // CollisionCircle
 
@@ -56,22 +57,22 @@ std::string CollisionCircle::getType() {
 
 
 bool CollisionCircle::canCheckCollision(CollisionObject* opponent) {
-	if (opponent->getType() == "CollisionCircle")
+	if (opponent->getTypeId() == COLLISIONOBJECT_CIRCLE)
 		return true;
 	return false;
 } // canCheckCollision
 
-std::vector<CollisionData*>& CollisionCircle::checkCollisionInternal(CollisionObject* opponent,
-		std::vector<CollisionData*>& dst, bool changeOrder) {
-	if (opponent->getType() == "CollisionCircle")
+CollisionDataBuffer& CollisionCircle::checkCollisionInternal(CollisionObject* opponent,
+		CollisionDataBuffer& dst, bool changeOrder) {
+	if (opponent->getTypeId() == COLLISIONOBJECT_CIRCLE)
 		return checkCollisionWithCircle((CollisionCircle*)opponent, dst, changeOrder);
 
 	assert(false);
 	return dst;
 } // checkCollisionInternal
 
-std::vector<CollisionData*>& CollisionCircle::checkCollisionWithCircle(CollisionCircle* opponent,
-		std::vector<CollisionData*>& dst, bool changeOrder) {
+CollisionDataBuffer& CollisionCircle::checkCollisionWithCircle(CollisionCircle* opponent,
+		CollisionDataBuffer& dst, bool changeOrder) {
 	// TODO: Scale!!!
 	float length;
 	float penetrationDepth;
@@ -89,13 +90,14 @@ std::vector<CollisionData*>& CollisionCircle::checkCollisionWithCircle(Collision
 		return dst;
 
 	// 	printd("Found Circle Circle Collision!\n");
-	result = new CollisionData;
+	result = dst.add();
+	if (!result)
+		return dst;
 	result->object1 = this;
 	result->object2 = opponent;
 	result->normal1 = gmtl::Vec2f(distance[0], distance[2]);
 	gmtl::normalize(result->normal1);
 	result->normal2 = result->normal1 * (-1.f);
 	result->collisionPoint = center + result->normal1 * (this->radius - 0.5f * penetrationDepth);
-	dst.push_back(result);
 	return dst;
 } // checkCollisionWithCircle
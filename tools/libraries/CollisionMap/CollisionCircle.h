@@ -87,7 +87,7 @@ public:
 protected:
 	/** Checks if a collision-method is implemented for a collision check
 	 * between the current CollisionObject and the passed one. Internally
-	 * it checks the name of the passed CollisionObject and returns if a method
+	 * it checks the type of the passed CollisionObject and returns if a method
 	 * exists locally to check for collisions.
 	 * @param opponent CollisionObject for which a collision-method is searched
 	 * @return true if a collision-method is implemented in this class, false
@@ -98,12 +98,12 @@ protected:
 	/** Calculates the collisions between the passed CollisionObject and itself.
 	 * @see CollisionObject::checkCollisionInternal()
 	 * @param opponent CollisionObject to check the collision with
-	 * @param dst Destination vector where to write the collision information to
+	 * @param dst Destination buffer where to write the collision information to
 	 * @param changeOrder Defines order of CollisionObjects in CollisionData
-	 * @return Destination vector (same as second parameter)
+	 * @return Destination buffer (same as second parameter)
 	 */
-	virtual std::vector<CollisionData*>& checkCollisionInternal(CollisionObject* opponent,
-			std::vector<CollisionData*>& dst, bool changeOrder);
+	virtual CollisionDataBuffer& checkCollisionInternal(CollisionObject* opponent,
+			CollisionDataBuffer& dst, bool changeOrder);
 
 	/** Searches for collisions between the current CollisionCircle and the
 	 * passed one.
@@ -111,12 +111,12 @@ protected:
 	 * collision test between the local CollisionCircle and the passed
 	 * CollisionCircle.
 	 * @param opponent CollisionCircle to check the collision with
-	 * @param dst Destination vector where to write the collision information to
+	 * @param dst Destination buffer where to write the collision information to
 	 * @param changeOrder Defines order of CollisionObjects in CollisionData
-	 * @return Destination vector (same as second parameter)
+	 * @return Destination buffer (same as second parameter)
 	 */
-	std::vector<CollisionData*>& checkCollisionWithCircle(CollisionCircle* opponent, std::vector<
-			CollisionData*>& dst, bool changeOrder);
+	CollisionDataBuffer& checkCollisionWithCircle(CollisionCircle* opponent,
+			CollisionDataBuffer& dst, bool changeOrder);
 
 	/// Radius of the Collision Circle
 	float radius;
@@ -28,6 +28,7 @@
 #include "CollisionLineSet.h"
 
 #include <assert.h>
+#include <math.h>
 
 #include <gmtl/Generate.h>
 
@@ -36,8 +37,17 @@
 #include <inVRs/SystemCore/DataTypes.h>
 #include <inVRs/SystemCore/DebugOutput.h>
 
-
-CollisionLineSet::CollisionLineSet(const std::vector<CollisionLineSet::CollisionLine *> lines) {
+/// maximum number of grid cells in each direction
+static const int MAX_GRID_SIZE = 1024;
+
+CollisionLineSet::CollisionLineSet(const std::vector<CollisionLineSet::CollisionLine *> lines) :
+	CollisionObject(COLLISIONOBJECT_LINESET),
+	gridQueryStamp(0),
+	gridCellSize(1),
+	gridInvCellSize(1),
+	gridWidth(0),
+	gridHeight(0),
+	gridValid(false) {
 	assert( ! lines.empty() );
 	collisionLines = lines;
 	printd(INFO, "CollisionLineSet(): Found %i collisionLines!\n", collisionLines.size());
@@ -56,180 +66,387 @@ std::string CollisionLineSet::getType() {
 } // getType
 
 bool CollisionLineSet::canCheckCollision(CollisionObject* opponent) {
-	if (opponent->getType() == "CollisionCircle" || opponent->getType() == "CollisionLineSet")
+	if (opponent->getTypeId() == COLLISIONOBJECT_CIRCLE || opponent->getTypeId()
+			== COLLISIONOBJECT_LINESET)
 		return true;
 	return false;
 } // canCheckCollision
 
-std::vector<CollisionData*>& CollisionLineSet::checkCollisionInternal(CollisionObject* opponent,
-		std::vector<CollisionData*>& dst, bool changeOrder) {
-	if (opponent->getType() == "CollisionCircle")
+CollisionDataBuffer& CollisionLineSet::checkCollisionInternal(CollisionObject* opponent,
+		CollisionDataBuffer& dst, bool changeOrder) {
+	switch (opponent->getTypeId()) {
+	case COLLISIONOBJECT_CIRCLE:
 		return checkCollisionWithCircle((CollisionCircle*)opponent, dst, changeOrder);
-	if (opponent->getType() == "CollisionLineSet")
+	case COLLISIONOBJECT_LINESET:
 		return checkCollisionWithLineSet((CollisionLineSet*)opponent, dst, changeOrder);
+	default:
+		break;
+	} // switch
 
 	assert(false);
 	return dst;
 } // checkCollisionInternal
 
-/// \todo Test checkCollisionWithLineSet
-std::vector<CollisionData*>& CollisionLineSet::checkCollisionWithLineSet(
-		CollisionLineSet* opponent, std::vector<CollisionData*>& dst, bool changeOrder) {
-	std::vector<CollisionLine*>::iterator it, opit;
-	CollisionData* result = NULL;
-
-	gmtl::Matrix44f transformation;
-	gmtl::Point4f p0_tmp, p1_tmp;
-	gmtl::Point4f vec0_tmp, vec1_tmp; //XXX should these be rotated or not?
-	gmtl::Point2f p0, p1;
-	gmtl::Point2f int0, int1; //points of intersection
-	gmtl::Vec2f vec0, vec1;
-	gmtl::Matrix<float, 2, 1> p1_minus_p0; //temporarily needed
-	gmtl::Matrix<float, 2, 1> params; // the parameters to the two line-equations in vector-form
-	gmtl::Matrix22f v0_v1;
+void CollisionLineSet::updateGrid() {
+	unsigned i, numLines;
+	int x, y, x0, y0, x1, y1;
+	float minX, minY, maxX, maxY, extent;
+	gmtl::Vec3f scaledLine, rotatedLine;
+	GridLine* line;
+
+	if (gridValid && gridScale == transformation.scale && gridOrientation
+			== transformation.orientation)
+		return;
+
+	gridScale = transformation.scale;
+	gridOrientation = transformation.orientation;
+	gridValid = true;
+
+	// transform the lines (scale, rotate) and calculate their bounding box
+	numLines = (unsigned)collisionLines.size();
+	gridLines.resize(numLines);
+	extent = 0;
+	minX = minY = 0;
+	maxX = maxY = 0;
+	for (i = 0; i < numLines; i++) {
+		line = &gridLines[i];
+		scaledLine = gmtl::Vec3f(collisionLines[i]->startPoint[0] * gridScale[0], 0,
+				collisionLines[i]->startPoint[1] * gridScale[2]);
+		rotatedLine = gridOrientation * scaledLine;
+		line->startPoint = gmtl::Vec2f(rotatedLine[0], rotatedLine[2]);
+		scaledLine = gmtl::Vec3f(collisionLines[i]->endPoint[0] * gridScale[0], 0,
+				collisionLines[i]->endPoint[1] * gridScale[2]);
+		rotatedLine = gridOrientation * scaledLine;
+		line->endPoint = gmtl::Vec2f(rotatedLine[0], rotatedLine[2]);
+
+		if (i == 0) {
+			minX = maxX = line->startPoint[0];
+			minY = maxY = line->startPoint[1];
+		} // if
+		minX = gmtl::Math::Min(minX, gmtl::Math::Min(line->startPoint[0], line->endPoint[0]));
+		maxX = gmtl::Math::Max(maxX, gmtl::Math::Max(line->startPoint[0], line->endPoint[0]));
+		minY = gmtl::Math::Min(minY, gmtl::Math::Min(line->startPoint[1], line->endPoint[1]));
+		maxY = gmtl::Math::Max(maxY, gmtl::Math::Max(line->startPoint[1], line->endPoint[1]));
+		extent += gmtl::Math::Max(fabsf(line->endPoint[0] - line->startPoint[0]),
+				fabsf(line->endPoint[1] - line->startPoint[1]));
+	} // for
+
+	// Choose the cell size so that there are about as many cells as lines
+	// but a cell is not smaller than the average line extent, which keeps the
+	// number of cells a single line is sorted into small.
+	gridCellSize = sqrtf((maxX - minX) * (maxY - minY) / numLines);
+	gridCellSize = gmtl::Math::Max(gridCellSize, extent / numLines);
+	gridCellSize = gmtl::Math::Max(gridCellSize, (maxX - minX) / (MAX_GRID_SIZE - 1));
+	gridCellSize = gmtl::Math::Max(gridCellSize, (maxY - minY) / (MAX_GRID_SIZE - 1));
+	if (!(gridCellSize > 0))
+		gridCellSize = 1;
+	gridInvCellSize = 1.f / gridCellSize;
+	gridOrigin = gmtl::Vec2f(minX, minY);
+	gridWidth = gmtl::Math::Min((int)((maxX - minX) * gridInvCellSize) + 1, MAX_GRID_SIZE);
+	gridHeight = gmtl::Math::Min((int)((maxY - minY) * gridInvCellSize) + 1, MAX_GRID_SIZE);
+
+	// sort the lines into the cells overlapped by their bounding box: first
+	// count the lines per cell, then fill the cells
+	gridCellStart.assign(gridWidth * gridHeight + 1, 0);
+	for (i = 0; i < numLines; i++) {
+		line = &gridLines[i];
+		if (!getCellRange(gmtl::Math::Min(line->startPoint[0], line->endPoint[0]),
+				gmtl::Math::Min(line->startPoint[1], line->endPoint[1]), gmtl::Math::Max(
+						line->startPoint[0], line->endPoint[0]), gmtl::Math::Max(
+						line->startPoint[1], line->endPoint[1]), x0, y0, x1, y1))
+			continue;
+		for (y = y0; y <= y1; y++)
+			for (x = x0; x <= x1; x++)
+				gridCellStart[y * gridWidth + x + 1]++;
+	} // for
+	for (i = 1; i < gridCellStart.size(); i++)
+		gridCellStart[i] += gridCellStart[i - 1];
+
+	std::vector<unsigned> fillIndex(gridCellStart.begin(), gridCellStart.end() - 1);
+	gridLineIndices.resize(gridCellStart.back());
+	for (i = 0; i < numLines; i++) {
+		line = &gridLines[i];
+		if (!getCellRange(gmtl::Math::Min(line->startPoint[0], line->endPoint[0]),
+				gmtl::Math::Min(line->startPoint[1], line->endPoint[1]), gmtl::Math::Max(
+						line->startPoint[0], line->endPoint[0]), gmtl::Math::Max(
+						line->startPoint[1], line->endPoint[1]), x0, y0, x1, y1))
+			continue;
+		for (y = y0; y <= y1; y++)
+			for (x = x0; x <= x1; x++)
+				gridLineIndices[fillIndex[y * gridWidth + x]++] = i;
+	} // for
+
+	gridLineStamps.assign(numLines, 0);
+	gridQueryStamp = 0;
+
+	printd(INFO, "CollisionLineSet::updateGrid(): sorted %u lines into %i x %i cells (cell size %f)\n",
+			numLines, gridWidth, gridHeight, gridCellSize);
+} // updateGrid
+
+bool CollisionLineSet::getCellRange(float minX, float minY, float maxX, float maxY, int& x0,
+		int& y0, int& x1, int& y1) const {
+	float fx0 = (minX - gridOrigin[0]) * gridInvCellSize;
+	float fy0 = (minY - gridOrigin[1]) * gridInvCellSize;
+	float fx1 = (maxX - gridOrigin[0]) * gridInvCellSize;
+	float fy1 = (maxY - gridOrigin[1]) * gridInvCellSize;
+
+	if (!(fx1 >= 0 && fy1 >= 0 && fx0 < gridWidth && fy0 < gridHeight))
+		return false;
+
+	x0 = gmtl::Math::Max((int)fx0, 0);
+	y0 = gmtl::Math::Max((int)fy0, 0);
+	x1 = gmtl::Math::Min((int)fx1, gridWidth - 1);
+	y1 = gmtl::Math::Min((int)fy1, gridHeight - 1);
+	return true;
+} // getCellRange
+
+unsigned CollisionLineSet::startQuery() {
+	gridQueryStamp++;
+	if (gridQueryStamp == 0) {
+		gridLineStamps.assign(gridLineStamps.size(), 0);
+		gridQueryStamp = 1;
+	} // if
+	return gridQueryStamp;
+} // startQuery
+
+bool CollisionLineSet::sweepCircle(const gmtl::Vec2f& start, const gmtl::Vec2f& end,
+		float radius, float& timeOfImpact, gmtl::Vec2f& normal) {
+	unsigned i, j, cellEnd, lineIndex, stamp;
+	int x, y, x0, y0, x1, y1;
+	float lineLength, distance, dn, t, u, a, b, c, discriminant;
+	bool found = false;
+	gmtl::Vec2f position, p, q, lineDir, lineNormal, closest, toCircle, movement;
+	gmtl::Vec2f corners[2];
+
+	updateGrid();
+	position = gmtl::Vec2f(transformation.position[0], transformation.position[2]);
+	movement = end - start;
+	timeOfImpact = 1;
+
+	// query the cells overlapped by the bounding box of the swept circle
+	if (!getCellRange(gmtl::Math::Min(start[0], end[0]) - radius - position[0], gmtl::Math::Min(
+			start[1], end[1]) - radius - position[1], gmtl::Math::Max(start[0], end[0]) + radius
+			- position[0], gmtl::Math::Max(start[1], end[1]) + radius - position[1], x0, y0, x1,
+			y1))
+		return false;
+
+	stamp = startQuery();
+	for (y = y0; y <= y1; y++) {
+		for (x = x0; x <= x1; x++) {
+			cellEnd = gridCellStart[y * gridWidth + x + 1];
+			for (j = gridCellStart[y * gridWidth + x]; j < cellEnd; j++) {
+				lineIndex = gridLineIndices[j];
+				if (gridLineStamps[lineIndex] == stamp)
+					continue;
+				gridLineStamps[lineIndex] = stamp;
+
+				p = gridLines[lineIndex].startPoint + position;
+				q = gridLines[lineIndex].endPoint + position;
+				lineDir = q - p;
+				lineLength = gmtl::length(lineDir);
+
+				// overlap at the start position: only block movements towards the line
+				if (lineLength > 0) {
+					u = gmtl::Math::clamp(gmtl::dot(start - p, lineDir) / (lineLength
+							* lineLength), 0.f, 1.f);
+					closest = p + u * lineDir;
+				} else
+					closest = p;
+				toCircle = start - closest;
+				distance = gmtl::length(toCircle);
+				if (distance < radius) {
+					if (distance > 0 && gmtl::dot(toCircle, movement) < 0) {
+						timeOfImpact = 0;
+						normal = toCircle / distance;
+						return true;
+					} // if
+					continue;
+				} // if
+
+				// contact with the inner part of the line: the distance of the
+				// center to the line equals the radius
+				if (lineLength > 0) {
+					lineDir /= lineLength;
+					lineNormal = gmtl::Vec2f(-lineDir[1], lineDir[0]);
+					distance = gmtl::dot(start - p, lineNormal);
+					if (distance < 0) {
+						lineNormal = -lineNormal;
+						distance = -distance;
+					} // if
+					dn = gmtl::dot(movement, lineNormal);
+					if (dn < 0) {
+						t = (radius - distance) / dn;
+						if (t >= 0 && t <= timeOfImpact) {
+							u = gmtl::dot(start + t * movement - p, lineDir);
+							if (u >= 0 && u <= lineLength) {
+								timeOfImpact = t;
+								normal = lineNormal;
+								found = true;
+							} // if
+						} // if
+					} // if
+				} // if
+
+				// contact with one of the end points of the line
+				corners[0] = p;
+				corners[1] = q;
+				a = gmtl::dot(movement, movement);
+				if (a <= 0)
+					continue;
+				for (i = 0; i < 2; i++) {
+					toCircle = start - corners[i];
+					b = gmtl::dot(toCircle, movement);
+					if (b >= 0)
+						continue;
+					c = gmtl::dot(toCircle, toCircle) - radius * radius;
+					discriminant = b * b - a * c;
+					if (discriminant < 0)
+						continue;
+					t = (-b - sqrtf(discriminant)) / a;
+					if (t >= 0 && t <= timeOfImpact) {
+						timeOfImpact = t;
+						normal = start + t * movement - corners[i];
+						gmtl::normalize(normal);
+						found = true;
+					} // if
+				} // for
+			} // for
+		} // for
+	} // for
+
+	if (!found)
+		timeOfImpact = 1;
+	return found;
+} // sweepCircle
+
+CollisionDataBuffer& CollisionLineSet::checkCollisionWithLineSet(
+		CollisionLineSet* opponent, CollisionDataBuffer& dst, bool changeOrder) {
+	unsigned i, j, end, lineIndex, stamp;
+	int x, y, x0, y0, x1, y1;
+	float denominator, s, t;
+	gmtl::Vec2f p0, p1, vec0, vec1, p1_minus_p0, offset;
+	gmtl::Vec2f position, opponentPosition;
+	CollisionData* result;
 
 	/* let both lines be of the form
-	 * (1): p0 + s * vec0 = 0 and
-	 * (2): p1 + t * vec1 = 0
+	 * (1): p0 + s * vec0 and
+	 * (2): p1 + t * vec1
 	 *
-	 * (1) - (2) yields:
+	 * (1) = (2) yields:
 	 * vec0 * s - vec1 * t = p1 - p0
 	 *
-	 * writing this as a matrix-system:
-	 * ( vec0[0] , -vec1[0] )     ( s )    ( (p1-p0)[0] )
-	 * ( vec0[1] , -vec1[1] )  *  ( t )  = ( (p1-p0)[1] )
-	 *
-	 *  ^^^^^^^^^^^^^^^^^^^         ^
-	 *   this matrix is v0_v1       |this is params
-	 *
-	 * so we can write for short:
-	 * v0_v1 * params = p1-p0
-	 * i.e. params = invert(v0_v1) * (p1-p0)
-	 *
-	 * XXX what if line0 = line1 ?
+	 * which is solved with Cramer's rule. The lines intersect if both
+	 * parameters are within [0, 1]. Parallel lines are not reported.
 	 */
 
-	for (it = collisionLines.begin(); it != collisionLines.end(); ++it) {
-		// build and transform own line (translate,scale,rotate):
-		// the transformation has to be done in 3D:
-		// N.B.: Point3f will be rotated, Vec3f not
-		p1_tmp = gmtl::Point4f((*it)->startPoint[0], 0.0f, (*it)->startPoint[1], 1.0f);
-		vec0_tmp = gmtl::Point4f((*it)->endPoint[0] - (*it)->startPoint[0], 0.0f,
-				(*it)->endPoint[1] - (*it)->startPoint[1], 1.0f);
-		transformationDataToMatrix(getTransformation(), transformation);
-		p0_tmp = p0_tmp * transformation;
-		vec0_tmp = vec0_tmp * transformation;
-		// go back to 2D:
-		p0 = gmtl::Point2f(p0_tmp[0], p0_tmp[2]);
-		vec0 = gmtl::Point2f(vec0_tmp[0], vec0_tmp[2]);
-
-		// cycle through opponent lines, identifying colliding lines
-		// for each line, get transformed position/size/rotation and test for collision
-		for (opit = opponent->collisionLines.begin(); opit != collisionLines.end(); opit++) {
-			// if the above test didn't help, we go back to our normal test:
-			p1_tmp = gmtl::Point4f((*opit)->startPoint[0], 0.0f, (*opit)->startPoint[1], 1.0f);
-			vec1_tmp = gmtl::Point4f((*opit)->endPoint[0] - (*opit)->startPoint[0], 0.0f,
-					(*opit)->endPoint[1] - (*opit)->startPoint[1], 1.0f);
-			// transform opponent line (translate,scale,rotate):
-			transformationDataToMatrix(opponent->getTransformation(), transformation);
-			p1_tmp = p1_tmp * transformation;
-			vec1_tmp = vec1_tmp * transformation;
-			// go back to 2D:
-			p1 = gmtl::Point2f(p1_tmp[0], p1_tmp[2]);
-			vec1 = gmtl::Point2f(vec1_tmp[0], vec1_tmp[2]);
-
-			// quick intersection test:
-			// if the line in its entirety is left/right/above/below of the other line, it cannot intersect:
-			if (gmtl::Math::Max(p0[0], (p0 + vec0)[0]) < gmtl::Math::Min(p1[0], (p1 + vec1)[0])
-					|| gmtl::Math::Max(p1[0], (p1 + vec1)[0]) < gmtl::Math::Min(p0[0],
-							(p0 + vec0)[0]) || gmtl::Math::Max(p0[1], (p0 + vec0)[1])
-					< gmtl::Math::Min(p1[1], (p1 + vec1)[1]) || gmtl::Math::Max(p1[1],
-					(p1 + vec1)[1]) < gmtl::Math::Min(p0[1], (p0 + vec0)[1])) {
-				continue;
-			}
-
-			// intersect lines the "conventional" way:
-			v0_v1.set(vec0[0], -vec1[0], vec0[1], -vec1[1]);
-			gmtl::invert(v0_v1);
-			// use (p1 - p0) as a 2x1 matrix
-			p1_minus_p0[0][0] = (p1 - p0)[0];
-			p1_minus_p0[1][0] = (p1 - p0)[1];
-			// multiply (p1-p0) by v0_v1 from right
-			gmtl::mult(params, v0_v1, p1_minus_p0);
-
-			// compute point of intersection based on both line-equations:
-			int0 = p0 + params[0][0] * vec0;
-			int1 = p1 + params[1][0] * vec1;
-
-			if (int0 == int1) //points match
-			{
-				//build result
-				result = new CollisionData;
-				result->object1 = this;
-				result->object2 = opponent;
-				result->normal1 = int0 - p0; // vector pointing from this.startPoint to collisionPoint
-				gmtl::normalize(result->normal1);
-				result->normal2 = result->normal1 * (-1.f);
-				result->collisionPoint = int0;
-				dst.push_back(result);
-				result = NULL;
-			}
-
-		}
-
+	updateGrid();
+	opponent->updateGrid();
+	position = gmtl::Vec2f(transformation.position[0], transformation.position[2]);
+	opponentPosition = gmtl::Vec2f(opponent->transformation.position[0],
+			opponent->transformation.position[2]);
+	// offset from the grid of the opponent into the own grid
+	offset = position - opponentPosition;
+
+	for (i = 0; i < gridLines.size(); i++) {
+		// own line relative to the position of the opponent
+		p0 = gridLines[i].startPoint + offset;
+		vec0 = gridLines[i].endPoint - gridLines[i].startPoint;
+
+		if (!opponent->getCellRange(gmtl::Math::Min(p0[0], p0[0] + vec0[0]), gmtl::Math::Min(
+				p0[1], p0[1] + vec0[1]), gmtl::Math::Max(p0[0], p0[0] + vec0[0]),
+				gmtl::Math::Max(p0[1], p0[1] + vec0[1]), x0, y0, x1, y1))
+			continue;
+
+		stamp = opponent->startQuery();
+		for (y = y0; y <= y1; y++) {
+			for (x = x0; x <= x1; x++) {
+				end = opponent->gridCellStart[y * opponent->gridWidth + x + 1];
+				for (j = opponent->gridCellStart[y * opponent->gridWidth + x]; j < end; j++) {
+					lineIndex = opponent->gridLineIndices[j];
+					if (opponent->gridLineStamps[lineIndex] == stamp)
+						continue;
+					opponent->gridLineStamps[lineIndex] = stamp;
+
+					p1 = opponent->gridLines[lineIndex].startPoint;
+					vec1 = opponent->gridLines[lineIndex].endPoint - p1;
+					denominator = vec0[0] * vec1[1] - vec0[1] * vec1[0];
+					if (denominator == 0)
+						continue;
+					p1_minus_p0 = p1 - p0;
+					s = (p1_minus_p0[0] * vec1[1] - p1_minus_p0[1] * vec1[0]) / denominator;
+					t = (p1_minus_p0[0] * vec0[1] - p1_minus_p0[1] * vec0[0]) / denominator;
+					if (s < 0 || s > 1 || t < 0 || t > 1)
+						continue;
+
+					//build result
+					result = dst.add();
+					if (!result)
+						return dst;
+					result->object1 = this;
+					result->object2 = opponent;
+					result->normal1 = s * vec0; // vector pointing from this.startPoint to collisionPoint
+					gmtl::normalize(result->normal1);
+					result->normal2 = result->normal1 * (-1.f);
+					result->collisionPoint = p0 + s * vec0 + opponentPosition;
+				} // for
+			} // for
+		} // for
 	} // for
 	return dst;
-}
+} // checkCollisionWithLineSet
 
-std::vector<CollisionData*>& CollisionLineSet::checkCollisionWithCircle(CollisionCircle* opponent,
-		std::vector<CollisionData*>& dst, bool changeOrder) {
-	std::vector<CollisionLine*>::iterator it;
-	CollisionData* result = NULL;
-
-	for (it = collisionLines.begin(); it != collisionLines.end(); ++it) {
-		if (checkCollisionWithCircle(result, *it, opponent, changeOrder)) {
-			dst.push_back(result);
-			result = NULL;
-		} // if
+CollisionDataBuffer& CollisionLineSet::checkCollisionWithCircle(CollisionCircle* opponent,
+		CollisionDataBuffer& dst, bool changeOrder) {
+	unsigned j, end, lineIndex, stamp;
+	int x, y, x0, y0, x1, y1;
+	float radius;
+	gmtl::Vec2f position, center;
+
+	updateGrid();
+	radius = opponent->getRadius();
+	position = gmtl::Vec2f(transformation.position[0], transformation.position[2]);
+	// center of the circle relative to the position of the CollisionLineSet
+	center = gmtl::Vec2f(opponent->getTransformation().position[0],
+			opponent->getTransformation().position[2]) - position;
+
+	if (!getCellRange(center[0] - radius, center[1] - radius, center[0] + radius, center[1]
+			+ radius, x0, y0, x1, y1))
+		return dst;
+
+	stamp = startQuery();
+	for (y = y0; y <= y1; y++) {
+		for (x = x0; x <= x1; x++) {
+			end = gridCellStart[y * gridWidth + x + 1];
+			for (j = gridCellStart[y * gridWidth + x]; j < end; j++) {
+				lineIndex = gridLineIndices[j];
+				if (gridLineStamps[lineIndex] == stamp)
+					continue;
+				gridLineStamps[lineIndex] = stamp;
+				checkCollisionWithCircle(dst, gridLines[lineIndex].startPoint + position,
+						gridLines[lineIndex].endPoint + position, opponent, changeOrder);
+			} // for
+		} // for
 	} // for
 	return dst;
 } // checkCollisionWithCircle
 
 ///\todo: CODE SHOULD CONTAIN MORE COMMENTS, USE BETTER VARIABLE NAMES AND ALL
 ///      IN ENGLISH IF POSSIBLE
-bool CollisionLineSet::checkCollisionWithCircle(CollisionData* &result, CollisionLine* line,
-		CollisionCircle* circle, bool changeOrder) {
+bool CollisionLineSet::checkCollisionWithCircle(CollisionDataBuffer& dst, const gmtl::Vec2f& p,
+		const gmtl::Vec2f& q, CollisionCircle* circle, bool changeOrder) {
 	gmtl::Vec2f dist; // Vektor von Kreismittelpunkt zu Kollisionspunkt
-	gmtl::Vec2f c, p, q; // c ... Circle-Center, p ... startPoint line, q ... endPoint line
+	gmtl::Vec2f c; // c ... Circle-Center, p ... startPoint line, q ... endPoint line
 	gmtl::Vec2f cp; // Vektor von Eckpunkt zu Kreis
 	gmtl::Vec2f qp; // Vektor von Eckpunkt zu Eckpunkt
 	gmtl::Vec2f R; // Projektion von Vektor zu Kreis auf Linie
-	gmtl::Vec3f rotatedLine;
-	gmtl::Vec3f scaledLine;
-	gmtl::Quatf orientation;
 	float radius;
 	float penetrationDepth;
-	int i;
+	CollisionData* result;
 
 	radius = circle->getRadius();
 	c = gmtl::Vec2f(circle->getTransformation().position[0],
 			circle->getTransformation().position[2]);
 
-	scaledLine = gmtl::Vec3f(line->startPoint[0], 0, line->startPoint[1]);
-	for (i = 0; i < 3; i++)
-		scaledLine[i] = scaledLine[i] * transformation.scale[i];
-	orientation = transformation.orientation;
-	rotatedLine = orientation * scaledLine;
-	p[0] = transformation.position[0] + rotatedLine[0];
-	p[1] = transformation.position[2] + rotatedLine[2];
-
-	scaledLine = gmtl::Vec3f(line->endPoint[0], 0, line->endPoint[1]);
-	for (i = 0; i < 3; i++)
-		scaledLine[i] = scaledLine[i] * transformation.scale[i];
-	rotatedLine = transformation.orientation * scaledLine;
-	q[0] = transformation.position[0] + rotatedLine[0];
-	q[1] = transformation.position[2] + rotatedLine[2];
-
 	cp = c - p; // Vektor von Eckpunkt zu Kreis
 	qp = q - p; // Vektor von Eckpunkt zu Eckpunkt
 	R = (gmtl::dot(cp, qp) / gmtl::dot(qp, qp)) * qp; // Projektion von Vektor zu Kreis auf Linie
@@ -266,7 +483,9 @@ bool CollisionLineSet::checkCollisionWithCircle(CollisionData* &result, Collisio
 	// 	Real32 projRad = projV.length();			// Ermitteln von projizierten Radius
 	// // Ende Ergaenzung
 
-	result = new CollisionData;
+	result = dst.add();
+	if (!result)
+		return false;
 	result->object1 = this;
 	result->object2 = circle;
 	result->normal1 = dist;
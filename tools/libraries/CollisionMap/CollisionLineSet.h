@@ -52,9 +52,17 @@ class CollisionCircle;
  * constructor of the class.
  * Implemented collision-methods:
  *     CollisionLineSet - CollisionCircle
+ *     CollisionLineSet - CollisionLineSet
  *
- * TODO: The class has no method for a collision test with another
- *       CollisionLineSet implemented. This still has to be done!!!
+ * For the collision tests the lines are transformed by the scale and
+ * orientation of the CollisionLineSet and sorted into a uniform 2D grid. Only
+ * the lines in the grid cells overlapped by the bounding box of the opponent
+ * are tested. The translation of the CollisionLineSet is applied when
+ * querying the grid, so moving the CollisionLineSet (e.g. placing the same
+ * collision map on several tiles) does not require rebuilding the grid. The
+ * grid is rebuilt lazily if the scale or orientation changed.
+ * Since the grid is updated during the collision tests, a CollisionLineSet
+ * must not be tested from several threads at the same time.
  */
 class CollisionLineSet : public CollisionObject {
 public:
@@ -82,19 +90,39 @@ public:
 
 	/** Returns the name of the CollisionObject (="CollisionLineSet").
 	 * The method returns the name of the CollisionObject. This name is
-	 * normally equal to the classname of the CollisionObject. It is used in
-	 * the <code>checkCollision</code> methods to identify the type of
-	 * CollisionObject and to find the correct method for the collision test
-	 * between two objects.
+	 * normally equal to the classname of the CollisionObject.
 	 * @return Type of the CollisionObject (returns "CollisionLineSet").
 	 */
 	virtual std::string getType();
 
+	/** Searches for the first contact of a circle moving along a straight
+	 * line with the collision lines.
+	 * The method calculates the earliest time of impact of a circle which
+	 * moves from <code>start</code> to <code>end</code> (both in world
+	 * coordinates). If the circle already overlaps a line at the start
+	 * position, a contact at time 0 is reported only if the movement points
+	 * towards that line.
+	 * @param start center of the circle at the start of the movement
+	 * @param end center of the circle at the end of the movement
+	 * @param radius radius of the circle
+	 * @param timeOfImpact fraction [0, 1] of the movement until the first contact
+	 * @param normal normalized contact normal pointing from the line to the circle
+	 * @return true if a contact was found, false otherwise
+	 */
+	bool sweepCircle(const gmtl::Vec2f& start, const gmtl::Vec2f& end, float radius,
+			float& timeOfImpact, gmtl::Vec2f& normal);
+
 protected:
 
+	/// Collision line transformed by the scale and orientation of the set
+	struct GridLine {
+		gmtl::Vec2f startPoint;
+		gmtl::Vec2f endPoint;
+	}; // GridLine
+
 	/** Checks if a collision-method is implemented for a collision check
 	 * between the current CollisionObject and the passed one. Internally
-	 * it checks the name of the passed CollisionObject and returns if a method
+	 * it checks the type of the passed CollisionObject and returns if a method
 	 * exists locally to check for collisions.
 	 * @param opponent CollisionObject for which a collision-method is searched
 	 * @return true if a collision-method is implemented in this class, false
@@ -105,56 +133,100 @@ protected:
 	/** Calculates the collisions between the passed CollisionObject and itself.
 	 * @see CollisionObject::checkCollisionInternal()
 	 * @param opponent CollisionObject to check the collision with
-	 * @param dst Destination vector where to write the collision information to
+	 * @param dst Destination buffer where to write the collision information to
 	 * @param changeOrder Defines order of CollisionObjects in CollisionData
-	 * @return Destination vector (same as second parameter)
+	 * @return Destination buffer (same as second parameter)
 	 */
-	virtual std::vector<CollisionData*>& checkCollisionInternal(CollisionObject* opponent,
-			std::vector<CollisionData*>& dst, bool changeOrder);
+	virtual CollisionDataBuffer& checkCollisionInternal(CollisionObject* opponent,
+			CollisionDataBuffer& dst, bool changeOrder);
 
 	/** Searches for collisions between two CollisionLineSets.
 	 * The method is called from the checkCollisionInternal method and does the
-	 * collision test between this CollisionLineSet and the passed one.
+	 * collision test between this CollisionLineSet and the passed one. Each
+	 * own line is tested against the lines in the grid of the opponent.
 	 * Note: if possible, the opponent should be the CollisionLineSet with more lines.
 	 * @param opponent CollisionLineSet to check the collision with
-	 * @param dst Destination vector where to write the collision information
+	 * @param dst Destination buffer where to write the collision information
 	 * @param changeOrder Defines order of CollisionObjects in CollisionData
-	 * @return Destination vector (same as second parameter)
+	 * @return Destination buffer (same as second parameter)
 	 */
-	std::vector<CollisionData*>& checkCollisionWithLineSet(CollisionLineSet* opponent, std::vector<
-			CollisionData*>& dst, bool changeOrder);
+	CollisionDataBuffer& checkCollisionWithLineSet(CollisionLineSet* opponent,
+			CollisionDataBuffer& dst, bool changeOrder);
 
 	/** Searches for collisions between the CollisionLineSet and the passed
 	 * CollisionCircle.
 	 * The method is called from the checkCollisionInternal method and does the
 	 * collision test between the CollisionLineSet and the passed
-	 * CollisionCircle. It therefore calls for each collision line the
-	 * <code>checkCollisionWithCircle</code> method.
+	 * CollisionCircle. It therefore calls the <code>checkCollisionWithCircle</code>
+	 * method for each collision line in the grid cells overlapped by the circle.
 	 * @param opponent CollisionCircle to check the collision with
-	 * @param dst Destination vector where to write the collision information to
+	 * @param dst Destination buffer where to write the collision information to
 	 * @param changeOrder Defines order of CollisionObjects in CollisionData
-	 * @return Destination vector (same as second parameter)
+	 * @return Destination buffer (same as second parameter)
 	 */
-	std::vector<CollisionData*>& checkCollisionWithCircle(CollisionCircle* opponent, std::vector<
-			CollisionData*>& dst, bool changeOrder);
+	CollisionDataBuffer& checkCollisionWithCircle(CollisionCircle* opponent,
+			CollisionDataBuffer& dst, bool changeOrder);
 
 	/** Searches for a collision between a single line and the passed
 	 * CollisionCircle.
-	 * The checks if the passed CollisionLine collides with the passed
-	 * CollisionCircle. If so a CollisionData object is created and returned to
-	 * the caller (which is the <code>checkCollisionWithCircle</code> method).
-	 * @param result CollisionData where the collision info is stored if found
-	 * @param line CollisionLine which should be checked for collision
+	 * The checks if the passed line collides with the passed CollisionCircle.
+	 * If so the collision information is written into a new entry of the
+	 * passed buffer.
+	 * @param dst Destination buffer where to write the collision information to
+	 * @param p start point of the line in world coordinates
+	 * @param q end point of the line in world coordinates
 	 * @param circle CollisionCircle which should be checked for collision
 	 * @param changeOrder Defines order of CollisionObjects in CollisionData
 	 * @return true if a collision was found, false otherwise
 	 */
-	bool checkCollisionWithCircle(CollisionData* &result, CollisionLine* line,
-			CollisionCircle* circle, bool changeOrder);
+	bool checkCollisionWithCircle(CollisionDataBuffer& dst, const gmtl::Vec2f& p,
+			const gmtl::Vec2f& q, CollisionCircle* circle, bool changeOrder);
+
+	/** Rebuilds the grid if the scale or orientation of the CollisionLineSet
+	 * changed since the last build.
+	 */
+	void updateGrid();
+
+	/** Calculates the range of grid cells overlapped by the passed bounding
+	 * box. The bounding box has to be passed relative to the position of the
+	 * CollisionLineSet.
+	 * @return false if the bounding box does not overlap the grid
+	 */
+	bool getCellRange(float minX, float minY, float maxX, float maxY, int& x0, int& y0,
+			int& x1, int& y1) const;
+
+	/** Starts a new grid query.
+	 * Lines spanning several cells are only tested once per query by
+	 * comparing their stamp with the returned value.
+	 * @return stamp of the new query
+	 */
+	unsigned startQuery();
 
 	/// List of all CollisionLines defining the shape of the CollisionObject
 	std::vector<CollisionLine*> collisionLines;
 
+	/// Scaled and rotated collision lines (same order as collisionLines)
+	std::vector<GridLine> gridLines;
+	/// Index into gridLineIndices of the first line of each cell (size = cells + 1)
+	std::vector<unsigned> gridCellStart;
+	/// Indices of the lines in each cell
+	std::vector<unsigned> gridLineIndices;
+	/// Stamp of the last query in which each line was tested
+	std::vector<unsigned> gridLineStamps;
+	/// Stamp of the current query
+	unsigned gridQueryStamp;
+	/// Lower left corner of the grid (relative to the position of the set)
+	gmtl::Vec2f gridOrigin;
+	/// Edge length and inverse edge length of a grid cell
+	float gridCellSize, gridInvCellSize;
+	/// Number of grid cells in x and y direction
+	int gridWidth, gridHeight;
+	/// Scale and orientation for which the grid was built
+	gmtl::Vec3f gridScale;
+	gmtl::Quatf gridOrientation;
+	/// true if the grid was built at least once
+	bool gridValid;
+
 }; // CollisionLineSet
 
 
@@ -30,6 +30,7 @@
 #include <irrXML.h>
 
 #include "CollisionLineSet.h"
+#include "CollisionCircle.h"
 #include <inVRs/SystemCore/DebugOutput.h>
 #include <inVRs/SystemCore/Configuration.h>
 #include <inVRs/SystemCore/XMLTools.h>
@@ -37,7 +38,8 @@
 using namespace irr;
 using namespace io;
 
-CollisionMap::CollisionMap() {
+CollisionMap::CollisionMap() :
+	user(NULL) {
 
 } // CollisionMap
 
@@ -129,6 +131,46 @@ std::vector<CollisionData*>& CollisionMap::checkCollision(TransformationData tra
 	return dst;
 } // checkCollision
 
+CollisionDataBuffer& CollisionMap::checkCollision(const TransformationData& trans,
+		CollisionDataBuffer& dst) {
+	std::vector<CollisionObject*>::iterator it;
+
+	user->setTransformation(trans);
+	for (it = objects.begin(); it != objects.end(); ++it) {
+		(*it)->checkCollision(user, dst);
+	} // for
+	return dst;
+} // checkCollision
+
+bool CollisionMap::sweepUser(const TransformationData& start, const TransformationData& end,
+		float& timeOfImpact, gmtl::Vec2f& normal) {
+	std::vector<CollisionObject*>::iterator it;
+	float radius, objectTimeOfImpact;
+	gmtl::Vec2f objectNormal;
+	bool found = false;
+
+	if (!user || user->getTypeId() != COLLISIONOBJECT_CIRCLE) {
+		printd(ERROR, "CollisionMap::sweepUser(): the user's shape must be a CollisionCircle!\n");
+		return false;
+	} // if
+
+	radius = ((CollisionCircle*)user)->getRadius();
+	gmtl::Vec2f startPoint(start.position[0], start.position[2]);
+	gmtl::Vec2f endPoint(end.position[0], end.position[2]);
+	timeOfImpact = 1;
+	for (it = objects.begin(); it != objects.end(); ++it) {
+		if ((*it)->getTypeId() != COLLISIONOBJECT_LINESET)
+			continue;
+		if (((CollisionLineSet*)(*it))->sweepCircle(startPoint, endPoint, radius,
+				objectTimeOfImpact, objectNormal) && objectTimeOfImpact <= timeOfImpact) {
+			timeOfImpact = objectTimeOfImpact;
+			normal = objectNormal;
+			found = true;
+		} // if
+	} // for
+	return found;
+} // sweepUser
+
 CollisionObject* CollisionMap::getTileCollisionMap(unsigned tileId) {
 	return tileMap[tileId];
 } // getTileCollisionMap
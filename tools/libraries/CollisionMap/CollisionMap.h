@@ -94,6 +94,34 @@ public:
 	std::vector<CollisionData*>& checkCollision(TransformationData trans, std::vector<
 			CollisionData*> &dst);
 
+	/** Checks the collision between the user and the Tiles without allocating
+	 * memory.
+	 * The user's shape passed in the constructor is moved to the passed
+	 * Transformation and tested against the CollisionLineSets of all loaded
+	 * Tiles. The found collisions are appended to the passed buffer, which is
+	 * not cleared before the test. Collisions which do not fit into the buffer
+	 * are only counted, see <code>CollisionDataBuffer::getNumDropped</code>.
+	 * The entries stay owned by the buffer and must not be deleted.
+	 * @param trans Transformation of the User in world coordinates
+	 * @param dst Buffer where to append the found collisions to
+	 * @return Destination buffer (same as second parameter)
+	 */
+	CollisionDataBuffer& checkCollision(const TransformationData& trans, CollisionDataBuffer& dst);
+
+	/** Searches for the first contact of the moving user with the Tiles.
+	 * The user's shape passed in the constructor has to be a CollisionCircle.
+	 * The method sweeps the circle from the start to the end position and
+	 * returns the earliest contact with any loaded CollisionLineSet.
+	 * @see CollisionLineSet::sweepCircle()
+	 * @param start Transformation of the User at the start of the movement
+	 * @param end Transformation of the User at the end of the movement
+	 * @param timeOfImpact fraction [0, 1] of the movement until the first contact
+	 * @param normal normalized contact normal pointing towards the User
+	 * @return true if a contact was found, false otherwise
+	 */
+	bool sweepUser(const TransformationData& start, const TransformationData& end,
+			float& timeOfImpact, gmtl::Vec2f& normal);
+
 	/** Returns the CollisionLineSet for the Tile with the passed Id.
 	 * The method checks if a CollisionLineSet is loaded for the Tile with the
 	 * passed ID. If so the corresponding CollisionLineSet is returned.
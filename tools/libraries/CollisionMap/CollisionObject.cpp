@@ -31,7 +31,22 @@
 
 #include <inVRs/SystemCore/DebugOutput.h>
 
-CollisionObject::CollisionObject() {
+/// initial capacity of the buffer used by the vector-based checkCollision
+static const unsigned DEFAULT_COLLISIONBUFFER_SIZE = 16;
+
+CollisionDataBuffer::CollisionDataBuffer(unsigned capacity) :
+	capacity(capacity),
+	count(0),
+	numDropped(0) {
+	data = new CollisionData[capacity > 0 ? capacity : 1];
+} // CollisionDataBuffer
+
+CollisionDataBuffer::~CollisionDataBuffer() {
+	delete[] data;
+} // ~CollisionDataBuffer
+
+CollisionObject::CollisionObject(CollisionObjectType typeId) :
+	typeId(typeId) {
 	transformation = identityTransformation();
 } // CollisionObject
 
@@ -41,6 +56,31 @@ CollisionObject::~CollisionObject() {
 
 std::vector<CollisionData*>& CollisionObject::checkCollision(CollisionObject* opponent,
 		std::vector<CollisionData*>& dst) {
+	unsigned i;
+	unsigned capacity = DEFAULT_COLLISIONBUFFER_SIZE;
+	CollisionData* result;
+
+	// repeat the test with a larger buffer until all collisions fit
+	while (true) {
+		CollisionDataBuffer buffer(capacity);
+		checkCollision(opponent, buffer);
+		if (buffer.getNumDropped() > 0) {
+			capacity = buffer.size() + buffer.getNumDropped();
+			continue;
+		} // if
+
+		for (i = 0; i < buffer.size(); i++) {
+			result = new CollisionData;
+			*result = buffer[i];
+			dst.push_back(result);
+		} // for
+		break;
+	} // while
+	return dst;
+} // checkCollision
+
+CollisionDataBuffer& CollisionObject::checkCollision(CollisionObject* opponent,
+		CollisionDataBuffer& dst) {
 	if (canCheckCollision(opponent))
 		return checkCollisionInternal(opponent, dst, false);
 
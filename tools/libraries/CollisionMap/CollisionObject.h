@@ -61,6 +61,88 @@ struct CollisionData {
 	// 	gmtl::Vec2f normal;
 }; // CollisionData
 
+/******************************************************************************
+ * @class CollisionDataBuffer
+ * @brief Fixed-capacity storage for the results of a collision query.
+ *
+ * The buffer is provided by the caller of the allocation-free
+ * <code>checkCollision</code> methods. The storage for all entries is
+ * allocated once in the constructor, so a buffer can be reused for every
+ * query by calling <code>clear</code>. Collisions which are found after the
+ * capacity is exhausted are dropped and only counted.
+ */
+class CollisionDataBuffer {
+public:
+
+	/** Constructor allocates storage for the passed number of entries.
+	 * @param capacity maximum number of CollisionData entries
+	 */
+	CollisionDataBuffer(unsigned capacity);
+
+	/** Destructor frees the storage.
+	 */
+	~CollisionDataBuffer();
+
+	/** Returns the next free entry of the buffer.
+	 * @return free CollisionData entry, NULL if the buffer is full
+	 */
+	CollisionData* add() {
+		if (count < capacity)
+			return &data[count++];
+		numDropped++;
+		return NULL;
+	} // add
+
+	/** Removes all entries and resets the counter of dropped entries.
+	 */
+	void clear() {
+		count = 0;
+		numDropped = 0;
+	} // clear
+
+	/** Returns the number of stored entries.
+	 */
+	unsigned size() const {
+		return count;
+	} // size
+
+	/** Returns the maximum number of entries.
+	 */
+	unsigned getCapacity() const {
+		return capacity;
+	} // getCapacity
+
+	/** Returns the number of collisions which did not fit into the buffer
+	 * since the last call of <code>clear</code>.
+	 */
+	unsigned getNumDropped() const {
+		return numDropped;
+	} // getNumDropped
+
+	CollisionData& operator[](unsigned index) {
+		return data[index];
+	} // operator[]
+
+	const CollisionData& operator[](unsigned index) const {
+		return data[index];
+	} // operator[]
+
+private:
+	CollisionDataBuffer(const CollisionDataBuffer&);
+	CollisionDataBuffer& operator=(const CollisionDataBuffer&);
+
+	CollisionData* data;
+	unsigned capacity;
+	unsigned count;
+	unsigned numDropped;
+}; // CollisionDataBuffer
+
+/// Type tags of the CollisionObjects, used to dispatch the collision tests
+enum CollisionObjectType {
+	COLLISIONOBJECT_CIRCLE,
+	COLLISIONOBJECT_LINESET
+}; // CollisionObjectType
+
 /******************************************************************************
  * @class CollisionObject
  * @brief Abstract class for Objects used for 2D collision detection.
@@ -75,9 +157,10 @@ struct CollisionData {
 class CollisionObject {
 public:
 
-	/** Constructor initializes transformation of CollisionObject.
+	/** Constructor initializes transformation and type of CollisionObject.
+	 * @param typeId type tag of the derived class
 	 */
-	CollisionObject();
+	CollisionObject(CollisionObjectType typeId);
 
 	/** Empty destructor.
 	 */
@@ -95,6 +178,15 @@ public:
 	std::vector<CollisionData*>& checkCollision(CollisionObject* opponent, std::vector<
 			CollisionData*>& dst);
 
+	/** Checks if the Object collides with another CollisionObject.
+	 * Same as above, but the found collisions are written into the passed
+	 * buffer so that no memory is allocated during the test.
+	 * @param opponent CollisionObject with which a collision should be checked
+	 * @param dst Destination buffer where all Collisions are stored to
+	 * @return Destination buffer (same as second parameter)
+	 */
+	CollisionDataBuffer& checkCollision(CollisionObject* opponent, CollisionDataBuffer& dst);
+
 	/** Sets the Transformation of the CollisionObject.
 	 * The method sets the Transformation of the Object. This Transformation
 	 * will be used boy the <code>checkCollision</code> methods to determine
@@ -121,11 +213,20 @@ public:
 	 */
 	virtual std::string getType() = 0;
 
+	/** Returns the type tag of the CollisionObject.
+	 * The type tag is used instead of the name in the <code>checkCollision</code>
+	 * methods to find the correct method for the collision test.
+	 * @return Type tag of the CollisionObject.
+	 */
+	CollisionObjectType getTypeId() const {
+		return typeId;
+	} // getTypeId
+
 protected:
 
 	/** Checks if a collision-method is implemented for a collision check
 	 * between the current CollisionObject and the passed one. Internally
-	 * it checks the name of the passed CollisionObject and returns if a method
+	 * it checks the type of the passed CollisionObject and returns if a method
 	 * exists locally to check for collisions.
 	 * @param opponent CollisionObject for which a collision-method is searched
 	 * @return true if a collision-method is implemented in this class, false
@@ -142,16 +243,19 @@ protected:
 	 * <code>checkCollision</code> method is called is always the first
 	 * CollisionObject in the CollisionData element.
 	 * @param opponent CollisionObject to check the collision with
-	 * @param dst Destination vector where to write the collision information to
+	 * @param dst Destination buffer where to write the collision information to
 	 * @param changeOrder Defines order of CollisionObjects in CollisionData
-	 * @return Destination vector (same as second parameter)
+	 * @return Destination buffer (same as second parameter)
 	 */
-	virtual std::vector<CollisionData*>& checkCollisionInternal(CollisionObject* opponent,
-			std::vector<CollisionData*>& dst, bool changeOrder) = 0;
+	virtual CollisionDataBuffer& checkCollisionInternal(CollisionObject* opponent,
+			CollisionDataBuffer& dst, bool changeOrder) = 0;
 
 	/// The Transformation of the CollisionObject
 	TransformationData transformation;
 
+	/// The type tag of the CollisionObject
+	CollisionObjectType typeId;
+
 }; // CollisionObject
 
 #endif // _COLLISIONOBJECT_H
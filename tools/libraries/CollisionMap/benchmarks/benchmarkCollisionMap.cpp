@@ -0,0 +1,143 @@
+// compile DEBUG messages out of the PRINTD macros for this benchmark:
+#define INVRS_PRINTD_MIN_SEVERITY 1
+
+#include <inVRs/SystemCore/DebugOutput.h>
+#include <inVRs/SystemCore/Timer.h>
+
+#include "../CollisionCircle.h"
+#include "../CollisionLineSet.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static const unsigned NUM_LINES = 100000;
+static const float WORLD_SIZE = 2000.f;
+static const float MAX_LINE_LENGTH = 10.f;
+static const float RADIUS = 0.5f;
+static const unsigned GRID_QUERIES = 100000;
+static const unsigned LINEAR_QUERIES = 200;
+
+static float randomFloat(float max) {
+	return max * (float)rand() / (float)RAND_MAX;
+} // randomFloat
+
+/** Collision test as done before the grid: every line is transformed and
+ * tested against the circle.
+ */
+static unsigned linearScan(const std::vector<CollisionLineSet::CollisionLine*>& lines,
+		const TransformationData& trans, const gmtl::Vec2f& c, float radius) {
+	unsigned i, hits = 0;
+	gmtl::Vec3f rotated;
+	gmtl::Vec2f p, q, qp, closest;
+	float t;
+
+	for (i = 0; i < lines.size(); i++) {
+		rotated = trans.orientation * gmtl::Vec3f(lines[i]->startPoint[0] * trans.scale[0], 0,
+				lines[i]->startPoint[1] * trans.scale[2]);
+		p = gmtl::Vec2f(trans.position[0] + rotated[0], trans.position[2] + rotated[2]);
+		rotated = trans.orientation * gmtl::Vec3f(lines[i]->endPoint[0] * trans.scale[0], 0,
+				lines[i]->endPoint[1] * trans.scale[2]);
+		q = gmtl::Vec2f(trans.position[0] + rotated[0], trans.position[2] + rotated[2]);
+		qp = q - p;
+		t = gmtl::dot(c - p, qp) / gmtl::dot(qp, qp);
+		t = gmtl::Math::clamp(t, 0.f, 1.f);
+		closest = p + t * qp;
+		if (gmtl::length(gmtl::Vec2f(closest - c)) <= radius)
+			hits++;
+	} // for
+	return hits;
+} // linearScan
+
+/** Benchmark for the collision test of a user (CollisionCircle) against a
+ * large CollisionLineSet as used for outdoor scenes.
+ * The grid query with a reused CollisionDataBuffer is compared with the
+ * allocating std::vector interface and with a linear scan over all lines.
+ */
+int main() {
+	unsigned i;
+	std::vector<CollisionLineSet::CollisionLine*> lines;
+	std::vector<gmtl::Vec2f> positions;
+
+	printd_severity(WARNING);
+
+	srand(42);
+	for (i = 0; i < NUM_LINES; i++) {
+		CollisionLineSet::CollisionLine* line = new CollisionLineSet::CollisionLine;
+		float angle = randomFloat(2 * gmtl::Math::PI);
+		float length = randomFloat(MAX_LINE_LENGTH);
+		line->startPoint = gmtl::Vec2f(randomFloat(WORLD_SIZE), randomFloat(WORLD_SIZE));
+		line->endPoint = line->startPoint + gmtl::Vec2f(cosf(angle) * length, sinf(angle)
+				* length);
+		lines.push_back(line);
+	} // for
+	for (i = 0; i < GRID_QUERIES; i++)
+		positions.push_back(gmtl::Vec2f(randomFloat(WORLD_SIZE), randomFloat(WORLD_SIZE)));
+
+	CollisionLineSet lineSet(lines);
+	CollisionCircle circle(RADIUS);
+	TransformationData lineSetTrans = identityTransformation();
+	TransformationData circleTrans = identityTransformation();
+	setQuatfAsAxisAngleDeg(lineSetTrans.orientation, 0, 1, 0, 30);
+	lineSet.setTransformation(lineSetTrans);
+
+	double start = inVRsUtilities::Timer::getMonotonicTime();
+	CollisionDataBuffer buffer(64);
+	lineSet.checkCollision(&circle, buffer);
+	double buildTime = inVRsUtilities::Timer::getMonotonicTime() - start;
+
+	unsigned gridHits = 0;
+	start = inVRsUtilities::Timer::getMonotonicTime();
+	for (i = 0; i < GRID_QUERIES; i++) {
+		circleTrans.position = gmtl::Vec3f(positions[i][0], 0, positions[i][1]);
+		circle.setTransformation(circleTrans);
+		buffer.clear();
+		lineSet.checkCollision(&circle, buffer);
+		gridHits += buffer.size() + buffer.getNumDropped();
+	} // for
+	double gridTime = inVRsUtilities::Timer::getMonotonicTime() - start;
+
+	unsigned vectorHits = 0;
+	std::vector<CollisionData*> collisions;
+	start = inVRsUtilities::Timer::getMonotonicTime();
+	for (i = 0; i < GRID_QUERIES; i++) {
+		circleTrans.position = gmtl::Vec3f(positions[i][0], 0, positions[i][1]);
+		circle.setTransformation(circleTrans);
+		lineSet.checkCollision(&circle, collisions);
+		vectorHits += collisions.size();
+		for (unsigned j = 0; j < collisions.size(); j++)
+			delete collisions[j];
+		collisions.clear();
+	} // for
+	double vectorTime = inVRsUtilities::Timer::getMonotonicTime() - start;
+
+	unsigned linearHits = 0, gridReferenceHits = 0;
+	start = inVRsUtilities::Timer::getMonotonicTime();
+	for (i = 0; i < LINEAR_QUERIES; i++) {
+		linearHits += linearScan(lines, lineSetTrans, positions[i], RADIUS);
+	} // for
+	double linearTime = inVRsUtilities::Timer::getMonotonicTime() - start;
+	for (i = 0; i < LINEAR_QUERIES; i++) {
+		circleTrans.position = gmtl::Vec3f(positions[i][0], 0, positions[i][1]);
+		circle.setTransformation(circleTrans);
+		buffer.clear();
+		lineSet.checkCollision(&circle, buffer);
+		gridReferenceHits += buffer.size() + buffer.getNumDropped();
+	} // for
+
+	if (gridHits != vectorHits || gridReferenceHits != linearHits)
+		fprintf(stderr, "Hit counts differ: grid %u, vector %u, grid %u vs. linear %u!\n",
+				gridHits, vectorHits, gridReferenceHits, linearHits);
+
+	printf("%u lines, circle radius %.2f, grid build %.1f ms\n", NUM_LINES, RADIUS, buildTime
+			* 1e3);
+	printf("%28s %12s\n", "", "[us/query]");
+	printf("%28s %12.3f\n", "grid, CollisionDataBuffer", gridTime * 1e6 / GRID_QUERIES);
+	printf("%28s %12.3f\n", "grid, std::vector", vectorTime * 1e6 / GRID_QUERIES);
+	printf("%28s %12.3f\n", "linear scan", linearTime * 1e6 / LINEAR_QUERIES);
+
+	for (i = 0; i < lines.size(); i++)
+		delete lines[i];
+	return 0;
+}
@@ -0,0 +1,106 @@
+#include <iostream>
+#include <stdexcept>
+#include <typeinfo>
+#include <vector>
+#include <math.h>
+
+#include <inVRs/SystemCore/DataTypes.h>
+#include <inVRs/SystemCore/DebugOutput.h>
+#include <gmtl/Generate.h>
+#include "../CollisionLineSet.h"
+
+#undef NDEBUG
+#include <cassert>
+
+#define test_bool_true(x) try { \
+	if ( !(x) ) \
+	{ \
+		std::cout << "Test condition ``" # x "'' failed!" <<std::endl; \
+		failed=true; \
+	} \
+} catch (std::exception &e ) \
+{ \
+	std::cout << "Exception " << typeid(e).name() << " during test ``" # x "'': " << e.what() << std::endl; \
+	failed=true;\
+}
+
+static bool near(float a, float b)
+{
+	return fabsf(a - b) < 1e-4f;
+}
+
+static bool near(const gmtl::Vec2f& a, float x, float y)
+{
+	return near(a[0], x) && near(a[1], y);
+}
+
+int main()
+{
+	bool failed=false;
+	float toi;
+	gmtl::Vec2f normal;
+	std::vector<CollisionLineSet::CollisionLine*> lines;
+	CollisionLineSet::CollisionLine wall;
+	TransformationData trans = identityTransformation();
+
+	printd_severity(WARNING);
+
+	// a single wall along the y axis from (0,-1) to (0,1)
+	wall.startPoint = gmtl::Vec2f(0, -1);
+	wall.endPoint = gmtl::Vec2f(0, 1);
+	lines.push_back(&wall);
+	CollisionLineSet lineSet(lines);
+	lineSet.setTransformation(trans);
+
+	// contact with the inner part of the line
+	test_bool_true ( lineSet.sweepCircle(gmtl::Vec2f(-2, 0), gmtl::Vec2f(2, 0), 0.5f, toi, normal) );
+	test_bool_true ( near(toi, 0.375f) );
+	test_bool_true ( near(normal, -1, 0) );
+	test_bool_true ( lineSet.sweepCircle(gmtl::Vec2f(2, 0.5f), gmtl::Vec2f(-2, 0.5f), 0.5f, toi, normal) );
+	test_bool_true ( near(toi, 0.375f) );
+	test_bool_true ( near(normal, 1, 0) );
+
+	// contact with the end point (0,1): the center touches at (-0.4,1.3)
+	test_bool_true ( lineSet.sweepCircle(gmtl::Vec2f(-2, 1.3f), gmtl::Vec2f(2, 1.3f), 0.5f, toi, normal) );
+	test_bool_true ( near(toi, 0.4f) );
+	test_bool_true ( near(normal, -0.8f, 0.6f) );
+
+	// passing the line, stopping before it
+	test_bool_true ( !lineSet.sweepCircle(gmtl::Vec2f(-2, 1.8f), gmtl::Vec2f(2, 1.8f), 0.5f, toi, normal) );
+	test_bool_true ( toi == 1 );
+	test_bool_true ( !lineSet.sweepCircle(gmtl::Vec2f(-2, 0), gmtl::Vec2f(-1, 0), 0.5f, toi, normal) );
+
+	// overlapping at the start: moving away or along the line is allowed,
+	// moving towards the line is blocked immediately
+	test_bool_true ( !lineSet.sweepCircle(gmtl::Vec2f(-0.3f, 0), gmtl::Vec2f(-2, 0), 0.5f, toi, normal) );
+	test_bool_true ( !lineSet.sweepCircle(gmtl::Vec2f(-0.3f, 0), gmtl::Vec2f(-0.3f, 0.5f), 0.5f, toi, normal) );
+	test_bool_true ( lineSet.sweepCircle(gmtl::Vec2f(-0.3f, 0), gmtl::Vec2f(1, 0), 0.5f, toi, normal) );
+	test_bool_true ( toi == 0 );
+	test_bool_true ( near(normal, -1, 0) );
+
+	// moving the set only offsets the query
+	trans.position = gmtl::Vec3f(10, 0, 0);
+	lineSet.setTransformation(trans);
+	test_bool_true ( !lineSet.sweepCircle(gmtl::Vec2f(-2, 0), gmtl::Vec2f(2, 0), 0.5f, toi, normal) );
+	test_bool_true ( lineSet.sweepCircle(gmtl::Vec2f(8, 0), gmtl::Vec2f(12, 0), 0.5f, toi, normal) );
+	test_bool_true ( near(toi, 0.375f) );
+	trans.position = gmtl::Vec3f(0, 0, 0);
+
+	// scaling the set rebuilds the grid: the wall now reaches from (0,-2) to (0,2)
+	trans.scale = gmtl::Vec3f(2, 2, 2);
+	lineSet.setTransformation(trans);
+	test_bool_true ( lineSet.sweepCircle(gmtl::Vec2f(-2, 1.8f), gmtl::Vec2f(2, 1.8f), 0.5f, toi, normal) );
+	test_bool_true ( near(toi, 0.375f) );
+	test_bool_true ( near(normal, -1, 0) );
+
+	// rotating the set by 90 degrees around the y axis rebuilds the grid: the
+	// wall now lies along the x axis from (-2,0) to (2,0)
+	gmtl::set(trans.orientation, gmtl::AxisAnglef(gmtl::Math::PI_OVER_2, 0, 1, 0));
+	lineSet.setTransformation(trans);
+	test_bool_true ( !lineSet.sweepCircle(gmtl::Vec2f(-2, 1.8f), gmtl::Vec2f(2, 1.8f), 0.5f, toi, normal) );
+	test_bool_true ( lineSet.sweepCircle(gmtl::Vec2f(1, -2), gmtl::Vec2f(1, 2), 0.5f, toi, normal) );
+	test_bool_true ( near(toi, 0.375f) );
+	test_bool_true ( near(normal, 0, -1) );
+
+	return (failed) ? 1 : 0;
+}